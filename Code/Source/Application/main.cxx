@@ -47,6 +47,7 @@
   #include "ctkPluginFrameworkLauncher.h"
   #include "sv4gui_MitkApp.h"
   #include "sv4gui_Main.h"
+  #include "sv4gui_MeshBatch.h"
 #endif
 
 #include "sv_IOstream.h"
@@ -159,6 +160,9 @@ svCatchDebugger() {
   bool catch_debugger = false;
   bool use_provisioning_file = false;
   bool pass_along_options = false;
+  char *mesh_batch_file = NULL;
+  int mesh_batch_workers = 0;
+  double mesh_batch_memory = -1.0;
 
 #ifdef WIN32  
   gSimVascularUseWin32Registry = 1;
@@ -190,6 +194,10 @@ svCatchDebugger() {
 	fprintf(stdout,"  -qt, --qt-gui            : use Qt GUI (SV_BATCH_MODE overrides)\n");
 	fprintf(stdout,"  --workbench              : use mitk workbench application\n");
 	fprintf(stdout,"  --use-pro                : use the .provisioning file \n");
+	fprintf(stdout,"  --mesh-batch jobfile     : run the mesh jobs in jobfile and exit\n");
+	fprintf(stdout,"  --mesh-workers n         : number of mesh jobs run at once\n");
+	fprintf(stdout,"  --mesh-memory mb         : resident memory limit (MB) for each mesh job\n");
+	fprintf(stdout,"                             (default memory/workers, 0 for none)\n");
 #endif
 #ifdef WIN32
 	fprintf(stdout,"  --use-registry           : use Windows registry entries (default) \n");
@@ -234,6 +242,24 @@ svCatchDebugger() {
 	use_provisioning_file = true;
 	foundValid = true;
       }
+      if((!strcmp("--mesh-batch",argv[iarg]))    ||
+	 (!strcmp("--mesh-workers",argv[iarg])) ||
+	 (!strcmp("--mesh-memory",argv[iarg]))) {
+	if(iarg+1 >= argc) {
+	  fprintf(stdout,"error!  no value for %s!\n",argv[iarg]);
+	  foundValid = false;
+	  break;
+	}
+	if(!strcmp("--mesh-batch",argv[iarg])) {
+	  mesh_batch_file = argv[iarg+1];
+	} else if(!strcmp("--mesh-workers",argv[iarg])) {
+	  mesh_batch_workers = atoi(argv[iarg+1]);
+	} else {
+	  mesh_batch_memory = atof(argv[iarg+1]);
+	}
+	iarg++;
+	foundValid = true;
+      }
 #endif
 #ifdef WIN32
       if((!strcmp("--ignore-registry",argv[iarg]))) {
@@ -347,6 +373,22 @@ svCatchDebugger() {
 
   vtkObject::GlobalWarningDisplayOff();
 
+#ifdef SV_USE_SV4_GUI
+  if (mesh_batch_file != NULL) {
+    sv4guiMeshBatch meshBatch;
+    std::string msg;
+    if (!meshBatch.ReadJobFile(mesh_batch_file, msg)) {
+      fprintf(stderr,"error reading mesh jobs: %s\n",msg.c_str());
+      return 1;
+    }
+    meshBatch.SetMaxWorkers(mesh_batch_workers);
+    meshBatch.SetMemoryLimitMB(mesh_batch_memory);
+    bool success = meshBatch.Run();
+    meshBatch.PrintResults(std::cout);
+    return success ? 0 : 1;
+  }
+#endif
+
   if (gSimVascularBatchMode == 1) {
 #ifdef SV_USE_PYTHON
     if(use_python) {
@@ -507,6 +507,86 @@ Mesher_load_model(PyMeshingMesher* self, PyObject* args, PyObject* kwargs)
   Py_RETURN_NONE;
 }
 
+//--------------------------------
+// Mesher_get_quality_statistics
+//--------------------------------
+
+PyDoc_STRVAR(Mesher_get_quality_statistics_doc,
+  "get_quality_statistics(bins=20)  \n\
+   \n\
+   Get the element quality statistics of the generated volume mesh.  \n\
+   \n\
+   The radius ratio, minimum dihedral angle (degrees), aspect ratio,     \n\
+   volume and edge length of the tetrahedral elements are collected for  \n\
+   the whole mesh, each model region and the boundary layer and interior \n\
+   elements of a region.                                                 \n\
+   \n\
+   Args: \n\
+     bins (Optional[int]): The number of histogram bins. \n\
+   \n\
+   Returns dict(str: dict): The statistics of each group, keyed by group \n\
+     name, with 'region', 'boundary_layer', 'elements', 'inverted' and   \n\
+     'skipped' values and a dict for each metric with 'count', 'min',    \n\
+     'max', 'mean', 'bin_min', 'bin_width' and 'bins' values.            \n\
+");
+
+static PyObject *
+Mesher_get_quality_statistics(PyMeshingMesher* self, PyObject* args, PyObject* kwargs)
+{
+  using namespace MeshingMesher;
+  auto api = PyUtilApiFunction("|i", PyRunTimeErr, __func__);
+  static char *keywords[] = {"bins", nullptr};
+  int numBins = 20;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, api.format, keywords, &numBins)) {
+    return api.argsError();
+  }
+
+  if (numBins < 1) {
+      api.error("The number of bins must be greater than 0.");
+      return nullptr;
+  }
+
+  auto mesher = self->mesher;
+  if (!MeshExists(api, mesher)) {
+      return nullptr;
+  }
+
+  cvMeshQuality quality;
+  quality.SetNumberOfBins(numBins);
+  if (mesher->GetQualityStatistics(quality) != SV_OK) {
+      api.error("Could not compute the quality statistics for the mesh.");
+      return nullptr;
+  }
+
+  // Build the statistics of each group.
+  //
+  PyObject* statistics = PyDict_New();
+  for (auto const& group : quality.GetGroups()) {
+      PyObject* groupStats = Py_BuildValue("{s:i,s:i,s:L,s:L,s:L}", "region", group.regionId,
+          "boundary_layer", group.boundaryLayer, "elements", (long long)group.numberOfElements,
+          "inverted", (long long)group.numberOfInverted, "skipped", (long long)group.numberOfSkipped);
+
+      for (int m = 0; m < cvMeshQuality::NUMBER_OF_METRICS; m++) {
+          auto const& histogram = group.metrics[m];
+          PyObject* bins = PyList_New(histogram.bins.size());
+          for (int i = 0; i < histogram.bins.size(); i++) {
+              PyList_SetItem(bins, i, Py_BuildValue("L", (long long)histogram.bins[i]));
+          }
+          PyObject* metricStats = Py_BuildValue("{s:L,s:d,s:d,s:d,s:d,s:d,s:N}", "count", (long long)histogram.count,
+              "min", histogram.min, "max", histogram.max, "mean", histogram.mean, "bin_min", histogram.binMin,
+              "bin_width", histogram.binWidth, "bins", bins);
+          PyDict_SetItemString(groupStats, cvMeshQuality::GetMetricName(m), metricStats);
+          Py_DECREF(metricStats);
+      }
+
+      PyDict_SetItemString(statistics, group.name.c_str(), groupStats);
+      Py_DECREF(groupStats);
+  }
+
+  return statistics;
+}
+
 //--------------------
 // Mesher_get_surface
 //--------------------
@@ -1103,6 +1183,8 @@ static PyMethodDef PyMeshingMesherMethods[] = {
 
   { "get_model_polydata", (PyCFunction)Mesher_get_model_polydata, METH_VARARGS, Mesher_get_model_polydata_doc },
 
+  { "get_quality_statistics", (PyCFunction)Mesher_get_quality_statistics, METH_VARARGS|METH_KEYWORDS, Mesher_get_quality_statistics_doc },
+
   { "get_surface", (PyCFunction)Mesher_get_surface, METH_VARARGS, Mesher_get_surface_doc },
 
   { "load_mesh", (PyCFunction)Mesher_load_mesh, METH_VARARGS|METH_KEYWORDS, Mesher_load_mesh_doc },
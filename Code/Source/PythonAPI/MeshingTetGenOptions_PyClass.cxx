@@ -84,6 +84,7 @@ PyObject * CreateTetGenOptionsType(PyObject* args, PyObject* kwargs);
 //   boundary_layer_inside: int
 //   diagnose: set option to true without value
 //   global_edge_size:
+//   incremental_remesh: Boolean
 //   no_bisect: set option to true without value
 //   no_merge: set option to true without value
 //   optimization: int, not sure what valid range is.
@@ -132,6 +133,7 @@ typedef struct {
   //double epsilon;
   double global_edge_size;
   //double hausd;
+  int incremental_remesh;
   //PyObject* mesh_wall_first;
   //PyObject* new_region_boundary_layer;
   double minimum_dihedral_angle;
@@ -175,6 +177,7 @@ namespace TetGenOption {
   //char* Epsilon = "epsilon";
   char* GlobalEdgeSize = "global_edge_size";
   //char* Hausd = "hausd";
+  char* IncrementalRemesh = "incremental_remesh";
   char* LocalEdgeSize = "local_edge_size";
   char* LocalEdgeSizeOn = "local_edge_size_on";
   //char* MeshWallFirst = "mesh_wall_first";
@@ -255,6 +258,7 @@ namespace TetGenOption {
       //{std::string(Epsilon), "Epsilon"},
       {std::string(GlobalEdgeSize), "GlobalEdgeSize"},
       //{std::string(Hausd), "Hausd"},
+      {std::string(IncrementalRemesh), "IncrementalRemesh"},
       //{std::string(MeshWallFirst), "MeshWallFirst"},
       //{std::string(NewRegionBoundaryLayer), "NewRegionBoundaryLayer"},
       {std::string(MinimumDihedralAngle), "MinDihedral"},
@@ -833,6 +837,7 @@ PyTetGenOptionsCreateFromList(cvMeshObject* mesher, std::vector<std::string>& op
   SetValueMapType SetValueMap = {
     {pyToSvNameMap[AllowMultipleRegions], [](OptType opt, ArgType vals, MapType fmap) -> void { opt->allow_multiple_regions = std::stoi(vals[0]); }},
     {pyToSvNameMap[GlobalEdgeSize], [](OptType opt, ArgType vals, MapType fmap) -> void { opt->global_edge_size = std::stof(vals[0]); }},
+    {pyToSvNameMap[IncrementalRemesh], [](OptType opt, ArgType vals, MapType fmap) -> void { opt->incremental_remesh = std::stoi(vals[0]); }},
     //{pyToSvNameMap[LocalEdgeSize], [](OptType opt, ArgType vals, MapType fmap) -> void { PyTetGenOptionsAddLocalEdgeSize(opt,vals,fmap); }},
     {pyToSvNameMap[MinimumDihedralAngle], [](OptType opt, ArgType vals, MapType fmap) -> void { opt->minimum_dihedral_angle = std::stod(vals[0]); }},
     {pyToSvNameMap[NoBisect], [](OptType opt, ArgType vals, MapType fmap) -> void { opt->no_bisect = Py_BuildValue("i", 1); }},
@@ -1032,6 +1037,8 @@ PyTetGenOptions_get_values(PyMeshingTetGenOptions* self, PyObject* args)
 
   //PyDict_SetItemString(values, TetGenOption::Hausd, Py_BuildValue("d", self->hausd));
 
+  PyDict_SetItemString(values, TetGenOption::IncrementalRemesh, PyBool_FromLong(self->incremental_remesh));
+
   PyDict_SetItemString(values, TetGenOption::LocalEdgeSize, self->local_edge_size);
   PyDict_SetItemString(values, TetGenOption::LocalEdgeSizeOn, PyBool_FromLong(self->local_edge_size_on));
 
@@ -1095,6 +1102,7 @@ PyTetGenOptions_set_defaults(PyMeshingTetGenOptions* self)
   //self->epsilon = 0;
   self->global_edge_size = 0;
   //self->hausd = 0;
+  self->incremental_remesh = 0;
   //self->mesh_wall_first = Py_BuildValue("");
   //self->new_region_boundary_layer = Py_BuildValue("");
   self->minimum_dihedral_angle = 0.0;
@@ -1228,6 +1236,15 @@ PyDoc_STRVAR(global_edge_size_doc,
    \n\
 ");
 
+PyDoc_STRVAR(incremental_remesh_doc,
+  "Type: bool                                                              \n\
+   Default: False                                                          \n\
+   \n\
+   If True then keep the remeshed surface between meshing runs of the same \n\
+   model and remesh only the faces whose local edge sizes changed.         \n\
+   \n\
+");
+
 PyDoc_STRVAR(local_edge_size_doc,
   "Type: list({'face_id':int, 'edge_size':float})                         \n\
    Default: []                                                            \n\
@@ -1434,6 +1451,7 @@ static PyMemberDef PyTetGenOptionsMembers[] = {
     //{TetGenOption::Epsilon, T_DOUBLE, offsetof(PyMeshingTetGenOptions, epsilon), 0, "Epsilon"},
     {TetGenOption::GlobalEdgeSize, T_DOUBLE, offsetof(PyMeshingTetGenOptions, global_edge_size), 0, global_edge_size_doc},
     //{TetGenOption::Hausd, T_DOUBLE, offsetof(PyMeshingTetGenOptions, hausd), 0, "Hausd"},
+    {TetGenOption::IncrementalRemesh, T_BOOL, offsetof(PyMeshingTetGenOptions, incremental_remesh), 0, incremental_remesh_doc},
 
     {TetGenOption::LocalEdgeSize, T_OBJECT_EX, offsetof(PyMeshingTetGenOptions, local_edge_size), 0, local_edge_size_doc},
     {TetGenOption::LocalEdgeSizeOn, T_BOOL, offsetof(PyMeshingTetGenOptions, local_edge_size_on), 0, local_edge_size_on_doc},
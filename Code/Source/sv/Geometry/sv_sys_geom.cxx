@@ -431,15 +431,6 @@ int sys_geom_assign_ids_based_on_faces( cvPolyData *model, cvPolyData **faces,in
 {
   cvPolyData *result = nullptr;
   *dst = nullptr;
-  vtkIdType cellId = 0;
-  vtkIdType closestCell;
-  vtkIdType npts;
-  const vtkIdType *pts;
-  int subId = 0;
-  double distance;
-  double centroid[3];
-  double closestPt[3];
-  vtkNew(vtkGenericCell,genericCell);
 
   vtkPolyData *fullPd = model->GetVtkPolyData();
   fullPd->BuildLinks();
@@ -458,31 +449,13 @@ int sys_geom_assign_ids_based_on_faces( cvPolyData *model, cvPolyData **faces,in
   appender->Update();
   facePd->DeepCopy(appender->GetOutput());
 
-  vtkNew(vtkCellLocator,cellLocator);
-  cellLocator->SetDataSet(facePd);
-  cellLocator->BuildLocator();
   vtkNew(vtkIntArray,newIdArray);
   newIdArray->SetName("ModelFaceID");
-  vtkNew(vtkIntArray,oldIdArray);
-  oldIdArray = vtkIntArray::SafeDownCast(facePd->GetCellData()->GetArray("ModelFaceID"));
+  vtkDataArray *oldIdArray = facePd->GetCellData()->GetArray("ModelFaceID");
 
-  for (vtkIdType cellId=0;cellId<fullPd->GetNumberOfCells();cellId++)
+  if (VtkUtils_TransferCellLabels(facePd,oldIdArray,fullPd,newIdArray) != SV_OK)
   {
-    fullPd->GetCellPoints(cellId,npts,pts);
-
-    vtkNew(vtkPoints,polyPts);
-    vtkNew(vtkIdTypeArray,polyPtIds);
-    for (int i=0;i<npts;i++)
-    {
-      polyPtIds->InsertValue(i,i);
-      polyPts->InsertNextPoint(fullPd->GetPoint(pts[i]));
-    }
-    vtkPolygon::ComputeCentroid(polyPtIds,polyPts,centroid);
-
-    cellLocator->FindClosestPoint(centroid,closestPt,genericCell,closestCell,
-	  subId,distance);
-    vtkIdType faceValue = oldIdArray->GetValue(closestCell);
-    newIdArray->InsertValue(cellId,faceValue);
+    return SV_ERROR;
   }
   fullPd->GetCellData()->AddArray(newIdArray);
   result = new cvPolyData( fullPd);
@@ -41,6 +41,7 @@
 #include "SimVascular.h"
 
 #include "sv_adapt_utils.h"
+#include "sv_vtk_utils.h"
 
 #include "vtkXMLUnstructuredGridWriter.h"
 #include "vtkDataSetSurfaceFilter.h"
@@ -57,7 +58,12 @@
 #include "vtkCellData.h"
 #include "vtkPolygon.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
 #include "vtkTetra.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
 
 #include "sv_eispack.h"
 
@@ -77,6 +83,342 @@ void  bzero(void* ptr, size_t sz) {
 }
 #endif
 
+namespace {
+
+// -----------------------------
+// PointAdjacencyFunctor
+// -----------------------------
+// Collects the unique points of the cells attached to each point. The
+// counting pass stores the number of neighbors in offsets[pointId+1],
+// the filling pass copies them into the already sized neighbor list.
+class PointAdjacencyFunctor {
+  public:
+    vtkUnstructuredGrid *Mesh;
+    PointAdjacency *Adjacency;
+    bool Fill;
+    vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+    vtkSMPThreadLocal<std::vector<vtkIdType> > Buffer;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkIdList *cellPoints = this->CellPoints.Local();
+      std::vector<vtkIdType> &buffer = this->Buffer.Local();
+      vtkIdType ncells;
+      vtkIdType *cells;
+
+      for (vtkIdType pointId=begin;pointId<end;pointId++)
+      {
+        buffer.clear();
+        this->Mesh->GetPointCells(pointId,ncells,cells);
+        for (vtkIdType i=0;i<ncells;i++)
+        {
+          this->Mesh->GetCellPoints(cells[i],cellPoints);
+          for (vtkIdType j=0;j<cellPoints->GetNumberOfIds();j++)
+          {
+            if (cellPoints->GetId(j) != pointId)
+              buffer.push_back(cellPoints->GetId(j));
+          }
+        }
+        std::sort(buffer.begin(),buffer.end());
+        buffer.erase(std::unique(buffer.begin(),buffer.end()),buffer.end());
+
+        if (this->Fill)
+        {
+          std::copy(buffer.begin(),buffer.end(),
+            this->Adjacency->neighbors.begin()+this->Adjacency->offsets[pointId]);
+        }
+        else
+        {
+          this->Adjacency->offsets[pointId+1] = buffer.size();
+        }
+      }
+    }
+};
+
+// -----------------------------
+// TetGenTetsFunctor
+// -----------------------------
+// Copies the corner points of the tetgen tetrahedra into VTK cell
+// offset and connectivity arrays and sets their global element ids.
+class TetGenTetsFunctor {
+  public:
+    const int *Tets;
+    int NumCorners;
+    vtkIdType *Offsets;
+    vtkIdType *Connectivity;
+    int *ElementIds;
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+    {
+      for (vtkIdType i=begin;i<end;i++)
+      {
+        for (int j=0;j<4;j++)
+          this->Connectivity[4*i+j] = this->Tets[i*this->NumCorners+j];
+        this->Offsets[i+1] = 4*(i+1);
+        this->ElementIds[i] = i+1;
+      }
+    }
+};
+
+// -----------------------------
+// SmoothHessiansFunctor
+// -----------------------------
+// Averages the hessian of each point with the hessians of its interior
+// neighbors. As before, an interior point is part of its own patch.
+class SmoothHessiansFunctor {
+  public:
+    const PointAdjacency *Adjacency;
+    const bool *PointOnSurface;
+    const double *NodalHessians;
+    double *AverageHessians;
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+    {
+      const vtkIdType *offsets = &this->Adjacency->offsets[0];
+      const vtkIdType *neighbors = this->Adjacency->neighbors.empty() ?
+        NULL : &this->Adjacency->neighbors[0];
+      int i;
+      int numSurroundingVerts;
+      double averageHessian[6];
+      const double *nodalHessian;
+      vtkIdType checkPt;
+
+      for (vtkIdType pointId=begin;pointId<end;pointId++)
+      {
+        nodalHessian = this->NodalHessians + 6*pointId;
+        for (i=0;i<6;i++)
+          averageHessian[i] = nodalHessian[i];
+
+        numSurroundingVerts = 0;
+        if (this->PointOnSurface[pointId] == false)
+        {
+          for (i=0;i<6;i++)
+            averageHessian[i] += nodalHessian[i];
+          numSurroundingVerts++;
+        }
+        for (vtkIdType k=offsets[pointId];k<offsets[pointId+1];k++)
+        {
+          checkPt = neighbors[k];
+          if (this->PointOnSurface[checkPt] == true)
+            continue;
+          nodalHessian = this->NodalHessians + 6*checkPt;
+          for (i=0;i<6;i++)
+            averageHessian[i] += nodalHessian[i];
+          numSurroundingVerts++;
+        }
+
+        if (numSurroundingVerts != 0)
+        {
+          for (i=0;i<6;i++)
+            averageHessian[i] = averageHessian[i]/numSurroundingVerts;
+        }
+        for (i=0;i<6;i++)
+          this->AverageHessians[6*pointId+i] = averageHessian[i];
+      }
+    }
+};
+
+// -----------------------------
+// HessianDecompositionFunctor
+// -----------------------------
+// Computes the eigen decomposition of the averaged hessian and the max
+// local interpolation error at each point. Points with a zero maximum
+// eigenvalue get a negative local error and are reported afterwards.
+class HessianDecompositionFunctor {
+  public:
+    vtkUnstructuredGrid *Mesh;
+    const PointAdjacency *Adjacency;
+    const double *AverageHessians;
+    Hessian *Hess;
+    double *LocalError;
+    double Tol;
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+    {
+      int j,k;
+      int three = 3;
+      double T[3][3];
+      double Tfoo[9];
+      double z[9];
+      double eigenVals[3];
+      double e[3];
+      const double *h;
+
+      for (vtkIdType pointId=begin;pointId<end;pointId++)
+      {
+        h = this->AverageHessians + 6*pointId;
+        T[0][0] = h[0];
+        T[0][1] = T[1][0] = h[1];
+        T[0][2] = T[2][0] = h[2];
+        T[1][1] = h[3];
+        T[1][2] = T[2][1] = h[4];
+        T[2][2] = h[5];
+
+        for (j=0;j<3;j++)
+        {
+          for (k=0;k<3;k++)
+          {
+            Tfoo[j*3+k] = T[j][k];
+          }
+        }
+
+        tred2(three,Tfoo,eigenVals,e,z);
+        tql2(three,eigenVals,e,z);
+
+        Hessian &hess = this->Hess[pointId];
+        for (j=0;j<3;j++)
+        {
+          hess.h[j] = ABS(eigenVals[j]);
+          for (k=0;k<3;k++)
+          {
+            hess.dir[j][k]=z[j*3+k];
+          }
+        }
+
+        if( MAX(hess.h[0],MAX(hess.h[1],hess.h[2])) < this->Tol ) {
+          this->LocalError[pointId] = -1.0;
+          continue;
+        }
+
+        // estimate relative interpolation error
+        // needed for scaling metric field (mesh size field)
+        // to get an idea refer Appendix A in Li's thesis
+        this->LocalError[pointId] =
+          AdaptUtils_maxLocalError(this->Mesh,pointId,T,this->Adjacency);
+      }
+    }
+};
+
+// -----------------------------
+// SizeFieldFunctor
+// -----------------------------
+// Turns the eigenvalues into clamped mesh sizes and writes the error
+// metric for each point. The hmin/hmax/sphere counts are kept per thread.
+struct SizeFieldCounts {
+  int hmin;
+  int hmax;
+  int both;
+  int sphere;
+};
+
+class SizeFieldFunctor {
+  public:
+    vtkUnstructuredGrid *Mesh;
+    Hessian *Hess;
+    double *ErrorMetric;
+    double Eloc;
+    double Hmax;
+    double Hmin;
+    double Tol;
+    double *Sphere;
+    int Strategy;
+    vtkSMPThreadLocal<SizeFieldCounts> LocalCounts;
+    SizeFieldCounts Counts;
+
+    void Initialize()
+    {
+      SizeFieldCounts &counts = this->LocalCounts.Local();
+      counts.hmin = counts.hmax = counts.both = counts.sphere = 0;
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SizeFieldCounts &counts = this->LocalCounts.Local();
+      int j,k;
+      int foundHmin,foundHmax;
+      double tol2 = 0.01*this->Hmax;
+      double tol3 = 0.01*this->Hmin;
+      double vxyz[3];
+
+      for (vtkIdType pointId=begin;pointId<end;pointId++)
+      {
+        Hessian &hess = this->Hess[pointId];
+        foundHmin = 0;
+        foundHmax = 0;
+        for( j=0; j<3; j++ ) {
+          if( hess.h[j] < this->Tol )
+            hess.h[j] = this->Hmax;
+          else {
+            hess.h[j] = sqrt(this->Eloc/hess.h[j]);
+            if( hess.h[j] > this->Hmax )
+              hess.h[j] = this->Hmax;
+            if( hess.h[j] < this->Hmin )
+              hess.h[j] = this->Hmin;
+          }
+        }
+
+        for(j=0; j<3; j++) {
+          if(ABS(hess.h[j]-this->Hmax) <= tol2)
+            foundHmax = 1;
+          if(ABS(hess.h[j]-this->Hmin) <= tol3)
+            foundHmin = 1;
+        }
+        if(foundHmin)
+          counts.hmin++;
+        if(foundHmax)
+          counts.hmax++;
+        if(foundHmin && foundHmax)
+          counts.both++;
+
+        this->Mesh->GetPoint(pointId,vxyz);
+        // check if inside of sphere radius
+        double r = sqrt ((vxyz[0] - this->Sphere[1])*(vxyz[0] - this->Sphere[1]) +
+                         (vxyz[1] - this->Sphere[2])*(vxyz[1] - this->Sphere[2]) +
+                         (vxyz[2] - this->Sphere[3])*(vxyz[2] - this->Sphere[3]));
+
+        if (r < this->Sphere[0]) {
+          hess.h[0] = this->Sphere[4];
+          hess.h[1] = this->Sphere[4];
+          hess.h[2] = this->Sphere[4];
+          counts.sphere++;
+        }
+
+        // set the data in directions
+        for (int jRow=0; jRow<3; jRow++) {
+          for(int iDir=0; iDir<3; iDir++) {
+            hess.dir[jRow][iDir]=hess.dir[jRow][iDir]*hess.h[jRow];
+          }
+        }
+
+        if (this->Strategy == 1)
+        {
+          double value = 0;
+          for (j=0;j<3;j++)
+          {
+            value += ABS(hess.h[j]);
+          }
+          this->ErrorMetric[pointId] = value/3;
+        }
+        else
+        {
+          for (j=0;j<3;j++)
+          {
+            for (k=0;k<3;k++)
+            {
+              this->ErrorMetric[9*pointId+j*3+k] = hess.dir[j][k];
+            }
+          }
+        }
+      }
+    }
+
+    void Reduce()
+    {
+      this->Counts.hmin = this->Counts.hmax = 0;
+      this->Counts.both = this->Counts.sphere = 0;
+      vtkSMPThreadLocal<SizeFieldCounts>::iterator it;
+      for (it = this->LocalCounts.begin(); it != this->LocalCounts.end(); ++it)
+      {
+        this->Counts.hmin += (*it).hmin;
+        this->Counts.hmax += (*it).hmax;
+        this->Counts.both += (*it).both;
+        this->Counts.sphere += (*it).sphere;
+      }
+    }
+};
+
+} // namespace
+
 // -----------------------------
 // AdaptUtils_file_exists()
 // -----------------------------
@@ -89,100 +431,108 @@ bool AdaptUtils_file_exists(const std::string& name) {
   return (stat (name.c_str(), &buffer) == 0);
 }
 
+// -----------------------------
+// buildPointAdjacency()
+// -----------------------------
+/**
+ * @brief builds the vertex adjacency of the mesh in compressed sparse row
+ * form. Two points are neighbors if they share a cell.
+ * @param mesh The mesh to get the adjacency for
+ * @param adjacency The offsets and neighbor ids, see PointAdjacency
+ */
+//
+int AdaptUtils_buildPointAdjacency(vtkUnstructuredGrid *mesh,
+    PointAdjacency &adjacency)
+{
+  vtkIdType pointId;
+  vtkIdType numVerts = mesh->GetNumberOfPoints();
+
+  adjacency.offsets.assign(numVerts+1,0);
+  adjacency.neighbors.clear();
+  if (numVerts == 0)
+    return SV_OK;
+
+  //The links are built once here, the functor only reads them
+  mesh->BuildLinks();
+
+  PointAdjacencyFunctor countNeighbors;
+  countNeighbors.Mesh = mesh;
+  countNeighbors.Adjacency = &adjacency;
+  countNeighbors.Fill = false;
+  vtkSMPTools::For(0,numVerts,countNeighbors);
+
+  for (pointId=0;pointId<numVerts;pointId++)
+    adjacency.offsets[pointId+1] += adjacency.offsets[pointId];
+  adjacency.neighbors.resize(adjacency.offsets[numVerts]);
+
+  PointAdjacencyFunctor fillNeighbors;
+  fillNeighbors.Mesh = mesh;
+  fillNeighbors.Adjacency = &adjacency;
+  fillNeighbors.Fill = true;
+  vtkSMPTools::For(0,numVerts,fillNeighbors);
+
+  return SV_OK;
+}
+
 // -----------------------------
 // SmoothHessians()
 // -----------------------------
 /**
  * @brief simple average over a patch surrounding the vertex
+ * @param adjacency The point adjacency of the mesh, built here if NULL
  * @note This smooths the hessians by patch method
  */
 //
-int AdaptUtils_SmoothHessians(vtkUnstructuredGrid *mesh)
+int AdaptUtils_SmoothHessians(vtkUnstructuredGrid *mesh,
+    const PointAdjacency *adjacency)
 {
-  int i,j,k;
   int numVerts;
-  int numSurroundingVerts;
-  double newHessian;
-  double averageHessian[6];
-  double nodalHessian[6];
-  vtkIdType checkPt;
-  vtkIdType npts;
-  const vtkIdType *pts;
-  vtkIdType p1,p2;
-  vtkIdType pointId,cellId;
-  vtkIdType surfacePt,volumePt;
-  vtkIdType surfacePtId;
+  PointAdjacency localAdjacency;
 
   vtkSmartPointer<vtkDoubleArray>  averageHessians =
     vtkSmartPointer<vtkDoubleArray>::New();
-  vtkSmartPointer<vtkDoubleArray>  nodalHessians =
-    vtkSmartPointer<vtkDoubleArray>::New();
-  vtkSmartPointer<vtkIdList> patchElements =
-    vtkSmartPointer<vtkIdList>::New();
+  vtkDoubleArray *nodalHessians;
 
   numVerts = mesh->GetNumberOfPoints();
-  bool *pointOnSurface = new bool[numVerts];
+
+  nodalHessians = vtkDoubleArray::SafeDownCast(mesh->GetPointData()->GetArray("hessians"));
+  if (nodalHessians == NULL || nodalHessians->GetNumberOfComponents() != 6)
+  {
+    fprintf(stderr,"Array named hessians with six components is not on mesh\n");
+    return SV_ERROR;
+  }
+
+  if (adjacency == NULL)
+  {
+    if (AdaptUtils_buildPointAdjacency(mesh,localAdjacency) != SV_OK)
+      return SV_ERROR;
+    adjacency = &localAdjacency;
+  }
 
   averageHessians->SetNumberOfComponents(6);
-  averageHessians->Allocate(numVerts,10000);
   averageHessians->SetNumberOfTuples(numVerts);
   averageHessians->SetName("averagehessians");
 
-  nodalHessians = vtkDoubleArray::SafeDownCast(mesh->GetPointData()->GetArray("hessians"));
-
-  //Have no purpose for point mapping here
-  AdaptUtils_getSurfaceBooleans(mesh,pointOnSurface);
-
-  for (pointId=0;pointId<numVerts;pointId++)
+  if (numVerts != 0)
   {
-    numSurroundingVerts = 0;
-    for (i=0;i<6;i++)
-    {
-      averageHessian[i] = 0.0;
-      nodalHessian[i] = nodalHessians->GetComponent(pointId,i);
-      averageHessian[i] = averageHessian[i] + nodalHessian[i];
-    }
-    mesh->GetPointCells(pointId,patchElements);
+    bool *pointOnSurface = new bool[numVerts];
 
-    vtkSmartPointer<vtkIdList> neighborPoints =
-      vtkSmartPointer<vtkIdList>::New();
-    for (cellId=0;cellId<patchElements->GetNumberOfIds();cellId++)
-    {
-      mesh->GetCellPoints(patchElements->GetId(cellId),npts,pts);
-      for (j=0;j<npts;j++)
-      {
-	if (pointOnSurface[pts[j]] == false)
-	{
-	  neighborPoints->InsertUniqueId(pts[j]);
-	}
-      }
-    }
-    numSurroundingVerts = neighborPoints->GetNumberOfIds();
+    //Have no purpose for point mapping here
+    AdaptUtils_getSurfaceBooleans(mesh,pointOnSurface);
 
-    if (numSurroundingVerts != 0)
-    {
-      for (i=0;i<numSurroundingVerts;i++)
-      {
-	checkPt = neighborPoints->GetId(i);
-	for (j=0;j<6;j++)
-	{
-	  newHessian = nodalHessians->GetComponent(checkPt,j);
-	  averageHessian[j] = averageHessian[j] + newHessian;
-	}
-      }
-      for (i=0;i<6;i++)
-      {
-	averageHessian[i] = averageHessian[i]/numSurroundingVerts;
-      }
-    }
-    averageHessians->SetTuple(pointId,averageHessian);
+    SmoothHessiansFunctor smoother;
+    smoother.Adjacency = adjacency;
+    smoother.PointOnSurface = pointOnSurface;
+    smoother.NodalHessians = nodalHessians->GetPointer(0);
+    smoother.AverageHessians = averageHessians->GetPointer(0);
+    vtkSMPTools::For(0,numVerts,smoother);
+
+    delete [] pointOnSurface;
   }
 
   mesh->GetPointData()->AddArray(averageHessians);
   mesh->GetPointData()->SetActiveScalars("averagehessians");
 
-  delete [] pointOnSurface;
-
   return SV_OK;
 }
 
@@ -553,66 +903,17 @@ int AdaptUtils_fix4SolutionTransfer(vtkUnstructuredGrid *inmesh,vtkUnstructuredG
 
 int AdaptUtils_modelFaceIDTransfer(vtkPolyData *inpd,vtkPolyData *outpd)
 {
-  int i,j,k;
-  int subId;
-  int maxIndex;
-  int temp;
-  int flag = 1;
-  int count;
-  int bigcount;
-  vtkIdType npts;
-  const vtkIdType *pts;
-  double distance;
-  double mappingPt[3];
-  double closestPt[3];
-  double tolerance = 1.0;
-  double minmax[2];
-  double centroid[3];
-  int range;
-  vtkIdType closestCell;
-  vtkIdType cellId;
-  vtkIdType currentValue;
-  vtkIdType realValue;
-  vtkSmartPointer<vtkCellLocator> locator =
-    vtkSmartPointer<vtkCellLocator>::New();
-  vtkSmartPointer<vtkGenericCell> genericCell =
-    vtkSmartPointer<vtkGenericCell>::New();
   vtkSmartPointer<vtkIntArray> currentRegionsInt =
     vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIntArray> realRegions =
-    vtkSmartPointer<vtkIntArray>::New();
 
   outpd->BuildLinks();
   inpd->BuildLinks();
-  locator->SetDataSet(inpd);
-  locator->BuildLocator();
 
-  realRegions = static_cast<vtkIntArray*>(inpd->GetCellData()->GetScalars("ModelFaceID"));
+  vtkDataArray *realRegions = inpd->GetCellData()->GetScalars("ModelFaceID");
 
-  range = minmax[1]-minmax[0];
-  int *mapper;
-  mapper = new int[1+range];
-
-  for (i=0;i<range+1;i++)
-  {
-    mapper[i] = -1;
-  }
-
-  for (cellId=0;cellId<outpd->GetNumberOfCells();cellId++)
+  if (VtkUtils_TransferCellLabels(inpd,realRegions,outpd,currentRegionsInt) != SV_OK)
   {
-      outpd->GetCellPoints(cellId,npts,pts);
-      vtkSmartPointer<vtkPoints> polyPts = vtkSmartPointer<vtkPoints>::New();
-      vtkSmartPointer<vtkIdTypeArray> polyPtIds = vtkSmartPointer<vtkIdTypeArray>::New();
-      for (i=0;i<npts;i++)
-      {
-	polyPtIds->InsertValue(i,i);
-	polyPts->InsertNextPoint(outpd->GetPoint(pts[i]));
-      }
-      vtkPolygon::ComputeCentroid(polyPtIds,polyPts,centroid);
-
-      locator->FindClosestPoint(centroid,closestPt,genericCell,closestCell,
-	  subId,distance);
-      currentRegionsInt->InsertValue(cellId,realRegions->GetValue(closestCell));
+    return SV_ERROR;
   }
 
   outpd->GetCellData()->RemoveArray("ModelFaceID");
@@ -621,8 +922,6 @@ int AdaptUtils_modelFaceIDTransfer(vtkPolyData *inpd,vtkPolyData *outpd)
 
   outpd->GetCellData()->SetActiveScalars("ModelFaceID");
 
-  delete [] mapper;
-
   return SV_OK;
 }
 
@@ -757,8 +1056,10 @@ int AdaptUtils_hessiansFromFilter(vtkUnstructuredGrid *mesh)
  * matrix in order to set the mesh size field
  * @note hessian  returned : 6-component (symmetric)
  * @note u_xx, u_xy, u_xz, u_yy, u_yz, u_zz
+ * @param adjacency The point adjacency used for smoothing, built if NULL
  */
-int AdaptUtils_hessiansFromSolution(vtkUnstructuredGrid *mesh)
+int AdaptUtils_hessiansFromSolution(vtkUnstructuredGrid *mesh,
+    const PointAdjacency *adjacency)
 {
   // compute the hessain field from the solution
 
@@ -790,7 +1091,7 @@ int AdaptUtils_hessiansFromSolution(vtkUnstructuredGrid *mesh)
     return SV_ERROR;
   }
 
-  if (AdaptUtils_SmoothHessians(mesh) != SV_OK)
+  if (AdaptUtils_SmoothHessians(mesh,adjacency) != SV_OK)
   {
     fprintf(stderr,"Error in setting hessians\n");
     return SV_ERROR;
@@ -848,41 +1149,37 @@ double AdaptUtils_getErrorValue(double *nodalValues, int option) {
  * @param factor This is the ratio refinement factor
  * @param hmax This is the maximum edge length acceptable for the mesh
  * @param hmin This is the minimum edge length acceptable for the mesh
+ * @param adjacency The point adjacency used for the local error, built
+ * here if NULL
  */
 int AdaptUtils_setSizeFieldUsingHessians(vtkUnstructuredGrid *mesh,
 			       double factor,
 			       double hmax,
 			       double hmin,
                                double sphere[5],
-			       int strategy)
+			       int strategy,
+                               const PointAdjacency *adjacency)
 {
-  int i,j,k;
   int nshg;
-  int ierr;
-  int three = 3;
   int bdryNumNodes = 0;
-  double xyz[3];
-  double T[3][3];
   double tol=1.e-12;
-  double maxEigenval=0;
   double eloc;  	  // local error at a vertex
   double etot=0.;	  // total error for all vertices
   double emean; 	  // emean = etot / nv
   double elocmax=0.;	  // max local error
   double elocmin=1.e20;   // min local error
-  //double z[3][3];
-  double z[9];
-  vtkIdType pointId,averageHessian;
+  vtkIdType pointId;
+  PointAdjacency localAdjacency;
 
-  vtkSmartPointer<vtkDoubleArray> averageHessians =
-    vtkSmartPointer<vtkDoubleArray>::New();
+  vtkDoubleArray *averageHessians;
 
   nshg = mesh->GetNumberOfPoints();
   averageHessians = vtkDoubleArray::SafeDownCast(mesh->GetPointData()->GetArray("averagehessians"));
-
-  // struct Hessian contains decomposed values
-  // mesh sizes and directional information
-  Hessian *hess = new Hessian[nshg];
+  if (averageHessians == NULL || averageHessians->GetNumberOfComponents() != 6)
+  {
+    fprintf(stderr,"Error when getting hessian\n");
+    return SV_ERROR;
+  }
 
   vtkSmartPointer<vtkDoubleArray> errorMetricArray =
     vtkSmartPointer<vtkDoubleArray>::New();
@@ -895,78 +1192,44 @@ int AdaptUtils_setSizeFieldUsingHessians(vtkUnstructuredGrid *mesh,
     fprintf(stderr,"Strategy does not exist\n");
     return SV_ERROR;
   }
-  errorMetricArray->Allocate(nshg,10000);
   errorMetricArray->SetNumberOfTuples(nshg);
   errorMetricArray->SetName("errormetric");
 
-  i=0;
-  for (pointId=0;pointId<nshg;pointId++)
+  if (adjacency == NULL)
   {
-    mesh->GetPoint(pointId,xyz);
-
-    if (AdaptUtils_getHessian(averageHessians,pointId,T) != SV_OK)
-    {
-      fprintf(stderr,"Error when getting hessian\n");
-      return SV_OK;
-    }
-
-    double eigenVals[3];
-    double e[3];
-    //double Tfoo[3][3];
-    double Tfoo[9];
-
-    //copy T into temporary buffer
-    //for (j=0;j<3;j++)
-    //{
-    //  for (k=0;k<3;k++)
-    //  {
-    //    Tfoo[j][k] = T[j][k];
-    //  }
-    //}
-    for (j=0;j<3;j++)
-    {
-      for (k=0;k<3;k++)
-      {
-        Tfoo[j*3+k] = T[j][k];
-      }
-    }
-
-    //mytred(&three,&three,Tfoo,eigenVals,e,z);
-    tred2(three,Tfoo,eigenVals,e,z);
-
-    //tql2(&three,&three,eigenVals,e,z,&ierr);
-    ierr = tql2(three,eigenVals,e,z);
+    if (AdaptUtils_buildPointAdjacency(mesh,localAdjacency) != SV_OK)
+      return SV_ERROR;
+    adjacency = &localAdjacency;
+  }
 
-    for (j=0;j<3;j++)
+  // struct Hessian contains decomposed values
+  // mesh sizes and directional information
+  Hessian *hess = new Hessian[nshg];
+  std::vector<double> localError(nshg);
+
+  HessianDecompositionFunctor decompose;
+  decompose.Mesh = mesh;
+  decompose.Adjacency = adjacency;
+  decompose.AverageHessians = averageHessians->GetPointer(0);
+  decompose.Hess = hess;
+  decompose.LocalError = localError.empty() ? NULL : &localError[0];
+  decompose.Tol = tol;
+  vtkSMPTools::For(0,nshg,decompose);
+
+  // reduce in point order so the totals do not depend on the threads
+  for (pointId=0;pointId<nshg;pointId++)
+  {
+    eloc = localError[pointId];
+    if (eloc < 0.0)
     {
-      hess[i].h[j] = eigenVals[j];
-      for (k=0;k<3;k++)
-      {
-	//hess[i].dir[j][k]=z[j][k];
-	hess[i].dir[j][k]=z[j*3+k];
-      }
-    }
-
-    hess[i].h[0] = ABS(hess[i].h[0]);
-    hess[i].h[1] = ABS(hess[i].h[1]);
-    hess[i].h[2] = ABS(hess[i].h[2]);
-
-    if( MAX(hess[i].h[0],MAX(hess[i].h[1],hess[i].h[2])) < tol ) {
-      printf("Warning: zero maximum eigenvalue for node %d !!!\n",i);
-      printf("       %f %f %f\n", hess[i].h[0],
-             hess[i].h[1],hess[i].h[2]);
+      printf("Warning: zero maximum eigenvalue for node %d !!!\n",(int)pointId);
+      printf("       %f %f %f\n", hess[pointId].h[0],
+             hess[pointId].h[1],hess[pointId].h[2]);
       continue;
     }
-
-    // estimate relative interpolation error
-    // needed for scaling metric field (mesh size field)
-    // to get an idea refer Appendix A in Li's thesis
-    eloc=AdaptUtils_maxLocalError(mesh,pointId,T);
     etot += eloc;
     if( eloc>elocmax )  elocmax=eloc;
     if( eloc<elocmin )  elocmin=eloc;
-
-    i++;
   }
 
   printf("Info: Reading hessian... done...\n");
@@ -994,102 +1257,22 @@ int AdaptUtils_setSizeFieldUsingHessians(vtkUnstructuredGrid *mesh,
   fprintf(stdout,"with min. edge length : %.4f\n",hmin);
   fprintf(stdout,"with max. edge length : %.4f\n",hmax);
 
-  int foundHmin = 0;
-  int foundHmax = 0;
-  int hminCount = 0;
-  int hmaxCount = 0;
-  int bothHminHmaxCount = 0;
-  int insideSphereCount = 0;
-
-  double tol2, tol3;
-
-  i=0;
-  for (pointId=0;pointId<nshg;pointId++)
-  {
-    tol2 = 0.01*hmax;
-    tol3 = 0.01*hmin;
-    foundHmin = 0;
-    foundHmax = 0;
-    for( j=0; j<3; j++ ) {
-      if( hess[i].h[j] < tol )
-	hess[i].h[j] = hmax;
-      else {
-	hess[i].h[j] = sqrt(eloc/hess[i].h[j]);
-	if( hess[i].h[j] > hmax )
-	  hess[i].h[j] = hmax;
-	if( hess[i].h[j] < hmin )
-	  hess[i].h[j] = hmin;
-      }
-    }
-
-    for(j=0; j<3; j++) {
-      if(ABS(hess[i].h[j]-hmax) <= tol2)
-	foundHmax = 1;
-      if(ABS(hess[i].h[j]-hmin) <= tol3)
-	foundHmin = 1;
-    }
-    if(foundHmin)
-      hminCount++;
-    if(foundHmax)
-      hmaxCount++;
-    if(foundHmin && foundHmax)
-      bothHminHmaxCount++;
-
-    double vxyz[3];
-    mesh->GetPoint(pointId,vxyz);
-    // check if inside of sphere radius
-    double r = sqrt ((vxyz[0] - sphere[1])*(vxyz[0] - sphere[1]) +
-		     (vxyz[1] - sphere[2])*(vxyz[1] - sphere[2]) +
-		     (vxyz[2] - sphere[3])*(vxyz[2] - sphere[3]));
-
-    if (r < sphere[0]) {
-
-      hess[i].h[0] = sphere[4];
-      hess[i].h[1] = sphere[4];
-      hess[i].h[2] = sphere[4];
-
-      insideSphereCount++;
-
-    }
-
-    // set the data in directions
-    for (int jRow=0; jRow<3; jRow++) {
-      for(int iDir=0; iDir<3; iDir++) {
-	hess[i].dir[jRow][iDir]=hess[i].dir[jRow][iDir]*hess[i].h[jRow];
-      }
-    }
-
-    if (strategy == 1)
-    {
-      double value = 0;
-      for (j=0;j<3;j++)
-      {
-	 value += ABS(hess[i].h[j]);
-      }
-      value = value/3;
-      errorMetricArray->SetValue(i,value);
-    }
-    else if (strategy == 2)
-    {
-      //fprintf(stdout,"\nHessian for node %d is:\n",i);
-      for (j=0;j<3;j++)
-      {
-	for (k=0;k<3;k++)
-	{
-	  //fprintf(stdout,"%.4f ",hess[i].dir[j][k]);
-	  errorMetricArray->SetComponent(i,j*3+k,hess[i].dir[j][k]);
-	}
-	//fprintf(stdout,"\n");
-      }
-      //fprintf(stdout,"\n");
-    }
-
-    i++;
-  }
-  fprintf(stdout,"Nodes with hmin into effect : %d\n",hminCount);
-  fprintf(stdout,"Nodes with hmax into effect : %d\n",hmaxCount);
-  fprintf(stdout,"Nodes with both hmin/hmax into effect : %d\n",bothHminHmaxCount);
-  fprintf(stdout,"Nodes within sphere : %d\v",insideSphereCount);
+  SizeFieldFunctor sizeField;
+  sizeField.Mesh = mesh;
+  sizeField.Hess = hess;
+  sizeField.ErrorMetric = errorMetricArray->GetPointer(0);
+  sizeField.Eloc = eloc;
+  sizeField.Hmax = hmax;
+  sizeField.Hmin = hmin;
+  sizeField.Tol = tol;
+  sizeField.Sphere = sphere;
+  sizeField.Strategy = strategy;
+  vtkSMPTools::For(0,nshg,sizeField);
+
+  fprintf(stdout,"Nodes with hmin into effect : %d\n",sizeField.Counts.hmin);
+  fprintf(stdout,"Nodes with hmax into effect : %d\n",sizeField.Counts.hmax);
+  fprintf(stdout,"Nodes with both hmin/hmax into effect : %d\n",sizeField.Counts.both);
+  fprintf(stdout,"Nodes within sphere : %d\v",sizeField.Counts.sphere);
   fprintf(stdout,"Nodes ignored in boundary layer : %d\n",bdryNumNodes);;
 
   delete [] hess;
@@ -1108,47 +1291,56 @@ int AdaptUtils_setSizeFieldUsingHessians(vtkUnstructuredGrid *mesh,
  * @brief This returns the maximum relative interpolation error at a vertex
  * @param vertex This is the vertex where the max local error is calculated
  * @param H This is the Hessian matrix that the error is calculated for
+ * @param adjacency The point adjacency of the mesh. If NULL, the neighbors
+ * are gathered from the cells attached to the vertex
  */
-double AdaptUtils_maxLocalError(vtkUnstructuredGrid *mesh,vtkIdType vertex, double H[3][3])
+double AdaptUtils_maxLocalError(vtkUnstructuredGrid *mesh,vtkIdType vertex, double H[3][3],
+    const PointAdjacency *adjacency)
 {
   int i;
-  int listCount=0;
   double locE;
   double xyz[2][3];
   double maxLocE=0;
-  vtkIdType cellId,pointId;
+  vtkIdType cellId;
   vtkIdType npts;
   const vtkIdType *pts;
-  vtkSmartPointer<vtkIdList> attachedCells =
-    vtkSmartPointer<vtkIdList>::New();
-  vtkSmartPointer<vtkIdList> firstPointList =
-    vtkSmartPointer<vtkIdList>::New();
-  vtkSmartPointer<vtkIdList> fullPointList =
-    vtkSmartPointer<vtkIdList>::New();
 
   mesh->GetPoint(vertex,xyz[0]);
-  mesh->GetPointCells(vertex,attachedCells);
 
+  if (adjacency != NULL)
+  {
+    for (vtkIdType k=adjacency->offsets[vertex];k<adjacency->offsets[vertex+1];k++)
+    {
+      mesh->GetPoint(adjacency->neighbors[k],xyz[1]);
+      locE = AdaptUtils_E_error(xyz,H);
+      if ( locE > maxLocE )
+      {
+        maxLocE=locE;
+      }
+    }
+    return maxLocE;
+  }
 
+  vtkSmartPointer<vtkIdList> attachedCells =
+    vtkSmartPointer<vtkIdList>::New();
+  std::vector<vtkIdType> pointList;
+
+  mesh->GetPointCells(vertex,attachedCells);
   for (cellId=0;cellId<attachedCells->GetNumberOfIds();cellId++)
   {
     mesh->GetCellPoints(attachedCells->GetId(cellId),npts,pts);
     for (i=0;i<npts;i++)
     {
-      if(firstPointList->InsertUniqueId(pts[i]) != listCount)
-      {
-	fullPointList->InsertUniqueId(pts[i]);
-      }
-      else
-      {
-	listCount++;
-      }
+      if (pts[i] != vertex)
+        pointList.push_back(pts[i]);
     }
   }
+  std::sort(pointList.begin(),pointList.end());
+  pointList.erase(std::unique(pointList.begin(),pointList.end()),pointList.end());
 
-  for (pointId = 0;pointId<fullPointList->GetNumberOfIds();pointId++)
+  for (i=0;i<(int)pointList.size();i++)
   {
-    mesh->GetPoint(fullPointList->GetId(pointId),xyz[1]);
+    mesh->GetPoint(pointList[i],xyz[1]);
     locE = AdaptUtils_E_error(xyz,H);
     if ( locE > maxLocE )
     {
@@ -1247,83 +1439,74 @@ int AdaptUtils_getSurfaceBooleans(vtkUnstructuredGrid *mesh,bool *pointOnSurface
 
 int AdaptUtils_convertToVTK(vtkUnstructuredGrid *mesh,vtkPolyData *surfaceMesh,tetgenio *outmesh)
 {
-  int count;
-  int numAdaptPts;
-  int numAdaptTets;
-  int numAdaptFaces;
+  vtkIdType numAdaptPts;
+  vtkIdType numAdaptTets;
+  vtkIdType numAdaptFaces;
   vtkIdType i,j;
-  vtkIdType globalId = 1;
-  vtkIdType vtkId;
-  vtkSmartPointer<vtkPoints> vtpAdaptPoints = vtkSmartPointer<vtkPoints>::New();
-  vtkSmartPointer<vtkPoints> adaptPoints = vtkSmartPointer<vtkPoints>::New();
-  vtkSmartPointer<vtkCellArray> adaptTets = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkCellArray> adaptFaces = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkIntArray> adaptGlobalNodeIds = vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIntArray> adaptGlobalElementIds = vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIdList> adaptTetPointIds = vtkSmartPointer<vtkIdList>::New();
-  vtkSmartPointer<vtkIntArray> vtpAdaptPointIds = vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIntArray> vtpAdaptFaceIds = vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIdList> facePointIds = vtkSmartPointer<vtkIdList>::New();
 
   numAdaptPts = outmesh->numberofpoints;
   numAdaptTets = outmesh->numberoftetrahedra;
   numAdaptFaces = outmesh->numberoftrifaces;
 
-  bool *pointOnSurface = new bool[numAdaptPts];
-  int *pointMapping = new int[numAdaptPts];
-
   std::cout<<"Converting Points to adapt VTK Structures..."<<endl;
-  globalId = 1;
-  adaptPoints->SetNumberOfPoints(numAdaptPts);
-  for (i=0;i< numAdaptPts; i++)
-  {
-    adaptPoints->SetPoint(i,outmesh->pointlist[i*3],outmesh->pointlist[i*3+1],outmesh->pointlist[i*3+2]);
-    adaptGlobalNodeIds->InsertValue(i,globalId);
-    pointOnSurface[i] = false;
-    globalId++;
-  }
+  vtkSmartPointer<vtkDoubleArray> adaptCoords = vtkSmartPointer<vtkDoubleArray>::New();
+  adaptCoords->SetNumberOfComponents(3);
+  adaptCoords->SetNumberOfTuples(numAdaptPts);
+  std::copy(outmesh->pointlist,outmesh->pointlist+3*numAdaptPts,adaptCoords->GetPointer(0));
+  vtkSmartPointer<vtkPoints> adaptPoints = vtkSmartPointer<vtkPoints>::New();
+  adaptPoints->SetData(adaptCoords);
+
+  vtkSmartPointer<vtkIntArray> adaptGlobalNodeIds = vtkSmartPointer<vtkIntArray>::New();
+  adaptGlobalNodeIds->SetNumberOfValues(numAdaptPts);
+  for (i=0;i<numAdaptPts;i++)
+    adaptGlobalNodeIds->SetValue(i,i+1);
 
   //Save all point information in a vtkPoints list
-  count = 0;
-  for (i=0;i<numAdaptFaces;i++)
+  std::vector<int> pointMapping(numAdaptPts,-1);
+  std::vector<int> surfacePoints;
+  for (i=0;i<3*numAdaptFaces;i++)
   {
-    for (j=0;j<3;j++)
+    int ptId = outmesh->trifacelist[i];
+    if (pointMapping[ptId] < 0)
     {
-      if (pointOnSurface[outmesh->trifacelist[3*i+j]] == false)
-      {
-	pointOnSurface[outmesh->trifacelist[3*i+j]] = true;
-	pointMapping[outmesh->trifacelist[3*i+j]] = count++;
-      }
+      pointMapping[ptId] = surfacePoints.size();
+      surfacePoints.push_back(ptId);
     }
   }
 
-  vtpAdaptPoints->SetNumberOfPoints(count);
   //Create face point list
-  count=0;
-  for (i=0;i<numAdaptPts;i++)
+  vtkSmartPointer<vtkDoubleArray> vtpAdaptCoords = vtkSmartPointer<vtkDoubleArray>::New();
+  vtpAdaptCoords->SetNumberOfComponents(3);
+  vtpAdaptCoords->SetNumberOfTuples(surfacePoints.size());
+  vtkSmartPointer<vtkIntArray> vtpAdaptPointIds = vtkSmartPointer<vtkIntArray>::New();
+  vtpAdaptPointIds->SetNumberOfValues(surfacePoints.size());
+  for (i=0;i<(vtkIdType) surfacePoints.size();i++)
   {
-    if (pointOnSurface[i] == true)
-    {
-      vtpAdaptPoints->SetPoint(pointMapping[i],outmesh->pointlist[i*3],outmesh->pointlist[i*3+1],outmesh->pointlist[i*3+2]);
-      vtpAdaptPointIds->InsertValue(pointMapping[i],i+1);
-    }
+    vtpAdaptCoords->SetTypedTuple(i,&outmesh->pointlist[3*surfacePoints[i]]);
+    vtpAdaptPointIds->SetValue(i,surfacePoints[i]+1);
   }
+  vtkSmartPointer<vtkPoints> vtpAdaptPoints = vtkSmartPointer<vtkPoints>::New();
+  vtpAdaptPoints->SetData(vtpAdaptCoords);
 
   std::cout<<"Converting Elements to Adapt VTK Structures..."<<endl;
-  adaptTetPointIds->SetNumberOfIds(4);
-  globalId=1;
-  for (i=0;i< numAdaptTets;i++)
-  {
-    for (j=0; j< outmesh->numberofcorners;j++)
-    {
-      vtkId = outmesh->tetrahedronlist[i*outmesh->numberofcorners+j];
-      adaptTetPointIds->SetId(j,vtkId);
-    }
+  vtkSmartPointer<vtkIdTypeArray> tetOffsets = vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkIdTypeArray> tetConnectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkIntArray> adaptGlobalElementIds = vtkSmartPointer<vtkIntArray>::New();
+  tetOffsets->SetNumberOfValues(numAdaptTets+1);
+  tetOffsets->SetValue(0,0);
+  tetConnectivity->SetNumberOfValues(4*numAdaptTets);
+  adaptGlobalElementIds->SetNumberOfValues(numAdaptTets);
+
+  TetGenTetsFunctor tetsFunctor;
+  tetsFunctor.Tets = outmesh->tetrahedronlist;
+  tetsFunctor.NumCorners = outmesh->numberofcorners;
+  tetsFunctor.Offsets = tetOffsets->GetPointer(0);
+  tetsFunctor.Connectivity = tetConnectivity->GetPointer(0);
+  tetsFunctor.ElementIds = adaptGlobalElementIds->GetPointer(0);
+  vtkSMPTools::For(0,numAdaptTets,tetsFunctor);
 
-    adaptGlobalElementIds->InsertValue(i,globalId);
-    globalId++;
-    adaptTets->InsertNextCell(adaptTetPointIds);
-  }
+  vtkSmartPointer<vtkCellArray> adaptTets = vtkSmartPointer<vtkCellArray>::New();
+  adaptTets->SetData(tetOffsets,tetConnectivity);
 
   mesh->SetPoints(adaptPoints);
   mesh->SetCells(VTK_TETRA, adaptTets);
@@ -1337,35 +1520,40 @@ int AdaptUtils_convertToVTK(vtkUnstructuredGrid *mesh,vtkPolyData *surfaceMesh,t
   mesh->GetCellData()->SetActiveScalars("GlobalElementID");
 
   fprintf(stderr,"Converting Faces to VTK Structures...\n");
-  facePointIds->SetNumberOfIds(3);
+  vtkSmartPointer<vtkIdTypeArray> faceOffsets = vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkIdTypeArray> faceConnectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkIntArray> vtpAdaptFaceIds = vtkSmartPointer<vtkIntArray>::New();
+  faceOffsets->SetNumberOfValues(numAdaptFaces+1);
+  faceOffsets->SetValue(0,0);
+  faceConnectivity->SetNumberOfValues(3*numAdaptFaces);
+  vtpAdaptFaceIds->SetNumberOfValues(numAdaptFaces);
 
-  count=0;
   for (i=0;i< numAdaptFaces;i++)
   {
     for (j=0; j<3;j++)
     {
-      facePointIds->SetId(j,pointMapping[outmesh->trifacelist[i*3+j]]);
+      faceConnectivity->SetValue(3*i+j,pointMapping[outmesh->trifacelist[i*3+j]]);
     }
+    faceOffsets->SetValue(i+1,3*(i+1));
 
-    adaptFaces->InsertNextCell(facePointIds);
-
+    // The global element id of a tetrahedron is its index + 1
     if (outmesh->adjtetlist[2*i] >= numAdaptTets || outmesh->adjtetlist[2*i] <= 0)
     {
-      vtpAdaptFaceIds->InsertValue(i,adaptGlobalElementIds->GetValue(outmesh->adjtetlist[2*i+1]));
-      count++;
+      vtpAdaptFaceIds->SetValue(i,outmesh->adjtetlist[2*i+1]+1);
     }
     else if (outmesh->adjtetlist[2*i+1] >= numAdaptTets || outmesh->adjtetlist[2*i+1] <= 0)
     {
-      vtpAdaptFaceIds->InsertValue(i,adaptGlobalElementIds->GetValue(outmesh->adjtetlist[2*i]));
-      count++;
+      vtpAdaptFaceIds->SetValue(i,outmesh->adjtetlist[2*i]+1);
     }
-
     else
     {
-      vtpAdaptFaceIds->InsertValue(i,adaptGlobalElementIds->GetValue(outmesh->adjtetlist[2*i+1]));
+      vtpAdaptFaceIds->SetValue(i,outmesh->adjtetlist[2*i+1]+1);
     }
   }
 
+  vtkSmartPointer<vtkCellArray> adaptFaces = vtkSmartPointer<vtkCellArray>::New();
+  adaptFaces->SetData(faceOffsets,faceConnectivity);
+
   //Create a polydata grid and link scalar information to nodes and elements
   surfaceMesh->SetPoints(vtpAdaptPoints);
   surfaceMesh->SetPolys(adaptFaces);
@@ -1378,9 +1566,6 @@ int AdaptUtils_convertToVTK(vtkUnstructuredGrid *mesh,vtkPolyData *surfaceMesh,t
   surfaceMesh->GetCellData()->AddArray(vtpAdaptFaceIds);
   surfaceMesh->GetCellData()->SetActiveScalars("GlobalElementID");
 
-  delete [] pointMapping;
-  delete [] pointOnSurface;
-
   return SV_OK;
 }
 
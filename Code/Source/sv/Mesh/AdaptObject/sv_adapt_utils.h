@@ -87,10 +87,26 @@ struct Hessian {
   };
   typedef struct Hessian Hessian;
 
+// vertex adjacency in compressed sparse row form; the neighbors of
+// point i are neighbors[offsets[i]] ... neighbors[offsets[i+1]-1],
+// sorted and not including i itself
+struct PointAdjacency {
+    std::vector<vtkIdType> offsets;
+    std::vector<vtkIdType> neighbors;
+  };
+  typedef struct PointAdjacency PointAdjacency;
+
 SV_EXPORT_ADAPTOR bool AdaptUtils_file_exists (const std::string& name);
 
+// builds the point adjacency of the mesh once so that it can be shared
+// by the smoothing and size field routines below
+SV_EXPORT_ADAPTOR int AdaptUtils_buildPointAdjacency (vtkUnstructuredGrid *mesh,
+    PointAdjacency &adjacency);
+
 // simple average over a patch surrounding the vertex
-SV_EXPORT_ADAPTOR int AdaptUtils_SmoothHessians (vtkUnstructuredGrid *mesh);
+// adjacency is built internally if not given
+SV_EXPORT_ADAPTOR int AdaptUtils_SmoothHessians (vtkUnstructuredGrid *mesh,
+    const PointAdjacency *adjacency=NULL);
 
 // hessian returned : 6-component (symmetric)
 // u_xx, u_xy, u_xz, u_yy, u_yz, u_zz
@@ -145,7 +161,8 @@ SV_EXPORT_ADAPTOR int AdaptUtils_hessiansFromFilter (vtkUnstructuredGrid *mesh);
 // u_xx, u_xy, u_xz, u_yy, u_yz, u_zz
 // the nodal data later can be retrieved via
 // nodalHessianID
-SV_EXPORT_ADAPTOR int AdaptUtils_hessiansFromSolution (vtkUnstructuredGrid *mesh);
+SV_EXPORT_ADAPTOR int AdaptUtils_hessiansFromSolution (vtkUnstructuredGrid *mesh,
+    const PointAdjacency *adjacency=NULL);
 
 // option is to decide how to compute the error value
 // (i.e., use 3 EI for flow problem or use 1 EI for scalar problem)
@@ -153,10 +170,12 @@ SV_EXPORT_ADAPTOR double AdaptUtils_getErrorValue (double *nodalValues, int opti
 
 SV_EXPORT_ADAPTOR int AdaptUtils_setSizeFieldUsingHessians ( vtkUnstructuredGrid *mesh,
       		           double factor, double hmax,
-      		           double hmin, double sphere[5],int strategy);
+      		           double hmin, double sphere[5],int strategy,
+                           const PointAdjacency *adjacency=NULL);
 
 // max relative interpolation error at a vertex
-SV_EXPORT_ADAPTOR double AdaptUtils_maxLocalError (vtkUnstructuredGrid *mesh,vtkIdType vertex, double H[3][3]);
+SV_EXPORT_ADAPTOR double AdaptUtils_maxLocalError (vtkUnstructuredGrid *mesh,vtkIdType vertex, double H[3][3],
+    const PointAdjacency *adjacency=NULL);
 
 // relative interpolation error along an edge
 SV_EXPORT_ADAPTOR double AdaptUtils_E_error (double xyz[2][3], double H[3][3]);
@@ -46,9 +46,13 @@
 
 #include "mmg/mmgs/libmmgs.h"
 
+#include <map>
+#include <utility>
+
 int MMGUtils_ConvertToMMG(MMG5_pMesh mesh, MMG5_pSol sol, vtkPolyData *polydatasolid,
     double hmin, double hmax, double hausd, double angle, double hgrad,
-    int useSizingFunction, vtkDoubleArray *meshSizingFunction, int numAddedRefines)
+    int useSizingFunction, vtkDoubleArray *meshSizingFunction, int numAddedRefines,
+    int preserveBoundaryEdges)
 {
   vtkSmartPointer<vtkIntArray> boundaryScalars =
     vtkSmartPointer<vtkIntArray>::New();
@@ -87,7 +91,28 @@ int MMGUtils_ConvertToMMG(MMG5_pMesh mesh, MMG5_pSol sol, vtkPolyData *polydatas
 
   int numPts   = polydatasolid->GetNumberOfPoints();
   int numTris  = polydatasolid->GetNumberOfCells();
-  int numEdges = ridges->GetNumberOfEdges();
+  int numRidges = ridges->GetNumberOfEdges();
+
+  // Edges used by a single triangle are the boundary of an open surface;
+  // these are passed as required edges so the boundary is left untouched
+  vtkSmartPointer<vtkEdgeTable> boundaryEdges = vtkSmartPointer<vtkEdgeTable>::New();
+  int numBoundaryOnly = 0;
+  if (preserveBoundaryEdges)
+  {
+    if (MMGUtils_BuildBoundaryEdgeTable(polydatasolid, boundaryEdges) != SV_OK)
+    {
+      fprintf(stderr,"Problem creating boundary edge table\n");
+      return SV_ERROR;
+    }
+    vtkIdType p1,p2;
+    boundaryEdges->InitTraversal();
+    while (boundaryEdges->GetNextEdge(p1,p2) >= 0)
+    {
+      if (ridges->IsEdge(p1,p2) == -1)
+        numBoundaryOnly++;
+    }
+  }
+  int numEdges = numRidges + numBoundaryOnly;
   int *faces;
   int numFaces = 0;
   if (PlyDtaUtils_GetFaceIds(polydatasolid,&numFaces,&faces) != SV_OK)
@@ -224,7 +249,7 @@ int MMGUtils_ConvertToMMG(MMG5_pMesh mesh, MMG5_pSol sol, vtkPolyData *polydatas
   }
   MMG5_pEdge edge;
   ridges->InitTraversal();
-  for (int i=0;i<numEdges;i++)
+  for (int i=0;i<numRidges;i++)
   {
     vtkIdType p1,p2;
     ridges->GetNextEdge(p1,p2);
@@ -238,6 +263,36 @@ int MMGUtils_ConvertToMMG(MMG5_pMesh mesh, MMG5_pSol sol, vtkPolyData *polydatas
       fprintf(stderr,"Error in mmgs\n");
       return SV_ERROR;
     }
+    if (preserveBoundaryEdges && boundaryEdges->IsEdge(p1,p2) != -1)
+    {
+      if (!MMGS_Set_requiredEdge(mesh, i+1))
+      {
+        fprintf(stderr,"Error in mmgs\n");
+        return SV_ERROR;
+      }
+    }
+  }
+  if (numBoundaryOnly > 0)
+  {
+    int edgeId = numRidges;
+    vtkIdType p1,p2;
+    boundaryEdges->InitTraversal();
+    while (boundaryEdges->GetNextEdge(p1,p2) >= 0)
+    {
+      if (ridges->IsEdge(p1,p2) != -1)
+        continue;
+
+      edgeId++;
+      edge = &mesh->edge[edgeId];
+      edge->a = p1+1;
+      edge->b = p2+1;
+      edge->ref = edgeId;
+      if (!MMGS_Set_requiredEdge(mesh, edgeId))
+      {
+        fprintf(stderr,"Error in mmgs\n");
+        return SV_ERROR;
+      }
+    }
   }
 
   return SV_OK;
@@ -308,7 +363,7 @@ int MMGUtils_ConvertToVTK(MMG5_pMesh mesh, MMG5_pSol sol, vtkPolyData *polydatas
   return SV_OK;
 }
 
-int MMGUtils_SurfaceRemeshing(vtkPolyData *surface, double hmin, double hmax, double hausd, double angle, double hgrad, int useSizingFunction, vtkDoubleArray *meshSizingFunction, int numAddedRefines)
+int MMGUtils_SurfaceRemeshing(vtkPolyData *surface, double hmin, double hmax, double hausd, double angle, double hgrad, int useSizingFunction, vtkDoubleArray *meshSizingFunction, int numAddedRefines, int preserveBoundaryEdges)
 {
   vtkSmartPointer<vtkCleanPolyData> cleaner =
     vtkSmartPointer<vtkCleanPolyData>::New();
@@ -337,7 +392,8 @@ int MMGUtils_SurfaceRemeshing(vtkPolyData *surface, double hmin, double hmax, do
   surface->BuildCells();
   surface->BuildLinks();
   if (MMGUtils_ConvertToMMG(mesh, sol, surface, hmin, hmax,
-	hausd, angle, hgrad, useSizingFunction, meshSizingFunction, numAddedRefines) != SV_OK)
+	hausd, angle, hgrad, useSizingFunction, meshSizingFunction, numAddedRefines,
+        preserveBoundaryEdges) != SV_OK)
   {
     fprintf(stderr,"Error converting to MMG\n");
     MMGS_Free_all(MMG5_ARG_start,
@@ -613,3 +669,34 @@ int MMGUtils_BuildRidgeTable(vtkPolyData *polydatasolid, vtkEdgeTable *ridges, s
 
   return SV_OK;
 }
+
+int MMGUtils_BuildBoundaryEdgeTable(vtkPolyData *polydatasolid, vtkEdgeTable *boundaryEdges)
+{
+  vtkIdType npts;
+  const vtkIdType *pts;
+  int numPts = polydatasolid->GetNumberOfPoints();
+  int numTris = polydatasolid->GetNumberOfCells();
+
+  std::map<std::pair<vtkIdType,vtkIdType>,int> edgeUses;
+  for (int i=0;i<numTris;i++)
+  {
+    polydatasolid->GetCellPoints(i,npts,pts);
+    for (int j=0;j<npts;j++)
+    {
+      vtkIdType p1 = pts[j];
+      vtkIdType p2 = pts[(j+1)%npts];
+      if (p1 > p2)
+        std::swap(p1,p2);
+      edgeUses[std::make_pair(p1,p2)]++;
+    }
+  }
+
+  boundaryEdges->InitEdgeInsertion(numPts, 1);
+  for (auto it=edgeUses.begin();it!=edgeUses.end();++it)
+  {
+    if (it->second == 1)
+      boundaryEdges->InsertEdge(it->first.first,it->first.second);
+  }
+
+  return SV_OK;
+}
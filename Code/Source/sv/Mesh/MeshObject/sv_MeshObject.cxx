@@ -129,3 +129,20 @@ int cvMeshObject::closeOutputFile() {
 }
 
 
+// ----------------------
+// GetQualityStatistics
+// ----------------------
+// Compute the element quality statistics of the volume mesh.
+
+int cvMeshObject::GetQualityStatistics(cvMeshQuality& quality)
+{
+  cvUnstructuredGrid *mesh = GetUnstructuredGrid();
+  if (mesh == nullptr) {
+    fprintf(stderr,"No volume mesh to compute quality statistics for\n");
+    return SV_ERROR;
+  }
+
+  int status = quality.Compute(mesh->GetVtkUnstructuredGrid());
+  delete mesh;
+  return status;
+}
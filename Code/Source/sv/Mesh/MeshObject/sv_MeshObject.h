@@ -40,6 +40,7 @@
 //#include "sys/param.h"
 #define MAXPATHLEN 1024
 
+#include "sv_MeshQuality.h"
 #include "sv_RepositoryData.h"
 #include "sv_UnstructuredGrid.h"
 #include "sv_SolidModel.h"
@@ -128,6 +129,7 @@ public:
   virtual int GenerateMesh() = 0;
   virtual int WriteMesh(char *filename, int smsver) = 0;
   virtual int WriteStats(char *filename) = 0;
+  virtual int GetQualityStatistics(cvMeshQuality& quality);
 
   //Not necessary anymore, but leaving for now
   virtual int WriteMetisAdjacency (char *filename) = 0;
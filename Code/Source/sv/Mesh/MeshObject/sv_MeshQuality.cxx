@@ -0,0 +1,513 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SimVascular.h"
+
+#include "sv_MeshQuality.h"
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+// Number of cells in a block of partial results.
+const vtkIdType QualityBlockSize = 65536;
+
+// Fixed histogram ranges of the bounded metrics.
+const double MaxRadiusRatio = 1.0;
+const double MaxDihedralAngle = 90.0;
+
+class MetricSums {
+  public:
+    vtkIdType count = 0;
+    double min = DBL_MAX;
+    double max = -DBL_MAX;
+    double sum = 0.0;
+
+    void Add(double value)
+    {
+      count++;
+      min = std::min(min, value);
+      max = std::max(max, value);
+      sum += value;
+    }
+
+    void Add(const MetricSums& other)
+    {
+      count += other.count;
+      min = std::min(min, other.min);
+      max = std::max(max, other.max);
+      sum += other.sum;
+    }
+};
+
+class GroupSums {
+  public:
+    vtkIdType numberOfElements = 0;
+    vtkIdType numberOfInverted = 0;
+    vtkIdType numberOfSkipped = 0;
+    MetricSums metrics[cvMeshQuality::NUMBER_OF_METRICS];
+};
+
+// -----------------------------
+// ComputeTetQuality
+// -----------------------------
+// Computes the radius ratio, minimum dihedral angle, aspect ratio and
+// volume of a tetrahedron, and its six edge lengths. Returns false if the
+// tetrahedron is inverted or degenerate, in which case the volume is zero
+// and the aspect ratio is not set.
+bool ComputeTetQuality(const double p[4][3], double values[cvMeshQuality::EDGE_LENGTH], double edges[6])
+{
+  static const int edgePoints[6][2] = {{0,1}, {0,2}, {0,3}, {1,2}, {1,3}, {2,3}};
+  // The faces on either side of each edge, by their opposite point.
+  static const int edgeFaces[6][2] = {{2,3}, {1,3}, {1,2}, {0,3}, {0,2}, {0,1}};
+
+  double maxEdge = 0.0;
+  for (int i = 0; i < 6; i++) {
+    edges[i] = sqrt(vtkMath::Distance2BetweenPoints(p[edgePoints[i][0]], p[edgePoints[i][1]]));
+    maxEdge = std::max(maxEdge, edges[i]);
+  }
+
+  double a[3], b[3], c[3], bc[3], ca[3], ab[3];
+  for (int i = 0; i < 3; i++) {
+    a[i] = p[1][i] - p[0][i];
+    b[i] = p[2][i] - p[0][i];
+    c[i] = p[3][i] - p[0][i];
+  }
+  vtkMath::Cross(b, c, bc);
+  vtkMath::Cross(c, a, ca);
+  vtkMath::Cross(a, b, ab);
+  double volume = vtkMath::Dot(a, bc) / 6.0;
+
+  // Outward face normals scaled by twice the face area.
+  double normals[4][3];
+  double area = 0.0;
+  for (int i = 0; i < 4; i++) {
+    const double *q0 = p[(i+1)%4];
+    const double *q1 = p[(i+2)%4];
+    const double *q2 = p[(i+3)%4];
+    double u[3], v[3], w[3];
+    for (int j = 0; j < 3; j++) {
+      u[j] = q1[j] - q0[j];
+      v[j] = q2[j] - q0[j];
+      w[j] = p[i][j] - q0[j];
+    }
+    vtkMath::Cross(u, v, normals[i]);
+    if (vtkMath::Dot(normals[i], w) > 0.0) {
+      for (int j = 0; j < 3; j++) {
+        normals[i][j] = -normals[i][j];
+      }
+    }
+    area += 0.5 * vtkMath::Norm(normals[i]);
+  }
+
+  double minAngle = 180.0;
+  for (int i = 0; i < 6; i++) {
+    const double *n0 = normals[edgeFaces[i][0]];
+    const double *n1 = normals[edgeFaces[i][1]];
+    double norms = vtkMath::Norm(n0) * vtkMath::Norm(n1);
+    double angle = 0.0;
+    if (norms > 0.0) {
+      double cosAngle = std::max(-1.0, std::min(1.0, -vtkMath::Dot(n0, n1) / norms));
+      angle = vtkMath::DegreesFromRadians(acos(cosAngle));
+    }
+    minAngle = std::min(minAngle, angle);
+  }
+
+  if (volume <= 0.0 || area <= 0.0) {
+    values[cvMeshQuality::RADIUS_RATIO] = 0.0;
+    values[cvMeshQuality::MIN_DIHEDRAL_ANGLE] = (volume < 0.0) ? 0.0 : minAngle;
+    values[cvMeshQuality::VOLUME] = 0.0;
+    return false;
+  }
+
+  double circum[3];
+  double aa = vtkMath::Dot(a, a), bb = vtkMath::Dot(b, b), cc = vtkMath::Dot(c, c);
+  for (int i = 0; i < 3; i++) {
+    circum[i] = aa*bc[i] + bb*ca[i] + cc*ab[i];
+  }
+  double circumRadius = vtkMath::Norm(circum) / (12.0 * volume);
+  double inRadius = 3.0 * volume / area;
+
+  values[cvMeshQuality::RADIUS_RATIO] = (circumRadius > 0.0) ? 3.0 * inRadius / circumRadius : 0.0;
+  values[cvMeshQuality::MIN_DIHEDRAL_ANGLE] = minAngle;
+  values[cvMeshQuality::ASPECT_RATIO] = maxEdge / (2.0 * sqrt(6.0) * inRadius);
+  values[cvMeshQuality::VOLUME] = volume;
+  return true;
+}
+
+// -----------------------------
+// QualityFunctor
+// -----------------------------
+// Computes the quality of the cells in a range of blocks. The first pass
+// stores the counts, ranges and sums of each block in BlockSums, the second
+// pass the histogram counts in BlockBins, both indexed by
+// block x group x metric.
+class QualityFunctor {
+  public:
+    vtkUnstructuredGrid *Mesh;
+    vtkDataArray *RegionIds;
+    const std::vector<int> *Regions;
+    const std::vector<int> *RegionGroups;
+    const std::vector<unsigned char> *BoundaryLayer;
+    int NumGroups;
+    int NumBins;
+    bool Binning;
+    const std::vector<cvMeshQuality::Group> *Groups;
+    std::vector<GroupSums> *BlockSums;
+    std::vector<vtkIdType> *BlockBins;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+    {
+      vtkIdList *ptIds = this->PointIds.Local();
+      vtkIdType numCells = this->Mesh->GetNumberOfCells();
+      vtkPoints *points = this->Mesh->GetPoints();
+      double p[4][3];
+      double values[cvMeshQuality::EDGE_LENGTH];
+      double edges[6];
+      int groups[3];
+
+      for (vtkIdType block = beginBlock; block < endBlock; block++) {
+        vtkIdType endCell = std::min(numCells, (block+1)*QualityBlockSize);
+        for (vtkIdType cellId = block*QualityBlockSize; cellId < endCell; cellId++) {
+          int numCellGroups = this->GetCellGroups(cellId, groups);
+
+          if (this->Mesh->GetCellType(cellId) != VTK_TETRA) {
+            if (!this->Binning) {
+              for (int g = 0; g < numCellGroups; g++) {
+                (*this->BlockSums)[block*this->NumGroups + groups[g]].numberOfSkipped++;
+              }
+            }
+            continue;
+          }
+
+          this->Mesh->GetCellPoints(cellId, ptIds);
+          for (int i = 0; i < 4; i++) {
+            points->GetPoint(ptIds->GetId(i), p[i]);
+          }
+          bool valid = ComputeTetQuality(p, values, edges);
+
+          for (int g = 0; g < numCellGroups; g++) {
+            for (int m = 0; m < cvMeshQuality::EDGE_LENGTH; m++) {
+              if (m == cvMeshQuality::ASPECT_RATIO && !valid) {
+                continue;
+              }
+              this->AddValue(block, groups[g], m, values[m]);
+            }
+            for (int i = 0; i < 6; i++) {
+              this->AddValue(block, groups[g], cvMeshQuality::EDGE_LENGTH, edges[i]);
+            }
+            if (!this->Binning) {
+              GroupSums& sums = (*this->BlockSums)[block*this->NumGroups + groups[g]];
+              sums.numberOfElements++;
+              if (!valid) {
+                sums.numberOfInverted++;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // The whole mesh, the region and, with a boundary layer mask, the
+    // interior or boundary layer part of the region.
+    int GetCellGroups(vtkIdType cellId, int groups[3]) const
+    {
+      int numCellGroups = 0;
+      groups[numCellGroups++] = 0;
+
+      int regionId = (this->RegionIds != nullptr) ? (int) this->RegionIds->GetComponent(cellId, 0) : 1;
+      auto it = std::lower_bound(this->Regions->begin(), this->Regions->end(), regionId);
+      int region = it - this->Regions->begin();
+      groups[numCellGroups++] = (*this->RegionGroups)[3*region];
+
+      if (this->BoundaryLayer != nullptr) {
+        int layer = ((*this->BoundaryLayer)[cellId] != 0) ? 1 : 0;
+        int group = (*this->RegionGroups)[3*region + 1 + layer];
+        if (group >= 0) {
+          groups[numCellGroups++] = group;
+        }
+      }
+      return numCellGroups;
+    }
+
+    void AddValue(vtkIdType block, int group, int metric, double value)
+    {
+      if (!this->Binning) {
+        (*this->BlockSums)[block*this->NumGroups + group].metrics[metric].Add(value);
+        return;
+      }
+
+      const cvMeshQuality::Histogram& histogram = (*this->Groups)[group].metrics[metric];
+      int bin = 0;
+      if (histogram.binWidth > 0.0) {
+        bin = (int) ((value - histogram.binMin) / histogram.binWidth);
+        bin = std::max(0, std::min(this->NumBins-1, bin));
+      }
+      vtkIdType index = ((block*this->NumGroups + group)*cvMeshQuality::NUMBER_OF_METRICS + metric)*this->NumBins + bin;
+      (*this->BlockBins)[index]++;
+    }
+};
+
+}
+
+//---------------
+// cvMeshQuality
+//---------------
+//
+cvMeshQuality::cvMeshQuality() : numBins_(20)
+{
+}
+
+//---------------
+// GetMetricName
+//---------------
+//
+const char* cvMeshQuality::GetMetricName(int metric)
+{
+  switch (metric) {
+    case RADIUS_RATIO: return "radius_ratio";
+    case MIN_DIHEDRAL_ANGLE: return "min_dihedral_angle";
+    case ASPECT_RATIO: return "aspect_ratio";
+    case VOLUME: return "volume";
+    case EDGE_LENGTH: return "edge_length";
+  }
+  return "";
+}
+
+void cvMeshQuality::SetNumberOfBins(int numBins)
+{
+  numBins_ = std::max(1, numBins);
+}
+
+//---------
+// Compute
+//---------
+// Compute the quality statistics of 'mesh'. 'boundaryLayer' optionally
+// marks the boundary layer cells with a non-zero value.
+//
+int cvMeshQuality::Compute(vtkUnstructuredGrid *mesh, const std::vector<unsigned char> *boundaryLayer)
+{
+  groups_.clear();
+
+  if (mesh == nullptr || mesh->GetPoints() == nullptr) {
+    fprintf(stderr,"No volume mesh to compute quality statistics for\n");
+    return SV_ERROR;
+  }
+  vtkIdType numCells = mesh->GetNumberOfCells();
+  if (boundaryLayer != nullptr && (vtkIdType) boundaryLayer->size() != numCells) {
+    fprintf(stderr,"The boundary layer mask does not match the number of mesh elements\n");
+    return SV_ERROR;
+  }
+
+  // Find the regions and whether they have boundary layer and interior cells.
+  //
+  vtkDataArray *regionIds = mesh->GetCellData()->GetArray("ModelRegionID");
+  std::vector<int> regions;
+  std::vector<unsigned char> regionLayers;
+  int lastRegionId = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++) {
+    int regionId = (regionIds != nullptr) ? (int) regionIds->GetComponent(cellId, 0) : 1;
+    if (cellId == 0 || regionId != lastRegionId) {
+      if (!std::binary_search(regions.begin(), regions.end(), regionId)) {
+        auto it = std::lower_bound(regions.begin(), regions.end(), regionId);
+        regionLayers.insert(regionLayers.begin() + (it - regions.begin()), 0);
+        regions.insert(it, regionId);
+      }
+      lastRegionId = regionId;
+    }
+    if (boundaryLayer != nullptr) {
+      int region = std::lower_bound(regions.begin(), regions.end(), regionId) - regions.begin();
+      regionLayers[region] |= ((*boundaryLayer)[cellId] != 0) ? 2 : 1;
+    }
+  }
+
+  // The whole mesh is group 0, followed by each region and the interior
+  // and boundary layer parts of regions that have both.
+  //
+  Group newGroup;
+  newGroup.name = "mesh";
+  newGroup.regionId = -1;
+  newGroup.boundaryLayer = -1;
+  groups_.push_back(newGroup);
+
+  std::vector<int> regionGroups(3*regions.size(), -1);
+  for (size_t i = 0; i < regions.size(); i++) {
+    newGroup.name = "region " + std::to_string(regions[i]);
+    newGroup.regionId = regions[i];
+    newGroup.boundaryLayer = -1;
+    regionGroups[3*i] = groups_.size();
+    groups_.push_back(newGroup);
+
+    if (regionLayers[i] == 3) {
+      newGroup.name = "region " + std::to_string(regions[i]) + " interior";
+      newGroup.boundaryLayer = 0;
+      regionGroups[3*i+1] = groups_.size();
+      groups_.push_back(newGroup);
+
+      newGroup.name = "region " + std::to_string(regions[i]) + " boundary layer";
+      newGroup.boundaryLayer = 1;
+      regionGroups[3*i+2] = groups_.size();
+      groups_.push_back(newGroup);
+    }
+  }
+
+  int numGroups = groups_.size();
+  vtkIdType numBlocks = (numCells + QualityBlockSize - 1) / QualityBlockSize;
+
+  // Counts, ranges and sums.
+  //
+  std::vector<GroupSums> blockSums(numBlocks*numGroups);
+  std::vector<vtkIdType> blockBins;
+
+  QualityFunctor quality;
+  quality.Mesh = mesh;
+  quality.RegionIds = regionIds;
+  quality.Regions = &regions;
+  quality.RegionGroups = &regionGroups;
+  quality.BoundaryLayer = boundaryLayer;
+  quality.NumGroups = numGroups;
+  quality.NumBins = numBins_;
+  quality.Binning = false;
+  quality.Groups = &groups_;
+  quality.BlockSums = &blockSums;
+  quality.BlockBins = &blockBins;
+  vtkSMPTools::For(0, numBlocks, quality);
+
+  for (int g = 0; g < numGroups; g++) {
+    GroupSums sums;
+    for (vtkIdType block = 0; block < numBlocks; block++) {
+      const GroupSums& blockSum = blockSums[block*numGroups + g];
+      sums.numberOfElements += blockSum.numberOfElements;
+      sums.numberOfInverted += blockSum.numberOfInverted;
+      sums.numberOfSkipped += blockSum.numberOfSkipped;
+      for (int m = 0; m < NUMBER_OF_METRICS; m++) {
+        sums.metrics[m].Add(blockSum.metrics[m]);
+      }
+    }
+
+    Group& group = groups_[g];
+    group.numberOfElements = sums.numberOfElements;
+    group.numberOfInverted = sums.numberOfInverted;
+    group.numberOfSkipped = sums.numberOfSkipped;
+    for (int m = 0; m < NUMBER_OF_METRICS; m++) {
+      Histogram& histogram = group.metrics[m];
+      const MetricSums& metricSums = sums.metrics[m];
+      histogram.count = metricSums.count;
+      histogram.min = (metricSums.count > 0) ? metricSums.min : 0.0;
+      histogram.max = (metricSums.count > 0) ? metricSums.max : 0.0;
+      histogram.mean = (metricSums.count > 0) ? metricSums.sum / metricSums.count : 0.0;
+
+      if (m == RADIUS_RATIO || m == MIN_DIHEDRAL_ANGLE) {
+        histogram.binMin = 0.0;
+        histogram.binWidth = ((m == RADIUS_RATIO) ? MaxRadiusRatio : MaxDihedralAngle) / numBins_;
+      } else {
+        histogram.binMin = histogram.min;
+        histogram.binWidth = (histogram.max - histogram.min) / numBins_;
+      }
+      histogram.bins.assign(numBins_, 0);
+    }
+  }
+  blockSums.clear();
+  blockSums.shrink_to_fit();
+
+  // Histograms.
+  //
+  blockBins.assign(numBlocks*numGroups*NUMBER_OF_METRICS*numBins_, 0);
+  quality.Binning = true;
+  vtkSMPTools::For(0, numBlocks, quality);
+
+  for (vtkIdType block = 0; block < numBlocks; block++) {
+    for (int g = 0; g < numGroups; g++) {
+      for (int m = 0; m < NUMBER_OF_METRICS; m++) {
+        const vtkIdType *bins = &blockBins[((block*numGroups + g)*NUMBER_OF_METRICS + m)*numBins_];
+        std::vector<vtkIdType>& histogramBins = groups_[g].metrics[m].bins;
+        for (int k = 0; k < numBins_; k++) {
+          histogramBins[k] += bins[k];
+        }
+      }
+    }
+  }
+
+  return SV_OK;
+}
+
+//-------
+// Print
+//-------
+//
+void cvMeshQuality::Print(FILE *fp) const
+{
+  fprintf(fp,"Mesh quality statistics\n");
+
+  for (auto const& group : groups_) {
+    fprintf(fp,"\n%s\n", group.name.c_str());
+    fprintf(fp,"  elements: %lld  inverted: %lld  skipped: %lld\n", (long long) group.numberOfElements,
+        (long long) group.numberOfInverted, (long long) group.numberOfSkipped);
+
+    for (int m = 0; m < NUMBER_OF_METRICS; m++) {
+      const Histogram& histogram = group.metrics[m];
+      fprintf(fp,"  %s: count %lld  min %g  max %g  mean %g\n", GetMetricName(m), (long long) histogram.count,
+          histogram.min, histogram.max, histogram.mean);
+      for (int k = 0; k < (int) histogram.bins.size(); k++) {
+        fprintf(fp,"    [%g, %g) %lld\n", histogram.binMin + k*histogram.binWidth,
+            histogram.binMin + (k+1)*histogram.binWidth, (long long) histogram.bins[k]);
+      }
+    }
+  }
+}
+
+//-------
+// Write
+//-------
+//
+int cvMeshQuality::Write(const char *fileName) const
+{
+  FILE *fp = fopen(fileName, "w");
+  if (fp == nullptr) {
+    fprintf(stderr,"Unable to open %s for writing\n", fileName);
+    return SV_ERROR;
+  }
+  Print(fp);
+  fclose(fp);
+  return SV_OK;
+}
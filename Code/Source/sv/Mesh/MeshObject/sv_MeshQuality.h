@@ -0,0 +1,117 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CVMESHQUALITY_H
+#define __CVMESHQUALITY_H
+
+#include "SimVascular.h"
+#include "svMeshObjectExports.h"
+
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//---------------
+// cvMeshQuality
+//---------------
+// Element quality statistics for a tetrahedral volume mesh.
+//
+// The radius ratio (3 x inradius / circumradius), minimum dihedral angle
+// (degrees), aspect ratio (longest edge / (2 sqrt(6) x inradius)), volume
+// and edge length of each tetrahedron are collected into a histogram for
+// the whole mesh, for each 'ModelRegionID' and, if a boundary layer mask
+// is given, for the boundary layer and interior cells of each region.
+// The radius ratio and aspect ratio of a regular tetrahedron are 1. Edge
+// lengths are counted once for each element they belong to.
+//
+// Non-tetrahedral cells are skipped. Cells with a zero or negative volume
+// are counted as inverted; their volume is added as zero and they have no
+// aspect ratio.
+//
+// The elements are processed in parallel in fixed size blocks whose
+// partial results are combined in order, so the statistics do not depend
+// on the number of threads.
+//
+class SV_EXPORT_MESH cvMeshQuality {
+
+public:
+  enum Metric {
+    RADIUS_RATIO,
+    MIN_DIHEDRAL_ANGLE,
+    ASPECT_RATIO,
+    VOLUME,
+    EDGE_LENGTH,
+    NUMBER_OF_METRICS
+  };
+
+  class Histogram {
+    public:
+      vtkIdType count;
+      double min;
+      double max;
+      double mean;
+      double binMin;
+      double binWidth;
+      std::vector<vtkIdType> bins;
+  };
+
+  class Group {
+    public:
+      std::string name;
+      int regionId;             // -1 for the whole mesh
+      int boundaryLayer;        // -1 whole region, 0 interior, 1 boundary layer
+      vtkIdType numberOfElements;
+      vtkIdType numberOfInverted;
+      vtkIdType numberOfSkipped;
+      Histogram metrics[NUMBER_OF_METRICS];
+  };
+
+  cvMeshQuality();
+
+  static const char* GetMetricName(int metric);
+
+  void SetNumberOfBins(int numBins);
+  int GetNumberOfBins() const { return numBins_; }
+
+  int Compute(vtkUnstructuredGrid *mesh, const std::vector<unsigned char> *boundaryLayer = nullptr);
+  const std::vector<Group>& GetGroups() const { return groups_; }
+
+  void Print(FILE *fp) const;
+  int Write(const char *fileName) const;
+
+private:
+  int numBins_;
+  std::vector<Group> groups_;
+};
+
+#endif // __CVMESHQUALITY_H
@@ -633,15 +633,23 @@ int cvTetGenAdapt::SetMetric(char *input,int option, int strategy)
 	  return SV_ERROR;
       }
 
+      //Point adjacency is shared by the smoothing and the size field
+      PointAdjacency adjacency;
+      if (AdaptUtils_buildPointAdjacency(inmesh_,adjacency) != SV_OK)
+      {
+	fprintf(stderr,"Error: Error when building point adjacency\n");
+	return SV_ERROR;
+      }
+
       //Compute hessian and attach to mesh!
-      if (AdaptUtils_hessiansFromSolution(inmesh_) != SV_OK)
+      if (AdaptUtils_hessiansFromSolution(inmesh_,&adjacency) != SV_OK)
       {
 	fprintf(stderr,"Error: Error when calculating hessians from solution\n");
 	return SV_ERROR;
       }
       if (AdaptUtils_setSizeFieldUsingHessians(inmesh_,
 	    options.ratio_,options.hmax_,options.hmin_,
-	    options.sphere_,options.strategy_) != SV_OK)
+	    options.sphere_,options.strategy_,&adjacency) != SV_OK)
       {
 	  fprintf(stderr,"Error: Error when setting size field with hessians\n");
 	  return SV_ERROR;
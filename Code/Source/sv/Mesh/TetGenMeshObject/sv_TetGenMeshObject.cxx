@@ -56,6 +56,9 @@
 #include "vtkAppendPolyData.h"
 #include "vtkPolyDataConnectivityFilter.h"
 #include "vtkCenterOfMass.h"
+#include "vtkPointData.h"
+#include "vtkCellData.h"
+#include "vtkPointLocator.h"
 
 #ifdef SV_USE_VMTK
   #include "sv_vmtk_utils.h"
@@ -66,10 +69,165 @@
   #include "sv_mmg_mesh_utils.h"
 #endif
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <set>
+#include <vector>
 #include <math.h>
 
+namespace {
+
+// --------------------
+// SurfaceRemeshCache
+// --------------------
+// The surface mesh from the last GenerateSurfaceRemesh call with the
+// IncrementalRemesh option set, with hashes of the input surface, the
+// remesh options and the sizing values on each model face it was made
+// from. Mesh objects are created for every meshing run so the cache is
+// kept for the process until the option is turned off or a surface
+// remesh runs without it.
+//
+struct SurfaceRemeshCache
+{
+  std::mutex lock;
+  uint64_t modelKey = 0;
+  uint64_t optionsKey = 0;
+  std::map<int,uint64_t> faceKeys;
+  vtkSmartPointer<vtkPolyData> surface;
+};
+
+SurfaceRemeshCache& GetSurfaceRemeshCache()
+{
+  static SurfaceRemeshCache cache;
+  return cache;
+}
+
+const uint64_t SurfaceRemeshHashSeed = 14695981039346656037ULL;
+
+// FNV-1a hash of 'size' bytes continued from 'hash'.
+uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+{
+  const unsigned char *bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+template <typename T>
+uint64_t HashValue(uint64_t hash, const T& value)
+{
+  return HashBytes(hash, &value, sizeof(T));
+}
+
+//----------------------
+// GetSurfaceRemeshKeys
+//----------------------
+// Hash the points, cells and ModelFaceID values of 'surface' into
+// 'modelKey', and the MeshSizingFunction and RefineID values at the cell
+// points of each model face into 'faceKeys'.
+//
+void GetSurfaceRemeshKeys(vtkPolyData *surface, uint64_t& modelKey,
+    std::map<int,uint64_t>& faceKeys)
+{
+  vtkIdType numPts = surface->GetNumberOfPoints();
+  vtkIdType numCells = surface->GetNumberOfCells();
+  vtkIntArray *faceIds = vtkIntArray::SafeDownCast(
+    surface->GetCellData()->GetArray("ModelFaceID"));
+  vtkDoubleArray *sizes = vtkDoubleArray::SafeDownCast(
+    surface->GetPointData()->GetArray("MeshSizingFunction"));
+  vtkIntArray *refineIds = vtkIntArray::SafeDownCast(
+    surface->GetPointData()->GetArray("RefineID"));
+
+  modelKey = HashValue(SurfaceRemeshHashSeed, numPts);
+  modelKey = HashValue(modelKey, numCells);
+  double pt[3];
+  for (vtkIdType i = 0; i < numPts; i++)
+  {
+    surface->GetPoint(i, pt);
+    modelKey = HashBytes(modelKey, pt, sizeof(pt));
+  }
+
+  faceKeys.clear();
+  vtkIdType npts;
+  const vtkIdType *pts;
+  for (vtkIdType i = 0; i < numCells; i++)
+  {
+    surface->GetCellPoints(i, npts, pts);
+    int faceId = faceIds != nullptr ? faceIds->GetValue(i) : 0;
+    modelKey = HashBytes(modelKey, pts, npts*sizeof(vtkIdType));
+    modelKey = HashValue(modelKey, faceId);
+
+    uint64_t& faceKey = faceKeys.emplace(faceId, SurfaceRemeshHashSeed).first->second;
+    for (vtkIdType j = 0; j < npts; j++)
+    {
+      if (sizes != nullptr)
+        faceKey = HashValue(faceKey, sizes->GetValue(pts[j]));
+      if (refineIds != nullptr)
+        faceKey = HashValue(faceKey, refineIds->GetValue(pts[j]));
+    }
+  }
+}
+
+//------------------
+// ExtractFaceCells
+//------------------
+// Copy the cells of 'surface' whose face id is in 'faces' (or not in
+// 'faces' when 'inFaces' is false) into 'output' with the points and
+// point/cell data they use.
+//
+void ExtractFaceCells(vtkPolyData *surface, vtkIntArray *faceIds,
+    const std::set<int>& faces, bool inFaces, vtkPolyData *output)
+{
+  vtkIdType numPts = surface->GetNumberOfPoints();
+  vtkIdType numCells = surface->GetNumberOfCells();
+  vtkPointData *inPD = surface->GetPointData();
+  vtkCellData *inCD = surface->GetCellData();
+  vtkPointData *outPD = output->GetPointData();
+  vtkCellData *outCD = output->GetCellData();
+  outPD->CopyAllocate(inPD, numPts);
+  outCD->CopyAllocate(inCD, numCells);
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  std::vector<vtkIdType> cellPts;
+
+  vtkIdType npts;
+  const vtkIdType *pts;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+  {
+    if ((faces.count(faceIds->GetValue(cellId)) != 0) != inFaces)
+      continue;
+
+    surface->GetCellPoints(cellId, npts, pts);
+    cellPts.resize(npts);
+    for (vtkIdType j = 0; j < npts; j++)
+    {
+      if (pointMap[pts[j]] < 0)
+      {
+        pointMap[pts[j]] = points->InsertNextPoint(surface->GetPoint(pts[j]));
+        outPD->CopyData(inPD, pts[j], pointMap[pts[j]]);
+      }
+      cellPts[j] = pointMap[pts[j]];
+    }
+    vtkIdType newCellId = polys->InsertNextCell(npts, cellPts.data());
+    outCD->CopyData(inCD, cellId, newCellId);
+  }
+
+  output->SetPoints(points);
+  output->SetPolys(polys);
+  outPD->Squeeze();
+  outCD->Squeeze();
+}
+
+}
+
 // -----------
 // cvTetGenMeshObject for python
 // -----------
@@ -142,6 +300,7 @@ cvTetGenMeshObject::cvTetGenMeshObject() : cvMeshObject()
   meshoptions_.usemmg=0;
 #endif
   meshoptions_.hausd=0;
+  meshoptions_.incrementalremesh=0;
   for (int i=0;i<3;i++)
   {
     meshoptions_.spherecenter[i] = 0;
@@ -1004,6 +1163,13 @@ int cvTetGenMeshObject::SetMeshOptions(char *flags,int numValues,double *values)
         return SV_ERROR;
       meshoptions_.usemmg=values[0];
   }
+  else if (!strncmp(flags,"IncrementalRemesh",17)) {
+    if (numValues < 1)
+      return SV_ERROR;
+    meshoptions_.incrementalremesh=values[0];
+    if (!meshoptions_.incrementalremesh)
+      ClearSurfaceRemeshCache();
+  }
   else if (!strncmp(flags,"NewRegionBoundaryLayer",22)) {
     meshoptions_.newregionboundarylayer=1;
   }
@@ -1505,7 +1671,7 @@ int cvTetGenMeshObject::GenerateMesh() {
     volumemesh_ = vtkUnstructuredGrid::New();
 
     if (TGenUtils_ConvertToVTK(outmesh_,volumemesh_,surfacemesh_,
-	  &numBoundaryRegions_,1) != SV_OK)
+	  &numBoundaryRegions_,1,1) != SV_OK)
       return SV_ERROR;
   }
 
@@ -1541,12 +1707,80 @@ int cvTetGenMeshObject::WriteMesh(char *filename, int smsver)
   return SV_OK;
 }
 
+/**
+ * @brief Writes the element quality statistics of the volume mesh
+ * @param *filename char holding the name of the file to be written to
+ * @return SV_OK if executed correctly
+ */
 int cvTetGenMeshObject::WriteStats(char *filename) {
   // must have created mesh
-  if (inmesh_ == nullptr) {
+  if (inmesh_ == nullptr || volumemesh_ == nullptr) {
     return SV_ERROR;
   }
-  return SV_OK;
+
+  cvMeshQuality quality;
+  if (GetQualityStatistics(quality) != SV_OK) {
+    return SV_ERROR;
+  }
+  return quality.Write(filename);
+}
+
+/**
+ * @brief Computes the element quality statistics of the volume mesh,
+ * separating the boundary layer from the interior elements of each region
+ * @return SV_OK if executed correctly
+ */
+int cvTetGenMeshObject::GetQualityStatistics(cvMeshQuality& quality) {
+  if (volumemesh_ == nullptr) {
+    fprintf(stderr,"Mesh must be created before computing quality statistics\n");
+    return SV_ERROR;
+  }
+
+  std::vector<unsigned char> boundaryLayer;
+  GetBoundaryLayerCells(boundaryLayer);
+  return quality.Compute(volumemesh_, boundaryLayer.empty() ? nullptr : &boundaryLayer);
+}
+
+/**
+ * @brief Marks the boundary layer elements of the volume mesh
+ * @note A boundary layer in its own region has the largest 'ModelRegionID',
+ * otherwise its tetrahedra are the first elements of the volume mesh (see
+ * VMTKUtils_AssembleVolumeMesh). The mask is left empty if the mesh has no
+ * boundary layer.
+ */
+void cvTetGenMeshObject::GetBoundaryLayerCells(std::vector<unsigned char>& boundaryLayer) {
+  boundaryLayer.clear();
+  if (!meshoptions_.boundarylayermeshflag || boundarylayermesh_ == nullptr || volumemesh_ == nullptr) {
+    return;
+  }
+
+  vtkIdType numCells = volumemesh_->GetNumberOfCells();
+  if (meshoptions_.newregionboundarylayer) {
+    vtkDataArray *regionIds = volumemesh_->GetCellData()->GetArray("ModelRegionID");
+    if (regionIds == nullptr) {
+      return;
+    }
+    double range[2];
+    regionIds->GetRange(range);
+    boundaryLayer.resize(numCells);
+    for (vtkIdType cellId = 0; cellId < numCells; cellId++) {
+      boundaryLayer[cellId] = (regionIds->GetComponent(cellId, 0) == range[1]);
+    }
+    return;
+  }
+
+  vtkIdType numBoundaryLayerCells = 0;
+  for (vtkIdType cellId = 0; cellId < boundarylayermesh_->GetNumberOfCells(); cellId++) {
+    int cellType = boundarylayermesh_->GetCellType(cellId);
+    if (cellType != VTK_TRIANGLE && cellType != VTK_QUAD) {
+      numBoundaryLayerCells++;
+    }
+  }
+  if (numBoundaryLayerCells > numCells) {
+    return;
+  }
+  boundaryLayer.assign(numCells, 0);
+  std::fill(boundaryLayer.begin(), boundaryLayer.begin() + numBoundaryLayerCells, 1);
 }
 
 /**
@@ -1682,6 +1916,21 @@ int cvTetGenMeshObject::SetInputUnstructuredGrid(vtkUnstructuredGrid *ug)
   return SV_OK;
 }
 
+/**
+ * @brief Release the surface kept for incremental remeshing
+ * @note The next surface remesh with IncrementalRemesh set remeshes the
+ * whole surface again
+ */
+void cvTetGenMeshObject::ClearSurfaceRemeshCache()
+{
+  SurfaceRemeshCache& cache = GetSurfaceRemeshCache();
+  std::lock_guard<std::mutex> guard(cache.lock);
+  cache.surface = nullptr;
+  cache.modelKey = 0;
+  cache.optionsKey = 0;
+  cache.faceKeys.clear();
+}
+
 /**
  * @brief Helper function to generate surface mesh
  * @note This is a helper function. It is called from GenerateMesh
@@ -1691,31 +1940,9 @@ int cvTetGenMeshObject::SetInputUnstructuredGrid(vtkUnstructuredGrid *ug)
 int cvTetGenMeshObject::GenerateSurfaceRemesh()
 {
 #ifdef SV_USE_VMTK
-  int meshcapsonly = 0;
-  int preserveedges;
-  int trianglesplitfactor;
   int useSizingFunction = 0;
-  double collapseanglethreshold;
-  std::string markerListName;
   vtkSmartPointer<vtkDoubleArray> meshsizingfunction =
     vtkSmartPointer<vtkDoubleArray>::New();
-  //If we are doing a boundary layer mesh, we do not want to retain edges
-  //for our surface remeshing
-  //Else, we would like to preserve the edges of the boundary layer mesh
-  if (meshoptions_.meshwallfirst)
-  {
-    preserveedges = 0;
-    trianglesplitfactor = 5.0;
-    collapseanglethreshold = 0.2;
-    markerListName = "CellEntityIds";
-  }
-  else
-  {
-    preserveedges = 1;
-    trianglesplitfactor = NULL;
-    collapseanglethreshold = NULL;
-    markerListName = "ModelFaceID";
-  }
   //If doing sphere refinement, we need to base surface mesh on mesh
   //sizing function
   if (meshoptions_.refinement || meshoptions_.functionbasedmeshing)
@@ -1740,46 +1967,106 @@ int cvTetGenMeshObject::GenerateSurfaceRemesh()
     meshsizingfunction = nullptr;
   }
 
+  int usemmg = 0;
 #ifdef SV_USE_MMG
-  if (meshoptions_.usemmg)
+  usemmg = meshoptions_.usemmg;
+#endif
+
+  //With incremental remeshing the input is compared against the last
+  //surface remesh and only the model faces whose sizing changed are
+  //remeshed again
+  int incremental = meshoptions_.incrementalremesh && !meshoptions_.meshwallfirst;
+  uint64_t modelKey = 0;
+  uint64_t optionsKey = 0;
+  std::map<int,uint64_t> faceKeys;
+  std::set<int> changedFaces;
+  vtkSmartPointer<vtkPolyData> cachedSurface;
+  if (!incremental)
+    ClearSurfaceRemeshCache();
+  else
   {
-    double meshFactor = 0.8;
-    double meshsize = meshFactor*meshoptions_.maxedgesize;
-    double mmg_maxsize = 1.5*meshsize;
-    double mmg_minsize = 0.5*meshsize;
-    if (meshoptions_.hausd == 0)
-      meshoptions_.hausd = 10.0*meshsize;
-    double hausd = meshoptions_.hausd;
-    double dumAng = 45.0;
-    double hgrad = 1.01;
+    GetSurfaceRemeshKeys(polydatasolid_, modelKey, faceKeys);
 
-    //Generate Surface Remeshing
-    if(MMGUtils_SurfaceRemeshing(polydatasolid_, mmg_minsize,
-	  mmg_maxsize, hausd, dumAng, hgrad,
-	  useSizingFunction, meshsizingfunction, meshoptions_.refinecount) != SV_OK)
+    optionsKey = SurfaceRemeshHashSeed;
+    optionsKey = HashValue(optionsKey, usemmg);
+    optionsKey = HashValue(optionsKey, useSizingFunction);
+    optionsKey = HashValue(optionsKey, meshoptions_.maxedgesize);
+    optionsKey = HashValue(optionsKey, usemmg ? GetSurfaceRemeshHausd() : 0.0);
+    optionsKey = HashValue(optionsKey, meshoptions_.refinecount);
+
+    SurfaceRemeshCache& cache = GetSurfaceRemeshCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    if (cache.surface != nullptr && cache.modelKey == modelKey &&
+        cache.optionsKey == optionsKey)
     {
-      fprintf(stderr,"Problem with surface meshing\n");
-      return SV_ERROR;
+      cachedSurface = cache.surface;
+      for (auto face = faceKeys.begin(); face != faceKeys.end(); ++face)
+      {
+        auto cachedFace = cache.faceKeys.find(face->first);
+        if (cachedFace == cache.faceKeys.end() || cachedFace->second != face->second)
+          changedFaces.insert(face->first);
+      }
     }
   }
-  else
+
+  //Keep the input so that a surface built from the cache that fails the
+  //checks can be replaced by a full remesh
+  int fromCache = 0;
+  vtkSmartPointer<vtkPolyData> originalInput;
+  if (cachedSurface != nullptr && changedFaces.size() < faceKeys.size())
   {
-#endif
-    //Generate Surface Remeshing
-    if(VMTKUtils_SurfaceRemeshing(polydatasolid_,meshoptions_.maxedgesize,
-          meshcapsonly,preserveedges,trianglesplitfactor,
-          collapseanglethreshold,nullptr,markerListName,
-          useSizingFunction,meshsizingfunction) != SV_OK)
+    originalInput = vtkSmartPointer<vtkPolyData>::New();
+    originalInput->DeepCopy(polydatasolid_);
+    if (changedFaces.empty())
+    {
+      fprintf(stdout,"Surface unchanged, reusing previous surface mesh\n");
+      polydatasolid_->DeepCopy(cachedSurface);
+      fromCache = 1;
+    }
+    else
+    {
+      fprintf(stdout,"Remeshing %d of %d surface faces\n",
+        (int) changedFaces.size(), (int) faceKeys.size());
+      if (RemeshChangedFaces(cachedSurface, changedFaces, useSizingFunction) == SV_OK)
+      {
+        if (!usemmg)
+          ResetOriginalRegions("ModelFaceID");
+        fromCache = 1;
+      }
+      else
+      {
+        fprintf(stdout,"Incremental surface remesh failed, remeshing the whole surface\n");
+        polydatasolid_->DeepCopy(originalInput);
+      }
+    }
+  }
+
+  int meshInfo[3];
+  if (fromCache &&
+      (TGenUtils_CheckSurfaceMesh(polydatasolid_, meshInfo) != SV_OK ||
+       (!meshoptions_.allowMultipleRegions && meshInfo[0] > 1) ||
+       meshInfo[1] > 0 || meshInfo[2] > 0))
+  {
+    fprintf(stdout,"Incremental surface mesh is bad, remeshing the whole surface\n");
+    polydatasolid_->DeepCopy(originalInput);
+    fromCache = 0;
+  }
+
+  if (!fromCache)
+  {
+    //The input was restored from the copy, so use its sizing array
+    if (originalInput != nullptr && useSizingFunction)
+      meshsizingfunction = vtkDoubleArray::SafeDownCast(
+        polydatasolid_->GetPointData()->GetScalars("MeshSizingFunction"));
+    if (RemeshSurface(polydatasolid_, useSizingFunction, meshsizingfunction, 0) != SV_OK)
     {
       fprintf(stderr,"Problem with surface meshing\n");
       return SV_ERROR;
     }
-    ResetOriginalRegions("ModelFaceID");
-#ifdef SV_USE_MMG
+    if (!usemmg)
+      ResetOriginalRegions("ModelFaceID");
   }
-#endif
 
-  int meshInfo[3];
   if (TGenUtils_CheckSurfaceMesh(polydatasolid_, meshInfo) != SV_OK)
   {
     fprintf(stderr,"Mesh surface is bad\n");
@@ -1809,6 +2096,17 @@ int cvTetGenMeshObject::GenerateSurfaceRemesh()
     }
   }
 
+  if (incremental)
+  {
+    SurfaceRemeshCache& cache = GetSurfaceRemeshCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.surface = vtkSmartPointer<vtkPolyData>::New();
+    cache.surface->DeepCopy(polydatasolid_);
+    cache.modelKey = modelKey;
+    cache.optionsKey = optionsKey;
+    cache.faceKeys = faceKeys;
+  }
+
   if (meshoptions_.meshwallfirst && !meshoptions_.boundarylayermeshflag)
   {
     if (GenerateAndMeshCaps() != SV_OK)
@@ -1824,6 +2122,204 @@ int cvTetGenMeshObject::GenerateSurfaceRemesh()
   return SV_OK;
 }
 
+// -----------------------
+//  GetSurfaceRemeshHausd
+// -----------------------
+/**
+ * @brief The Hausdorff distance used by MMG surface remeshing
+ * @note Derived from the global edge size when the Hausd option is not set
+ * @return the Hausdorff distance
+ */
+double cvTetGenMeshObject::GetSurfaceRemeshHausd()
+{
+  if (meshoptions_.hausd != 0)
+    return meshoptions_.hausd;
+
+  double meshFactor = 0.8;
+  double meshsize = meshFactor*meshoptions_.maxedgesize;
+  return 10.0*meshsize;
+}
+
+// ---------------
+//  RemeshSurface
+// ---------------
+/**
+ * @brief Helper function to remesh a surface with MMG or VMTK
+ * @param surface the surface to remesh in place; needs ModelFaceID
+ * @param useSizingFunction use the point sizes in meshSizingFunction
+ * @param meshSizingFunction point edge sizes on surface, may be nullptr
+ * @param preserveBoundaryEdges keep the free edges of an open surface fixed
+ * @return SV_OK if executed correctly
+ */
+int cvTetGenMeshObject::RemeshSurface(vtkPolyData *surface, int useSizingFunction,
+    vtkDoubleArray *meshSizingFunction, int preserveBoundaryEdges)
+{
+#ifdef SV_USE_VMTK
+  int meshcapsonly = 0;
+  int preserveedges;
+  int trianglesplitfactor;
+  double collapseanglethreshold;
+  std::string markerListName;
+  //If we are doing a boundary layer mesh, we do not want to retain edges
+  //for our surface remeshing
+  //Else, we would like to preserve the edges of the boundary layer mesh
+  if (meshoptions_.meshwallfirst)
+  {
+    preserveedges = preserveBoundaryEdges;
+    trianglesplitfactor = 5.0;
+    collapseanglethreshold = 0.2;
+    markerListName = "CellEntityIds";
+  }
+  else
+  {
+    preserveedges = 1;
+    trianglesplitfactor = NULL;
+    collapseanglethreshold = NULL;
+    markerListName = "ModelFaceID";
+  }
+
+#ifdef SV_USE_MMG
+  if (meshoptions_.usemmg)
+  {
+    double meshFactor = 0.8;
+    double meshsize = meshFactor*meshoptions_.maxedgesize;
+    double mmg_maxsize = 1.5*meshsize;
+    double mmg_minsize = 0.5*meshsize;
+    meshoptions_.hausd = GetSurfaceRemeshHausd();
+    double hausd = meshoptions_.hausd;
+    double dumAng = 45.0;
+    double hgrad = 1.01;
+
+    //Generate Surface Remeshing
+    if(MMGUtils_SurfaceRemeshing(surface, mmg_minsize,
+	  mmg_maxsize, hausd, dumAng, hgrad,
+	  useSizingFunction, meshSizingFunction, meshoptions_.refinecount,
+	  preserveBoundaryEdges) != SV_OK)
+    {
+      return SV_ERROR;
+    }
+    return SV_OK;
+  }
+#endif
+
+  //Generate Surface Remeshing
+  if(VMTKUtils_SurfaceRemeshing(surface,meshoptions_.maxedgesize,
+        meshcapsonly,preserveedges,trianglesplitfactor,
+        collapseanglethreshold,nullptr,markerListName,
+        useSizingFunction,meshSizingFunction) != SV_OK)
+  {
+    return SV_ERROR;
+  }
+
+  return SV_OK;
+#else
+  fprintf(stderr,"Cannot do a surface remesh without using VMTK\n");
+  return SV_ERROR;
+#endif
+}
+
+// --------------------
+//  RemeshChangedFaces
+// --------------------
+/**
+ * @brief Helper function to remesh only some faces of a previous surface mesh
+ * @note The cells of changedFaces are cut out of cachedSurface as an open
+ * patch, given the sizing values of the current input and remeshed with
+ * their boundary fixed so that the seam still matches the faces kept from
+ * cachedSurface. The result replaces polydatasolid_.
+ * @param cachedSurface surface mesh from a previous run on the same model
+ * @param changedFaces ModelFaceID values of the faces to remesh
+ * @param useSizingFunction remesh with the input MeshSizingFunction
+ * @return SV_OK if executed correctly
+ */
+int cvTetGenMeshObject::RemeshChangedFaces(vtkPolyData *cachedSurface,
+    const std::set<int>& changedFaces, int useSizingFunction)
+{
+  vtkIntArray *cachedFaceIds = vtkIntArray::SafeDownCast(
+    cachedSurface->GetCellData()->GetArray("ModelFaceID"));
+  vtkIntArray *faceIds = vtkIntArray::SafeDownCast(
+    polydatasolid_->GetCellData()->GetArray("ModelFaceID"));
+  if (cachedFaceIds == nullptr || faceIds == nullptr)
+  {
+    fprintf(stderr,"Array name 'ModelFaceID' does not exist on surface\n");
+    return SV_ERROR;
+  }
+
+  vtkSmartPointer<vtkPolyData> kept = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPolyData> patch = vtkSmartPointer<vtkPolyData>::New();
+  ExtractFaceCells(cachedSurface, cachedFaceIds, changedFaces, false, kept);
+  ExtractFaceCells(cachedSurface, cachedFaceIds, changedFaces, true, patch);
+
+  vtkDoubleArray *patchSizing = nullptr;
+  if (useSizingFunction)
+  {
+    //Patch points take the sizing values of the closest input point on
+    //the changed faces
+    vtkSmartPointer<vtkPolyData> inputFaces = vtkSmartPointer<vtkPolyData>::New();
+    ExtractFaceCells(polydatasolid_, faceIds, changedFaces, true, inputFaces);
+
+    vtkSmartPointer<vtkPointLocator> locator =
+      vtkSmartPointer<vtkPointLocator>::New();
+    locator->SetDataSet(inputFaces);
+    locator->BuildLocator();
+
+    vtkIdType numPatchPts = patch->GetNumberOfPoints();
+    std::vector<vtkIdType> closestPts(numPatchPts);
+    for (vtkIdType i=0;i<numPatchPts;i++)
+      closestPts[i] = locator->FindClosestPoint(patch->GetPoint(i));
+
+    const char *arrayNames[2] = {"MeshSizingFunction", "RefineID"};
+    for (int n=0;n<2;n++)
+    {
+      vtkDataArray *inArray = inputFaces->GetPointData()->GetArray(arrayNames[n]);
+      if (inArray == nullptr)
+        continue;
+
+      vtkSmartPointer<vtkDataArray> outArray;
+      outArray.TakeReference(inArray->NewInstance());
+      outArray->SetName(arrayNames[n]);
+      outArray->SetNumberOfComponents(inArray->GetNumberOfComponents());
+      outArray->SetNumberOfTuples(numPatchPts);
+      for (vtkIdType i=0;i<numPatchPts;i++)
+        outArray->SetTuple(i, closestPts[i], inArray);
+
+      patch->GetPointData()->RemoveArray(arrayNames[n]);
+      patch->GetPointData()->AddArray(outArray);
+    }
+    patchSizing = vtkDoubleArray::SafeDownCast(
+      patch->GetPointData()->GetArray("MeshSizingFunction"));
+    if (patchSizing == nullptr)
+    {
+      fprintf(stderr,"Array name 'MeshSizingFunction' does not exist on surface\n");
+      return SV_ERROR;
+    }
+  }
+
+  if (RemeshSurface(patch, useSizingFunction, patchSizing, 1) != SV_OK)
+    return SV_ERROR;
+
+  //Seam points are held fixed by the remesh, so merging the patch back
+  //into the kept faces closes the surface again
+  vtkSmartPointer<vtkAppendPolyData> appender =
+    vtkSmartPointer<vtkAppendPolyData>::New();
+  appender->AddInputData(kept);
+  appender->AddInputData(patch);
+  appender->Update();
+
+  vtkSmartPointer<vtkCleanPolyData> cleaner =
+    vtkSmartPointer<vtkCleanPolyData>::New();
+  cleaner->SetInputData(appender->GetOutput());
+  cleaner->PointMergingOn();
+  cleaner->ToleranceIsAbsoluteOn();
+  cleaner->SetAbsoluteTolerance(1.0e-6*meshoptions_.maxedgesize);
+  cleaner->Update();
+
+  polydatasolid_->DeepCopy(cleaner->GetOutput());
+  polydatasolid_->BuildLinks();
+
+  return SV_OK;
+}
+
 //-----------------------
 // SetCapBoundaryNormals 
 //-----------------------
@@ -2264,7 +2760,7 @@ int cvTetGenMeshObject::AppendBoundaryLayerMesh()
   auto newnormaler = vtkSmartPointer<vtkPolyDataNormals>::New();
 
   if (TGenUtils_ConvertToVTK(outmesh_,volumemesh_,surfacemesh_,
-    &numBoundaryRegions_,0) != SV_OK)
+    &numBoundaryRegions_,0,1) != SV_OK)
   {
   return SV_ERROR;
   }
@@ -2383,7 +2879,7 @@ int cvTetGenMeshObject::Adapt()
   surfacemesh_ = vtkPolyData::New();
   volumemesh_ = vtkUnstructuredGrid::New();
   if (TGenUtils_ConvertToVTK(outmesh_,volumemesh_,surfacemesh_,
-	&numBoundaryRegions_,1) != SV_OK)
+	&numBoundaryRegions_,1,1) != SV_OK)
     return SV_ERROR;
 
   if (TGenUtils_ResetOriginalRegions(surfacemesh_,originalpolydata_,
@@ -98,6 +98,7 @@ class SV_EXPORT_TETGEN_MESH cvTetGenMeshObject : public cvMeshObject {
     int refinecount;
     int usemmg;
     double hausd;
+    int incrementalremesh;
     bool allowMultipleRegions;
   } TGoptions;
 
@@ -131,6 +132,9 @@ class SV_EXPORT_TETGEN_MESH cvTetGenMeshObject : public cvMeshObject {
   //Set curve sizes and other mesh options
   int SetMeshOptions(char *flags,int numValues, double *values);
 
+  //Release the surface kept by the IncrementalRemesh option
+  static void ClearSurfaceRemeshCache();
+
   //Set boundary layer and/or specify wall faces
   int SetBoundaryLayer(int type, int id, int side, int nL, double* H);
   int SetWalls(int numWalls,int *walls);
@@ -154,6 +158,7 @@ class SV_EXPORT_TETGEN_MESH cvTetGenMeshObject : public cvMeshObject {
   int GenerateMesh();
   int WriteMesh(char *filename, int smsver);
   int WriteStats(char *filename);
+  int GetQualityStatistics(cvMeshQuality& quality);
 
   // output visualization files
   int WriteMetisAdjacency (char *filename);
@@ -185,6 +190,7 @@ class SV_EXPORT_TETGEN_MESH cvTetGenMeshObject : public cvMeshObject {
   int GenerateMeshSizingFunction();
   int AppendBoundaryLayerMesh();
   int ResetOriginalRegions(std::string regionName);
+  void GetBoundaryLayerCells(std::vector<unsigned char>& boundaryLayer);
 
   private:
   char meshFileName_[MAXPATHLEN];
@@ -214,6 +220,12 @@ class SV_EXPORT_TETGEN_MESH cvTetGenMeshObject : public cvMeshObject {
   TGoptions meshoptions_;
 
   void SetCapBoundaryNormals(vtkPolyData* surface);
+
+  double GetSurfaceRemeshHausd();
+  int RemeshSurface(vtkPolyData *surface, int useSizingFunction,
+                    vtkDoubleArray *meshSizingFunction, int preserveBoundaryEdges);
+  int RemeshChangedFaces(vtkPolyData *cachedSurface, const std::set<int>& changedFaces,
+                         int useSizingFunction);
 };
 
 #endif // _CVTETGENMESHOBJECT_H
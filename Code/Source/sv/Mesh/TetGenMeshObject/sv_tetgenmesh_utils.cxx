@@ -58,6 +58,11 @@
 #include "vtkGenericCell.h"
 #include "vtkConnectivityFilter.h"
 #include "vtkDataSetSurfaceFilter.h"
+#include "vtkIdTypeArray.h"
+#include "vtkTypeInt32Array.h"
+#include "vtkTypeInt64Array.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocalObject.h"
 
 #include "simvascular_tetgen.h"
 
@@ -83,6 +88,229 @@
 
 #include "sv_tetgenmesh_utils.h"
 
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// -----------------------------
+// GlobalIdsFunctor
+// -----------------------------
+// Sets the 1-based ids of a range of points or elements.
+class GlobalIdsFunctor {
+  public:
+    int *Ids;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i=begin;i<end;i++)
+        this->Ids[i] = i+1;
+    }
+};
+
+// -----------------------------
+// TetCellsFunctor
+// -----------------------------
+// Fills the cell offsets and region ids of the tetgen tetrahedra, and the
+// connectivity when it can not reference the tetgen list directly.
+template <class T>
+class TetCellsFunctor {
+  public:
+    const int *Tets;
+    int NumCorners;
+    const REAL *Attributes;
+    T *Offsets;
+    T *Connectivity;
+    int *RegionIds;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i=begin;i<end;i++)
+      {
+        this->Offsets[i+1] = 4*(i+1);
+        if (this->Connectivity != nullptr)
+        {
+          for (int j=0;j<4;j++)
+            this->Connectivity[4*i+j] = this->Tets[i*this->NumCorners+j];
+        }
+        if (this->Attributes != nullptr)
+          this->RegionIds[i] = this->Attributes[i] + 1;
+        else
+          this->RegionIds[i] = 1;
+      }
+    }
+};
+
+// -----------------------------
+// SurfacePointsFunctor
+// -----------------------------
+// Gathers the coordinates and global node ids of the surface points.
+class SurfacePointsFunctor {
+  public:
+    const REAL *Points;
+    const int *SurfacePoints;
+    double *SurfaceCoords;
+    int *NodeIds;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i=begin;i<end;i++)
+      {
+        const REAL *pt = &this->Points[3*this->SurfacePoints[i]];
+        this->SurfaceCoords[3*i] = pt[0];
+        this->SurfaceCoords[3*i+1] = pt[1];
+        this->SurfaceCoords[3*i+2] = pt[2];
+        this->NodeIds[i] = this->SurfacePoints[i] + 1;
+      }
+    }
+};
+
+// -----------------------------
+// SurfaceFacesFunctor
+// -----------------------------
+// Renumbers the tetgen boundary faces to the surface points.
+class SurfaceFacesFunctor {
+  public:
+    const int *Faces;
+    const int *PointMapping;
+    vtkIdType *Offsets;
+    vtkIdType *Connectivity;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i=begin;i<end;i++)
+      {
+        this->Offsets[i+1] = 3*(i+1);
+        for (int j=0;j<3;j++)
+          this->Connectivity[3*i+j] = this->PointMapping[this->Faces[3*i+j]];
+      }
+    }
+};
+
+// -----------------------------
+// SurfaceFacetsFunctor
+// -----------------------------
+// Creates a single triangle facet for each surface polygon.
+class SurfaceFacetsFunctor {
+  public:
+    vtkPolyData *Surface;
+    tetgenio::facet *Facets;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkIdList *ptIds = this->PointIds.Local();
+      for (vtkIdType i=begin;i<end;i++)
+      {
+        this->Surface->GetCellPoints(i,ptIds);
+
+        tetgenio::facet *f = &this->Facets[i];
+        f->numberofpolygons = 1;
+        f->polygonlist = new tetgenio::polygon[f->numberofpolygons];
+        f->numberofholes = 0;
+        f->holelist = nullptr;
+
+        tetgenio::polygon *p = &f->polygonlist[0];
+        p->numberofvertices = 3;
+        p->vertexlist = new int[p->numberofvertices];
+        p->vertexlist[0] = (int) ptIds->GetId(0);
+        p->vertexlist[1] = (int) ptIds->GetId(1);
+        p->vertexlist[2] = (int) ptIds->GetId(2);
+      }
+    }
+};
+
+// -----------------------------
+// VolumeTetsFunctor
+// -----------------------------
+// Copies the point ids of the mesh tetrahedra into the tetgen list.
+class VolumeTetsFunctor {
+  public:
+    vtkUnstructuredGrid *Mesh;
+    int *Tets;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkIdList *ptIds = this->PointIds.Local();
+      for (vtkIdType i=begin;i<end;i++)
+      {
+        this->Mesh->GetCellPoints(i,ptIds);
+        for (vtkIdType j=0;j<4;j++)
+          this->Tets[4*i+j] = ptIds->GetId(j);
+      }
+    }
+};
+
+// -----------------------------
+// CopyPointCoordinates
+// -----------------------------
+// Copies the point coordinates into a tetgen point list, with a single
+// copy when the points are stored as doubles.
+void CopyPointCoordinates(vtkPoints *points, REAL *pointlist)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  vtkDoubleArray *coords = vtkDoubleArray::SafeDownCast(points->GetData());
+  if (coords != nullptr)
+  {
+    std::copy(coords->GetPointer(0),coords->GetPointer(0)+3*numPts,pointlist);
+    return;
+  }
+  for (vtkIdType i=0;i<numPts;i++)
+    points->GetPoint(i,&pointlist[3*i]);
+}
+
+// -----------------------------
+// SetTetCells
+// -----------------------------
+// Sets the tetgen tetrahedra as the cells of 'cells' using offset and
+// connectivity arrays of type ArrayType. A four-corner list with matching
+// value type is copied in one pass, or is taken over without a copy if
+// 'release' is set.
+template <class ArrayType>
+void SetTetCells(tetgenio *outmesh, bool release, vtkCellArray *cells, int *regionIds)
+{
+  typedef typename ArrayType::ValueType ValueType;
+  vtkIdType numTets = outmesh->numberoftetrahedra;
+  auto offsets = vtkSmartPointer<ArrayType>::New();
+  auto connectivity = vtkSmartPointer<ArrayType>::New();
+  offsets->SetNumberOfValues(numTets+1);
+  offsets->SetValue(0,0);
+
+  TetCellsFunctor<ValueType> tets;
+  tets.Tets = outmesh->tetrahedronlist;
+  tets.NumCorners = outmesh->numberofcorners;
+  tets.Attributes = nullptr;
+  if (outmesh->numberoftetrahedronattributes > 0)
+    tets.Attributes = outmesh->tetrahedronattributelist;
+  tets.Offsets = offsets->GetPointer(0);
+  tets.Connectivity = nullptr;
+  tets.RegionIds = regionIds;
+
+  bool sameLayout = (outmesh->numberofcorners == 4 && sizeof(ValueType) == sizeof(int));
+  if (sameLayout && release)
+  {
+    connectivity->SetArray(reinterpret_cast<ValueType*>(outmesh->tetrahedronlist),4*numTets,0,
+      vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
+    outmesh->tetrahedronlist = nullptr;
+  }
+  else if (sameLayout)
+  {
+    connectivity->SetNumberOfValues(4*numTets);
+    std::copy(outmesh->tetrahedronlist,outmesh->tetrahedronlist+4*numTets,connectivity->GetPointer(0));
+  }
+  else
+  {
+    connectivity->SetNumberOfValues(4*numTets);
+    tets.Connectivity = connectivity->GetPointer(0);
+  }
+  vtkSMPTools::For(0,numTets,tets);
+
+  cells->SetData(offsets,connectivity);
+}
+
+}
+
 // -----------------------------
 // cvTetGenMeshObjectUtils_Init()
 // -----------------------------
@@ -104,55 +332,25 @@ int TGenUtils_Init()
 
 int TGenUtils_ConvertSurfaceToTetGen(tetgenio *inmesh,vtkPolyData *polydatasolid)
 {
-  tetgenio::facet *f;
-  tetgenio::polygon *p;
-
   //All input numbers start from zero, all outmesh_put number start from zero
   inmesh->firstnumber = 0;
   inmesh->numberofpoints = polydatasolid->GetNumberOfPoints();
   inmesh->pointlist = new REAL[inmesh->numberofpoints*3];
-
-  //Do Point transition from polydatasolid into pointlist
-  //fprintf(stderr,"Converting Points...\n");
-  vtkSmartPointer<vtkPoints> inPts = vtkSmartPointer<vtkPoints>::New();
-  inPts = polydatasolid->GetPoints();
-  for (int i=0; i<inmesh->numberofpoints;i++)
-  {
-    double polyPt[3];
-    inPts->GetPoint(i,polyPt);
-    inmesh->pointlist[i*3] = polyPt[0];
-    inmesh->pointlist[i*3+1] = polyPt[1];
-    inmesh->pointlist[i*3+2] = polyPt[2];
-  }
+  CopyPointCoordinates(polydatasolid->GetPoints(),inmesh->pointlist);
 
   // Convert faces
   inmesh->numberoffacets = (int) polydatasolid->GetNumberOfPolys();
   inmesh->facetlist = new tetgenio::facet[inmesh->numberoffacets];
   inmesh->facetmarkerlist = new int[inmesh->numberoffacets];
 
-  //fprintf(stderr,"Converting Faces...\n");
-  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
-  ptIds->SetNumberOfIds(3);
-  for (int i=0;i<inmesh->numberoffacets;i++)
-  {
-    polydatasolid->GetCellPoints(i,ptIds);
-
-    f = &inmesh->facetlist[i];
-    f->numberofpolygons=1;
-
-    f->polygonlist = new tetgenio::polygon[f->numberofpolygons];
-
-    f->numberofholes = 0;
-    f->holelist = nullptr;
-
-    p = &f->polygonlist[0];
-    p->numberofvertices=3;
-    p->vertexlist = new int[p->numberofvertices];
-    p->vertexlist[0] =  (int) ptIds->GetId(0);
-    p->vertexlist[1] =  (int) ptIds->GetId(1);
-    p->vertexlist[2] =  (int) ptIds->GetId(2);
+  // The cell map must exist before cells are queried from several threads
+  if (polydatasolid->NeedToBuildCells())
+    polydatasolid->BuildCells();
 
-  }
+  SurfaceFacetsFunctor facets;
+  facets.Surface = polydatasolid;
+  facets.Facets = inmesh->facetlist;
+  vtkSMPTools::For(0,inmesh->numberoffacets,facets);
 
   return SV_OK;
 }
@@ -296,32 +494,18 @@ int TGenUtils_AddRegions(tetgenio *inmesh, vtkPoints *regionList, vtkDoubleArray
 int TGenUtils_ConvertVolumeToTetGen(vtkUnstructuredGrid *mesh,vtkPolyData *surfaceMesh,
     tetgenio *inmesh)
 {
-  int numTets,numPolys;
-  int numPoints,numSurfacePoints;
-  double tetPts[3];
-  tetgenio::facet *f;
-  tetgenio::polygon *p;
-  vtkIdType i,j;
-  vtkIdType npts = 0;
-  const vtkIdType *pts;
-  vtkIdType cellId;
-  vtkSmartPointer<vtkPoints> uPoints = vtkSmartPointer<vtkPoints>::New();
-  vtkSmartPointer<vtkCellArray> pPolys = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkCellArray> uTets = vtkSmartPointer<vtkCellArray>::New();
-  vtkIntArray *boundaryScalars;
+  int numTets;
+  int numPoints;
   vtkDoubleArray *errorMetricArray;
 
-  mesh->BuildLinks();
   numTets = mesh->GetNumberOfCells();
   numPoints = mesh->GetNumberOfPoints();
-  uPoints = mesh->GetPoints();
-  uTets = mesh->GetCells();
-
-  numSurfacePoints = surfaceMesh->GetNumberOfPoints();
-  numPolys = surfaceMesh->GetNumberOfPolys();
-  pPolys = surfaceMesh->GetPolys();
-  boundaryScalars = vtkIntArray::SafeDownCast(surfaceMesh->GetCellData()->GetArray("ModelFaceID"));
   errorMetricArray = vtkDoubleArray::SafeDownCast(mesh->GetPointData()->GetArray("errormetric"));
+  if (errorMetricArray == nullptr)
+  {
+    fprintf(stderr,"Array name 'errormetric' does not exist on the volume mesh\n");
+    return SV_ERROR;
+  }
 
   cout<<"Num Cells "<<numTets<<endl;
   cout<<"Num Points "<<numPoints<<endl;
@@ -335,23 +519,15 @@ int TGenUtils_ConvertVolumeToTetGen(vtkUnstructuredGrid *mesh,vtkPolyData *surfa
   inmesh->pointmtrlist = new REAL[numPoints*inmesh->numberofpointmtrs];
 
   cout<<"Converting to Adapt Points..."<<endl;
-  for (i = 0; i < numPoints; i++)
-  {
-    uPoints->GetPoint(i,tetPts);
-    inmesh->pointlist[i*3] = tetPts[0];
-    inmesh->pointlist[i*3+1] = tetPts[1];
-    inmesh->pointlist[i*3+2] = tetPts[2];
-    inmesh->pointmtrlist[i] = errorMetricArray->GetValue(i);
-  }
+  CopyPointCoordinates(mesh->GetPoints(),inmesh->pointlist);
+  std::copy(errorMetricArray->GetPointer(0),errorMetricArray->GetPointer(0)+numPoints,
+    inmesh->pointmtrlist);
 
   cout<<"Converting to Adapt Tets..."<<endl;
-  for (i=0,uTets->InitTraversal();uTets->GetNextCell(npts,pts);i++)
-  {
-    for (j = 0;j < npts;j++)
-    {
-      inmesh->tetrahedronlist[i*npts+j] = pts[j];
-    }
-  }
+  VolumeTetsFunctor tets;
+  tets.Mesh = mesh;
+  tets.Tets = inmesh->tetrahedronlist;
+  vtkSMPTools::For(0,numTets,tets);
 
   return SV_OK;
 }
@@ -366,157 +542,155 @@ int TGenUtils_ConvertVolumeToTetGen(vtkUnstructuredGrid *mesh,vtkPolyData *surfa
  * @param *outmesh tetgen structure for which the mesh is output
  * @param *volumemesh vtkPolyData on which to save the surface mesh
  * @param *surfacemesh vtkUnstructuredGrid on which to save the volume mesh
+ * @param releaseTetGenArrays if set, the volume mesh takes over the tetgen
+ * point and tetrahedron lists instead of copying them, and they are set to
+ * nullptr in outmesh
  * @return SV_OK if function completes properly
  */
 
-int TGenUtils_ConvertToVTK(tetgenio *outmesh,vtkUnstructuredGrid *volumemesh,vtkPolyData *surfacemesh,int *modelRegions,int getBoundary)
+int TGenUtils_ConvertToVTK(tetgenio *outmesh,vtkUnstructuredGrid *volumemesh,vtkPolyData *surfacemesh,int *modelRegions,int getBoundary,int releaseTetGenArrays)
 {
-  int modelId = 1;
-  int globalId = 1;
-  int count=0;
   int totRegions=0;
-  double tmp;
-  vtkIdType i, j;
-  vtkIdType vtkId;
-  vtkIdType npts = 0;
-  const vtkIdType *pts;
-
-  vtkIdType numPts,numPolys,numFaces;
-
-  vtkSmartPointer<vtkUnstructuredGrid> fullUGrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
-  vtkSmartPointer<vtkPolyData> fullPolyData = vtkSmartPointer<vtkPolyData>::New();
-
-  //Create pointers to vtk scalar lists, point lists, and element lists
-  vtkSmartPointer<vtkIdList> polyPointIds = vtkSmartPointer<vtkIdList>::New();
-  vtkSmartPointer<vtkIdList> facePointIds = vtkSmartPointer<vtkIdList>::New();
-
-  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-  vtkSmartPointer<vtkCellArray> faces = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkPoints> vtpPoints = vtkSmartPointer<vtkPoints>::New();
-
-  vtkSmartPointer<vtkIntArray> modelRegionIds = vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIntArray> globalNodeIds = vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIntArray> globalElementIds = vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIntArray> vtpNodeIds = vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIntArray> vtpFaceIds = vtkSmartPointer<vtkIntArray>::New();
-
-  vtkSmartPointer<vtkIntArray> boundaryScalars = vtkSmartPointer<vtkIntArray>::New();
+  vtkIdType i;
+  vtkIdType numPts,numTets,numFaces;
 
   //Get number of points, polys, and faces
   numPts = outmesh->numberofpoints;
-  numPolys = outmesh->numberoftetrahedra;
+  numTets = outmesh->numberoftetrahedra;
   numFaces = outmesh->numberoftrifaces;
 
-  bool *pointOnSurface = new bool[numPts];
-  int *pointMapping = new int[numPts];
-
-  //Save all point information in a vtkPoints list
-  //fprintf(stderr,"Converting Points to VTK Structures...\n");
-  points->SetNumberOfPoints(numPts);
-  for (i=0;i< outmesh->numberofpoints; i++)
+  //Wrap or copy the point list into a vtkPoints list
+  auto coords = vtkSmartPointer<vtkDoubleArray>::New();
+  coords->SetNumberOfComponents(3);
+  if (releaseTetGenArrays)
   {
-    points->SetPoint(i,outmesh->pointlist[i*3],outmesh->pointlist[i*3+1],outmesh->pointlist[i*3+2]);
-    globalNodeIds->InsertValue(i,globalId);
-    pointOnSurface[i] = false;
-    globalId++;
+    coords->SetArray(outmesh->pointlist,3*numPts,0,vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
+    outmesh->pointlist = nullptr;
   }
-
-  //Save all point information in a vtkPoints list
-  for (i=0;i<numFaces;i++)
-  {
-    for (j=0;j<3;j++)
-    {
-      if (pointOnSurface[outmesh->trifacelist[3*i+j]] == false)
-      {
-        pointOnSurface[outmesh->trifacelist[3*i+j]] = true;
-        pointMapping[outmesh->trifacelist[3*i+j]] = count++;
-      }
-    }
-  }
-
-  vtpPoints->SetNumberOfPoints(count);
-  //Create face point list
-  for (i=0;i<numPts;i++)
-  {
-    if (pointOnSurface[i] == true)
-    {
-      vtpPoints->SetPoint(pointMapping[i],outmesh->pointlist[i*3],outmesh->pointlist[i*3+1],outmesh->pointlist[i*3+2]);
-      vtpNodeIds->InsertValue(pointMapping[i],i+1);
-    }
-  }
-
-  //Save all element information in a vtkCellArray list
-  //fprintf(stderr,"Converting Elements to VTK Structures...\n");
-  polyPointIds->SetNumberOfIds(4);
-  globalId=1;
-  for (i=0;i< numPolys;i++)
+  else
   {
-    for (j=0; j< outmesh->numberofcorners;j++)
-    {
-      vtkId = outmesh->tetrahedronlist[i*outmesh->numberofcorners+j];
-      polyPointIds->SetId(j,vtkId);
-    }
-
-    if (outmesh->numberoftetrahedronattributes > 0)
-      modelRegionIds->InsertValue(i, outmesh->tetrahedronattributelist[i] + 1);
-    else
-      modelRegionIds->InsertValue(i,modelId);
+    coords->SetNumberOfTuples(numPts);
+    std::copy(outmesh->pointlist,outmesh->pointlist+3*numPts,coords->GetPointer(0));
+  }
+  auto points = vtkSmartPointer<vtkPoints>::New();
+  points->SetData(coords);
+
+  auto globalNodeIds = vtkSmartPointer<vtkIntArray>::New();
+  globalNodeIds->SetNumberOfValues(numPts);
+  GlobalIdsFunctor nodeIds;
+  nodeIds.Ids = globalNodeIds->GetPointer(0);
+  vtkSMPTools::For(0,numPts,nodeIds);
+
+  //Save all element information in a vtkCellArray list, 32-bit when the
+  //connectivity fits so that the tetgen list can be used directly
+  auto tets = vtkSmartPointer<vtkCellArray>::New();
+  auto modelRegionIds = vtkSmartPointer<vtkIntArray>::New();
+  modelRegionIds->SetNumberOfValues(numTets);
+  if (4*numTets <= VTK_TYPE_INT32_MAX)
+    SetTetCells<vtkTypeInt32Array>(outmesh,releaseTetGenArrays != 0,tets,modelRegionIds->GetPointer(0));
+  else
+    SetTetCells<vtkTypeInt64Array>(outmesh,releaseTetGenArrays != 0,tets,modelRegionIds->GetPointer(0));
 
-    globalElementIds->InsertValue(i,globalId);
-    globalId++;
-    polys->InsertNextCell(polyPointIds);
-  }
+  auto globalElementIds = vtkSmartPointer<vtkIntArray>::New();
+  globalElementIds->SetNumberOfValues(numTets);
+  GlobalIdsFunctor elementIds;
+  elementIds.Ids = globalElementIds->GetPointer(0);
+  vtkSMPTools::For(0,numTets,elementIds);
 
   //Create an unstructured grid and link scalar information to nodes and
   //elements
-  fullUGrid->SetPoints(points);
-  fullUGrid->SetCells(VTK_TETRA, polys);
+  volumemesh->Initialize();
+  volumemesh->SetPoints(points);
+  volumemesh->SetCells(VTK_TETRA, tets);
 
   modelRegionIds->SetName("ModelRegionID");
-  fullUGrid->GetCellData()->AddArray(modelRegionIds);
-  fullUGrid->GetCellData()->SetActiveScalars("ModelRegionID");
+  volumemesh->GetCellData()->AddArray(modelRegionIds);
+  volumemesh->GetCellData()->SetActiveScalars("ModelRegionID");
 
   globalNodeIds->SetName("GlobalNodeID");
-  fullUGrid->GetPointData()->AddArray(globalNodeIds);
+  volumemesh->GetPointData()->AddArray(globalNodeIds);
 
   globalElementIds->SetName("GlobalElementID");
-  fullUGrid->GetCellData()->AddArray(globalElementIds);
+  volumemesh->GetCellData()->AddArray(globalElementIds);
 
-  //Save all external faces to a vtkCellArray list
-  //fprintf(stdout,"Converting Faces to VTK Structures...\n");
-  facePointIds->SetNumberOfIds(3);
-
-  for (i=0;i< numFaces;i++)
+  //Number the surface points in the order they are first used by the
+  //boundary faces
+  std::vector<int> pointMapping(numPts,-1);
+  std::vector<int> surfacePoints;
+  for (i=0;i<3*numFaces;i++)
   {
-    for (j=0; j<3;j++)
+    int ptId = outmesh->trifacelist[i];
+    if (pointMapping[ptId] < 0)
     {
-      facePointIds->SetId(j,pointMapping[outmesh->trifacelist[i*3+j]]);
+      pointMapping[ptId] = surfacePoints.size();
+      surfacePoints.push_back(ptId);
     }
+  }
+  vtkIdType numSurfacePts = surfacePoints.size();
 
-    faces->InsertNextCell(facePointIds);
+  auto surfaceCoords = vtkSmartPointer<vtkDoubleArray>::New();
+  surfaceCoords->SetNumberOfComponents(3);
+  surfaceCoords->SetNumberOfTuples(numSurfacePts);
+  auto vtpNodeIds = vtkSmartPointer<vtkIntArray>::New();
+  vtpNodeIds->SetNumberOfValues(numSurfacePts);
 
-    if (!(outmesh->adjtetlist[2*i] >= numPolys || outmesh->adjtetlist[2*i] < 0))
+  SurfacePointsFunctor surfacePointsFunctor;
+  surfacePointsFunctor.Points = coords->GetPointer(0);
+  surfacePointsFunctor.SurfacePoints = surfacePoints.data();
+  surfacePointsFunctor.SurfaceCoords = surfaceCoords->GetPointer(0);
+  surfacePointsFunctor.NodeIds = vtpNodeIds->GetPointer(0);
+  vtkSMPTools::For(0,numSurfacePts,surfacePointsFunctor);
+
+  auto vtpPoints = vtkSmartPointer<vtkPoints>::New();
+  vtpPoints->SetData(surfaceCoords);
+
+  //Save all external faces to a vtkCellArray list
+  auto faceOffsets = vtkSmartPointer<vtkIdTypeArray>::New();
+  auto faceConnectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+  faceOffsets->SetNumberOfValues(numFaces+1);
+  faceOffsets->SetValue(0,0);
+  faceConnectivity->SetNumberOfValues(3*numFaces);
+
+  SurfaceFacesFunctor surfaceFacesFunctor;
+  surfaceFacesFunctor.Faces = outmesh->trifacelist;
+  surfaceFacesFunctor.PointMapping = pointMapping.data();
+  surfaceFacesFunctor.Offsets = faceOffsets->GetPointer(0);
+  surfaceFacesFunctor.Connectivity = faceConnectivity->GetPointer(0);
+  vtkSMPTools::For(0,numFaces,surfaceFacesFunctor);
+
+  auto faces = vtkSmartPointer<vtkCellArray>::New();
+  faces->SetData(faceOffsets,faceConnectivity);
+
+  //Global element id of the tetrahedron adjacent to each face
+  auto vtpFaceIds = vtkSmartPointer<vtkIntArray>::New();
+  vtpFaceIds->SetNumberOfValues(numFaces);
+  auto boundaryScalars = vtkSmartPointer<vtkIntArray>::New();
+  bool hasMarkers = getBoundary && outmesh->trifacemarkerlist != nullptr;
+  if (hasMarkers)
+    boundaryScalars->SetNumberOfValues(numFaces);
+
+  for (i=0;i< numFaces;i++)
+  {
+    int adjTet0 = outmesh->adjtetlist[2*i];
+    int adjTet1 = outmesh->adjtetlist[2*i+1];
+    if (adjTet0 >= 0 && adjTet0 < numTets)
     {
-      vtpFaceIds->InsertValue(i,globalElementIds->GetValue(outmesh->adjtetlist[2*i]));
+      vtpFaceIds->SetValue(i,adjTet0+1);
     }
-    else if (!(outmesh->adjtetlist[2*i+1] >= numPolys || outmesh->adjtetlist[2*i+1] < 0))
+    else if (adjTet1 >= 0 && adjTet1 < numTets)
     {
-      vtpFaceIds->InsertValue(i,globalElementIds->GetValue(outmesh->adjtetlist[2*i+1]));
+      vtpFaceIds->SetValue(i,adjTet1+1);
     }
     else
     {
       fprintf(stderr,"WARNING: TetGen says face has no adjacent tetrahedron\n");
-      vtpFaceIds->InsertValue(i,globalElementIds->GetValue(outmesh->adjtetlist[2*i+1]));
+      vtpFaceIds->SetValue(i,adjTet1+1);
     }
 
-    if (getBoundary)
+    if (hasMarkers)
     {
-      if (outmesh->trifacemarkerlist != nullptr)
-      {
-        boundaryScalars->InsertValue(i,outmesh->trifacemarkerlist[i]);
-      }
-      if (boundaryScalars->GetValue(i)>totRegions)
+      boundaryScalars->SetValue(i,outmesh->trifacemarkerlist[i]);
+      if (outmesh->trifacemarkerlist[i] > totRegions)
       {
         totRegions = outmesh->trifacemarkerlist[i];
       }
@@ -524,46 +698,27 @@ int TGenUtils_ConvertToVTK(tetgenio *outmesh,vtkUnstructuredGrid *volumemesh,vtk
   }
 
   //Create a polydata grid and link scalar information to nodes and elements
-  fullPolyData->SetPoints(vtpPoints);
-  fullPolyData->SetPolys(faces);
-  fullPolyData->BuildCells();
+  surfacemesh->Initialize();
+  surfacemesh->SetPoints(vtpPoints);
+  surfacemesh->SetPolys(faces);
 
   vtpNodeIds->SetName("GlobalNodeID");
-  fullPolyData->GetPointData()->AddArray(vtpNodeIds);
-  fullPolyData->GetPointData()->SetActiveScalars("GlobalNodeID");
+  surfacemesh->GetPointData()->AddArray(vtpNodeIds);
+  surfacemesh->GetPointData()->SetActiveScalars("GlobalNodeID");
 
   vtpFaceIds->SetName("GlobalElementID");
-  fullPolyData->GetCellData()->AddArray(vtpFaceIds);
-  fullPolyData->GetCellData()->SetActiveScalars("GlobalElementID");
+  surfacemesh->GetCellData()->AddArray(vtpFaceIds);
+  surfacemesh->GetCellData()->SetActiveScalars("GlobalElementID");
 
   if (getBoundary)
   {
     boundaryScalars->SetName("ModelFaceID");
-    fullPolyData->GetCellData()->AddArray(boundaryScalars);
-    fullPolyData->GetCellData()->SetActiveScalars("ModelFaceID");
+    surfacemesh->GetCellData()->AddArray(boundaryScalars);
+    surfacemesh->GetCellData()->SetActiveScalars("ModelFaceID");
 
     *modelRegions = totRegions;
   }
 
-//  //Flip the cells on the polydata for presolver
-  for (i=0;i<fullPolyData->GetNumberOfCells();i++)
-  {
-    fullPolyData->GetCellPoints(i,npts,pts);
-
-    // // this could fail if pts has more than 2 components?
-    const vtkIdType pts_[3] = {pts[1], pts[0], pts[2]};
-    // tmp = pts[0];
-    // pts[0] = pts[1];
-    // pts[1] = tmp;
-    fullPolyData->ReplaceCell(i,npts,pts);
-  }
-
-  delete [] pointMapping;
-  delete [] pointOnSurface;
-
-  surfacemesh->DeepCopy(fullPolyData);
-  volumemesh->DeepCopy(fullUGrid);
-
   return SV_OK;
 }
 
@@ -1285,37 +1440,11 @@ int TGenUtils_ResetOriginalRegions(vtkPolyData *newgeom,
     vtkPolyData *originalgeom,
     std::string regionName)
 {
-  int i,j,k;
-  int subId;
-  int maxIndex;
-  int temp;
-  int flag = 1;
-  int count;
-  int bigcount;
-  vtkIdType npts;
-  const vtkIdType *pts;
-  double distance;
-  double closestPt[3];
-  double tolerance = 1.0;
-  double centroid[3];
-  int range;
-  vtkIdType closestCell;
-  vtkIdType cellId;
-  vtkIdType currentValue;
-  vtkIdType realValue;
-  vtkSmartPointer<vtkCellLocator> locator =
-    vtkSmartPointer<vtkCellLocator>::New();
-  vtkSmartPointer<vtkGenericCell> genericCell =
-    vtkSmartPointer<vtkGenericCell>::New();
   vtkSmartPointer<vtkIntArray> currentRegions =
     vtkSmartPointer<vtkIntArray>::New();
-  vtkSmartPointer<vtkIntArray> realRegions =
-    vtkSmartPointer<vtkIntArray>::New();
 
   newgeom->BuildLinks();
   originalgeom->BuildLinks();
-  locator->SetDataSet(originalgeom);
-  locator->BuildLocator();
 
   if (VtkUtils_PDCheckArrayName(originalgeom,1,regionName) != SV_OK)
   {
@@ -1324,25 +1453,11 @@ int TGenUtils_ResetOriginalRegions(vtkPolyData *newgeom,
     return SV_ERROR;
   }
 
-  realRegions = static_cast<vtkIntArray*>(originalgeom->GetCellData()->GetScalars(regionName.c_str()));
-
+  vtkDataArray *realRegions = originalgeom->GetCellData()->GetScalars(regionName.c_str());
 
-  for (cellId=0;cellId<newgeom->GetNumberOfCells();cellId++)
+  if (VtkUtils_TransferCellLabels(originalgeom, realRegions, newgeom, currentRegions) != SV_OK)
   {
-      newgeom->GetCellPoints(cellId,npts,pts);
-      //int eachValue[npts];
-      vtkSmartPointer<vtkPoints> polyPts = vtkSmartPointer<vtkPoints>::New();
-      vtkSmartPointer<vtkIdTypeArray> polyPtIds = vtkSmartPointer<vtkIdTypeArray>::New();
-      for (i=0;i<npts;i++)
-      {
-	polyPtIds->InsertValue(i,i);
-	polyPts->InsertNextPoint(newgeom->GetPoint(pts[i]));
-      }
-      vtkPolygon::ComputeCentroid(polyPtIds,polyPts,centroid);
-
-      locator->FindClosestPoint(centroid,closestPt,genericCell,closestCell,
-	  subId,distance);
-      currentRegions->InsertValue(cellId,realRegions->GetValue(closestCell));
+    return SV_ERROR;
   }
 
   newgeom->GetCellData()->RemoveArray(regionName.c_str());
@@ -1359,28 +1474,7 @@ int TGenUtils_ResetOriginalRegions(vtkPolyData *newgeom,
     std::string regionName,
     vtkIdList *excludeList)
 {
-  int i,j,k;
-  int subId;
   int region;
-  int temp;
-  int flag = 1;
-  int count;
-  int bigcount;
-  vtkIdType npts;
-  const vtkIdType *pts;
-  double distance;
-  double closestPt[3];
-  double tolerance = 1.0;
-  double centroid[3];
-  int range;
-  vtkIdType closestCell;
-  vtkIdType cellId;
-  vtkIdType currentValue;
-  vtkIdType realValue;
-  vtkSmartPointer<vtkCellLocator> locator =
-    vtkSmartPointer<vtkCellLocator>::New();
-  vtkSmartPointer<vtkGenericCell> genericCell =
-    vtkSmartPointer<vtkGenericCell>::New();
   vtkSmartPointer<vtkPolyData> originalCopy =
     vtkSmartPointer<vtkPolyData>::New();
 
@@ -1431,31 +1525,12 @@ int TGenUtils_ResetOriginalRegions(vtkPolyData *newgeom,
     originalCopy->DeepCopy(cleaner->GetOutput());
     originalCopy->BuildLinks();
 
-  locator->SetDataSet(originalCopy);
-  locator->BuildLocator();
   vtkDataArray *realRegions = originalCopy->GetCellData()->GetScalars( regionName.c_str());
 
-  for (cellId=0;cellId<newgeom->GetNumberOfCells();cellId++)
+  if (VtkUtils_TransferCellLabels(originalCopy, realRegions, newgeom, currentRegions,
+                                  VTKUTILS_TRANSFER_EXCLUDE, excludeList) != SV_OK)
   {
-    currentValue = currentRegions->GetTuple1(cellId);
-    if (excludeList->IsId(currentValue) != -1)
-    {
-      continue;
-    }
-
-    newgeom->GetCellPoints(cellId,npts,pts);
-    vtkSmartPointer<vtkPoints> polyPts = vtkSmartPointer<vtkPoints>::New();
-    vtkSmartPointer<vtkIdTypeArray> polyPtIds = vtkSmartPointer<vtkIdTypeArray>::New();
-    for (i=0;i<npts;i++)
-    {
-      polyPtIds->InsertValue(i,i);
-      polyPts->InsertNextPoint(newgeom->GetPoint(pts[i]));
-    }
-    vtkPolygon::ComputeCentroid(polyPtIds,polyPts,centroid);
-
-    locator->FindClosestPoint(centroid,closestPt,genericCell,closestCell,
-	subId,distance);
-    currentRegions->SetTuple1(cellId,realRegions->GetTuple1(closestCell));
+    return SV_ERROR;
   }
 
   newgeom->GetCellData()->SetActiveScalars(regionName.c_str());
@@ -1469,28 +1544,6 @@ int TGenUtils_ResetOriginalRegions(vtkPolyData *newgeom,
     vtkIdList *onlyList,
     int dummy)
 {
-  int i,j,k;
-  int subId;
-  int region;
-  int temp;
-  int flag = 1;
-  int count;
-  int bigcount;
-  vtkIdType npts;
-  const vtkIdType *pts;
-  double distance;
-  double closestPt[3];
-  double tolerance = 1.0;
-  double centroid[3];
-  int range;
-  vtkIdType closestCell;
-  vtkIdType cellId;
-  vtkIdType currentValue;
-  vtkIdType realValue;
-  vtkSmartPointer<vtkCellLocator> locator =
-    vtkSmartPointer<vtkCellLocator>::New();
-  vtkSmartPointer<vtkGenericCell> genericCell =
-    vtkSmartPointer<vtkGenericCell>::New();
   vtkSmartPointer<vtkPolyData> originalCopy =
     vtkSmartPointer<vtkPolyData>::New();
 
@@ -1522,31 +1575,12 @@ int TGenUtils_ResetOriginalRegions(vtkPolyData *newgeom,
 
   vtkDataArray *currentRegions = newgeom->GetCellData()->GetArray(regionName.c_str());
 
-  locator->SetDataSet(originalCopy);
-  locator->BuildLocator();
   vtkDataArray *realRegions = originalCopy->GetCellData()->GetScalars( regionName.c_str());
 
-  for (cellId=0;cellId<newgeom->GetNumberOfCells();cellId++)
+  if (VtkUtils_TransferCellLabels(originalCopy, realRegions, newgeom, currentRegions,
+                                  VTKUTILS_TRANSFER_ONLY, onlyList) != SV_OK)
   {
-    currentValue = currentRegions->GetTuple1(cellId);
-    if (onlyList->IsId(currentValue) == -1)
-    {
-      continue;
-    }
-
-    newgeom->GetCellPoints(cellId,npts,pts);
-    vtkSmartPointer<vtkPoints> polyPts = vtkSmartPointer<vtkPoints>::New();
-    vtkSmartPointer<vtkIdTypeArray> polyPtIds = vtkSmartPointer<vtkIdTypeArray>::New();
-    for (i=0;i<npts;i++)
-    {
-      polyPtIds->InsertValue(i,i);
-      polyPts->InsertNextPoint(newgeom->GetPoint(pts[i]));
-    }
-    vtkPolygon::ComputeCentroid(polyPtIds,polyPts,centroid);
-
-    locator->FindClosestPoint(centroid,closestPt,genericCell,closestCell,
-	subId,distance);
-    currentRegions->SetTuple1(cellId,realRegions->GetTuple1(closestCell));
+    return SV_ERROR;
   }
 
   newgeom->GetCellData()->SetActiveScalars(regionName.c_str());
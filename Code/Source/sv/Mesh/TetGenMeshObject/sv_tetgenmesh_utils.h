@@ -72,7 +72,7 @@ SV_EXPORT_TETGEN_MESH int TGenUtils_ConvertVolumeToTetGen(vtkUnstructuredGrid *m
     vtkPolyData *surfaceMesh,tetgenio *inmesh);
 
 SV_EXPORT_TETGEN_MESH int TGenUtils_ConvertToVTK(tetgenio *outmesh,vtkUnstructuredGrid *volumemesh,
-    vtkPolyData *surfacemesh,int *totRegions,int getBoundary);
+    vtkPolyData *surfacemesh,int *totRegions,int getBoundary,int releaseTetGenArrays = 0);
 
 SV_EXPORT_TETGEN_MESH int TGenUtils_GetFacePolyData(int id,vtkPolyData *mesh, vtkPolyData *face);
 
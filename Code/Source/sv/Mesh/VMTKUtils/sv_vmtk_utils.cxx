@@ -56,8 +56,13 @@
 #include "vtkDataSetSurfaceFilter.h"
 #include "vtkGeometryFilter.h"
 #include "vtkCellArray.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkSVFillHolesWithIdsFilter.h"
-#include <vtkMeshQuality.h>
+#include "vtkSVVoronoiCache.h"
+#include <vtkMergePoints.h>
+
+#include <algorithm>
+#include <vector>
 
 #include <vtkXMLPolyDataWriter.h>
 #include <vtkXMLUnstructuredGridWriter.h>
@@ -68,7 +73,6 @@
 #include "vtkvmtkSurfaceProjection.h"
 #include "vtkvmtkCapPolyData.h"
 #include "vtkvmtkSimpleCapPolyData.h"
-#include "vtkvmtkAppendFilter.h"
 #include "vtkvmtkBoundaryLayerGenerator.h"
 #include "sv_polydatasolid_utils.h"
 #include "vtkvmtkPolyDataDistanceToCenterlines.h"
@@ -138,8 +142,24 @@ int sys_geom_centerlines( cvPolyData *polydata, int *sources, int nsources, int
     centerLiner->SetSimplifyVoronoi(0);
     centerLiner->SetCenterlineResampling(0);
     centerLiner->SetResamplingStepLength(1);
+
+    // The tessellation only depends on the surface, reuse it when the
+    // centerlines of the same model are extracted again
+    std::string cacheKey = vtkSVVoronoiCache::ComputeKey(geom, centerLiner->GetDelaunayTolerance(),
+      0, nullptr, 0, "MaximumInscribedSphereRadius");
+    vtkNew(vtkUnstructuredGrid, cachedDelaunay);
+    int cached = vtkSVVoronoiCache::Find(cacheKey, cachedDelaunay, nullptr, nullptr);
+    if (cached) {
+      centerLiner->SetDelaunayTessellation(cachedDelaunay);
+      centerLiner->GenerateDelaunayTessellationOff();
+    }
+
     centerLiner->Update();
 
+    if (!cached) {
+      vtkSVVoronoiCache::Insert(cacheKey, centerLiner->GetDelaunayTessellation(), nullptr, nullptr);
+    }
+
     result1 = new cvPolyData( centerLiner->GetOutput() );
     *lines = result1;
     result2 = new cvPolyData( centerLiner->GetVoronoiDiagram() );
@@ -1231,16 +1251,14 @@ int VMTKUtils_AppendData(vtkUnstructuredGrid *meshFromTetGen, vtkUnstructuredGri
 
   // Mesh the 'boundaryMesh' mesh with tetrahedra.
   //
+  // The filter output is shared rather than copied so the wedge mesh
+  // is released as soon as the filter goes away.
+  //
   auto tetrahedralizer = vtkSmartPointer<vtkvmtkUnstructuredGridTetraFilter>::New();
   tetrahedralizer->SetInputData(boundaryMesh);
   tetrahedralizer->Update();
-  boundaryMesh->DeepCopy(tetrahedralizer->GetOutput());
-
-  // The tet elements created for the boundary layer using 
-  // vtkvmtkUnstructuredGridTetraFilter have incorrect node 
-  // ordering (generate negative Jacobians) so modify their
-  // node ordering.
-  VMTKUtils_ReorderTetElements(boundaryMesh);
+  boundaryMesh->ShallowCopy(tetrahedralizer->GetOutput());
+  tetrahedralizer = nullptr;
 
   // Get model regions on tetgen mesh
   auto meshFromTetGenRegionIds = meshFromTetGen->GetCellData()->GetArray("ModelRegionID");
@@ -1284,53 +1302,40 @@ int VMTKUtils_AppendData(vtkUnstructuredGrid *meshFromTetGen, vtkUnstructuredGri
   boundaryMeshRegionIds->SetName("ModelRegionID");
   boundaryMesh->GetCellData()->AddArray(boundaryMeshRegionIds);
 
-  // Create the boundary layer voume, surface and cap meshes.
+  // Create the boundary layer surface and cap meshes. The boundary
+  // layer volume is only extracted when it is kept as its own region,
+  // otherwise its cells are written straight into 'newMeshVolume'.
   //
   auto boundaryMeshSurface = vtkSmartPointer<vtkPolyData>::New();
   auto surfaceMeshCaps = vtkSmartPointer<vtkPolyData>::New();
-  auto boundaryMeshVolume = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkSmartPointer<vtkUnstructuredGrid> boundaryMeshVolume;
+  if (newRegionBoundaryLayer) {
+    boundaryMeshVolume = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  }
   VMTKUtils_CreateBoundaryLayerSurfaceAndCaps(boundaryMesh, modelId, surfaceWithSize, boundaryMeshSurface, surfaceMeshCaps, boundaryMeshVolume);
 
   // Define the inner and outer boundary layer as two separate regions. 
   // This is used for FSI to define the outer boundary layer as a solid. 
   //
   if (newRegionBoundaryLayer) {
+    // The tet elements created for the boundary layer using 
+    // vtkvmtkUnstructuredGridTetraFilter have incorrect node 
+    // ordering (generate negative Jacobians) so modify their
+    // node ordering.
+    VMTKUtils_ReorderTetElements(boundaryMeshVolume);
+
     VMTKUtils_CreateNewBoundaryLayerRegion(meshFromTetGen, surfaceWithSize, newMeshVolume, newMeshSurface, boundaryMeshVolume, 
       boundaryMeshSurface);
 
   } else {
 
-    // Combine boundary layer and interior meshes into 'newMeshVolume'. 
-    //
-    auto appender = vtkSmartPointer<vtkvmtkAppendFilter>::New();
-    appender->AddInputData(boundaryMeshVolume);
-    appender->AddInputData(meshFromTetGen);
-    appender->Update();
-    newMeshVolume->DeepCopy(appender->GetOutput());
-
-    // Add global node IDs to 'newMeshVolume'.
-    //
-    auto globalNodeIds0 = vtkSmartPointer<vtkIntArray>::New();
-    globalNodeIds0->SetNumberOfTuples(newMeshVolume->GetNumberOfPoints());
-    globalNodeIds0->SetName("GlobalNodeID");
-    int globalId = 1;
-    for (int i = 0; i  < newMeshVolume->GetNumberOfPoints(); i++) {
-      globalNodeIds0->SetTuple1(i,globalId);
-      globalId++;
-    }
-    newMeshVolume->GetPointData()->AddArray(globalNodeIds0);
-
-    // Add global element IDs to 'newMeshVolume'.
+    // Combine boundary layer and interior meshes into 'newMeshVolume'
+    // with correctly ordered tets and region, node and element IDs.
     //
-    auto globalElementIds0 = vtkSmartPointer<vtkIntArray>::New();
-    globalElementIds0->SetNumberOfTuples(newMeshVolume->GetNumberOfCells());
-    globalElementIds0->SetName("GlobalElementID");
-    globalId = 1;
-    for (int i = 0; i < newMeshVolume->GetNumberOfCells();i++) {
-      globalElementIds0->SetTuple1(i,globalId);
-      globalId++;
+    if (VMTKUtils_AssembleVolumeMesh(boundaryMesh, modelId, meshFromTetGen, newMeshVolume) != SV_OK) {
+      fprintf(stderr,"Failure in combining boundary layer and interior meshes\n");
+      return SV_ERROR;
     }
-    newMeshVolume->GetCellData()->AddArray(globalElementIds0);
 
     // Create 'newMeshSurface' surface for combined boundary layer and interior meshes.
     //
@@ -1609,8 +1614,10 @@ int VMTKUtils_CreateBoundaryLayerSurfaceAndCaps(vtkUnstructuredGrid* boundaryMes
   thresholder->Update();
   boundaryMeshVolume->DeepCopy(thresholder->GetOutput());
   */
-  auto threshold_volume = VtkUtils_ThresholdUgrid(0.0, 0.0, "isSurface", boundaryMesh);
-  boundaryMeshVolume->DeepCopy(threshold_volume);
+  if (boundaryMeshVolume != nullptr) {
+    auto threshold_volume = VtkUtils_ThresholdUgrid(0.0, 0.0, "isSurface", boundaryMesh);
+    boundaryMeshVolume->DeepCopy(threshold_volume);
+  }
 
   // Create boundary layer mesh caps from cells with 'WallID' array value 0. 
   //
@@ -1629,8 +1636,10 @@ int VMTKUtils_CreateBoundaryLayerSurfaceAndCaps(vtkUnstructuredGrid* boundaryMes
   auto threshold_caps = VtkUtils_ThresholdSurface(0.0, 0.0, "WallID", surfaceWithSize);
   surfaceMeshCaps->DeepCopy(threshold_caps);
 
+  #ifdef debug_VMTKUtils_CreateBoundaryLayerSurfaceAndCaps
   VtkUtils_write_vtu(surfaceWithSize, "VMTKUtils_CreateBoundaryLayerSurfaceAndCaps_surfaceWithSize.vtu");
   VtkUtils_write_vtp(surfaceMeshCaps, "VMTKUtils_CreateBoundaryLayerSurfaceAndCaps_surfaceMeshCaps.vtp");
+  #endif
 
   // Set the values of the 'ModelFaceID' array for the caps to 9999(?). 
   //
@@ -1654,6 +1663,29 @@ int VMTKUtils_CreateBoundaryLayerSurfaceAndCaps(vtkUnstructuredGrid* boundaryMes
   return SV_OK;
 }
 
+//----------------------
+// TetElementIsInverted
+//----------------------
+// Return true if the tet with points 'pts' has a negative volume.
+//
+static bool TetElementIsInverted(vtkPoints* points, const vtkIdType* pts)
+{
+  double p0[3], p1[3], p2[3], p3[3];
+  points->GetPoint(pts[0], p0);
+  points->GetPoint(pts[1], p1);
+  points->GetPoint(pts[2], p2);
+  points->GetPoint(pts[3], p3);
+
+  double e1[3], e2[3], e3[3], n[3];
+  for (int i = 0; i < 3; i++) {
+    e1[i] = p1[i] - p0[i];
+    e2[i] = p2[i] - p0[i];
+    e3[i] = p3[i] - p0[i];
+  }
+  vtkMath::Cross(e1, e2, n);
+  return vtkMath::Dot(n, e3) < 0.0;
+}
+
 //------------------------------
 // VMTKUtils_ReorderTetElements
 //------------------------------
@@ -1663,8 +1695,8 @@ int VMTKUtils_CreateBoundaryLayerSurfaceAndCaps(vtkUnstructuredGrid* boundaryMes
 // because the tet element node ordering is incorrect.
 //
 // It is likely that all elements in an extruded boundary layer mesh will be tets
-// and need to be reordered but just in case make a list of tet elements with negative 
-// volume and only reorder those.
+// and need to be reordered but just in case only reorder the tet elements with
+// negative volume.
 //
 // This function is called for any boundary layer mesh, extruded inward or not, so there
 // may be no elements that need to be reordered.
@@ -1673,71 +1705,182 @@ void VMTKUtils_ReorderTetElements(vtkUnstructuredGrid* boundaryLayerMesh)
 {
   vtkIdType numCells = boundaryLayerMesh->GetNumberOfCells();
   vtkCellArray* cells = boundaryLayerMesh->GetCells();
-  vtkUnsignedCharArray* cellTypes = boundaryLayerMesh->GetCellTypesArray();
+  vtkPoints* points = boundaryLayerMesh->GetPoints();
 
-  // Check element volumes.
+  // Swapping the 1st and 2nd nodes is sufficient to create a proper node ordering.
   //
-  vtkGenericCell* cell = vtkGenericCell::New();
-  vtkSmartPointer<vtkMeshQuality> qualityFilter = vtkSmartPointer<vtkMeshQuality>::New();
-  qualityFilter->SetInputData(boundaryLayerMesh);
-  qualityFilter->SetTetQualityMeasureToVolume();
-  qualityFilter->Update();
+  vtkIdType npts;
+  const vtkIdType* pts;
+  vtkIdType ids[4];
 
-  // Get the element volumes.
-  //
-  vtkDataSet* qualityMesh = qualityFilter->GetOutput();
-  vtkSmartPointer<vtkDoubleArray> qualityArray =
-      vtkDoubleArray::SafeDownCast(qualityMesh->GetCellData()->GetArray("Quality"));
-
-  // Store element IDs that have volume < 0. Need to also 
-  // store the location of element connectivity 'loc'. 
-  // 
-  std::vector<vtkIdType> negVolElements;
-  std::vector<vtkIdType> connLoc;
-  vtkIdType loc = 0;
-
-  for(vtkIdType i = 0; i < qualityArray->GetNumberOfTuples(); i++) {
-    boundaryLayerMesh->GetCell(i, cell);
-    auto numPts = cell->GetNumberOfPoints();
-
-    if ((cellTypes->GetValue(i) == VTK_TETRA) && (qualityArray->GetValue(i) < 0.0)) {
-      negVolElements.push_back(i);
-      connLoc.push_back(loc);
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++) {
+    if (boundaryLayerMesh->GetCellType(cellId) != VTK_TETRA) {
+      continue;
     }
-
-  loc += numPts + 1;
+    cells->GetCellAtId(cellId, npts, pts);
+    if (!TetElementIsInverted(points, pts)) {
+      continue;
+    }
+    ids[0] = pts[1];
+    ids[1] = pts[0];
+    ids[2] = pts[2];
+    ids[3] = pts[3];
+    cells->ReplaceCellAtId(cellId, 4, ids);
   }
+}
 
-  if (negVolElements.size() == 0) {
-    return;
+//------------------------------
+// VMTKUtils_AssembleVolumeMesh
+//------------------------------
+// Combine the volume cells of a tetrahedralized boundary layer mesh with
+// an interior volume mesh in one pass.
+//
+// The points and cells of both meshes are written into preallocated
+// arrays of 'newMeshVolume'. Boundary layer tets with a negative volume
+// have their first two nodes swapped as they are written. Points on the
+// interface between the two meshes are merged. The 'ModelRegionID',
+// 'GlobalElementID' and 'GlobalNodeID' arrays are filled in the same sweep.
+//
+// The points and cells are in the same order as thresholding the boundary
+// layer volume and appending it with vtkvmtkAppendFilter.
+//
+// Arguments:
+//   boundaryMesh - Tetrahedralized boundary layer mesh. Its triangle and
+//     quad cells are skipped.
+//   boundaryRegionId - 'ModelRegionID' of the boundary layer cells.
+//   meshFromTetGen - Interior mesh created by TetGen.
+//   newMeshVolume - Combined volume mesh.
+//
+int VMTKUtils_AssembleVolumeMesh(vtkUnstructuredGrid *boundaryMesh, int boundaryRegionId,
+                                 vtkUnstructuredGrid *meshFromTetGen, vtkUnstructuredGrid *newMeshVolume)
+{
+  auto tetGenRegionIds = meshFromTetGen->GetCellData()->GetArray("ModelRegionID");
+  if (tetGenRegionIds == nullptr) {
+    fprintf(stderr,"No model region id on tetgen mesh\n");
+    return SV_ERROR;
   }
 
-  // Reorder the nodes of tet elements.
+  vtkIdType numBoundaryPts = boundaryMesh->GetNumberOfPoints();
+  vtkIdType numBoundaryCells = boundaryMesh->GetNumberOfCells();
+  vtkIdType numTetGenPts = meshFromTetGen->GetNumberOfPoints();
+  vtkIdType numTetGenCells = meshFromTetGen->GetNumberOfCells();
+  vtkPoints* boundaryPoints = boundaryMesh->GetPoints();
+  vtkCellArray* boundaryCells = boundaryMesh->GetCells();
+  vtkCellArray* tetGenCells = meshFromTetGen->GetCells();
+
+  // Size the output from the boundary layer volume cells and the tetgen mesh.
   //
-  // Swapping the 1st and 2nd nodes is sufficient to create a proper node ordering.
+  vtkIdType numCells = numTetGenCells;
+  vtkIdType connSize = tetGenCells->GetNumberOfConnectivityIds();
+  vtkIdType npts;
+  const vtkIdType* pts;
+
+  for (vtkIdType cellId = 0; cellId < numBoundaryCells; cellId++) {
+    int cellType = boundaryMesh->GetCellType(cellId);
+    if ((cellType == VTK_TRIANGLE) || (cellType == VTK_QUAD)) {
+      continue;
+    }
+    boundaryCells->GetCellAtId(cellId, npts, pts);
+    numCells++;
+    connSize += npts;
+  }
+
+  double bounds[6], tetGenBounds[6];
+  boundaryMesh->GetBounds(bounds);
+  meshFromTetGen->GetBounds(tetGenBounds);
+  for (int i = 0; i < 6; i += 2) {
+    bounds[i] = std::min(bounds[i], tetGenBounds[i]);
+    bounds[i+1] = std::max(bounds[i+1], tetGenBounds[i+1]);
+  }
+
+  auto newPoints = vtkSmartPointer<vtkPoints>::New();
+  newPoints->Allocate(numBoundaryPts + numTetGenPts);
+  auto merger = vtkSmartPointer<vtkMergePoints>::New();
+  merger->InitPointInsertion(newPoints, bounds, numBoundaryPts + numTetGenPts);
+
+  auto newCells = vtkSmartPointer<vtkCellArray>::New();
+  newCells->AllocateExact(numCells, connSize);
+  auto newCellTypes = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  newCellTypes->SetNumberOfTuples(numCells);
+
+  auto regionIds = vtkSmartPointer<vtkIntArray>::New();
+  regionIds->SetName("ModelRegionID");
+  regionIds->SetNumberOfTuples(numCells);
+  auto globalElementIds = vtkSmartPointer<vtkIntArray>::New();
+  globalElementIds->SetName("GlobalElementID");
+  globalElementIds->SetNumberOfTuples(numCells);
+
+  // Write the boundary layer volume cells, adding their points in the
+  // order they are first used.
   //
-  //std::cout << "Reorder the nodes of boundary layer tet elements ..." << std::endl;
-  vtkIdType ids[4];
-  vtkIdType id0;
+  std::vector<vtkIdType> pointMap(numBoundaryPts, -1);
+  std::vector<vtkIdType> ids;
+  double pt[3];
+  vtkIdType newCellId = 0;
+
+  for (vtkIdType cellId = 0; cellId < numBoundaryCells; cellId++) {
+    int cellType = boundaryMesh->GetCellType(cellId);
+    if ((cellType == VTK_TRIANGLE) || (cellType == VTK_QUAD)) {
+      continue;
+    }
+    boundaryCells->GetCellAtId(cellId, npts, pts);
+    ids.resize(npts);
+    for (vtkIdType i = 0; i < npts; i++) {
+      if (pointMap[pts[i]] < 0) {
+        boundaryPoints->GetPoint(pts[i], pt);
+        merger->InsertUniquePoint(pt, pointMap[pts[i]]);
+      }
+      ids[i] = pointMap[pts[i]];
+    }
+    if ((cellType == VTK_TETRA) && TetElementIsInverted(boundaryPoints, pts)) {
+      std::swap(ids[0], ids[1]);
+    }
+    newCells->InsertNextCell(npts, ids.data());
+    newCellTypes->SetValue(newCellId, cellType);
+    regionIds->SetValue(newCellId, boundaryRegionId);
+    globalElementIds->SetValue(newCellId, newCellId+1);
+    newCellId++;
+  }
 
-  for (auto i = 0; i < negVolElements.size(); ++i) { 
-    auto cellId = negVolElements[i];
-    loc = connLoc[i];
-    boundaryLayerMesh->GetCell(cellId, cell);
-    auto numPts = cell->GetNumberOfPoints();
+  // Write the interior cells, merging the points on the interface.
+  //
+  pointMap.assign(numTetGenPts, -1);
+  for (vtkIdType ptId = 0; ptId < numTetGenPts; ptId++) {
+    meshFromTetGen->GetPoint(ptId, pt);
+    merger->InsertUniquePoint(pt, pointMap[ptId]);
+  }
 
-    for (vtkIdType pointInd = 0; pointInd < numPts; ++pointInd) {
-      auto id = cell->PointIds->GetId(pointInd);
-      ids[pointInd] = id;
+  for (vtkIdType cellId = 0; cellId < numTetGenCells; cellId++) {
+    tetGenCells->GetCellAtId(cellId, npts, pts);
+    ids.resize(npts);
+    for (vtkIdType i = 0; i < npts; i++) {
+      ids[i] = pointMap[pts[i]];
     }
+    newCells->InsertNextCell(npts, ids.data());
+    newCellTypes->SetValue(newCellId, meshFromTetGen->GetCellType(cellId));
+    regionIds->SetValue(newCellId, static_cast<int>(tetGenRegionIds->GetTuple1(cellId)));
+    globalElementIds->SetValue(newCellId, newCellId+1);
+    newCellId++;
+  }
 
-    id0 = ids[0];
-    ids[0] = ids[1];
-    ids[1] = id0;
-    cells->ReplaceCell(loc, numPts, ids);
+  std::vector<vtkIdType>().swap(pointMap);
+  newPoints->Squeeze();
+
+  auto globalNodeIds = vtkSmartPointer<vtkIntArray>::New();
+  globalNodeIds->SetName("GlobalNodeID");
+  globalNodeIds->SetNumberOfTuples(newPoints->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < newPoints->GetNumberOfPoints(); ptId++) {
+    globalNodeIds->SetValue(ptId, ptId+1);
   }
 
-  //std::cout << "Number of tet elements with changed order " << negVolElements.size() << std::endl;
+  newMeshVolume->Initialize();
+  newMeshVolume->SetPoints(newPoints);
+  newMeshVolume->SetCells(newCellTypes, newCells);
+  newMeshVolume->GetCellData()->AddArray(regionIds);
+  newMeshVolume->GetCellData()->AddArray(globalElementIds);
+  newMeshVolume->GetPointData()->AddArray(globalNodeIds);
+
+  return SV_OK;
 }
 
 //--------------------------------
@@ -1770,41 +1913,16 @@ int VMTKUtils_ResetOriginalRegions(vtkPolyData *newGeom, vtkPolyData *originalGe
   newGeom->BuildLinks();
   originalGeom->BuildLinks();
 
-  // Create a locator object used to find the cell closest to a point.
-  auto locator = vtkSmartPointer<vtkCellLocator>::New();
-  locator->SetDataSet(originalGeom);
-  locator->BuildLocator();
-
   // Create a 'regionArrayName' cell array for 'newGeom'.
   //
   // The value for each cell in 'newGeom' is obtained by finding 
   // the cell from 'originalGeom' closest to its center.
   //
-  auto genericCell = vtkSmartPointer<vtkGenericCell>::New();
-  auto originalRegions = static_cast<vtkIntArray*>(originalGeom->GetCellData()->GetScalars(regionArrayName.c_str()));
+  auto originalRegions = originalGeom->GetCellData()->GetScalars(regionArrayName.c_str());
   auto newRegions = vtkSmartPointer<vtkIntArray>::New();
 
-  for (int cellId = 0; cellId < newGeom->GetNumberOfCells(); cellId++) {
-      // Calculate cell center.
-      vtkIdType npts;
-      const vtkIdType *pts;
-      double center[3];
-      newGeom->GetCellPoints(cellId, npts, pts);
-      auto polyPts = vtkSmartPointer<vtkPoints>::New();
-      auto polyPtIds = vtkSmartPointer<vtkIdTypeArray>::New();
-      for (int i = 0; i < npts; i++) {
-	polyPtIds->InsertValue(i,i);
-	polyPts->InsertNextPoint(newGeom->GetPoint(pts[i]));
-      }
-      vtkPolygon::ComputeCentroid(polyPtIds, polyPts, center);
-      // Find the closest cell in 'originalGeom'.
-      double closestPt[3];
-      vtkIdType closestCell;
-      double distance;
-      int subId;
-      locator->FindClosestPoint(center, closestPt, genericCell, closestCell, subId,distance);
-      // Set the array value from the value of 'originalGeom' for the closest cell.
-      newRegions->InsertValue(cellId, originalRegions->GetValue(closestCell));
+  if (VtkUtils_TransferCellLabels(originalGeom, originalRegions, newGeom, newRegions) != SV_OK) {
+    return SV_ERROR;
   }
 
   // Set the cel array for 'newGeom'.
@@ -1822,27 +1940,8 @@ int VMTKUtils_ResetOriginalRegions(vtkPolyData *newGeom, vtkPolyData *originalGe
 //
 int VMTKUtils_ResetOriginalRegions(vtkPolyData *newgeom, vtkPolyData *originalgeom, std::string regionName, vtkIdList *excludeList)
 {
-  int i,j,k;
-  int subId;
   int region;
-  int temp;
-  int flag = 1;
-  int count;
-  int bigcount;
-  vtkIdType npts;
-  const vtkIdType *pts;
-  double distance;
-  double closestPt[3];
-  double tolerance = 1.0;
-  double centroid[3];
-  int range;
-  vtkIdType closestCell;
-  vtkIdType cellId;
-  vtkIdType currentValue;
-  vtkIdType realValue;
 
-  auto locator = vtkSmartPointer<vtkCellLocator>::New();
-  auto genericCell = vtkSmartPointer<vtkGenericCell>::New();
   auto originalCopy = vtkSmartPointer<vtkPolyData>::New();
 
   if (excludeList == nullptr) {
@@ -1886,26 +1985,11 @@ int VMTKUtils_ResetOriginalRegions(vtkPolyData *newgeom, vtkPolyData *originalge
   originalCopy->DeepCopy(cleaner->GetOutput());
   originalCopy->BuildLinks();
 
-  locator->SetDataSet(originalCopy);
-  locator->BuildLocator();
   vtkDataArray *realRegions = originalCopy->GetCellData()->GetScalars( regionName.c_str());
 
-  for (cellId = 0; cellId < newgeom->GetNumberOfCells(); cellId++) {
-    currentValue = currentRegions->GetTuple1(cellId);
-    if (excludeList->IsId(currentValue) != -1) {
-      continue;
-    }
-
-    newgeom->GetCellPoints(cellId,npts,pts);
-    vtkSmartPointer<vtkPoints> polyPts = vtkSmartPointer<vtkPoints>::New();
-    vtkSmartPointer<vtkIdTypeArray> polyPtIds = vtkSmartPointer<vtkIdTypeArray>::New();
-    for (i=0;i<npts;i++) {
-      polyPtIds->InsertValue(i,i);
-      polyPts->InsertNextPoint(newgeom->GetPoint(pts[i]));
-    }
-    vtkPolygon::ComputeCentroid(polyPtIds,polyPts,centroid);
-    locator->FindClosestPoint(centroid,closestPt,genericCell,closestCell, subId,distance);
-    currentRegions->SetTuple1(cellId,realRegions->GetTuple1(closestCell));
+  if (VtkUtils_TransferCellLabels(originalCopy, realRegions, newgeom, currentRegions,
+                                  VTKUTILS_TRANSFER_EXCLUDE, excludeList) != SV_OK) {
+    return SV_ERROR;
   }
 
   newgeom->GetCellData()->SetActiveScalars(regionName.c_str());
@@ -1927,28 +2011,6 @@ int VMTKUtils_ResetOriginalRegions(vtkPolyData *newgeom, vtkPolyData *originalge
   std::cout << msg << "regionName: '" << regionName << "'" << std::endl;
   #endif
 
-  int i,j,k;
-  int subId;
-  int region;
-  int temp;
-  int flag = 1;
-  int count;
-  int bigcount;
-  vtkIdType npts;
-  const vtkIdType *pts =  new vtkIdType;
-  double distance;
-  double closestPt[3];
-  double tolerance = 1.0;
-  double centroid[3];
-  int range;
-
-  vtkIdType closestCell;
-  vtkIdType cellId;
-  vtkIdType currentValue;
-  vtkIdType realValue;
-
-  vtkSmartPointer<vtkCellLocator> locator = vtkSmartPointer<vtkCellLocator>::New();
-  vtkSmartPointer<vtkGenericCell> genericCell = vtkSmartPointer<vtkGenericCell>::New();
   vtkSmartPointer<vtkPolyData> originalCopy = vtkSmartPointer<vtkPolyData>::New();
 
   if (onlyList == nullptr)
@@ -1981,31 +2043,12 @@ int VMTKUtils_ResetOriginalRegions(vtkPolyData *newgeom, vtkPolyData *originalge
 
   vtkDataArray *currentRegions = newgeom->GetCellData()->GetArray(regionName.c_str());
 
-  locator->SetDataSet(originalCopy);
-  locator->BuildLocator();
   vtkDataArray *realRegions = originalCopy->GetCellData()->GetScalars( regionName.c_str());
 
-  for (cellId=0;cellId<newgeom->GetNumberOfCells();cellId++)
+  if (VtkUtils_TransferCellLabels(originalCopy, realRegions, newgeom, currentRegions,
+                                  VTKUTILS_TRANSFER_ONLY, onlyList) != SV_OK)
   {
-    currentValue = currentRegions->GetTuple1(cellId);
-    if (onlyList->IsId(currentValue) == -1)
-    {
-      continue;
-    }
-
-    newgeom->GetCellPoints(cellId,npts,pts);
-    vtkSmartPointer<vtkPoints> polyPts = vtkSmartPointer<vtkPoints>::New();
-    vtkSmartPointer<vtkIdTypeArray> polyPtIds = vtkSmartPointer<vtkIdTypeArray>::New();
-    for (i=0;i<npts;i++)
-    {
-      polyPtIds->InsertValue(i,i);
-      polyPts->InsertNextPoint(newgeom->GetPoint(pts[i]));
-    }
-    vtkPolygon::ComputeCentroid(polyPtIds,polyPts,centroid);
-
-    locator->FindClosestPoint(centroid,closestPt,genericCell,closestCell,
-	subId,distance);
-    currentRegions->SetTuple1(cellId,realRegions->GetTuple1(closestCell));
+    return SV_ERROR;
   }
 
   newgeom->GetCellData()->SetActiveScalars(regionName.c_str());
@@ -120,6 +120,11 @@ SV_EXPORT_VMTK_UTILS int VMTKUtils_ResetOriginalRegions(vtkPolyData *newgeom,
 
 SV_EXPORT_VMTK_UTILS void VMTKUtils_ReorderTetElements(vtkUnstructuredGrid* mesh);
 
+SV_EXPORT_VMTK_UTILS int VMTKUtils_AssembleVolumeMesh(vtkUnstructuredGrid *boundaryMesh,
+    int boundaryRegionId,
+    vtkUnstructuredGrid *meshFromTetGen,
+    vtkUnstructuredGrid *newMeshVolume);
+
 SV_EXPORT_VMTK_UTILS int VMTKUtils_CreateBoundaryLayerSurfaceAndCaps(vtkUnstructuredGrid* boundaryMesh, int modelID, 
     vtkUnstructuredGrid* surfaceWithSize, vtkSmartPointer<vtkPolyData>& boundaryMeshSurface, vtkSmartPointer<vtkPolyData>& surfaceMeshCaps,
     vtkSmartPointer<vtkUnstructuredGrid>& boundaryMeshVolume);
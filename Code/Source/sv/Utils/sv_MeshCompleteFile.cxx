@@ -0,0 +1,787 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SimVascular.h"
+
+#include "sv_MeshCompleteFile.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTypeInt64Array.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MeshCompleteMagic[8] = {'S','V','M','E','S','H','C','\0'};
+const uint32_t MeshCompleteVersion = 1;
+const uint32_t MeshCompleteByteOrder = 0x01020304;
+const uint64_t MeshCompleteAlignment = 64;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t numSections;
+  uint64_t indexOffset;
+  uint64_t namesOffset;
+  uint64_t namesSize;
+  uint64_t reserved[2];
+};
+
+struct IndexEntry
+{
+  uint64_t nameOffset;
+  uint32_t nameLength;
+  uint32_t type;
+  uint32_t numComponents;
+  uint32_t reserved;
+  int64_t numTuples;
+  uint64_t offset;
+  uint64_t size;
+};
+
+uint64_t TypeSize(int type)
+{
+  switch (type)
+  {
+    case cvMeshCompleteFile::MC_FLOAT64: return 8;
+    case cvMeshCompleteFile::MC_INT32: return 4;
+    case cvMeshCompleteFile::MC_INT64: return 8;
+    case cvMeshCompleteFile::MC_UINT8: return 1;
+  }
+  return 0;
+}
+
+//---------------
+// SectionWriter
+//---------------
+// Append aligned sections to a file and write the index and header
+// once all sections are added.
+//
+class SectionWriter
+{
+public:
+  SectionWriter(FILE *fp) : fp_(fp), offset_(0), ok_(true)
+  {
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    Put(&header, sizeof(header));
+  }
+
+  void Add(const std::string& name, int type, int numComponents,
+           int64_t numTuples, const void *data)
+  {
+    static const char zeros[MeshCompleteAlignment] = {0};
+    uint64_t pad = (MeshCompleteAlignment - offset_ % MeshCompleteAlignment) % MeshCompleteAlignment;
+    Put(zeros, pad);
+
+    IndexEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.nameOffset = names_.size();
+    entry.nameLength = name.size();
+    entry.type = type;
+    entry.numComponents = numComponents;
+    entry.numTuples = numTuples;
+    entry.offset = offset_;
+    entry.size = numTuples*numComponents*TypeSize(type);
+    entries_.push_back(entry);
+    names_ += name;
+
+    Put(data, entry.size);
+  }
+
+  bool Finish()
+  {
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MeshCompleteMagic, sizeof(header.magic));
+    header.version = MeshCompleteVersion;
+    header.byteOrder = MeshCompleteByteOrder;
+    header.numSections = entries_.size();
+    header.indexOffset = offset_;
+    Put(entries_.data(), entries_.size()*sizeof(IndexEntry));
+    header.namesOffset = offset_;
+    header.namesSize = names_.size();
+    Put(names_.data(), names_.size());
+
+    if (fseek(fp_, 0, SEEK_SET) != 0)
+      ok_ = false;
+    else if (fwrite(&header, sizeof(header), 1, fp_) != 1)
+      ok_ = false;
+    return ok_;
+  }
+
+private:
+  void Put(const void *data, uint64_t size)
+  {
+    if (size == 0)
+      return;
+    if (fwrite(data, 1, size, fp_) != size)
+      ok_ = false;
+    offset_ += size;
+  }
+
+  FILE *fp_;
+  uint64_t offset_;
+  bool ok_;
+  std::vector<IndexEntry> entries_;
+  std::string names_;
+};
+
+//-------------
+// WriteArrays
+//-------------
+// Write the named data arrays of 'attributes' with 'prefix', int arrays
+// as int32 and all other numeric arrays as float64.
+//
+void WriteArrays(SectionWriter& writer, const std::string& prefix,
+                 vtkFieldData *attributes, const char *skipName)
+{
+  for (int i = 0; i < attributes->GetNumberOfArrays(); i++)
+  {
+    vtkDataArray *array = attributes->GetArray(i);
+    if (array == nullptr || array->GetName() == nullptr)
+      continue;
+    if (skipName != nullptr && strcmp(array->GetName(), skipName) == 0)
+      continue;
+
+    int numComponents = array->GetNumberOfComponents();
+    vtkIdType numTuples = array->GetNumberOfTuples();
+    std::string name = prefix + array->GetName();
+
+    vtkIntArray *intArray = vtkIntArray::SafeDownCast(array);
+    if (intArray != nullptr && sizeof(int) == 4)
+    {
+      writer.Add(name, cvMeshCompleteFile::MC_INT32, numComponents, numTuples,
+                 intArray->GetPointer(0));
+      continue;
+    }
+
+    std::vector<double> values(numTuples*numComponents);
+    for (vtkIdType j = 0; j < numTuples; j++)
+    {
+      for (int k = 0; k < numComponents; k++)
+        values[j*numComponents+k] = array->GetComponent(j, k);
+    }
+    writer.Add(name, cvMeshCompleteFile::MC_FLOAT64, numComponents, numTuples, values.data());
+  }
+}
+
+//---------------
+// IdToIndexMap
+//---------------
+// Map the values of the int array 'name' in 'attributes' to their index.
+//
+void IdToIndexMap(vtkFieldData *attributes, const char *name,
+                  std::unordered_map<int,int64_t>& map)
+{
+  vtkIntArray *ids = vtkIntArray::SafeDownCast(attributes->GetArray(name));
+  if (ids == nullptr)
+    return;
+
+  map.reserve(ids->GetNumberOfTuples());
+  for (vtkIdType i = 0; i < ids->GetNumberOfTuples(); i++)
+    map.emplace(ids->GetValue(i), i);
+}
+
+//------------------
+// MapIdsToIndices
+//------------------
+// Map the values of the int array 'name' in 'attributes' to volume
+// indices. Returns false if the array is missing or a value is not found.
+//
+bool MapIdsToIndices(vtkFieldData *attributes, const char *name,
+                     const std::unordered_map<int,int64_t>& map,
+                     vtkIdType numValues, std::vector<int64_t>& indices)
+{
+  vtkIntArray *ids = vtkIntArray::SafeDownCast(attributes->GetArray(name));
+  if (ids == nullptr || map.empty() || ids->GetNumberOfTuples() != numValues)
+    return false;
+
+  indices.resize(numValues);
+  for (vtkIdType i = 0; i < numValues; i++)
+  {
+    auto it = map.find(ids->GetValue(i));
+    if (it == map.end())
+      return false;
+    indices[i] = it->second;
+  }
+  return true;
+}
+
+//--------------
+// WriteSurface
+//--------------
+//
+void WriteSurface(SectionWriter& writer, const std::string& prefix, vtkPolyData *surface,
+                  const std::unordered_map<int,int64_t>& nodeMap,
+                  const std::unordered_map<int,int64_t>& elemMap)
+{
+  vtkIdType numPts = surface->GetNumberOfPoints();
+  vtkCellArray *polys = surface->GetPolys();
+  vtkIdType numPolys = polys->GetNumberOfCells();
+  bool polysOnly = (numPolys == surface->GetNumberOfCells());
+
+  std::vector<int64_t> nodes;
+  bool hasNodes = MapIdsToIndices(surface->GetPointData(), "GlobalNodeID", nodeMap, numPts, nodes);
+  if (hasNodes)
+  {
+    writer.Add(prefix + "/nodes", cvMeshCompleteFile::MC_INT64, 1, numPts, nodes.data());
+  }
+  else
+  {
+    std::vector<double> points(3*numPts);
+    for (vtkIdType i = 0; i < numPts; i++)
+      surface->GetPoint(i, &points[3*i]);
+    writer.Add(prefix + "/points", cvMeshCompleteFile::MC_FLOAT64, 3, numPts, points.data());
+  }
+
+  std::vector<int64_t> elements;
+  bool hasElements = polysOnly &&
+    MapIdsToIndices(surface->GetCellData(), "GlobalElementID", elemMap, numPolys, elements);
+  if (hasElements)
+    writer.Add(prefix + "/elements", cvMeshCompleteFile::MC_INT64, 1, numPolys, elements.data());
+
+  std::vector<int64_t> offsets(numPolys+1);
+  std::vector<int64_t> connectivity;
+  connectivity.reserve(polys->GetNumberOfConnectivityIds());
+  vtkIdType npts;
+  const vtkIdType *pts;
+  vtkIdType cellId = 0;
+  offsets[0] = 0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); cellId++)
+  {
+    connectivity.insert(connectivity.end(), pts, pts+npts);
+    offsets[cellId+1] = connectivity.size();
+  }
+  writer.Add(prefix + "/offsets", cvMeshCompleteFile::MC_INT64, 1, numPolys+1, offsets.data());
+  writer.Add(prefix + "/connectivity", cvMeshCompleteFile::MC_INT64, 1, connectivity.size(), connectivity.data());
+
+  WriteArrays(writer, prefix + "/point/", surface->GetPointData(), hasNodes ? "GlobalNodeID" : nullptr);
+  if (polysOnly)
+    WriteArrays(writer, prefix + "/cell/", surface->GetCellData(), hasElements ? "GlobalElementID" : nullptr);
+}
+
+bool StartsWith(const std::string& s, const std::string& prefix)
+{
+  return s.compare(0, prefix.size(), prefix) == 0;
+}
+
+}
+
+cvMeshCompleteFile::cvMeshCompleteFile()
+  : data_(nullptr), size_(0)
+#ifdef _WIN32
+  , file_(nullptr), mapping_(nullptr)
+#else
+  , fd_(-1)
+#endif
+{
+}
+
+cvMeshCompleteFile::~cvMeshCompleteFile()
+{
+  Close();
+}
+
+//-------
+// Write
+//-------
+//
+int cvMeshCompleteFile::Write(std::string fileName, vtkUnstructuredGrid *volumeMesh,
+    vtkPolyData *exterior, const std::vector<std::string>& faceNames,
+    const std::vector<vtkPolyData*>& faces)
+{
+  if (volumeMesh == nullptr || faceNames.size() != faces.size())
+  {
+    fprintf(stderr,"Mesh-complete file needs a volume mesh and a name for each face\n");
+    return SV_ERROR;
+  }
+
+  FILE *fp = fopen(fileName.c_str(), "wb");
+  if (fp == nullptr)
+  {
+    fprintf(stderr,"Unable to open %s for writing\n",fileName.c_str());
+    return SV_ERROR;
+  }
+  SectionWriter writer(fp);
+
+  vtkIdType numPts = volumeMesh->GetNumberOfPoints();
+  std::vector<double> points(3*numPts);
+  for (vtkIdType i = 0; i < numPts; i++)
+    volumeMesh->GetPoint(i, &points[3*i]);
+  writer.Add("volume/points", MC_FLOAT64, 3, numPts, points.data());
+  points.clear();
+  points.shrink_to_fit();
+
+  vtkIdType numCells = volumeMesh->GetNumberOfCells();
+  std::vector<int64_t> offsets(numCells+1);
+  std::vector<int64_t> connectivity;
+  std::vector<uint8_t> types(numCells);
+  vtkIdType npts;
+  const vtkIdType *pts;
+  offsets[0] = 0;
+  for (vtkIdType i = 0; i < numCells; i++)
+  {
+    volumeMesh->GetCellPoints(i, npts, pts);
+    connectivity.insert(connectivity.end(), pts, pts+npts);
+    offsets[i+1] = connectivity.size();
+    types[i] = volumeMesh->GetCellType(i);
+  }
+  writer.Add("volume/offsets", MC_INT64, 1, numCells+1, offsets.data());
+  writer.Add("volume/connectivity", MC_INT64, 1, connectivity.size(), connectivity.data());
+  writer.Add("volume/types", MC_UINT8, 1, numCells, types.data());
+
+  WriteArrays(writer, "volume/point/", volumeMesh->GetPointData(), nullptr);
+  WriteArrays(writer, "volume/cell/", volumeMesh->GetCellData(), nullptr);
+
+  std::unordered_map<int,int64_t> nodeMap;
+  std::unordered_map<int,int64_t> elemMap;
+  IdToIndexMap(volumeMesh->GetPointData(), "GlobalNodeID", nodeMap);
+  IdToIndexMap(volumeMesh->GetCellData(), "GlobalElementID", elemMap);
+
+  if (exterior != nullptr)
+    WriteSurface(writer, "exterior", exterior, nodeMap, elemMap);
+
+  for (size_t i = 0; i < faces.size(); i++)
+  {
+    if (faces[i] != nullptr)
+      WriteSurface(writer, "face/" + faceNames[i], faces[i], nodeMap, elemMap);
+  }
+
+  bool ok = writer.Finish();
+  if (fclose(fp) != 0)
+    ok = false;
+
+  if (!ok)
+  {
+    fprintf(stderr,"Error writing %s\n",fileName.c_str());
+    return SV_ERROR;
+  }
+
+  return SV_OK;
+}
+
+//------
+// Open
+//------
+// Map the file into memory and read its index.
+//
+int cvMeshCompleteFile::Open(std::string fileName)
+{
+  Close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    fprintf(stderr,"Unable to open %s\n",fileName.c_str());
+    return SV_ERROR;
+  }
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(file, &fileSize);
+  size_ = fileSize.QuadPart;
+  HANDLE mapping = nullptr;
+  if (size_ > 0)
+    mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (mapping == nullptr)
+  {
+    fprintf(stderr,"Unable to map %s\n",fileName.c_str());
+    CloseHandle(file);
+    size_ = 0;
+    return SV_ERROR;
+  }
+  data_ = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+  file_ = file;
+  mapping_ = mapping;
+  if (data_ == nullptr)
+  {
+    fprintf(stderr,"Unable to map %s\n",fileName.c_str());
+    Close();
+    return SV_ERROR;
+  }
+#else
+  fd_ = open(fileName.c_str(), O_RDONLY);
+  if (fd_ < 0)
+  {
+    fprintf(stderr,"Unable to open %s\n",fileName.c_str());
+    return SV_ERROR;
+  }
+  struct stat st;
+  if (fstat(fd_, &st) != 0 || st.st_size == 0)
+  {
+    fprintf(stderr,"Unable to read %s\n",fileName.c_str());
+    Close();
+    return SV_ERROR;
+  }
+  size_ = st.st_size;
+  // A private writable mapping lets VTK arrays wrap the data; any writes
+  // to them go to copied pages, never to the file
+  void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0);
+  if (data == MAP_FAILED)
+  {
+    fprintf(stderr,"Unable to map %s\n",fileName.c_str());
+    Close();
+    return SV_ERROR;
+  }
+  data_ = static_cast<char*>(data);
+#endif
+
+  FileHeader header;
+  if (size_ < sizeof(header))
+  {
+    fprintf(stderr,"%s is not a mesh-complete file\n",fileName.c_str());
+    Close();
+    return SV_ERROR;
+  }
+  memcpy(&header, data_, sizeof(header));
+  if (memcmp(header.magic, MeshCompleteMagic, sizeof(header.magic)) != 0 ||
+      header.byteOrder != MeshCompleteByteOrder ||
+      header.version != MeshCompleteVersion ||
+      header.indexOffset + header.numSections*sizeof(IndexEntry) > size_ ||
+      header.namesOffset + header.namesSize > size_)
+  {
+    fprintf(stderr,"%s is not a mesh-complete file\n",fileName.c_str());
+    Close();
+    return SV_ERROR;
+  }
+
+  const IndexEntry *entries = reinterpret_cast<const IndexEntry*>(data_ + header.indexOffset);
+  const char *names = data_ + header.namesOffset;
+  sections_.resize(header.numSections);
+  for (uint64_t i = 0; i < header.numSections; i++)
+  {
+    const IndexEntry& entry = entries[i];
+    if (entry.nameOffset + entry.nameLength > header.namesSize ||
+        entry.offset + entry.size > size_ ||
+        entry.size != entry.numTuples*entry.numComponents*TypeSize(entry.type))
+    {
+      fprintf(stderr,"%s has a bad section index\n",fileName.c_str());
+      Close();
+      return SV_ERROR;
+    }
+    Section& section = sections_[i];
+    section.name.assign(names + entry.nameOffset, entry.nameLength);
+    section.type = entry.type;
+    section.numComponents = entry.numComponents;
+    section.numTuples = entry.numTuples;
+    section.offset = entry.offset;
+    section.size = entry.size;
+  }
+
+  return SV_OK;
+}
+
+void cvMeshCompleteFile::Close()
+{
+#ifdef _WIN32
+  if (data_ != nullptr)
+    UnmapViewOfFile(data_);
+  if (mapping_ != nullptr)
+    CloseHandle(static_cast<HANDLE>(mapping_));
+  if (file_ != nullptr)
+    CloseHandle(static_cast<HANDLE>(file_));
+  file_ = nullptr;
+  mapping_ = nullptr;
+#else
+  if (data_ != nullptr)
+    munmap(data_, size_);
+  if (fd_ >= 0)
+    close(fd_);
+  fd_ = -1;
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  sections_.clear();
+}
+
+const cvMeshCompleteFile::Section* cvMeshCompleteFile::GetSection(const std::string& name) const
+{
+  for (size_t i = 0; i < sections_.size(); i++)
+  {
+    if (sections_[i].name == name)
+      return &sections_[i];
+  }
+  return nullptr;
+}
+
+const void* cvMeshCompleteFile::GetSectionData(const Section *section) const
+{
+  if (data_ == nullptr || section == nullptr)
+    return nullptr;
+  return data_ + section->offset;
+}
+
+std::vector<std::string> cvMeshCompleteFile::GetFaceNames() const
+{
+  std::vector<std::string> faceNames;
+  const std::string prefix = "face/";
+  const std::string suffix = "/offsets";
+  for (size_t i = 0; i < sections_.size(); i++)
+  {
+    const std::string& name = sections_[i].name;
+    if (name.size() > prefix.size() + suffix.size() && StartsWith(name, prefix) &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+    {
+      faceNames.push_back(name.substr(prefix.size(), name.size() - prefix.size() - suffix.size()));
+    }
+  }
+  return faceNames;
+}
+
+//-----------------
+// NewSectionArray
+//-----------------
+// Create a VTK array that uses the mapped section data without a copy.
+//
+vtkDataArray* cvMeshCompleteFile::NewSectionArray(const Section *section) const
+{
+  void *data = const_cast<void*>(GetSectionData(section));
+  if (data == nullptr)
+    return nullptr;
+
+  vtkIdType numValues = section->numTuples*section->numComponents;
+  vtkDataArray *array = nullptr;
+  switch (section->type)
+  {
+    case MC_FLOAT64:
+    {
+      vtkDoubleArray *values = vtkDoubleArray::New();
+      values->SetNumberOfComponents(section->numComponents);
+      values->SetArray(static_cast<double*>(data), numValues, 1);
+      array = values;
+      break;
+    }
+    case MC_INT32:
+    {
+      vtkIntArray *values = vtkIntArray::New();
+      values->SetNumberOfComponents(section->numComponents);
+      values->SetArray(static_cast<int*>(data), numValues, 1);
+      array = values;
+      break;
+    }
+    case MC_INT64:
+    {
+      vtkTypeInt64Array *values = vtkTypeInt64Array::New();
+      values->SetNumberOfComponents(section->numComponents);
+      values->SetArray(static_cast<vtkTypeInt64*>(data), numValues, 1);
+      array = values;
+      break;
+    }
+    case MC_UINT8:
+    {
+      vtkUnsignedCharArray *values = vtkUnsignedCharArray::New();
+      values->SetNumberOfComponents(section->numComponents);
+      values->SetArray(static_cast<unsigned char*>(data), numValues, 1);
+      array = values;
+      break;
+    }
+  }
+  return array;
+}
+
+//------------------
+// AddSectionArrays
+//------------------
+// Add every section named <prefix><array> to 'fieldData' as <array>.
+//
+void cvMeshCompleteFile::AddSectionArrays(const std::string& prefix, vtkFieldData *fieldData) const
+{
+  for (size_t i = 0; i < sections_.size(); i++)
+  {
+    if (!StartsWith(sections_[i].name, prefix))
+      continue;
+
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(NewSectionArray(&sections_[i]));
+    if (array == nullptr)
+      continue;
+    array->SetName(sections_[i].name.substr(prefix.size()).c_str());
+    fieldData->AddArray(array);
+  }
+}
+
+//---------------
+// GetVolumeMesh
+//---------------
+//
+int cvMeshCompleteFile::GetVolumeMesh(vtkUnstructuredGrid *volumeMesh) const
+{
+  const Section *points = GetSection("volume/points");
+  const Section *offsets = GetSection("volume/offsets");
+  const Section *connectivity = GetSection("volume/connectivity");
+  const Section *types = GetSection("volume/types");
+  if (points == nullptr || offsets == nullptr || connectivity == nullptr || types == nullptr ||
+      points->type != MC_FLOAT64 || offsets->type != MC_INT64 ||
+      connectivity->type != MC_INT64 || types->type != MC_UINT8)
+  {
+    fprintf(stderr,"No volume mesh in mesh-complete file\n");
+    return SV_ERROR;
+  }
+
+  vtkSmartPointer<vtkDataArray> pointData;
+  pointData.TakeReference(NewSectionArray(points));
+  vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::New();
+  newPoints->SetData(pointData);
+
+  vtkSmartPointer<vtkDataArray> offsetData;
+  vtkSmartPointer<vtkDataArray> connectivityData;
+  vtkSmartPointer<vtkDataArray> typeData;
+  offsetData.TakeReference(NewSectionArray(offsets));
+  connectivityData.TakeReference(NewSectionArray(connectivity));
+  typeData.TakeReference(NewSectionArray(types));
+
+  vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(vtkTypeInt64Array::SafeDownCast(offsetData),
+                 vtkTypeInt64Array::SafeDownCast(connectivityData));
+
+  volumeMesh->Initialize();
+  volumeMesh->SetPoints(newPoints);
+  volumeMesh->SetCells(vtkUnsignedCharArray::SafeDownCast(typeData), cells);
+  AddSectionArrays("volume/point/", volumeMesh->GetPointData());
+  AddSectionArrays("volume/cell/", volumeMesh->GetCellData());
+
+  return SV_OK;
+}
+
+int cvMeshCompleteFile::GetExteriorSurface(vtkPolyData *surface) const
+{
+  return GetSurface("exterior", surface);
+}
+
+int cvMeshCompleteFile::GetFaceSurface(const std::string& faceName, vtkPolyData *surface) const
+{
+  return GetSurface("face/" + faceName, surface);
+}
+
+//------------
+// GetSurface
+//------------
+// Points of surfaces stored as volume nodes are gathered from the volume
+// points.
+//
+int cvMeshCompleteFile::GetSurface(const std::string& prefix, vtkPolyData *surface) const
+{
+  const Section *offsets = GetSection(prefix + "/offsets");
+  const Section *connectivity = GetSection(prefix + "/connectivity");
+  const Section *nodes = GetSection(prefix + "/nodes");
+  const Section *points = GetSection(prefix + "/points");
+  const Section *elements = GetSection(prefix + "/elements");
+  const Section *volumePoints = GetSection("volume/points");
+  if (offsets == nullptr || connectivity == nullptr || (nodes == nullptr && points == nullptr) ||
+      (nodes != nullptr && volumePoints == nullptr))
+  {
+    fprintf(stderr,"No surface %s in mesh-complete file\n",prefix.c_str());
+    return SV_ERROR;
+  }
+
+  surface->Initialize();
+
+  vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::New();
+  if (nodes != nullptr)
+  {
+    const int64_t *nodeIds = static_cast<const int64_t*>(GetSectionData(nodes));
+    const double *xyz = static_cast<const double*>(GetSectionData(volumePoints));
+    newPoints->SetDataTypeToDouble();
+    newPoints->SetNumberOfPoints(nodes->numTuples);
+    for (int64_t i = 0; i < nodes->numTuples; i++)
+    {
+      if (nodeIds[i] < 0 || nodeIds[i] >= volumePoints->numTuples)
+      {
+        fprintf(stderr,"Bad node in surface %s\n",prefix.c_str());
+        return SV_ERROR;
+      }
+      newPoints->SetPoint(i, &xyz[3*nodeIds[i]]);
+    }
+  }
+  else
+  {
+    vtkSmartPointer<vtkDataArray> pointData;
+    pointData.TakeReference(NewSectionArray(points));
+    newPoints->SetData(pointData);
+  }
+
+  vtkSmartPointer<vtkDataArray> offsetData;
+  vtkSmartPointer<vtkDataArray> connectivityData;
+  offsetData.TakeReference(NewSectionArray(offsets));
+  connectivityData.TakeReference(NewSectionArray(connectivity));
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  polys->SetData(vtkTypeInt64Array::SafeDownCast(offsetData),
+                 vtkTypeInt64Array::SafeDownCast(connectivityData));
+
+  surface->SetPoints(newPoints);
+  surface->SetPolys(polys);
+  AddSectionArrays(prefix + "/point/", surface->GetPointData());
+  AddSectionArrays(prefix + "/cell/", surface->GetCellData());
+
+  // As in the mesh-surfaces files, the global ids of a surface are the
+  // 1-based index of the volume point or cell
+  const struct { const Section *indices; vtkFieldData *output; const char *name; } ids[2] =
+  {
+    {nodes, surface->GetPointData(), "GlobalNodeID"},
+    {elements, surface->GetCellData(), "GlobalElementID"}
+  };
+  for (int n = 0; n < 2; n++)
+  {
+    if (ids[n].indices == nullptr)
+      continue;
+
+    const int64_t *indices = static_cast<const int64_t*>(GetSectionData(ids[n].indices));
+    vtkSmartPointer<vtkIntArray> globalIds = vtkSmartPointer<vtkIntArray>::New();
+    globalIds->SetName(ids[n].name);
+    globalIds->SetNumberOfValues(ids[n].indices->numTuples);
+    for (int64_t i = 0; i < ids[n].indices->numTuples; i++)
+      globalIds->SetValue(i, indices[i]+1);
+    ids[n].output->AddArray(globalIds);
+  }
+
+  return SV_OK;
+}
@@ -0,0 +1,139 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CVMESHCOMPLETEFILE_H
+#define __CVMESHCOMPLETEFILE_H
+
+#include "SimVascular.h"
+#include "svUtilsExports.h" // For exports
+
+#include "vtkDataArray.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A single binary file holding a mesh-complete set: the volume mesh, its
+// exterior surface and the surface of each model face.
+//
+// The file is a fixed header, the data sections, each a contiguous array
+// aligned to 64 bytes, and an index giving the name, type, size and offset
+// of every section. The volume mesh is stored as
+//
+//   volume/points              float64 x 3
+//   volume/offsets             int64, number of cells + 1
+//   volume/connectivity        int64
+//   volume/types               uint8, VTK cell types
+//   volume/point/<array>       point data, int32 or float64
+//   volume/cell/<array>        cell data, int32 or float64
+//
+// and the exterior surface ("exterior") and each face ("face/<name>") as
+//
+//   <surface>/nodes            int64, volume point of each surface point
+//   <surface>/elements         int64, volume cell of each surface cell
+//   <surface>/offsets, <surface>/connectivity, <surface>/point/<array>,
+//   <surface>/cell/<array>
+//
+// A surface whose GlobalNodeID values are not all found in the volume
+// mesh stores <surface>/points instead of nodes, and one without matching
+// GlobalElementID values has no elements section.
+//
+// Open() maps the file into memory. The arrays of the meshes returned by
+// GetVolumeMesh() and GetFaceSurface() reference the mapped data wherever
+// the layout allows, so the file must stay open while they are used (or
+// the meshes must be deep copied). As in the mesh-surfaces files, the
+// GlobalNodeID and GlobalElementID of a returned surface are the 1-based
+// index of the volume point or cell.
+//
+class SV_EXPORT_UTILS cvMeshCompleteFile
+{
+public:
+  enum DataType
+  {
+    MC_FLOAT64 = 1,
+    MC_INT32 = 2,
+    MC_INT64 = 3,
+    MC_UINT8 = 4
+  };
+
+  struct Section
+  {
+    std::string name;
+    int type;
+    int numComponents;
+    int64_t numTuples;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  cvMeshCompleteFile();
+  ~cvMeshCompleteFile();
+
+  cvMeshCompleteFile(const cvMeshCompleteFile&) = delete;
+  cvMeshCompleteFile& operator=(const cvMeshCompleteFile&) = delete;
+
+  static int Write(std::string fileName, vtkUnstructuredGrid *volumeMesh,
+                   vtkPolyData *exterior, const std::vector<std::string>& faceNames,
+                   const std::vector<vtkPolyData*>& faces);
+
+  int Open(std::string fileName);
+  void Close();
+  bool IsOpen() const { return data_ != nullptr; }
+
+  const std::vector<Section>& GetSections() const { return sections_; }
+  const Section* GetSection(const std::string& name) const;
+  const void* GetSectionData(const Section *section) const;
+
+  std::vector<std::string> GetFaceNames() const;
+
+  int GetVolumeMesh(vtkUnstructuredGrid *volumeMesh) const;
+  int GetExteriorSurface(vtkPolyData *surface) const;
+  int GetFaceSurface(const std::string& faceName, vtkPolyData *surface) const;
+
+private:
+  int GetSurface(const std::string& prefix, vtkPolyData *surface) const;
+  vtkDataArray* NewSectionArray(const Section *section) const;
+  void AddSectionArrays(const std::string& prefix, vtkFieldData *fieldData) const;
+
+  std::vector<Section> sections_;
+  char *data_;
+  size_t size_;
+#ifdef _WIN32
+  void *file_;
+  void *mapping_;
+#else
+  int fd_;
+#endif
+};
+
+#endif // __CVMESHCOMPLETEFILE_H
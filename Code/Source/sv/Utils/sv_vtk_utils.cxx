@@ -35,12 +35,18 @@
 #include <math.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <vector>
 #include "sv_misc_utils.h"
 #include "sv_cgeom.h"
 
+#include <vtkCellLocator.h>
 #include <vtkDataSetSurfaceFilter.h>
+#include <vtkGenericCell.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkThreshold.h>
+#include <vtkVersion.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkXMLUnstructuredGridWriter.h>
 #include <vtkXMLPolyDataWriter.h>
@@ -83,6 +89,92 @@ static int GetStartPt( int *state, int stateSz );
 static int UpdateCells( int *cells, int numCells,
 			vtkIdType **newCells, int *numNewCells );
 
+static void CellCentroid( vtkPolyData *pd, vtkIdList *ptIds, double centroid[3] );
+
+namespace {
+
+// Finds the source cell closest to the centroid of each target cell
+// marked for update. Each thread has its own generic cell and id list.
+struct ClosestCellFunctor
+{
+  vtkPolyData *Target;
+  vtkCellLocator *Locator;
+  const std::vector<char> *Update;
+  std::vector<vtkIdType> *ClosestCell;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    vtkGenericCell *genericCell = this->Cell.Local();
+    vtkIdList *ptIds = this->PtIds.Local();
+    double centroid[3], closestPt[3], distance;
+    vtkIdType closestCell;
+    int subId;
+
+    for (vtkIdType cellId = begin; cellId < end; cellId++) {
+      if (!(*this->Update)[cellId]) {
+        continue;
+      }
+      this->Target->GetCellPoints(cellId, ptIds);
+      CellCentroid(this->Target, ptIds, centroid);
+      this->Locator->FindClosestPoint(centroid, closestPt, genericCell,
+                                      closestCell, subId, distance);
+      (*this->ClosestCell)[cellId] = closestCell;
+    }
+  }
+};
+
+// Finds updated cells whose edge neighbors all share one other label.
+struct NeighborLabelFunctor
+{
+  vtkPolyData *Target;
+  const std::vector<char> *Update;
+  const std::vector<double> *Labels;
+  std::vector<double> *NewLabels;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+  vtkSMPThreadLocalObject<vtkIdList> Neighbors;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    vtkIdList *ptIds = this->PtIds.Local();
+    vtkIdList *neighbors = this->Neighbors.Local();
+
+    for (vtkIdType cellId = begin; cellId < end; cellId++) {
+      double label = (*this->Labels)[cellId];
+      (*this->NewLabels)[cellId] = label;
+      if (!(*this->Update)[cellId]) {
+        continue;
+      }
+
+      this->Target->GetCellPoints(cellId, ptIds);
+      vtkIdType npts = ptIds->GetNumberOfIds();
+      int numNeighbors = 0;
+      int agree = 1;
+      double neighborLabel = label;
+      for (vtkIdType i = 0; i < npts && agree; i++) {
+        this->Target->GetCellEdgeNeighbors(cellId, ptIds->GetId(i),
+                                           ptIds->GetId((i+1)%npts), neighbors);
+        for (vtkIdType j = 0; j < neighbors->GetNumberOfIds(); j++) {
+          double value = (*this->Labels)[neighbors->GetId(j)];
+          if (numNeighbors > 0 && value != neighborLabel) {
+            agree = 0;
+            break;
+          }
+          neighborLabel = value;
+          numNeighbors++;
+        }
+      }
+
+      if (agree && numNeighbors > 1 && neighborLabel != label) {
+        (*this->NewLabels)[cellId] = neighborLabel;
+      }
+    }
+  }
+};
+
+}
+
 //-------------------------
 // VtkUtils_ThresholdUgrid
 //-------------------------
@@ -1796,6 +1888,165 @@ void VtkUtils_write_vtp(vtkPolyData* polydata, const std::string file_name)
   writer->Write();
 }
 
+//-----------------------------
+// VtkUtils_TransferCellLabels
+//-----------------------------
+// Set the 'targetLabels' cell values of 'target' from the 'sourceLabels'
+// value of the 'source' cell closest to each target cell centroid.
+//
+// The closest cell searches run in parallel and the labels are written
+// afterwards, so the result does not depend on the number of threads.
+//
+// mode: VTKUTILS_TRANSFER_ALL sizes 'targetLabels' and sets every cell.
+//       VTKUTILS_TRANSFER_EXCLUDE skips cells whose current label is in
+//       'labelList', VTKUTILS_TRANSFER_ONLY sets only those cells.
+//
+// neighborPass: if set, an updated cell whose edge neighbors all have the
+//       same label, different from its own, is given that label. This
+//       removes single misassigned cells along region boundaries.
+//
+int VtkUtils_TransferCellLabels( vtkPolyData *source, vtkDataArray *sourceLabels,
+                                 vtkPolyData *target, vtkDataArray *targetLabels,
+                                 int mode, vtkIdList *labelList, int neighborPass )
+{
+  if (sourceLabels == nullptr || targetLabels == nullptr) {
+    fprintf(stderr,"Cell label arrays must be given to transfer labels\n");
+    return SV_ERROR;
+  }
+  if (mode != VTKUTILS_TRANSFER_ALL && labelList == nullptr) {
+    fprintf(stderr,"A label list must be given to transfer a subset of labels\n");
+    return SV_ERROR;
+  }
+  if (source->GetNumberOfCells() == 0) {
+    fprintf(stderr,"No source cells to transfer labels from\n");
+    return SV_ERROR;
+  }
+
+  vtkIdType numCells = target->GetNumberOfCells();
+  if (mode == VTKUTILS_TRANSFER_ALL) {
+    targetLabels->SetNumberOfComponents(1);
+    targetLabels->SetNumberOfTuples(numCells);
+  }
+  else if (targetLabels->GetNumberOfTuples() != numCells) {
+    fprintf(stderr,"Target label array does not match the number of cells\n");
+    return SV_ERROR;
+  }
+
+  // Cells must exist before the meshes are read from several threads.
+  if (source->NeedToBuildCells()) {
+    source->BuildCells();
+  }
+  if (target->NeedToBuildCells()) {
+    target->BuildCells();
+  }
+
+  auto locator = vtkSmartPointer<vtkCellLocator>::New();
+  locator->SetDataSet(source);
+  locator->BuildLocator();
+
+  std::vector<char> update(numCells, 1);
+  if (mode != VTKUTILS_TRANSFER_ALL) {
+    for (vtkIdType cellId = 0; cellId < numCells; cellId++) {
+      vtkIdType label = static_cast<vtkIdType>(targetLabels->GetTuple1(cellId));
+      int inList = labelList->IsId(label) != -1;
+      update[cellId] = (mode == VTKUTILS_TRANSFER_ONLY) ? inList : !inList;
+    }
+  }
+
+  std::vector<vtkIdType> closestCell(numCells, -1);
+  ClosestCellFunctor finder;
+  finder.Target = target;
+  finder.Locator = locator;
+  finder.Update = &update;
+  finder.ClosestCell = &closestCell;
+
+  // vtkCellLocator queries are only thread safe from VTK 9.2.
+  #if VTK_MAJOR_VERSION > 9 || (VTK_MAJOR_VERSION == 9 && VTK_MINOR_VERSION >= 2)
+  vtkSMPTools::For(0, numCells, finder);
+  #else
+  finder(0, numCells);
+  #endif
+
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++) {
+    if (update[cellId]) {
+      targetLabels->SetTuple1(cellId, sourceLabels->GetTuple1(closestCell[cellId]));
+    }
+  }
+
+  if (neighborPass) {
+    target->BuildLinks();
+
+    std::vector<double> labels(numCells), newLabels(numCells);
+    for (vtkIdType cellId = 0; cellId < numCells; cellId++) {
+      labels[cellId] = targetLabels->GetTuple1(cellId);
+    }
+
+    NeighborLabelFunctor smoother;
+    smoother.Target = target;
+    smoother.Update = &update;
+    smoother.Labels = &labels;
+    smoother.NewLabels = &newLabels;
+    vtkSMPTools::For(0, numCells, smoother);
+
+    for (vtkIdType cellId = 0; cellId < numCells; cellId++) {
+      if (newLabels[cellId] != labels[cellId]) {
+        targetLabels->SetTuple1(cellId, newLabels[cellId]);
+      }
+    }
+  }
+
+  return SV_OK;
+}
+
+//--------------
+// CellCentroid
+//--------------
+// Area weighted centroid of a polygon computed from a fan of triangles
+// about its first point. Falls back to the average of the points for
+// degenerate cells, lines and vertices.
+//
+static void CellCentroid( vtkPolyData *pd, vtkIdList *ptIds, double centroid[3] )
+{
+  vtkIdType npts = ptIds->GetNumberOfIds();
+  double p0[3], p1[3], p2[3];
+  double sum[3] = {0.0, 0.0, 0.0};
+  double area = 0.0;
+
+  centroid[0] = centroid[1] = centroid[2] = 0.0;
+  if (npts == 0) {
+    return;
+  }
 
+  pd->GetPoint(ptIds->GetId(0), p0);
+  for (vtkIdType i = 1; i < npts-1; i++) {
+    pd->GetPoint(ptIds->GetId(i), p1);
+    pd->GetPoint(ptIds->GetId(i+1), p2);
+    double e1[3], e2[3], n[3];
+    for (int k = 0; k < 3; k++) {
+      e1[k] = p1[k] - p0[k];
+      e2[k] = p2[k] - p0[k];
+    }
+    n[0] = e1[1]*e2[2] - e1[2]*e2[1];
+    n[1] = e1[2]*e2[0] - e1[0]*e2[2];
+    n[2] = e1[0]*e2[1] - e1[1]*e2[0];
+    double a = 0.5*sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+    for (int k = 0; k < 3; k++) {
+      sum[k] += a*(p0[k] + p1[k] + p2[k])/3.0;
+    }
+    area += a;
+  }
 
+  if (npts > 2 && area > 0.0) {
+    for (int k = 0; k < 3; k++) {
+      centroid[k] = sum[k]/area;
+    }
+    return;
+  }
 
+  for (vtkIdType i = 0; i < npts; i++) {
+    pd->GetPoint(ptIds->GetId(i), p1);
+    for (int k = 0; k < 3; k++) {
+      centroid[k] += p1[k]/npts;
+    }
+  }
+}
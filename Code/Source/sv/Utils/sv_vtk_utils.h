@@ -114,6 +114,20 @@ int SV_EXPORT_UTILS VtkUtils_PDCheckArrayName( vtkPolyData *object, int datatype
 
 int SV_EXPORT_UTILS VtkUtils_UGCheckArrayName( vtkUnstructuredGrid *object, int datatype,std::string arrayname);
 
+// Which target cells VtkUtils_TransferCellLabels updates.
+#define VTKUTILS_TRANSFER_ALL      0  // every cell
+#define VTKUTILS_TRANSFER_EXCLUDE  1  // cells whose label is not in the list
+#define VTKUTILS_TRANSFER_ONLY     2  // cells whose label is in the list
+
+// Set the cell labels of 'target' from the 'source' cell closest to the
+// centroid of each target cell. 'neighborPass' relabels single updated
+// cells whose edge neighbors all agree on a different label.
+int SV_EXPORT_UTILS VtkUtils_TransferCellLabels( vtkPolyData *source, vtkDataArray *sourceLabels,
+                                                 vtkPolyData *target, vtkDataArray *targetLabels,
+                                                 int mode = VTKUTILS_TRANSFER_ALL,
+                                                 vtkIdList *labelList = nullptr,
+                                                 int neighborPass = 0 );
+
 void VtkUtils_write_vtu(vtkUnstructuredGrid *ugrid, const std::string file_name);
 
 void VtkUtils_write_vtp(vtkPolyData* polydata, const std::string file_name);
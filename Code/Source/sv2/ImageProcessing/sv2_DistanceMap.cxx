@@ -36,13 +36,300 @@
 #include <stdio.h>
 #include <math.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "vtkXMLDataSetWriter.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocal.h"
+
+// squared distance used for voxels with no background voxel in reach
+#define EDT_INFINITY 1.0e20
+
+namespace {
+
+// ------------------
+//   ThresholdFunctor
+// ------------------
+// Initialize the distance map from the image threshold and count the
+// voxels in the threshold.
+
+class ThresholdFunctor {
+
+  public:
+
+    vtkDataArray *scalars_;
+    vtkFloatingPointType thrval_;
+    distanceMapType *dist_;
+    vtkSMPThreadLocal<int> count_;
+    int nonZeroPixels_;
+
+    void Initialize() {
+      count_.Local() = 0;
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end) {
+      int &count = count_.Local();
+      for (vtkIdType s = begin; s < end; s++) {
+        if ((int)(scalars_->GetComponent(s,0)) >= thrval_) {
+          // hopefully big number!
+          dist_[s] = MAX_DISTANCE_VAL;
+          count++;
+        } else {
+          dist_[s] = -1;
+        }
+      }
+    }
+
+    void Reduce() {
+      nonZeroPixels_ = 0;
+      for (vtkSMPThreadLocal<int>::iterator it = count_.begin(); it != count_.end(); ++it) {
+        nonZeroPixels_ += *it;
+      }
+    }
+
+};
+
+// ---------------
+//   EDTFunctor
+// ---------------
+// One pass of the separable euclidean distance transform (Felzenszwalb
+// and Huttenlocher): each line along axis_ is replaced by the lower
+// envelope of the parabolas rooted at its samples.  Lines are
+// independent, so they are processed in parallel.
+
+class EDTFunctor {
+
+  public:
+
+    double *dist_;
+    int dims_[3];
+    int axis_;
+    double spacing_;
+    vtkSMPThreadLocal<std::vector<double> > f_;
+    vtkSMPThreadLocal<std::vector<double> > z_;
+    vtkSMPThreadLocal<std::vector<int> > v_;
+
+    void operator()(vtkIdType begin, vtkIdType end) {
+
+      int n = dims_[axis_];
+      std::vector<double> &f = f_.Local();
+      std::vector<double> &z = z_.Local();
+      std::vector<int> &v = v_.Local();
+      f.resize(n);
+      z.resize(n+1);
+      v.resize(n);
+
+      vtkIdType stride = 1;
+      if (axis_ > 0) stride *= dims_[0];
+      if (axis_ > 1) stride *= dims_[1];
+
+      for (vtkIdType line = begin; line < end; line++) {
+
+        vtkIdType base;
+        if (axis_ == 0) {
+          base = line*dims_[0];
+        } else if (axis_ == 1) {
+          base = (line % dims_[0]) + (line / dims_[0])*dims_[0]*dims_[1];
+        } else {
+          base = line;
+        }
+
+        int q;
+        for (q = 0; q < n; q++) {
+          f[q] = dist_[base + q*stride];
+        }
+
+        // lower envelope, sites at infinity are skipped
+        int k = -1;
+        double sq = 0.0;
+        for (q = 0; q < n; q++) {
+          if (f[q] >= EDT_INFINITY) continue;
+          double xq = spacing_*q;
+          while (k >= 0) {
+            double xv = spacing_*v[k];
+            sq = ((f[q] + xq*xq) - (f[v[k]] + xv*xv)) / (2.0*(xq - xv));
+            if (sq <= z[k]) {
+              k--;
+            } else {
+              break;
+            }
+          }
+          k++;
+          v[k] = q;
+          z[k] = (k == 0) ? -EDT_INFINITY : sq;
+          z[k+1] = EDT_INFINITY;
+        }
+
+        if (k < 0) continue;
+
+        k = 0;
+        for (q = 0; q < n; q++) {
+          double xq = spacing_*q;
+          while (z[k+1] < xq) k++;
+          double dx = xq - spacing_*v[k];
+          dist_[base + q*stride] = dx*dx + f[v[k]];
+        }
+
+      }
+
+    }
+
+};
+
+// -------------------
+//   Thinning helpers
+// -------------------
+// Topology preserving thinning removes simple points, i.e. foreground
+// voxels whose removal changes neither the number of 26-connected
+// foreground components nor the number of 6-connected background
+// components in their 3x3x3 neighborhood.
+
+void getNeighborhood(const short *mask, const int dims[3], int i, int j, int k, int nbhd[27]) {
+  int n = 0;
+  for (int dk = -1; dk < 2; dk++) {
+    for (int dj = -1; dj < 2; dj++) {
+      for (int di = -1; di < 2; di++) {
+        int ti = i + di;
+        int tj = j + dj;
+        int tk = k + dk;
+        if (ti < 0 || tj < 0 || tk < 0 ||
+            ti >= dims[0] || tj >= dims[1] || tk >= dims[2]) {
+          nbhd[n] = 0;
+        } else {
+          nbhd[n] = (mask[ti+dims[0]*tj+tk*dims[0]*dims[1]] > 0) ? 1 : 0;
+        }
+        n++;
+      }
+    }
+  }
+}
+
+int numForegroundNeighbors(const int nbhd[27]) {
+  int num = 0;
+  for (int n = 0; n < 27; n++) {
+    if (n != 13) num += nbhd[n];
+  }
+  return num;
+}
+
+// count the components of the cells with value val, only cells with
+// inSet[n] set take part.  Only components containing a cell with
+// seed[n] set are counted.
+int countComponents(const int nbhd[27], int val, const int inSet[27],
+                    const int seed[27], int connectivity) {
+
+  int label[27];
+  int stack[27];
+  int n,m,num = 0;
+
+  for (n = 0; n < 27; n++) label[n] = 0;
+
+  for (n = 0; n < 27; n++) {
+    if (!inSet[n] || nbhd[n] != val || label[n] || !seed[n]) continue;
+    num++;
+    int top = 0;
+    stack[top++] = n;
+    label[n] = num;
+    while (top > 0) {
+      int c = stack[--top];
+      int ci = c % 3, cj = (c / 3) % 3, ck = c / 9;
+      for (m = 0; m < 27; m++) {
+        if (!inSet[m] || nbhd[m] != val || label[m]) continue;
+        int di = abs(m % 3 - ci), dj = abs((m / 3) % 3 - cj), dk = abs(m / 9 - ck);
+        if (di > 1 || dj > 1 || dk > 1) continue;
+        if (connectivity == 6 && (di + dj + dk) != 1) continue;
+        label[m] = num;
+        stack[top++] = m;
+      }
+    }
+  }
+
+  return num;
+
+}
+
+int isSimplePoint(const int nbhd[27]) {
+
+  int n26[27], n18[27], n6[27], all[27];
+  for (int n = 0; n < 27; n++) {
+    int d = abs(n % 3 - 1) + abs((n / 3) % 3 - 1) + abs(n / 9 - 1);
+    n26[n] = (d > 0);
+    n18[n] = (d > 0 && d < 3);
+    n6[n] = (d == 1);
+    all[n] = 1;
+  }
+
+  // one 26-connected foreground component
+  if (countComponents(nbhd,1,n26,all,26) != 1) return 0;
+
+  // one 6-connected background component (within the 18 neighborhood)
+  // that touches the center
+  if (countComponents(nbhd,0,n18,n6,6) != 1) return 0;
+
+  return 1;
+
+}
+
+// ---------------------------
+//   ThinCandidatesFunctor
+// ---------------------------
+// Collect the border voxels in direction dir_ that can be removed.  The
+// candidates are checked again serially before removal since removing
+// two neighboring simple points at once can change the topology.
+
+class ThinCandidatesFunctor {
+
+  public:
+
+    const short *mask_;
+    int dims_[3];
+    int dir_[3];
+    vtkSMPThreadLocal<std::vector<int> > local_;
+    std::vector<int> candidates_;
+
+    void Initialize() {
+      local_.Local().clear();
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end) {
+      std::vector<int> &local = local_.Local();
+      int nbhd[27];
+      for (vtkIdType k = begin; k < end; k++) {
+        for (int j = 0; j < dims_[1]; j++) {
+          for (int i = 0; i < dims_[0]; i++) {
+            int s = i+dims_[0]*j+k*dims_[0]*dims_[1];
+            if (mask_[s] <= 0) continue;
+            getNeighborhood(mask_,dims_,i,j,k,nbhd);
+            if (nbhd[13 + dir_[0] + 3*dir_[1] + 9*dir_[2]] != 0) continue;
+            if (numForegroundNeighbors(nbhd) <= 1) continue;
+            if (!isSimplePoint(nbhd)) continue;
+            local.push_back(s);
+          }
+        }
+      }
+    }
+
+    void Reduce() {
+      candidates_.clear();
+      for (vtkSMPThreadLocal<std::vector<int> >::iterator it = local_.begin(); it != local_.end(); ++it) {
+        candidates_.insert(candidates_.end(),it->begin(),it->end());
+      }
+      std::sort(candidates_.begin(),candidates_.end());
+    }
+
+};
+
+}
 
 cvDistanceMap::cvDistanceMap() {
     map_ = nullptr;
     path_ = nullptr;
     mask_ = nullptr;
+    edt_ = nullptr;
     useCityBlock_ = 1;
+    start_[0] = -1; start_[1] = -1; start_[2] = -1;
+    stop_[0] = -1; stop_[1] = -1; stop_[2] = -1;
 
     // create index table for 26-connectivity neighborhood
     int num = 0,i,j,k;
@@ -70,6 +357,12 @@ cvDistanceMap::~cvDistanceMap() {
     if (path_ != nullptr) {
         path_->Delete();
     }
+    if (mask_ != nullptr) {
+        mask_->Delete();
+    }
+    if (edt_ != nullptr) {
+        edt_->Delete();
+    }
 }
 
 int cvDistanceMap::createDistanceMap (vtkStructuredPoints *vtksp,
@@ -88,8 +381,6 @@ int cvDistanceMap::createDistanceMap (vtkStructuredPoints *vtksp,
     start_[1] = start[1];
     start_[2] = start[2];
 
-    int s;
-
     DISTANCEMAPVTKTYPE *mapScalars = DISTANCEMAPVTKTYPE::New();
     mapScalars->SetNumberOfComponents(1);
     mapScalars->Allocate(1000,1000);
@@ -109,73 +400,45 @@ int cvDistanceMap::createDistanceMap (vtkStructuredPoints *vtksp,
     mapsp->SetSpacing(spacing);
 
     int n;
-    distanceMapType Dq;
-
-    vtkFloatingPointType pixDimsF[3];
-    vtkFloatingPointType originF[3];
 
     vtksp->GetDimensions( imgDims_ );
-    vtksp->GetSpacing( pixDimsF );
-    vtksp->GetOrigin( originF );
 
     fprintf(stdout,"dims: %i %i %i\n", imgDims_[0],imgDims_[1],imgDims_[2]);
 
     vtkDataArray *vScalars = vtksp->GetPointData()->GetScalars();
 
-    int buckindex, bloop;
-
-    // count the number of non-zero
-    int nonZeroPixels = 0;
     int totalNumPixels = imgDims_[0]*imgDims_[1]*imgDims_[2];
 
-    for (s = 0; s < totalNumPixels; s++) {
-      if ((int)(vScalars->GetTuple1(s)) >= thrval) {
-        nonZeroPixels++;
-      }
-    }
-
-    fprintf(stdout,"pixels in threshold: %i\n",nonZeroPixels);
-
     mapScalars->SetNumberOfTuples(totalNumPixels);
+    distanceMapType *dist = mapScalars->GetPointer(0);
 
-    // add all interior pixels into the first bucket
-    for (s = 0; s < totalNumPixels;s++) {
-      if ((int)(vScalars->GetTuple1(s)) >= thrval) {
-          //bucket[0]->InsertNextId(s);
-         // hopefully big number!
-         mapScalars->SetTuple1(s,MAX_DISTANCE_VAL);
-      } else {
-          mapScalars->SetTuple1(s,-1);
-      }
-    }
-
-    // wastefully allocation
-    int bucketlookup[5];
-    for (int i = 0; i < 5; i++) {
-      bucketlookup[i] = i;
-    }
-
-    vtkIdList *bucket[4];
-    bucket[0] = vtkIdList::New();bucket[0]->Allocate(100,100);
-    bucket[1] = vtkIdList::New();bucket[1]->Allocate(100,100);
-    bucket[2] = vtkIdList::New();bucket[2]->Allocate(100,100);
+    // mark the pixels in the threshold and count them
+    ThresholdFunctor threshold;
+    threshold.scalars_ = vScalars;
+    threshold.thrval_ = thrval;
+    threshold.dist_ = dist;
+    vtkSMPTools::For(0,totalNumPixels,threshold);
+    int nonZeroPixels = threshold.nonZeroPixels_;
 
-    bucketlookup[0] = 0;
-    bucketlookup[1] = 1;
-    bucketlookup[2] = 2;
+    fprintf(stdout,"pixels in threshold: %i\n",nonZeroPixels);
 
-    // loop until all the buckets are empty
-    int loopAllBuckets = 0;
+    // all steps have unit cost, so a breadth first search from the start
+    // point visits the pixels in order of distance.  The queue is a flat
+    // array, each pixel is queued at most once.
     int p = vtksp->ComputePointId(start);
-    int q = 0;
 
-    // id point is a zero distance from itself
-    mapScalars->SetTuple1(p,0);
+    std::vector<int> queue;
+    queue.reserve(nonZeroPixels+1);
 
-//    bucket[0]->InsertNextId(p);
-//    bucket[0]->DeleteId(p);
+    if (p >= 0) {
+      // id point is a zero distance from itself
+      dist[p] = 0;
+      queue.push_back(p);
+    }
 
-    while ((loopAllBuckets < nonZeroPixels) && (p != -1)) {
+    for (size_t head = 0; head < queue.size(); head++) {
+
+        p = queue[head];
 
         if (useCityBlock_ == 0) {
           get26ConnectivityNeighbors(p);
@@ -183,84 +446,18 @@ int cvDistanceMap::createDistanceMap (vtkStructuredPoints *vtksp,
           getCityBlockNeighbors(p);
         }
 
+        distanceMapType Dq = dist[p] + 1;
+
         // loop over neighbors_s and calc distance
         for (n = 0; n < numNeighbors_; n++) {
-            q = neighbors_[n];
-
+            int q = neighbors_[n];
             if (q < 0) continue;
-            // check distance value
-            //fprintf(stdout,"mapScalars [%i] : %i\n",q,(int)mapScalars->GetTuple1(q));
-            if ((int)(mapScalars->GetTuple1(q)) >= 0) {
-                distanceMapType pval = (distanceMapType)(mapScalars->GetTuple1(p));
-                distanceMapType qval = (distanceMapType)(mapScalars->GetTuple1(q));
-                Dq = pval + 1;
-                //fprintf(stdout,"%i %i %i\n",p,q,Dq);
-                if (Dq < qval) {
-                    if (qval != MAX_DISTANCE_VAL) {
-                      buckindex = -1;
-                      for (bloop = 0; bloop < 3; bloop++) {
-                        if (qval == bucketlookup[bloop]) {
-                          buckindex = bloop;
-                          break;
-                          }
-                      }
-                      if (buckindex < 0) {
-                        fprintf(stdout,"invalid bucket (Dq = %i, qval = %i)\n",Dq,qval);
-                        exit(-1);
-                      }
-                      bucket[buckindex] -> DeleteId(q);
-                    }
-                    mapScalars->SetTuple1(q,Dq);
-                    buckindex = -1;
-                    for (bloop = 0; bloop < 3; bloop++) {
-                      if (Dq == bucketlookup[bloop]) {
-                          buckindex = bloop;
-                          break;
-                      }
-                    }
-                    if (buckindex < 0) {
-                      fprintf(stdout,"invalid bucket (Dq = %i, q = %i)\n",Dq,q);
-                      exit(-1);
-                    }
-                    bucket[buckindex]->InsertNextId(q);
-                }
+            if (dist[q] >= 0 && Dq < dist[q]) {
+                dist[q] = Dq;
+                queue.push_back(q);
             }
         }
 
-      p = -1;
-
-      while (loopAllBuckets < nonZeroPixels) {
-        buckindex = -1;
-        for (bloop = 0; bloop < 3; bloop++) {
-          if (loopAllBuckets == bucketlookup[bloop]) {
-             buckindex = bloop;
-             break;
-          }
-        }
-        if (buckindex < 0) {
-          fprintf(stdout,"invalid bucket (loopAllBuckets %i)\n",loopAllBuckets);
-                        exit(-1);
-        }
-        if (bucket[buckindex]->GetNumberOfIds() == 0) {
-            //buckets[buckindex+3] = buckets[buckindex];
-          bucketlookup[buckindex] = loopAllBuckets+3;
-            //buckets[buckindex] = nullptr;
-          loopAllBuckets++;
-        } else {
-            //if (buckets[loopAllBuckets] == nullptr) {
-            //  fprintf(stdout,"invalid bucket (loopAllBuckets %i)\n",loopAllBuckets);
-            //  exit(-1);
-            //}
-            //if (buckets[loopAllBuckets]->GetNumberOfIds() == 0) {
-            //    fprintf(stdout,"error, zero entries in bucket %i\n",loopAllBuckets);
-            //    exit(-1);
-            //}
-            p = bucket[buckindex]->GetId(0);
-            bucket[buckindex]->DeleteId(p);
-            break;
-        }
-      }
-
     }
 
 //    vtkXMLDataSetWriter *foo = vtkXMLDataSetWriter::New();
@@ -270,11 +467,6 @@ int cvDistanceMap::createDistanceMap (vtkStructuredPoints *vtksp,
 
     map_ = mapsp;
 
-    //delete [] buckets;
-    bucket[0]->Delete();
-    bucket[1]->Delete();
-    bucket[2]->Delete();
-
     return SV_OK;
 
 }
@@ -283,6 +475,78 @@ vtkStructuredPoints* cvDistanceMap::getDistanceMap() {
     return map_;
 }
 
+int cvDistanceMap::createEuclideanDistanceTransform(vtkStructuredPoints *vtksp,
+                                                      vtkFloatingPointType thrval) {
+
+    // Exact separable distance transform: squared distances are computed
+    // one axis at a time, each pass being parallel over the lines along
+    // that axis.  Linear in the number of voxels and uses the voxel
+    // spacing, so anisotropic images are handled.
+
+    if (edt_ != nullptr) {
+        edt_->Delete();
+        edt_ = nullptr;
+    }
+
+    vtkDataArray *vScalars = vtksp->GetPointData()->GetScalars();
+    if (vScalars == nullptr) {
+        fprintf(stderr,"ERROR: no scalars on image!\n");
+        return SV_ERROR;
+    }
+
+    int dims[3];
+    vtkFloatingPointType spacing[3];
+    vtkFloatingPointType origin[3];
+    vtksp->GetDimensions(dims);
+    vtksp->GetSpacing(spacing);
+    vtksp->GetOrigin(origin);
+
+    int totalNumPixels = dims[0]*dims[1]*dims[2];
+
+    // background pixels are at zero distance
+    std::vector<double> dist(totalNumPixels);
+    for (int s = 0; s < totalNumPixels; s++) {
+      if ((int)(vScalars->GetComponent(s,0)) >= thrval) {
+        dist[s] = EDT_INFINITY;
+      } else {
+        dist[s] = 0.0;
+      }
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+      if (dims[axis] < 1) continue;
+      EDTFunctor edt;
+      edt.dist_ = &dist[0];
+      edt.dims_[0] = dims[0]; edt.dims_[1] = dims[1]; edt.dims_[2] = dims[2];
+      edt.axis_ = axis;
+      edt.spacing_ = spacing[axis];
+      vtkSMPTools::For(0,totalNumPixels/dims[axis],edt);
+    }
+
+    vtkFloatArray *edtScalars = vtkFloatArray::New();
+    edtScalars->SetNumberOfComponents(1);
+    edtScalars->SetNumberOfTuples(totalNumPixels);
+    edtScalars->SetName("EuclideanDistance");
+    float *edtValues = edtScalars->GetPointer(0);
+    for (int s = 0; s < totalNumPixels; s++) {
+      edtValues[s] = (dist[s] >= EDT_INFINITY) ? VTK_FLOAT_MAX : (float)sqrt(dist[s]);
+    }
+
+    edt_ = vtkStructuredPoints::New();
+    edt_->CopyStructure(vtksp);
+    edt_->SetOrigin(origin);
+    edt_->SetSpacing(spacing);
+    edt_->GetPointData()->SetScalars(edtScalars);
+    edtScalars->Delete();
+
+    return SV_OK;
+
+}
+
+vtkStructuredPoints* cvDistanceMap::getEuclideanDistanceTransform() {
+    return edt_;
+}
+
 vtkPolyData* cvDistanceMap::getPathOld(int stop[3]) {
 
     if (map_ == nullptr) {
@@ -710,7 +974,7 @@ int cvDistanceMap::get26ConnectivityNeighbors(int p) {
 
   int n,ti,tj,tk;
 
-  for (n = 0; n < 27; n++) {
+  for (n = 0; n < 26; n++) {
       ti = i + b_[0][n];
       tj = j + b_[1][n];
       tk = k + b_[2][n];
@@ -773,11 +1037,6 @@ int cvDistanceMap::createInitMask() {
     }
 
 
-    vtkXMLDataSetWriter *foo = vtkXMLDataSetWriter::New();
-    foo->SetInputData(mask_);
-    foo->SetFileName("debug.vti");
-    foo->Write();
-
     fprintf(stdout,"number of unmasked pixels (%i)\n",maskNum);
 
     return SV_OK;
@@ -788,57 +1047,52 @@ int cvDistanceMap::thinMask(int *numPixelsRemoved) {
 
     *numPixelsRemoved = 0;
 
-    vtkDataArray *maskScalars = mask_->GetPointData()->GetScalars();
+    vtkShortArray *maskScalars = vtkShortArray::SafeDownCast(mask_->GetPointData()->GetScalars());
+    short *mask = maskScalars->GetPointer(0);
 
-    // scan each direction, build list of
-    // indexes to remove, then parallel thin
-    int i,j,k,p,s,n;
+    // one layer of topology preserving thinning, done as six directional
+    // sub-iterations.  The start and stop pixels are never removed.
+    int startId = mask_->ComputePointId(start_);
+    int stopId = mask_->ComputePointId(stop_);
 
-    vtkIdList *removeIds = vtkIdList::New();
-    removeIds->Allocate(100,100);
+    static const int dirs[6][3] = {{-1,0,0},{1,0,0},{0,-1,0},
+                                   {0,1,0},{0,0,-1},{0,0,1}};
 
     int numPixels = 0;
-    int inside = 0;
-    int sprev = 0;
-    for (i = 0; i < imgDims_[0]; i++) {
-      for (j = 0; j < imgDims_[1]; j++) {
-        for (k = 0; k < imgDims_[2]; k++) {
-          s =  i+imgDims_[0]*j+k*imgDims_[0]*imgDims_[1];
-          p =  maskScalars->GetTuple1(s);
-          if (inside == 0 && p > 0) {
-            removeIds->InsertNextId(s);
-            inside = 1;
-          } else if (inside == 1 && p == 0) {
-            inside = 0;
-            removeIds->InsertNextId(sprev);
-          }
-          sprev = s;
-        }
-        if (inside == 1) {
-            removeIds->InsertNextId(s);
-            inside = 0;
-        }
+    int nbhd[27];
+
+    for (int d = 0; d < 6; d++) {
+
+      ThinCandidatesFunctor candidates;
+      candidates.mask_ = mask;
+      for (int c = 0; c < 3; c++) {
+        candidates.dims_[c] = imgDims_[c];
+        candidates.dir_[c] = dirs[d][c];
       }
+      vtkSMPTools::For(0,imgDims_[2],candidates);
+
+      // remove serially, checking again against the updated mask
+      for (size_t n = 0; n < candidates.candidates_.size(); n++) {
+        int s = candidates.candidates_[n];
+        if (s == startId || s == stopId) continue;
+        int k = s / (imgDims_[0]*imgDims_[1]);
+        int j = (s - k*imgDims_[0]*imgDims_[1]) / imgDims_[0];
+        int i = s - k*imgDims_[0]*imgDims_[1] - j*imgDims_[0];
+        getNeighborhood(mask,imgDims_,i,j,k,nbhd);
+        if (numForegroundNeighbors(nbhd) <= 1) continue;
+        if (!isSimplePoint(nbhd)) continue;
+        mask[s] = 0;
+        numPixels++;
+      }
+
     }
 
-    numPixels = removeIds->GetNumberOfIds();
+    maskScalars->Modified();
 
     fprintf(stdout,"num pixels removed (%i)\n",numPixels);
 
     *numPixelsRemoved = numPixels;
 
-    // mask all surface pixels
-    for (n = 0; n < numPixels; n++) {
-        maskScalars->SetTuple1(removeIds->GetId(n),0);
-    }
-
-    vtkXMLDataSetWriter *foo = vtkXMLDataSetWriter::New();
-    foo->SetInputData(mask_);
-    foo->SetFileName("debug-thinned.vti");
-    foo->Write();
-
-    removeIds->Delete();
-
     return SV_OK;
 
 }
@@ -58,6 +58,12 @@ class SV_EXPORT_IMAGE cvDistanceMap {
     vtkStructuredPoints* getDistanceMap();
     void setDistanceMap(vtkStructuredPoints *sp);
 
+    // exact euclidean distance (in physical units) from each voxel
+    // above threshold to the nearest voxel below threshold
+    int createEuclideanDistanceTransform(vtkStructuredPoints *vtksp,
+                                         vtkFloatingPointType thrval);
+    vtkStructuredPoints* getEuclideanDistanceTransform();
+
     vtkPolyData* getPath(int stop[3], int minqstop);
     vtkPolyData* getPathByThinning(int stop[3], int minqstop, int maxIterNum);
     vtkPolyData* getPathOld(int stop[3]);
@@ -74,6 +80,7 @@ class SV_EXPORT_IMAGE cvDistanceMap {
 
     vtkStructuredPoints *map_;
     vtkStructuredPoints *mask_;
+    vtkStructuredPoints *edt_;
     vtkPolyData *path_;
     int start_[3];
     int stop_[3];
@@ -39,6 +39,8 @@
 #include "sv2_image.h"
 #include "sv_misc_utils.h"
 
+#include "vtkSMPTools.h"
+
 
 static double gMachineEpsilon;
 
@@ -65,7 +67,6 @@ Image_T *ReadImage( char *filebase, int fileNumRange[], char *imgTypeFlag,
   int i, dataLen, fileLen, num;
   short *tmpDataShort = nullptr;
   double *tmpDataDouble = nullptr;
-  int rowIx, colIx, planeIx, planeOffset;
   int convertShort;
 
   // Uh, yeah, I know it's ugly to put this here, but what else are we
@@ -118,7 +119,10 @@ Image_T *ReadImage( char *filebase, int fileNumRange[], char *imgTypeFlag,
   dataLen = imgDims[0] * imgDims[1] * imgDims[2];
   fileLen = imgDims[0] * imgDims[1];
 
-  image->pixels = new Pixel_T [dataLen];
+  image->intensity = new float [dataLen];
+  image->gradX = nullptr;
+  image->gradY = nullptr;
+  image->gradZ = nullptr;
   if (convertShort) {
     tmpDataShort = new short [dataLen];
   } else {
@@ -135,8 +139,9 @@ Image_T *ReadImage( char *filebase, int fileNumRange[], char *imgTypeFlag,
     fp = fopen( filename, "r" );
     if (fp == nullptr) {
       fprintf(stderr, "ERR: Couldn't open image file %s.\n", filename);
-      delete image->pixels;
-      delete image;
+      if (convertShort) delete [] tmpDataShort;
+      else delete [] tmpDataDouble;
+      Image_Delete( image );
       return nullptr;
     }
 
@@ -151,29 +156,23 @@ Image_T *ReadImage( char *filebase, int fileNumRange[], char *imgTypeFlag,
     fclose(fp);
     if (num != fileLen) {
       fprintf(stderr, "ERR: Image file size mismatch [%s].\n", filename);
-      delete image->pixels;
-      delete image;
+      if (convertShort) delete [] tmpDataShort;
+      else delete [] tmpDataDouble;
+      Image_Delete( image );
       return nullptr;
     }
   }
 
   for (i = 0; i < dataLen; i++) {
-    planeIx = i / (imgDims[0] * imgDims[1]);
-    planeOffset = i % (imgDims[0] * imgDims[1]);
-    rowIx = planeOffset / imgDims[0];
-    colIx = planeOffset % imgDims[0];
     if (convertShort) {
-      image->pixels[i].intensity = (double)tmpDataShort[i];
+      image->intensity[i] = (float)tmpDataShort[i];
     } else {
-      image->pixels[i].intensity = tmpDataDouble[i];
+      image->intensity[i] = (float)tmpDataDouble[i];
     }
-    image->pixels[i].plane = planeIx;
-    image->pixels[i].row = rowIx;
-    image->pixels[i].col = colIx;
   }
 
-  if (convertShort) delete tmpDataShort;
-  else delete tmpDataDouble;
+  if (convertShort) delete [] tmpDataShort;
+  else delete [] tmpDataDouble;
 
   strcpy( image->filebase, filebase );
   image->fileNumRange[0] = fileNumRange[0];
@@ -197,9 +196,10 @@ Image_T *ReadImage( char *filebase, int fileNumRange[], char *imgTypeFlag,
 void Image_Delete( Image_T *img )
 {
   if ( img != nullptr ) {
-    if ( img->pixels != nullptr ) {
-      delete [] img->pixels;
-    }
+    delete [] img->intensity;
+    delete [] img->gradX;
+    delete [] img->gradY;
+    delete [] img->gradZ;
     delete img;
   }
   return;
@@ -209,80 +209,44 @@ void Image_Delete( Image_T *img )
 // =====================
 //   ComputePointSlope
 // =====================
-// Computes the first spatial derivative at a given point (curr) in
-// the dimension indicated by dimFlag (0 = x, 1 = y, 2 = z).  The
-// derivative is computed using linear interpolation, and the points
-// prev, curr and next are presumed to be from a single-valued
-// function.  That is, it is assumed that the slopes of the previous
-// and next edges are both finite (i.e. not infinite).
+// Computes the first spatial derivative at a given point (curr) from
+// the intensities of the point and its two neighbors in one dimension,
+// ddom being the pixel spacing in that dimension.  The derivative is
+// computed using linear interpolation, and the points prev, curr and
+// next are presumed to be from a single-valued function.  That is, it
+// is assumed that the slopes of the previous and next edges are both
+// finite (i.e. not infinite).
 //
-// Note some funny business with mixing of types (i.e. of short, int
-// and double).  This arises from the fact that the images are stored
-// as short's, but working in physical space (i.e. mm) requires
-// double's.  And just to be safe, I assign operations btw short's to
-// int's to avoid potential overflow problems.
-
-double ComputePointSlope( Pixel_T *prev, Pixel_T *curr, Pixel_T *next,
-                          Image_T *image, int dimFlag )
+// The shorter of the two edges is extended along the longer one by the
+// same arc length, and the slope is taken across the resulting
+// (symmetric in length) stencil.  Written without branches on the data
+// so that the row loops in ComputeImageGrad vectorize.  Intensities are
+// stored as float but the slope is evaluated in double.
+
+static inline double PointSlope( double prev, double curr, double next,
+                                 double ddom )
 {
-  double rngPrev, rngCurr, rngNext;
-  double drng;
-  double ddom, domCoord;
-  double lenPrev, lenNext;
-  double interpFactor, domInterp, rngInterp;
-  double slopeDdom, slopeDrng, slope;
-
-  rngPrev = prev->intensity;
-  rngCurr = curr->intensity;
-  rngNext = next->intensity;
-
-  switch (dimFlag) {
-  case 0:
-    // Differentiate w.r.t. x.
-    ddom = image->pixelDims[0];
-    domCoord = (curr->row * ddom) + (ddom / 2.0);
-    break;
-  case 1:
-    // Differentiate w.r.t. y.
-    ddom = image->pixelDims[1];
-    domCoord = (curr->col * ddom) + (ddom / 2.0);
-    break;
-  case 2:
-    // Differentiate w.r.t. z.
-    ddom = image->pixelDims[2];
-    domCoord = (curr->plane * ddom) + (ddom / 2.0);
-    break;
-  default:
-    fprintf(stderr, "ERR: Invalid dimension flag in ComputePointSlope.\n");
-    exit(0);
-  }
+  double drngPrev = curr - prev;
+  double drngNext = curr - next;
+  double lenPrev = sqrt( svSqr(ddom) + svSqr(drngPrev) );
+  double lenNext = sqrt( svSqr(ddom) + svSqr(drngNext) );
 
-  drng = rngCurr - rngPrev;
-  lenPrev = sqrt( svSqr(ddom) + svSqr(drng) );
-  drng = rngCurr - rngNext;
-  lenNext = sqrt( svSqr(ddom) + svSqr(drng) );
-
-  // Interpolate along next edge.
-  if (lenPrev < lenNext) {
-    interpFactor = lenPrev / lenNext;
-    domInterp = domCoord + interpFactor * ddom;
-    rngInterp = (double)rngCurr - interpFactor * (rngCurr - rngNext);
-    slopeDdom = ddom + (domInterp - domCoord);
-    slopeDrng = rngInterp - (double)rngPrev;
-  }
+  int interpNext = ( lenPrev < lenNext );
 
-  // Interpolate along previous edge.
-  else {
-    interpFactor = lenNext / lenPrev;
-    domInterp = domCoord - interpFactor * ddom;
-    rngInterp = (double)rngCurr - interpFactor * (rngCurr - rngPrev);
-    slopeDdom = (domCoord - domInterp) + ddom;
-    slopeDrng = (double)rngNext - rngInterp;
-  }
+  // Interpolate along next edge, or along previous edge.
+  double interpFactor = interpNext ? ( lenPrev / lenNext ) : ( lenNext / lenPrev );
+  double slopeDrng = interpNext ?
+    ( ( curr - interpFactor * drngNext ) - prev ) :
+    ( next - ( curr - interpFactor * drngPrev ) );
+  double slopeDdom = ddom + interpFactor * ddom;
 
-  slope = slopeDrng / slopeDdom;
+  return slopeDrng / slopeDdom;
+}
 
-  return slope;
+double ComputePointSlope( double prev, double curr, double next,
+                          double ddom )
+{
+  return PointSlope( prev, curr, next, ddom );
 }
 
 
@@ -308,105 +272,122 @@ double ComputePointSlope( Pixel_T *prev, Pixel_T *curr, Pixel_T *next,
 // being able to evaluate the gradient at the very edge of the image
 // is probably not important, as the propagating front should probably
 // not get too close to the image boundary.
+//
+// Rows of pixels are processed in parallel.  The interior of each row
+// is a straight loop over contiguous planes of intensity and gradient
+// values.
 
-void ComputeImageGrad( Image_T *image )
+class ImageGradFunctor
 {
-  int xdim, ydim, zdim;
-  int i, j, k, pixIx, prevIx, nextIx;
-  Pixel_T *prev, *curr, *next;
-  int tri;
+public:
+  Image_T *image;
 
-  if ( image->gradValid ) {
-    return;
+  // Boundary pixels keep the neighbor indexing of the original
+  // implementation.
+  void BorderPixel( int i, int j, int k, int tri ) const
+  {
+    int xdim = image->imgDims[0];
+    int ydim = image->imgDims[1];
+    int zdim = image->imgDims[2];
+    int pixIx = (k * xdim * ydim) + (j * xdim) + i;
+    const float *I = image->intensity;
+    int prevIx, nextIx;
+
+    // x:
+    prevIx = ( i == 0 ) ? 0 : pixIx-1;
+    nextIx = ( i == (xdim-1) ) ? (xdim-1) : pixIx+1;
+    image->gradX[pixIx] = PointSlope( I[prevIx], I[pixIx], I[nextIx],
+                                      image->pixelDims[0] );
+
+    // y:
+    prevIx = ( j == 0 ) ? 0 : pixIx-xdim;
+    nextIx = ( j == (ydim-1) ) ? (ydim-1) : pixIx+xdim;
+    image->gradY[pixIx] = PointSlope( I[prevIx], I[pixIx], I[nextIx],
+                                      image->pixelDims[1] );
+
+    // z:
+    if ( tri ) {
+      prevIx = ( k == 0 ) ? 0 : pixIx - (xdim*ydim);
+      nextIx = ( k == (zdim-1) ) ? (zdim-1) : pixIx + (xdim*ydim);
+      image->gradZ[pixIx] = PointSlope( I[prevIx], I[pixIx], I[nextIx],
+                                        image->pixelDims[2] );
+    } else {
+      image->gradZ[pixIx] = 0.0;
+    }
   }
 
-  xdim = image->imgDims[0];   // xdim == # cols
-  ydim = image->imgDims[1];   // ydim == # rows
-  zdim = image->imgDims[2];   // zdim == # planes
+  void operator()( vtkIdType begin, vtkIdType end ) const
+  {
+    int xdim = image->imgDims[0];
+    int ydim = image->imgDims[1];
+    int zdim = image->imgDims[2];
+    int planeSize = xdim * ydim;
+    int tri = ( image->dim == 3 );
+    double dx = image->pixelDims[0];
+    double dy = image->pixelDims[1];
+    double dz = image->pixelDims[2];
+    const float *I = image->intensity;
+    float *gx = image->gradX;
+    float *gy = image->gradY;
+    float *gz = image->gradZ;
+
+    for ( vtkIdType row = begin; row < end; row++ ) {
+      int k = row / ydim;
+      int j = row % ydim;
+      int i;
+
+      if ( ( j == 0 ) || ( j == (ydim-1) ) ||
+           ( (tri) && ( k == 0 ) ) || ( (tri) && ( k == (zdim-1) ) ) ) {
+        for ( i = 0; i < xdim; i++ ) {
+          BorderPixel( i, j, k, tri );
+        }
+        continue;
+      }
 
-  if ( image->dim == 3 ) {
-    tri = 1;
-  } else {
-    tri = 0;
+      BorderPixel( 0, j, k, tri );
+      if ( xdim > 1 ) {
+        BorderPixel( xdim-1, j, k, tri );
+      }
+
+      int base = (k * planeSize) + (j * xdim);
+      for ( i = 1; i < (xdim-1); i++ ) {
+        int ix = base + i;
+        gx[ix] = PointSlope( I[ix-1], I[ix], I[ix+1], dx );
+        gy[ix] = PointSlope( I[ix-xdim], I[ix], I[ix+xdim], dy );
+      }
+      if ( tri ) {
+        for ( i = 1; i < (xdim-1); i++ ) {
+          int ix = base + i;
+          gz[ix] = PointSlope( I[ix-planeSize], I[ix], I[ix+planeSize], dz );
+        }
+      } else {
+        for ( i = 1; i < (xdim-1); i++ ) {
+          gz[base+i] = 0.0;
+        }
+      }
+    }
   }
+};
 
-  for (k = 0; k < zdim; k++) {
-    for (j = 0; j < ydim; j++) {
-      for (i = 0; i < xdim; i++) {
-	pixIx = (k * xdim * ydim) + (j * xdim) + i;
-
-	// Boundary pixels:
-	if ( ( i == 0 ) || ( i == (xdim-1) ) ||
-	     ( j == 0 ) || ( j == (ydim-1) ) ||
-	     ( (tri) && ( k == 0 ) ) || ( (tri) && ( k == (zdim-1) ) ) ) {
-
-	  curr = &( image->pixels[pixIx] );
-
-	  // x:
-	  prevIx = ( i == 0 ) ? 0 : pixIx-1;
-	  nextIx = ( i == (xdim-1) ) ? (xdim-1) : pixIx+1;
-	  prev = &( image->pixels[prevIx] );
-	  next = &( image->pixels[nextIx] );
-	  image->pixels[pixIx].gradX = ComputePointSlope( prev, curr, next,
-							  image, 0 );
-
-	  // y:
-	  prevIx = ( j == 0 ) ? 0 : pixIx-xdim;
-	  nextIx = ( j == (ydim-1) ) ? (ydim-1) : pixIx+xdim;
-	  prev = &( image->pixels[prevIx] );
-	  next = &( image->pixels[nextIx] );
-	  image->pixels[pixIx].gradY = ComputePointSlope( prev, curr, next,
-							  image, 1 );
-
-	  // z:
-	  if ( tri ) {
-	    prevIx = ( k == 0 ) ? 0 : pixIx - (xdim*ydim);
-	    nextIx = ( k == (zdim-1) ) ? (zdim-1) : pixIx + (xdim*ydim);
-	    prev = &( image->pixels[prevIx] );
-	    next = &( image->pixels[nextIx] );
-	    image->pixels[pixIx].gradZ = ComputePointSlope( prev, curr, next,
-							    image, 2 );
-	  } else {
-	    image->pixels[pixIx].gradZ = 0.0;
-	  }
-
-	  // Before 2/16/00:
-	  //	  image->pixels[pixIx].gradX = 0.0;
-	  //	  image->pixels[pixIx].gradY = 0.0;
-	  //	  image->pixels[pixIx].gradZ = 0.0;
+void ComputeImageGrad( Image_T *image )
+{
+  int numPix;
 
-	  continue;
-	}
+  if ( image->gradValid ) {
+    return;
+  }
 
-	// Differentiation w.r.t. x:
-	// (adjacent elements in x are also physically adjacent)
-	prev = &( image->pixels[pixIx-1] );
-	curr = &( image->pixels[pixIx] );
-	next = &( image->pixels[pixIx+1] );
-	image->pixels[pixIx].gradX = ComputePointSlope( prev, curr, next,
-							image, 0 );
-
-	// Differentiation w.r.t. y:
-	prev = &( image->pixels[pixIx-xdim] );
-	curr = &( image->pixels[pixIx] );
-	next = &( image->pixels[pixIx+xdim] );
-	image->pixels[pixIx].gradY = ComputePointSlope( prev, curr, next,
-							image, 1 );
-
-	// Differentiation w.r.t. z:
-	if ( tri ) {
-	  prev = &( image->pixels[pixIx - (xdim*ydim)] );
-	  curr = &( image->pixels[pixIx] );
-	  next = &( image->pixels[pixIx + (xdim*ydim)] );
-	  image->pixels[pixIx].gradZ = ComputePointSlope( prev, curr, next,
-							  image, 2 );
-	} else {
-	  image->pixels[pixIx].gradZ = 0.0;
-	}
-      }
-    }
+  numPix = image->imgDims[0] * image->imgDims[1] * image->imgDims[2];
+  if ( image->gradX == nullptr ) {
+    image->gradX = new float [numPix];
+    image->gradY = new float [numPix];
+    image->gradZ = new float [numPix];
   }
 
+  ImageGradFunctor gradFunctor;
+  gradFunctor.image = image;
+  vtkSMPTools::For( 0, image->imgDims[1] * image->imgDims[2], gradFunctor );
+
   image->gradValid = 1;
   return;
 }
@@ -438,9 +419,9 @@ void Img_GetMagGradRange( Image_T *image, double rng[] )
   ComputeImageGrad( image );
   numPix = (image->imgDims[0]) * (image->imgDims[1]) * (image->imgDims[2]);
   for ( i = 0; i < numPix; i++ ) {
-    gx = image->pixels[i].gradX;
-    gy = image->pixels[i].gradY;
-    gz = image->pixels[i].gradZ;
+    gx = image->gradX[i];
+    gy = image->gradY[i];
+    gz = image->gradZ[i];
     mag = Magnitude( gx, gy, gz );
     if ( i == 0 ) {
       currMin = currMax = mag;
@@ -468,8 +449,8 @@ void Img_GetXYMagGradRange( Image_T *image, double rng[] )
   ComputeImageGrad( image );
   numPix = (image->imgDims[0]) * (image->imgDims[1]) * (image->imgDims[2]);
   for ( i = 0; i < numPix; i++ ) {
-    gx = image->pixels[i].gradX;
-    gy = image->pixels[i].gradY;
+    gx = image->gradX[i];
+    gy = image->gradY[i];
     mag = Magnitude( gx, gy, 0.0 );
     if ( i == 0 ) {
       currMin = currMax = mag;
@@ -497,7 +478,7 @@ void Img_GetZMagGradRange( Image_T *image, double rng[] )
   ComputeImageGrad( image );
   numPix = (image->imgDims[0]) * (image->imgDims[1]) * (image->imgDims[2]);
   for ( i = 0; i < numPix; i++ ) {
-    gz = image->pixels[i].gradZ;
+    gz = image->gradZ[i];
     mag = fabs(gz);
     if ( i == 0 ) {
       currMin = currMax = mag;
@@ -524,7 +505,7 @@ void Img_GetIntensityRange( Image_T *image, double rng[] )
 
   numPix = (image->imgDims[0]) * (image->imgDims[1]) * (image->imgDims[2]);
   for ( i = 0; i < numPix; i++ ) {
-    datum = image->pixels[i].intensity;
+    datum = image->intensity[i];
     if ( i == 0 ) {
       currMin = currMax = datum;
     } else {
@@ -669,9 +650,9 @@ void CloseImageGradBounds( Image_T *image )
 	     ( j < bdReg ) || ( j >= (ydim-bdReg) ) ||
 	     ( (tri) && ( k < bdReg ) ) ||
 	     ( (tri) && ( k >= (zdim-bdReg) ) ) ) {
-	  image->pixels[pixIx].gradX = maxG;
-	  image->pixels[pixIx].gradY = maxG;
-	  image->pixels[pixIx].gradZ = maxG;
+	  image->gradX[pixIx] = maxG;
+	  image->gradY[pixIx] = maxG;
+	  image->gradZ[pixIx] = maxG;
 	  continue;
 	}
       }
@@ -705,7 +686,6 @@ Image_T *CreateImage( void *data, int numData, char *imgTypeFlag,
   short *tmpDataShort;
   float *tmpDataFloat;
   double *tmpDataDouble;
-  int rowIx, colIx, planeIx, planeOffset;
   int dataCode;
 
    // See notes at the other call to FindMachineEpsilon.
@@ -736,9 +716,13 @@ Image_T *CreateImage( void *data, int numData, char *imgTypeFlag,
   len = imgDims[0] * imgDims[1] * imgDims[2];
   if (len != numData) {
     fprintf(stderr, "ERR: Data size mismatch.\n");
+    delete image;
     return nullptr;
   }
-  image->pixels = new Pixel_T [len];
+  image->intensity = new float [len];
+  image->gradX = nullptr;
+  image->gradY = nullptr;
+  image->gradZ = nullptr;
 
   switch (dataCode) {
   case 0:
@@ -753,26 +737,17 @@ Image_T *CreateImage( void *data, int numData, char *imgTypeFlag,
   }
 
   for (i = 0; i < len; i++) {
-    planeIx = i / (imgDims[0] * imgDims[1]);
-    planeOffset = i % (imgDims[0] * imgDims[1]);
-    rowIx = planeOffset / imgDims[0];
-    colIx = planeOffset % imgDims[0];
-
     switch (dataCode) {
     case 0:
-      image->pixels[i].intensity = (double)tmpDataShort[i];
+      image->intensity[i] = (float)tmpDataShort[i];
       break;
     case 1:
-      image->pixels[i].intensity = tmpDataDouble[i];
+      image->intensity[i] = (float)tmpDataDouble[i];
       break;
     case 2:
-      image->pixels[i].intensity = (double)tmpDataFloat[i];
+      image->intensity[i] = tmpDataFloat[i];
       break;
     }
-
-    image->pixels[i].plane = planeIx;
-    image->pixels[i].row = rowIx;
-    image->pixels[i].col = colIx;
   }
 
   image->closed = 0;
@@ -825,6 +800,10 @@ int LinearInterp( Image_T *image, ImageData_T code, double pos[],
     return SV_ERROR;
   }
 
+  if ( ( code != IMG_INTENSITY ) && ( ! image->gradValid ) ) {
+    ComputeImageGrad( image );
+  }
+
   xBdWidth = image->pixelDims[0] / 2.0;
   yBdWidth = image->pixelDims[1] / 2.0;
   zBdWidth = image->pixelDims[2] / 2.0;
@@ -863,16 +842,16 @@ int LinearInterp( Image_T *image, ImageData_T code, double pos[],
   if (inBorder) {
     switch (code) {
     case IMG_INTENSITY:
-      *value = (image->pixels[pixelIx].intensity);
+      *value = (image->intensity[pixelIx]);
       return SV_OK;
     case IMG_GRADIX:
-      *value = (image->pixels[pixelIx].gradX);
+      *value = (image->gradX[pixelIx]);
       return SV_OK;
     case IMG_GRADIY:
-      *value = (image->pixels[pixelIx].gradY);
+      *value = (image->gradY[pixelIx]);
       return SV_OK;
     case IMG_GRADIZ:
-      *value = (image->pixels[pixelIx].gradZ);
+      *value = (image->gradZ[pixelIx]);
       return SV_OK;
     default:
       fprintf(stderr, "ERR: ImageData_T not handled correctly.\n");
@@ -1041,51 +1020,51 @@ int LinearInterp( Image_T *image, ImageData_T code, double pos[],
 
   switch (code) {
   case IMG_INTENSITY:
-    I1 = image->pixels[ix1].intensity;
-    I2 = image->pixels[ix2].intensity;
-    I3 = image->pixels[ix3].intensity;
-    I4 = image->pixels[ix4].intensity;
+    I1 = image->intensity[ix1];
+    I2 = image->intensity[ix2];
+    I3 = image->intensity[ix3];
+    I4 = image->intensity[ix4];
     if ( tri ) {
-      I5 = image->pixels[ix5].intensity;
-      I6 = image->pixels[ix6].intensity;
-      I7 = image->pixels[ix7].intensity;
-      I8 = image->pixels[ix8].intensity;
+      I5 = image->intensity[ix5];
+      I6 = image->intensity[ix6];
+      I7 = image->intensity[ix7];
+      I8 = image->intensity[ix8];
     }
     break;
   case IMG_GRADIX:
-    I1 = image->pixels[ix1].gradX;
-    I2 = image->pixels[ix2].gradX;
-    I3 = image->pixels[ix3].gradX;
-    I4 = image->pixels[ix4].gradX;
+    I1 = image->gradX[ix1];
+    I2 = image->gradX[ix2];
+    I3 = image->gradX[ix3];
+    I4 = image->gradX[ix4];
     if ( tri ) {
-      I5 = image->pixels[ix5].gradX;
-      I6 = image->pixels[ix6].gradX;
-      I7 = image->pixels[ix7].gradX;
-      I8 = image->pixels[ix8].gradX;
+      I5 = image->gradX[ix5];
+      I6 = image->gradX[ix6];
+      I7 = image->gradX[ix7];
+      I8 = image->gradX[ix8];
     }
     break;
   case IMG_GRADIY:
-    I1 = image->pixels[ix1].gradY;
-    I2 = image->pixels[ix2].gradY;
-    I3 = image->pixels[ix3].gradY;
-    I4 = image->pixels[ix4].gradY;
+    I1 = image->gradY[ix1];
+    I2 = image->gradY[ix2];
+    I3 = image->gradY[ix3];
+    I4 = image->gradY[ix4];
     if ( tri ) {
-      I5 = image->pixels[ix5].gradY;
-      I6 = image->pixels[ix6].gradY;
-      I7 = image->pixels[ix7].gradY;
-      I8 = image->pixels[ix8].gradY;
+      I5 = image->gradY[ix5];
+      I6 = image->gradY[ix6];
+      I7 = image->gradY[ix7];
+      I8 = image->gradY[ix8];
     }
     break;
   case IMG_GRADIZ:
-    I1 = image->pixels[ix1].gradZ;
-    I2 = image->pixels[ix2].gradZ;
-    I3 = image->pixels[ix3].gradZ;
-    I4 = image->pixels[ix4].gradZ;
+    I1 = image->gradZ[ix1];
+    I2 = image->gradZ[ix2];
+    I3 = image->gradZ[ix3];
+    I4 = image->gradZ[ix4];
     if ( tri ) {
-      I5 = image->pixels[ix5].gradZ;
-      I6 = image->pixels[ix6].gradZ;
-      I7 = image->pixels[ix7].gradZ;
-      I8 = image->pixels[ix8].gradZ;
+      I5 = image->gradZ[ix5];
+      I6 = image->gradZ[ix6];
+      I7 = image->gradZ[ix7];
+      I8 = image->gradZ[ix8];
     }
     break;
   default:
@@ -1213,7 +1192,7 @@ void WriteZSlice( Image_T *image, char *filename, int num,
 		  char *imgTypeFlag, ImageData_T field )
 {
   FILE *fp;
-  int len, i;
+  int planeSize, i;
   short sDatum;
   double dDatum;
   int convertShort;
@@ -1227,49 +1206,52 @@ void WriteZSlice( Image_T *image, char *filename, int num,
     return;
   }
 
+  if ( field != IMG_INTENSITY ) {
+    ComputeImageGrad( image );
+  }
+
   fp = fopen( filename, "w" );
 
-  len = image->imgDims[0] * image->imgDims[1] * image->imgDims[2];
-  for ( i = 0; i < len; i++ ) {
-    if ( image->pixels[i].plane == num ) {
-      switch (field) {
-      case IMG_INTENSITY:
-	if (convertShort) {
-	  sDatum = (short)(image->pixels[i].intensity);
-	  fwrite( &sDatum, sizeof(short), 1, fp );
-	} else {
-	  dDatum = image->pixels[i].intensity;
-	  fwrite( &dDatum, sizeof(double), 1, fp );
-	}
-	break;
-      case IMG_GRADIX:
-	if (convertShort) {
-	  sDatum = (short)(image->pixels[i].gradX);
-	  fwrite( &sDatum, sizeof(short), 1, fp );
-	} else {
-	  dDatum = image->pixels[i].gradX;
-	  fwrite( &dDatum, sizeof(double), 1, fp );
-	}
-	break;
-      case IMG_GRADIY:
-	if (convertShort) {
-	  sDatum = (short)(image->pixels[i].gradY);
-	  fwrite( &sDatum, sizeof(short), 1, fp );
-	} else {
-	  dDatum = image->pixels[i].gradY;
-	  fwrite( &dDatum, sizeof(double), 1, fp );
-	}
-	break;
-      case IMG_GRADIZ:
-	if (convertShort) {
-	  sDatum = (short)(image->pixels[i].gradZ);
-	  fwrite( &sDatum, sizeof(short), 1, fp );
-	} else {
-	  dDatum = image->pixels[i].gradZ;
-	  fwrite( &dDatum, sizeof(double), 1, fp );
-	}
-	break;
+  // pixels of plane num are contiguous
+  planeSize = image->imgDims[0] * image->imgDims[1];
+  for ( i = num * planeSize; i < (num + 1) * planeSize; i++ ) {
+    switch (field) {
+    case IMG_INTENSITY:
+      if (convertShort) {
+        sDatum = (short)(image->intensity[i]);
+        fwrite( &sDatum, sizeof(short), 1, fp );
+      } else {
+        dDatum = image->intensity[i];
+        fwrite( &dDatum, sizeof(double), 1, fp );
+      }
+      break;
+    case IMG_GRADIX:
+      if (convertShort) {
+        sDatum = (short)(image->gradX[i]);
+        fwrite( &sDatum, sizeof(short), 1, fp );
+      } else {
+        dDatum = image->gradX[i];
+        fwrite( &dDatum, sizeof(double), 1, fp );
       }
+      break;
+    case IMG_GRADIY:
+      if (convertShort) {
+        sDatum = (short)(image->gradY[i]);
+        fwrite( &sDatum, sizeof(short), 1, fp );
+      } else {
+        dDatum = image->gradY[i];
+        fwrite( &dDatum, sizeof(double), 1, fp );
+      }
+      break;
+    case IMG_GRADIZ:
+      if (convertShort) {
+        sDatum = (short)(image->gradZ[i]);
+        fwrite( &sDatum, sizeof(short), 1, fp );
+      } else {
+        dDatum = image->gradZ[i];
+        fwrite( &dDatum, sizeof(double), 1, fp );
+      }
+      break;
     }
   }
 
@@ -1329,7 +1311,10 @@ int Img_GetMemoryUsage( Image_T *image )
 
   numPix = image->imgDims[0] * image->imgDims[1] * image->imgDims[2];
   sz = sizeof( Image_T );
-  sz += numPix * sizeof( Pixel_T );
+  sz += numPix * sizeof( float );
+  if ( image->gradX != nullptr ) {
+    sz += 3 * numPix * sizeof( float );
+  }
 
   return sz;
 }
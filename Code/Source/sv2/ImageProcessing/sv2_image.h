@@ -42,18 +42,16 @@
  * evolved from a C-style implementation and will probably remain this
  * way until we build more image functionality. */
 
-typedef struct {
-  double intensity;
-  int row;
-  int col;
-  int plane;
-  double gradX;
-  double gradY;
-  double gradZ;
-} Pixel_T;
+// Pixel data is stored as separate planes (struct of arrays) in
+// single precision.  The col/row/plane of a pixel are implicit in its
+// index, ix = (plane * imgDims[0] * imgDims[1]) + (row * imgDims[0]) + col.
+// The gradient planes are only allocated by ComputeImageGrad.
 
 typedef struct {
-  Pixel_T *pixels;
+  float *intensity;
+  float *gradX;
+  float *gradY;
+  float *gradZ;
   int imgDims[3];        // in pixels
   double pixelDims[3];   // in physical units
   char filebase[1000];
@@ -77,8 +75,8 @@ SV_EXPORT_IMAGE Image_T *CreateImage( void *data, int numData, char *imgTypeFlag
 
 SV_EXPORT_IMAGE void Image_Delete( Image_T *img );
 
-SV_EXPORT_IMAGE double ComputePointSlope( Pixel_T *prev, Pixel_T *curr, Pixel_T *next,
-                          Image_T *image, int dimFlag );
+SV_EXPORT_IMAGE double ComputePointSlope( double prev, double curr, double next,
+                          double ddom );
 
 SV_EXPORT_IMAGE void ComputeImageGrad( Image_T *image );
 
@@ -42,6 +42,42 @@
 
 #include "sv2_CalculateTKE.h"
 
+#include "vtkSMPTools.h"
+#include "vtkXMLPolyDataReader.h"
+
+// --------------------------
+// VelocityAccumulateFunctor
+// --------------------------
+// Welford update of the running mean velocity and the sum of squared
+// deviations for one timestep, run in parallel over the points.
+
+namespace {
+
+class VelocityAccumulateFunctor {
+
+  public:
+
+    vtkDataArray* velocity_;
+    double* mean_;
+    double* m2_;
+    double invNumSteps_;
+
+    void operator()(vtkIdType begin, vtkIdType end) const {
+        double vel[3];
+        for (vtkIdType i = begin; i < end; i++) {
+            velocity_->GetTuple(i,vel);
+            for (int j = 0; j < 3; j++) {
+                double delta = vel[j] - mean_[3*i+j];
+                mean_[3*i+j] += delta*invNumSteps_;
+                m2_[3*i+j] += delta*(vel[j] - mean_[3*i+j]);
+            }
+        }
+    }
+
+};
+
+}
+
 // --------------
 // cvCalculateTKE
 // --------------
@@ -53,6 +89,9 @@ cvCalculateTKE::cvCalculateTKE() {
     KE_ = nullptr;
     numInputArrays_ = 0;
     numArrayPts_ = 0;
+    points_ = nullptr;
+    numAccumSteps_ = 0;
+    accumPoints_ = nullptr;
 }
 
 
@@ -78,6 +117,10 @@ cvCalculateTKE::~cvCalculateTKE() {
         KE_->Delete();
     }
 
+    if (accumPoints_ != nullptr) {
+        accumPoints_->Delete();
+    }
+
 }
 
 
@@ -89,6 +132,9 @@ int cvCalculateTKE::SetInputData(int numPds, cvPolyData **inputPds) {
 
     int i = 0;
 
+    // drop any streaming state and previous input
+    this->ResetAccumulation();
+
     fprintf(stdout,"numPds: %i\n",numPds);
 
     numInputArrays_ = numPds;
@@ -126,6 +172,14 @@ int cvCalculateTKE::CalculateAverageVelocity() {
     averageU_->Allocate(numArrayPts_,1000);
     averageU_->Initialize();
 
+    // streaming input, the mean is already known
+    if (numAccumSteps_ > 0) {
+        for (i = 0; i < numArrayPts_; i++) {
+            averageU_->InsertNextTuple(&accumMean_[3*i]);
+        }
+        return SV_OK;
+    }
+
     for (i = 0; i < numArrayPts_; i++) {
         double v0 = 0.0;
         double v1 = 0.0;
@@ -172,6 +226,19 @@ int cvCalculateTKE::CalculateTKE() {
     vtkFloatingPointType avg[3];
     vtkFloatingPointType vel[3];
 
+    // streaming input, rms from the sum of squared deviations
+    if (numAccumSteps_ > 0) {
+        for (i = 0; i < numArrayPts_; i++) {
+            double v0 = sqrt(accumM2_[3*i]/numAccumSteps_);
+            double v1 = sqrt(accumM2_[3*i+1]/numAccumSteps_);
+            double v2 = sqrt(accumM2_[3*i+2]/numAccumSteps_);
+            rms_->InsertNextTuple3(v0,v1,v2);
+            double s = 0.5*((v0*v0)+(v1*v1)+(v2*v2));
+            KE_->InsertNextTuple1(s);
+        }
+        return SV_OK;
+    }
+
     for (i = 0; i < numArrayPts_; i++) {
         double v0 = 0.0;
         double v1 = 0.0;
@@ -228,3 +295,150 @@ cvPolyData* cvCalculateTKE::GetTKEPolyData() {
 
 }
 
+
+
+// ------------
+// ClearResults
+// ------------
+
+void cvCalculateTKE::ClearResults() {
+
+    if (averageU_ != nullptr) {
+        averageU_->Delete();
+        averageU_ = nullptr;
+    }
+
+    if (rms_ != nullptr) {
+        rms_->Delete();
+        rms_ = nullptr;
+    }
+
+    if (KE_ != nullptr) {
+        KE_->Delete();
+        KE_ = nullptr;
+    }
+
+}
+
+
+// -----------------
+// ResetAccumulation
+// -----------------
+
+int cvCalculateTKE::ResetAccumulation() {
+
+    this->ClearResults();
+
+    // also drop the arrays given to SetInputData
+    if (inputVectors_ != nullptr) {
+        delete [] inputVectors_;
+        inputVectors_ = nullptr;
+    }
+    numInputArrays_ = 0;
+
+    numAccumSteps_ = 0;
+    numArrayPts_ = 0;
+    std::vector<double>().swap(accumMean_);
+    std::vector<double>().swap(accumM2_);
+    if (accumPoints_ != nullptr) {
+        accumPoints_->Delete();
+        accumPoints_ = nullptr;
+    }
+    points_ = nullptr;
+
+    return SV_OK;
+
+}
+
+
+// ---------------
+// AddVelocityStep
+// ---------------
+
+int cvCalculateTKE::AddVelocityStep(cvPolyData *inputPd) {
+
+    vtkPolyData* pd = inputPd->GetVtkPolyData();
+    return this->AddVelocityStep(pd->GetPointData()->GetVectors(),pd->GetPoints());
+
+}
+
+
+// ---------------
+// AddVelocityStep
+// ---------------
+
+int cvCalculateTKE::AddVelocityStep(vtkDataArray *velocity, vtkPoints *points) {
+
+    if (velocity == nullptr || velocity->GetNumberOfComponents() != 3) {
+        fprintf(stderr,"ERROR: velocity step needs a 3 component array.\n");
+        return SV_ERROR;
+    }
+
+    if (inputVectors_ != nullptr) {
+        fprintf(stderr,"ERROR: cannot mix SetInputData and streaming steps.\n");
+        return SV_ERROR;
+    }
+
+    int numPts = velocity->GetNumberOfTuples();
+
+    if (numAccumSteps_ == 0) {
+        numArrayPts_ = numPts;
+        accumMean_.assign(3*numPts,0.0);
+        accumM2_.assign(3*numPts,0.0);
+        // keep our own copy so the step data can be released
+        if (accumPoints_ == nullptr) {
+            accumPoints_ = vtkPoints::New();
+        }
+        accumPoints_->Initialize();
+        if (points != nullptr) {
+            accumPoints_->DeepCopy(points);
+        }
+        points_ = accumPoints_;
+    } else if (numPts != numArrayPts_) {
+        fprintf(stderr,"ERROR: all velocity steps must have the same num pts (%i != %i).\n",numPts,numArrayPts_);
+        return SV_ERROR;
+    }
+
+    // previous results are out of date
+    this->ClearResults();
+
+    numAccumSteps_++;
+
+    VelocityAccumulateFunctor accumulator;
+    accumulator.velocity_ = velocity;
+    accumulator.mean_ = accumMean_.data();
+    accumulator.m2_ = accumM2_.data();
+    accumulator.invNumSteps_ = 1.0/numAccumSteps_;
+    vtkSMPTools::For(0,numPts,accumulator);
+
+    return SV_OK;
+
+}
+
+
+// -----------------------
+// AddVelocityStepFromFile
+// -----------------------
+
+int cvCalculateTKE::AddVelocityStepFromFile(char *fileName, char *arrayName) {
+
+    vtkXMLPolyDataReader* reader = vtkXMLPolyDataReader::New();
+    reader->SetFileName(fileName);
+    reader->Update();
+
+    vtkPolyData* pd = reader->GetOutput();
+    vtkDataArray* velocity = pd->GetPointData()->GetArray(arrayName);
+    if (velocity == nullptr) {
+        fprintf(stderr,"ERROR: no array %s in file %s.\n",arrayName,fileName);
+        reader->Delete();
+        return SV_ERROR;
+    }
+
+    int status = this->AddVelocityStep(velocity,pd->GetPoints());
+
+    // step data is released here
+    reader->Delete();
+
+    return status;
+
+}
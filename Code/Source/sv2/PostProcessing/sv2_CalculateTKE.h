@@ -37,6 +37,8 @@
 
 #include "sv_PolyData.h"
 
+#include <vector>
+
 // --------------
 // cvCalculateTKE
 // --------------
@@ -52,12 +54,23 @@ class SV_EXPORT_POST cvCalculateTKE {
     cvPolyData* GetAverageVelocityPolyData();
     cvPolyData* GetTKEPolyData();
 
+    // Streaming alternative to SetInputData. Timesteps are added one at a
+    // time and only a running mean and sum of squared deviations (Welford)
+    // are kept, each step is processed in parallel over the points.
+    // ResetAccumulation also drops the input of SetInputData.
+    int ResetAccumulation();
+    int AddVelocityStep(cvPolyData *inputPd);
+    int AddVelocityStep(vtkDataArray *velocity, vtkPoints *points);
+    int AddVelocityStepFromFile(char *fileName, char *arrayName);
+    int GetNumberOfAccumulatedSteps() { return numAccumSteps_; }
+
   protected:
 
   private:
 
     int CalculateAverageVelocity();
     int CalculateTKE();
+    void ClearResults();
 
     vtkDataArray** inputVectors_;
     int numInputArrays_;
@@ -68,6 +81,12 @@ class SV_EXPORT_POST cvCalculateTKE {
     vtkFloatingPointArrayType* rms_;
     vtkFloatingPointArrayType* KE_;
 
+    // running mean and sum of squared deviations per velocity component
+    int numAccumSteps_;
+    std::vector<double> accumMean_;
+    std::vector<double> accumM2_;
+    vtkPoints* accumPoints_;
+
 };
 
 #endif
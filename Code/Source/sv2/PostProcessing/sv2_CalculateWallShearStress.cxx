@@ -42,6 +42,42 @@
 
 #include "sv2_CalculateWallShearStress.h"
 
+#include "vtkSMPTools.h"
+#include "vtkXMLPolyDataReader.h"
+
+// -------------------------
+// WallShearAccumulateFunctor
+// -------------------------
+// Welford update of the running mean shear vector and shear magnitude for
+// one timestep, points are independent so the update runs in parallel.
+
+namespace {
+
+class WallShearAccumulateFunctor {
+
+  public:
+
+    vtkDataArray* shear_;
+    double* mean_;
+    double* magMean_;
+    double invNumSteps_;
+
+    void operator()(vtkIdType begin, vtkIdType end) const {
+        double shear[3];
+        for (vtkIdType i = begin; i < end; i++) {
+            shear_->GetTuple(i,shear);
+            double mag = sqrt(shear[0]*shear[0]+shear[1]*shear[1]+shear[2]*shear[2]);
+            for (int j = 0; j < 3; j++) {
+                mean_[3*i+j] += (shear[j] - mean_[3*i+j])*invNumSteps_;
+            }
+            magMean_[i] += (mag - magMean_[i])*invNumSteps_;
+        }
+    }
+
+};
+
+}
+
 // -----------------
 // cvCalculateWallShearStress
 // -----------------
@@ -50,6 +86,9 @@ cvCalculateWallShearStress::cvCalculateWallShearStress() {
     wallshear_ = nullptr;
     surfaceMesh_ = nullptr;
     tensors_ = nullptr;
+    numAccumSteps_ = 0;
+    numAccumPts_ = 0;
+    accumPoints_ = nullptr;
 
 }
 
@@ -62,6 +101,9 @@ cvCalculateWallShearStress::~cvCalculateWallShearStress() {
     if (wallshear_ != nullptr) {
         wallshear_->Delete();
     }
+    if (accumPoints_ != nullptr) {
+        accumPoints_->Delete();
+    }
 }
 
 
@@ -490,3 +532,196 @@ cvPolyData* cvCalculateWallShearStress::CalcAvgPointData(int numPds, cvPolyData
 
 }
 
+
+
+// ---------------------
+//   ResetAccumulation
+// ---------------------
+
+int cvCalculateWallShearStress::ResetAccumulation() {
+
+    numAccumSteps_ = 0;
+    numAccumPts_ = 0;
+    std::vector<double>().swap(accumShearMean_);
+    std::vector<double>().swap(accumShearMagMean_);
+    if (accumPoints_ != nullptr) {
+        accumPoints_->Delete();
+        accumPoints_ = nullptr;
+    }
+    return SV_OK;
+
+}
+
+// --------------------
+//   AddWallShearStep
+// --------------------
+
+int cvCalculateWallShearStress::AddWallShearStep(cvPolyData *shearPd) {
+
+    vtkPolyData* pd = shearPd->GetVtkPolyData();
+    return this->AddWallShearStep(pd->GetPointData()->GetVectors(),pd->GetPoints());
+
+}
+
+// --------------------
+//   AddWallShearStep
+// --------------------
+
+int cvCalculateWallShearStress::AddWallShearStep(vtkDataArray *shear, vtkPoints *points) {
+
+    if (shear == nullptr || shear->GetNumberOfComponents() != 3) {
+        fprintf(stderr,"ERROR: wall shear step needs a 3 component array.\n");
+        return SV_ERROR;
+    }
+
+    int numPts = shear->GetNumberOfTuples();
+
+    if (numAccumSteps_ == 0) {
+        numAccumPts_ = numPts;
+        accumShearMean_.assign(3*numPts,0.0);
+        accumShearMagMean_.assign(numPts,0.0);
+        // keep our own copy so the step data can be released
+        if (accumPoints_ == nullptr) {
+            accumPoints_ = vtkPoints::New();
+        }
+        accumPoints_->Initialize();
+        if (points != nullptr) {
+            accumPoints_->DeepCopy(points);
+        }
+    } else if (numPts != numAccumPts_) {
+        fprintf(stderr,"ERROR: all wall shear steps must have the same num pts (%i != %i).\n",numPts,numAccumPts_);
+        return SV_ERROR;
+    }
+
+    numAccumSteps_++;
+
+    WallShearAccumulateFunctor accumulator;
+    accumulator.shear_ = shear;
+    accumulator.mean_ = accumShearMean_.data();
+    accumulator.magMean_ = accumShearMagMean_.data();
+    accumulator.invNumSteps_ = 1.0/numAccumSteps_;
+    vtkSMPTools::For(0,numPts,accumulator);
+
+    return SV_OK;
+
+}
+
+// ----------------------------
+//   AddWallShearStepFromFile
+// ----------------------------
+
+int cvCalculateWallShearStress::AddWallShearStepFromFile(char *fileName, char *arrayName) {
+
+    vtkXMLPolyDataReader* reader = vtkXMLPolyDataReader::New();
+    reader->SetFileName(fileName);
+    reader->Update();
+
+    vtkPolyData* pd = reader->GetOutput();
+    vtkDataArray* shear = pd->GetPointData()->GetArray(arrayName);
+    if (shear == nullptr) {
+        fprintf(stderr,"ERROR: no array %s in file %s.\n",arrayName,fileName);
+        reader->Delete();
+        return SV_ERROR;
+    }
+
+    int status = this->AddWallShearStep(shear,pd->GetPoints());
+
+    // step data is released here
+    reader->Delete();
+
+    return status;
+
+}
+
+// -----------------------------
+//   CreateAccumulatedPolyData
+// -----------------------------
+
+cvPolyData* cvCalculateWallShearStress::CreateAccumulatedPolyData(vtkFloatingPointArrayType *scalars) {
+
+    vtkPolyData* pd = vtkPolyData::New();
+    if (surfaceMesh_ == nullptr) {
+      pd->SetPoints(accumPoints_);
+    } else {
+      pd->CopyStructure(surfaceMesh_);
+    }
+    pd->GetPointData()->SetScalars(scalars);
+    scalars->Delete();
+    cvPolyData* reposobj = new cvPolyData(pd);
+    return reposobj;
+
+}
+
+// -------------------------------
+//   GetAccumulatedWallShearMean
+// -------------------------------
+
+cvPolyData* cvCalculateWallShearStress::GetAccumulatedWallShearMean() {
+
+    if (numAccumSteps_ == 0) {
+        return nullptr;
+    }
+
+    vtkFloatingPointArrayType *shearmean = vtkFloatingPointArrayType::New();
+    shearmean->SetNumberOfComponents(1);
+    shearmean->SetNumberOfTuples(numAccumPts_);
+
+    for (int i = 0; i < numAccumPts_; i++) {
+        const double *v = &accumShearMean_[3*i];
+        shearmean->SetTuple1(i,sqrt(v[0]*v[0]+v[1]*v[1]+v[2]*v[2]));
+    }
+
+    return this->CreateAccumulatedPolyData(shearmean);
+
+}
+
+// --------------------------------
+//   GetAccumulatedWallShearPulse
+// --------------------------------
+
+cvPolyData* cvCalculateWallShearStress::GetAccumulatedWallShearPulse() {
+
+    if (numAccumSteps_ == 0) {
+        return nullptr;
+    }
+
+    vtkFloatingPointArrayType *shearpulse = vtkFloatingPointArrayType::New();
+    shearpulse->SetNumberOfComponents(1);
+    shearpulse->SetNumberOfTuples(numAccumPts_);
+
+    for (int i = 0; i < numAccumPts_; i++) {
+        shearpulse->SetTuple1(i,accumShearMagMean_[i]);
+    }
+
+    return this->CreateAccumulatedPolyData(shearpulse);
+
+}
+
+// ---------------------
+//   GetAccumulatedOSI
+// ---------------------
+
+cvPolyData* cvCalculateWallShearStress::GetAccumulatedOSI() {
+
+    if (numAccumSteps_ == 0) {
+        return nullptr;
+    }
+
+    vtkFloatingPointArrayType *osiScalars = vtkFloatingPointArrayType::New();
+    osiScalars->SetNumberOfComponents(1);
+    osiScalars->SetNumberOfTuples(numAccumPts_);
+
+    for (int i = 0; i < numAccumPts_; i++) {
+        const double *v = &accumShearMean_[3*i];
+        double mean = sqrt(v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+        double pulse = accumShearMagMean_[i];
+        double osi = 0.0;
+        if (pulse > 0.00001) {
+            osi = 1.0/2.0*(1-mean/pulse);
+        }
+        osiScalars->SetTuple1(i,osi);
+    }
+
+    return this->CreateAccumulatedPolyData(osiScalars);
+
+}
@@ -37,6 +37,8 @@
 
 #include "sv_PolyData.h"
 
+#include <vector>
+
 // -----------------
 // cvCalculateWallShearStress
 // -----------------
@@ -61,16 +63,38 @@ class SV_EXPORT_POST cvCalculateWallShearStress {
 
     cvPolyData* CalcAvgPointData(int numPds, cvPolyData **inputPds);
 
+    // Streaming versions of CalcWallShearMean, CalcWallShearPulse and
+    // CalcOSI. Timesteps are added one at a time so that only running
+    // averages are kept in memory, each step is processed in parallel
+    // over the points.
+    int ResetAccumulation();
+    int AddWallShearStep(cvPolyData *shearPd);
+    int AddWallShearStep(vtkDataArray *shear, vtkPoints *points);
+    int AddWallShearStepFromFile(char *fileName, char *arrayName);
+    int GetNumberOfAccumulatedSteps() { return numAccumSteps_; }
+    cvPolyData* GetAccumulatedWallShearMean();
+    cvPolyData* GetAccumulatedWallShearPulse();
+    cvPolyData* GetAccumulatedOSI();
+
   protected:
 
 
   private:
 
+    cvPolyData* CreateAccumulatedPolyData(vtkFloatingPointArrayType *scalars);
+
     vtkPolyData* surfaceMesh_;
     vtkPolyData* tensors_;
     vtkPolyData* tractions_;
     vtkFloatingPointArrayType* wallshear_;
 
+    // running averages of the shear vector and shear magnitude
+    int numAccumSteps_;
+    int numAccumPts_;
+    std::vector<double> accumShearMean_;
+    std::vector<double> accumShearMagMean_;
+    vtkPoints* accumPoints_;
+
 };
 
 #endif
@@ -42,6 +42,91 @@
 
 #include "sv2_ConvertVisFiles.h"
 
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+
+// size of the blocks inflated at a time and of the chunks parsed per thread,
+// the input buffer holds about one block and the next block is inflated on
+// a helper thread while it is parsed, so memory use does not depend on the
+// file size
+#define VISREADBLOCKSIZE (32*1024*1024)
+#define VISPARSECHUNKSIZE (1024*1024)
+
+// ------------------
+// VisBlockParser
+// ------------------
+// Parses lines holding numComps whitespace separated numbers each. The
+// lines are split into line aligned chunks; the lines of each
+// chunk are counted in parallel, then each chunk is parsed in parallel
+// into its slot of the output array.
+
+namespace {
+
+class VisLineCounter {
+
+  public:
+
+    const char* begin_;
+    const std::vector<size_t>* chunks_;
+    std::vector<vtkIdType>* counts_;
+
+    void operator()(vtkIdType first, vtkIdType last) const {
+        for (vtkIdType k = first; k < last; k++) {
+            const char* p = begin_ + (*chunks_)[k];
+            const char* end = begin_ + (*chunks_)[k+1];
+            vtkIdType count = 0;
+            while (p < end && (p = (const char*)memchr(p,'\n',end-p)) != nullptr) {
+                count++;
+                p++;
+            }
+            (*counts_)[k] = count;
+        }
+    }
+
+};
+
+class VisLineParser {
+
+  public:
+
+    const char* begin_;
+    const std::vector<size_t>* chunks_;
+    const std::vector<vtkIdType>* offsets_;
+    int numComps_;
+    double* values_;
+    std::vector<vtkIdType>* badLines_;
+
+    void operator()(vtkIdType first, vtkIdType last) const {
+        for (vtkIdType k = first; k < last; k++) {
+            const char* p = begin_ + (*chunks_)[k];
+            const char* end = begin_ + (*chunks_)[k+1];
+            vtkIdType line = (*offsets_)[k];
+            while (p < end) {
+                const char* eol = (const char*)memchr(p,'\n',end-p);
+                double* out = values_ + line*numComps_;
+                for (int c = 0; c < numComps_; c++) {
+                    char* next = nullptr;
+                    out[c] = strtod(p,&next);
+                    // strtod skips newlines, so make sure we stayed on the line
+                    if (next == p || next > eol) {
+                        if ((*badLines_)[k] < 0) {
+                            (*badLines_)[k] = line;
+                        }
+                        break;
+                    }
+                    p = next;
+                }
+                p = eol + 1;
+                line++;
+            }
+        }
+    }
+
+};
+
+}
+
 // -------------------
 // cvConvertVisFiles
 // -------------------
@@ -73,6 +158,10 @@ cvConvertVisFiles::cvConvertVisFiles() {
     haveDisplacementResults_ = 0;
     haveWSSResults_ = 0;
     currentLine_[0]  = '\0';
+    bufferedRead_ = 1;
+    inputBufferPos_ = 0;
+    inputEOF_ = 0;
+    prefetchRead_ = 0;
     meshpts_ = nullptr;
     grid_ = nullptr;
 }
@@ -85,6 +174,8 @@ cvConvertVisFiles::cvConvertVisFiles() {
 cvConvertVisFiles::~cvConvertVisFiles() {
 
     //fprintf(stdout,"inside of destructor: meshExported_ %i meshLoaded %i resLoaded_ %i\n",meshExported_,meshLoaded_,resLoaded_);
+    finishPrefetch();
+
     // here we rely on the reference counting
     // if the user has requested a vtk object
     // using a Get... method of this class.
@@ -133,20 +224,287 @@ cvConvertVisFiles::~cvConvertVisFiles() {
 
 int cvConvertVisFiles::openInputFile(char* filename, gzFile* fp) {
     // open the output file
+    finishPrefetch();
     *fp = nullptr;
     *fp = gzopen (filename, "rb");
     if (*fp == Z_nullptr) {
       fprintf(stderr,"Error: Could not open input file %s.\n",filename);
       return SV_ERROR;
     }
+    std::vector<char>().swap(inputBuffer_);
+    inputBufferPos_ = 0;
+    inputEOF_ = 0;
+    if (bufferedRead_) {
+      if (fillInputBuffer(*fp) < 0) {
+        fprintf(stderr,"Error: Could not read input file %s.\n",filename);
+        closeInputFile(*fp);
+        *fp = nullptr;
+        return SV_ERROR;
+      }
+    }
     return SV_OK;
 }
 
 int cvConvertVisFiles::closeInputFile(gzFile fp) {
+  finishPrefetch();
   gzclose(fp);
+  std::vector<char>().swap(inputBuffer_);
+  inputBufferPos_ = 0;
+  inputEOF_ = 0;
   return SV_OK;
 }
 
+// inflate the next block of the file into buffer, gzread also handles
+// uncompressed files
+int cvConvertVisFiles::inflateBlock(gzFile fp, char* buffer) {
+
+#ifdef SV_USE_ZLIB
+    return gzread(fp,buffer,VISREADBLOCKSIZE);
+#else
+    return fread(buffer,1,VISREADBLOCKSIZE,fp);
+#endif
+
+}
+
+// inflate the next block into prefetchBuffer_ on a helper thread, fp must
+// not be used until finishPrefetch is called
+void cvConvertVisFiles::startPrefetch(gzFile fp) {
+
+    prefetchBuffer_.resize(VISREADBLOCKSIZE);
+    prefetchThread_ = std::thread([this,fp]() {
+      prefetchRead_ = inflateBlock(fp,prefetchBuffer_.data());
+    });
+
+}
+
+// wait for the helper thread, returns the number of bytes it inflated
+int cvConvertVisFiles::finishPrefetch() {
+
+    if (!prefetchThread_.joinable()) {
+      return 0;
+    }
+    prefetchThread_.join();
+    return prefetchRead_;
+
+}
+
+// drop the consumed part of the buffer and append the next block, then
+// start inflating the block after it so that it overlaps with parsing.
+// Returns the number of bytes added, or -1 on a read error.
+int cvConvertVisFiles::fillInputBuffer(gzFile fp) {
+
+    if (inputEOF_) {
+      return 0;
+    }
+
+    int nread = 0;
+    if (prefetchThread_.joinable()) {
+      nread = finishPrefetch();
+    } else {
+      prefetchBuffer_.resize(VISREADBLOCKSIZE);
+      nread = inflateBlock(fp,prefetchBuffer_.data());
+    }
+
+    size_t size = inputBuffer_.size() - inputBufferPos_;
+    if (inputBufferPos_ > 0) {
+      memmove(inputBuffer_.data(),inputBuffer_.data() + inputBufferPos_,size);
+      inputBufferPos_ = 0;
+    }
+
+    if (nread < 0) {
+      inputBuffer_.resize(size);
+      inputEOF_ = 1;
+      return -1;
+    }
+    inputBuffer_.resize(size + nread);
+    memcpy(inputBuffer_.data() + size,prefetchBuffer_.data(),nread);
+
+    if (nread < VISREADBLOCKSIZE) {
+      inputEOF_ = 1;
+      std::vector<char>().swap(prefetchBuffer_);
+    } else {
+      startPrefetch(fp);
+    }
+
+    return nread;
+
+}
+
+int cvConvertVisFiles::endOfInputFile(gzFile fp) {
+
+    if (bufferedRead_) {
+      if (inputBufferPos_ >= inputBuffer_.size()) {
+        fillInputBuffer(fp);
+      }
+      return (inputBufferPos_ >= inputBuffer_.size());
+    }
+    return gzeof(fp);
+
+}
+
+// read a block of numeric lines up to the line containing endmarker (or
+// endmarker2), currentLine_ is left holding the end marker line. Returns
+// the number of lines read, or -1 on a parse error.
+int cvConvertVisFiles::readDataBlock(gzFile fp, int numComps, std::vector<double> &values,
+                                     const char *endmarker, const char *endmarker2) {
+
+    values.clear();
+
+    if (!bufferedRead_) {
+      while (0 == 0) {
+        if (readNextLineFromFile(fp) == SV_ERROR) {
+          fprintf(stderr,"ERROR: could not find (%s).\n",endmarker);
+          return -1;
+        }
+        if (strstr(currentLine_,endmarker) != nullptr) {
+          break;
+        }
+        if (endmarker2 != nullptr && strstr(currentLine_,endmarker2) != nullptr) {
+          break;
+        }
+        char* p = currentLine_;
+        for (int c = 0; c < numComps; c++) {
+          char* next = nullptr;
+          double d = strtod(p,&next);
+          if (next == p) {
+            fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
+            return -1;
+          }
+          values.push_back(d);
+          p = next;
+        }
+      }
+      return values.size()/numComps;
+    }
+
+    // parse a buffer at a time: the whole lines in the buffer are searched
+    // for the end marker and parsed, then the next block is inflated
+    size_t len1 = strlen(endmarker);
+    size_t len2 = (endmarker2 != nullptr) ? strlen(endmarker2) : 0;
+    while (0 == 0) {
+      const char* bufbegin = inputBuffer_.data();
+      const char* begin = bufbegin + inputBufferPos_;
+      const char* bufend = bufbegin + inputBuffer_.size();
+
+      // a partial last line is left for the next block
+      const char* linesend = bufend;
+      if (!inputEOF_) {
+        while (linesend > begin && *(linesend-1) != '\n') {
+          linesend--;
+        }
+      }
+
+      const char* found = std::search(begin,linesend,endmarker,endmarker+len1);
+      if (endmarker2 != nullptr) {
+        found = std::min(found,std::search(begin,linesend,endmarker2,endmarker2+len2));
+      }
+      if (found == linesend && inputEOF_) {
+        fprintf(stderr,"ERROR: could not find (%s).\n",endmarker);
+        inputBufferPos_ = inputBuffer_.size();
+        values.clear();
+        return -1;
+      }
+
+      const char* end = linesend;
+      if (found != linesend) {
+        end = found;
+        while (end > begin && *(end-1) != '\n') {
+          end--;
+        }
+      }
+
+      int status = parseDataLines(begin,end - begin,numComps,values);
+      inputBufferPos_ = end - bufbegin;
+      if (status < 0) {
+        values.clear();
+        return -1;
+      }
+
+      // leave the marker line in currentLine_
+      if (found != linesend) {
+        readNextLineFromFile(fp);
+        break;
+      }
+
+      if (fillInputBuffer(fp) < 0) {
+        fprintf(stderr,"ERROR: could not read input file.\n");
+        values.clear();
+        return -1;
+      }
+    }
+
+    return values.size()/numComps;
+
+}
+
+// parse size bytes of whole lines at begin in parallel, appending numComps
+// values per line. Returns the number of lines parsed, or -1 on a parse
+// error.
+int cvConvertVisFiles::parseDataLines(const char* begin, size_t size, int numComps,
+                                      std::vector<double> &values) {
+
+    if (size == 0) {
+      return 0;
+    }
+
+    // line aligned chunks
+    int numChunks = (int)(size/VISPARSECHUNKSIZE) + 1;
+    std::vector<size_t> chunks(numChunks+1,size);
+    chunks[0] = 0;
+    for (int k = 1; k < numChunks; k++) {
+      size_t pos = std::max(chunks[k-1],(size_t)k*VISPARSECHUNKSIZE);
+      const char* eol = (const char*)memchr(begin+pos,'\n',size-pos);
+      chunks[k] = (eol == nullptr) ? size : (eol - begin) + 1;
+    }
+
+    // count lines per chunk and offset each chunk
+    std::vector<vtkIdType> counts(numChunks,0);
+    VisLineCounter counter;
+    counter.begin_ = begin;
+    counter.chunks_ = &chunks;
+    counter.counts_ = &counts;
+    vtkSMPTools::For(0,numChunks,1,counter);
+
+    std::vector<vtkIdType> offsets(numChunks,0);
+    for (int k = 1; k < numChunks; k++) {
+      offsets[k] = offsets[k-1] + counts[k-1];
+    }
+    vtkIdType numLines = offsets[numChunks-1] + counts[numChunks-1];
+
+    // parse
+    size_t first = values.size();
+    values.resize(first + numLines*numComps);
+    std::vector<vtkIdType> badLines(numChunks,-1);
+    VisLineParser parser;
+    parser.begin_ = begin;
+    parser.chunks_ = &chunks;
+    parser.offsets_ = &offsets;
+    parser.numComps_ = numComps;
+    parser.values_ = values.data() + first;
+    parser.badLines_ = &badLines;
+    vtkSMPTools::For(0,numChunks,1,parser);
+
+    const char* end = begin + size;
+    for (int k = 0; k < numChunks; k++) {
+      if (badLines[k] >= 0) {
+        // report the offending line like the line by line reader does
+        const char* p = begin + chunks[k];
+        for (vtkIdType line = offsets[k]; line < badLines[k]; line++) {
+          p = (const char*)memchr(p,'\n',end-p) + 1;
+        }
+        const char* eol = (const char*)memchr(p,'\n',end-p);
+        int len = std::min((int)(eol-p),MAXVISLINELENGTH-1);
+        strncpy(currentLine_,p,len);
+        currentLine_[len] = '\0';
+        fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
+        return -1;
+      }
+    }
+
+    return (int)numLines;
+
+}
+
 
 int cvConvertVisFiles::ReadVisMesh(char *infilename) {
 
@@ -196,25 +554,18 @@ int cvConvertVisFiles::ReadVisMesh(char *infilename) {
     vtkFloatingPointType  fpt[3];
     int nodeid = 0;
 
-    while (0 == 0) {
-      int flag = readNextLineFromFile(meshfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(meshfp_);
-          meshpts_->Delete();
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end node coordinates") != nullptr) {
-          break;
-      }
-      if (strstr(currentLine_,"end nodal coordinates") != nullptr) {
-          break;
-      }
-      if (sscanf(currentLine_,"%i %lf %lf %lf",&nodeid,&dpt[0],&dpt[1],&dpt[2]) != 4) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(meshfp_);
-          meshpts_->Delete();
-          return SV_ERROR;
-      }
+    std::vector<double> values;
+    int numRows = readDataBlock(meshfp_,4,values,"end node coordinates","end nodal coordinates");
+    if (numRows < 0) {
+        closeInputFile(meshfp_);
+        meshpts_->Delete();
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      nodeid = (int)values[4*row];
+      dpt[0] = values[4*row+1];dpt[1] = values[4*row+2];dpt[2] = values[4*row+3];
 
       // convert to vtkFloatingPointTypes for vtk
       fpt[0] = dpt[0]; fpt[1] = dpt[1]; fpt[2] = dpt[2];
@@ -300,44 +651,37 @@ int cvConvertVisFiles::ReadVisMesh(char *infilename) {
     int elementid = 0;
     int currnum = 0;
 
-    while (0 == 0) {
+    if (nodesPerElement != 4 && nodesPerElement != 8) {
+        fprintf(stderr,"ERROR: invalid nodes per element (%i).\n",nodesPerElement);
+        closeInputFile(meshfp_);
+        meshpts_->Delete();
+        ptids->Delete();
+        grid_->Delete();
+        return SV_ERROR;
+    }
 
-      int flag = readNextLineFromFile(meshfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(meshfp_);
-          meshpts_->Delete();
-          ptids->Delete();
-          grid_->Delete();
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end connectivity") != nullptr) {
-          break;
+    int numComps = 1 + nodesPerElement;
+    numRows = readDataBlock(meshfp_,numComps,values,"end connectivity");
+    if (numRows < 0) {
+        closeInputFile(meshfp_);
+        meshpts_->Delete();
+        ptids->Delete();
+        grid_->Delete();
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      elementid = (int)values[numComps*row];
+      for (int j = 0; j < nodesPerElement; j++) {
+        conn[j] = (int)values[numComps*row+1+j];
       }
 
       if (nodesPerElement == 4) {
-        if (sscanf(currentLine_,"%i %i %i %i %i",&elementid,
-                &conn[0],&conn[1],&conn[2],&conn[3]) != 5) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(meshfp_);
-          meshpts_->Delete();
-          ptids->Delete();
-          grid_->Delete();
-          return SV_ERROR;
-        }
         ptids->SetNumberOfIds(4);
         ptids->SetId(0,conn[0]-1);ptids->SetId(1,conn[1]-1);
         ptids->SetId(2,conn[2]-1);ptids->SetId(3,conn[3]-1);
       } else if (nodesPerElement == 8) {
-        if (sscanf(currentLine_,"%i %i %i %i %i %i %i %i %i",&elementid,
-                &conn[0],&conn[1],&conn[2],&conn[3],
-                &conn[4],&conn[5],&conn[6],&conn[7]) != 9) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(meshfp_);
-          meshpts_->Delete();
-          ptids->Delete();
-          grid_->Delete();
-          return SV_ERROR;
-        }
         ptids->SetNumberOfIds(8);
         ptids->SetId(0,conn[0]-1);ptids->SetId(1,conn[1]-1);
         ptids->SetId(2,conn[2]-1);ptids->SetId(3,conn[3]-1);
@@ -401,6 +745,34 @@ int cvConvertVisFiles::ReadVisMesh(char *infilename) {
 
 int cvConvertVisFiles::readNextLineFromFile(gzFile fp) {
 
+    if (bufferedRead_) {
+      // same semantics as gzgets, at most MAXVISLINELENGTH-1 chars
+      // including the newline, so make sure that much or a whole line
+      // is buffered
+      while (!inputEOF_) {
+        size_t avail = inputBuffer_.size() - inputBufferPos_;
+        if (avail >= MAXVISLINELENGTH-1 ||
+            memchr(inputBuffer_.data() + inputBufferPos_,'\n',avail) != nullptr) {
+          break;
+        }
+        if (fillInputBuffer(fp) < 0) {
+          return SV_ERROR;
+        }
+      }
+      size_t size = inputBuffer_.size();
+      if (inputBufferPos_ >= size) {
+        return SV_ERROR;
+      }
+      const char* p = inputBuffer_.data() + inputBufferPos_;
+      size_t maxlen = std::min(size - inputBufferPos_,(size_t)(MAXVISLINELENGTH-1));
+      const char* eol = (const char*)memchr(p,'\n',maxlen);
+      size_t len = (eol == nullptr) ? maxlen : (eol - p) + 1;
+      memcpy(currentLine_,p,len);
+      currentLine_[len] = '\0';
+      inputBufferPos_ += len;
+      return SV_OK;
+    }
+
 #ifdef SV_USE_ZLIB
     if (gzgets(fp,currentLine_,MAXVISLINELENGTH) ==Z_nullptr) {
 #else
@@ -456,7 +828,7 @@ int cvConvertVisFiles::ReadVisRes(char *infilename) {
     while (0 == 0) {
 
       if (findStringInFile("analysis results", resfp_) == SV_ERROR) {
-        if (gzeof(resfp_)) {
+        if (endOfInputFile(resfp_)) {
             closeInputFile(resfp_);
             if ((haveVelocityResults_ + havePressureResults_ +
                  haveTransportResults_ + haveStressResults_) == 0) {
@@ -531,22 +903,17 @@ int cvConvertVisFiles::readPressureFromFile() {
     vtkFloatingPointType f = 0;
     int nodeid = 1;
 
-    while (0 == 0) {
-      int flag = readNextLineFromFile(resfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(resfp_);
-          scalars->Delete();
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end data") != nullptr) {
-          break;
-      }
-      if (sscanf(currentLine_,"%lf",&d) != 1) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(resfp_);
-          scalars->Delete();
-          return SV_ERROR;
-      }
+    std::vector<double> values;
+    int numRows = readDataBlock(resfp_,1,values,"end data");
+    if (numRows < 0) {
+        closeInputFile(resfp_);
+        scalars->Delete();
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      d = values[row];
 
       // convert to vtkFloatingPointTypes for vtk
       f = d;
@@ -606,22 +973,17 @@ int cvConvertVisFiles::readVelocityFromFile() {
     f[0] = 0; f[1] = 0; f[2] = 0;
     int nodeid = 1;
 
-    while (0 == 0) {
-      int flag = readNextLineFromFile(resfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(resfp_);
-          vectors->Delete();
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end data") != nullptr) {
-          break;
-      }
-      if (sscanf(currentLine_,"%lf %lf %lf",&d[0],&d[1],&d[2]) != 3) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(resfp_);
-          vectors->Delete();
-          return SV_ERROR;
-      }
+    std::vector<double> values;
+    int numRows = readDataBlock(resfp_,3,values,"end data");
+    if (numRows < 0) {
+        closeInputFile(resfp_);
+        vectors->Delete();
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      d[0] = values[3*row+0];d[1] = values[3*row+1];d[2] = values[3*row+2];
 
       // convert to vtkFloatingPointTypes for vtk
       f[0] = d[0];f[1] = d[1];f[2] = d[2];
@@ -695,22 +1057,17 @@ int cvConvertVisFiles::readTractionFromFile() {
 		traction->FillComponent(2,0.0);
     }
 
-    while (0 == 0) {
-      int flag = readNextLineFromFile(resfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(resfp_);
-          traction->Delete();
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end data") != nullptr) {
-          break;
-      }
-      if (sscanf(currentLine_,"%lf %lf %lf",&d[0],&d[1],&d[2]) != 3) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(resfp_);
-          traction->Delete();
-          return SV_ERROR;
-      }
+    std::vector<double> values;
+    int numRows = readDataBlock(resfp_,3,values,"end data");
+    if (numRows < 0) {
+        closeInputFile(resfp_);
+        traction->Delete();
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      d[0] = values[3*row+0];d[1] = values[3*row+1];d[2] = values[3*row+2];
 
       // convert to vtkFloatingPointTypes for vtk
       f[0] = d[0];f[1] = d[1];f[2] = d[2];
@@ -814,24 +1171,18 @@ int cvConvertVisFiles::readDisplacementFromFile() {
 
     }
 
-    while (0 == 0) {
-      int flag = readNextLineFromFile(resfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(resfp_);
-          displacement->Delete();
-          if (keepme != nullptr) delete [] keepme;
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end data") != nullptr) {
-          break;
-      }
-      if (sscanf(currentLine_,"%lf %lf %lf",&d[0],&d[1],&d[2]) != 3) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(resfp_);
-          displacement->Delete();
-          if (keepme != nullptr) delete [] keepme;
-          return SV_ERROR;
-      }
+    std::vector<double> values;
+    int numRows = readDataBlock(resfp_,3,values,"end data");
+    if (numRows < 0) {
+        closeInputFile(resfp_);
+        displacement->Delete();
+        if (keepme != nullptr) delete [] keepme;
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      d[0] = values[3*row+0];d[1] = values[3*row+1];d[2] = values[3*row+2];
 
       // convert to vtkFloatingPointTypes for vtk
       f[0] = d[0];f[1] = d[1];f[2] = d[2];
@@ -932,24 +1283,18 @@ int cvConvertVisFiles::readWSSFromFile() {
 
     }
 
-    while (0 == 0) {
-      int flag = readNextLineFromFile(resfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(resfp_);
-          wss->Delete();
-          if (keepme != nullptr) delete [] keepme;
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end data") != nullptr) {
-          break;
-      }
-      if (sscanf(currentLine_,"%lf %lf %lf",&d[0],&d[1],&d[2]) != 3) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(resfp_);
-          wss->Delete();
-          if (keepme != nullptr) delete [] keepme;
-          return SV_ERROR;
-      }
+    std::vector<double> values;
+    int numRows = readDataBlock(resfp_,3,values,"end data");
+    if (numRows < 0) {
+        closeInputFile(resfp_);
+        wss->Delete();
+        if (keepme != nullptr) delete [] keepme;
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      d[0] = values[3*row+0];d[1] = values[3*row+1];d[2] = values[3*row+2];
 
       // convert to vtkFloatingPointTypes for vtk
       f[0] = d[0];f[1] = d[1];f[2] = d[2];
@@ -1024,22 +1369,17 @@ int cvConvertVisFiles::readTransportFromFile() {
     vtkFloatingPointType f = 0;
     int nodeid = 1;
 
-    while (0 == 0) {
-      int flag = readNextLineFromFile(resfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(resfp_);
-          scalars->Delete();
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end data") != nullptr) {
-          break;
-      }
-      if (sscanf(currentLine_,"%lf",&d) != 1) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(resfp_);
-          scalars->Delete();
-          return SV_ERROR;
-      }
+    std::vector<double> values;
+    int numRows = readDataBlock(resfp_,1,values,"end data");
+    if (numRows < 0) {
+        closeInputFile(resfp_);
+        scalars->Delete();
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      d = values[row];
 
       // convert to vtkFloatingPointTypes for vtk
       f = d;
@@ -1103,23 +1443,18 @@ int cvConvertVisFiles::readStressFromFile() {
     f[3] = 0; f[4] = 0; f[5] = 0;
     int nodeid = 1;
 
-    while (0 == 0) {
-      int flag = readNextLineFromFile(resfp_);
-      if (flag == NEXTLINE_EOF) {
-          closeInputFile(resfp_);
-          tensors->Delete();
-          return SV_ERROR;
-      }
-      if (strstr(currentLine_,"end data") != nullptr) {
-          break;
-      }
-      if (sscanf(currentLine_,"%lf %lf %lf %lf %lf %lf",
-                 &d[0],&d[1],&d[2],&d[3],&d[4],&d[5]) != 6) {
-          fprintf(stderr,"ERROR: invalid line (%s).\n",currentLine_);
-          closeInputFile(resfp_);
-          tensors->Delete();
-          return SV_ERROR;
-      }
+    std::vector<double> values;
+    int numRows = readDataBlock(resfp_,6,values,"end data");
+    if (numRows < 0) {
+        closeInputFile(resfp_);
+        tensors->Delete();
+        return SV_ERROR;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+
+      d[0] = values[6*row+0];d[1] = values[6*row+1];d[2] = values[6*row+2];
+      d[3] = values[6*row+3];d[4] = values[6*row+4];d[5] = values[6*row+5];
 
       // convert to vtkFloatingPointTypes for vtk
       f[0] = d[0];f[1] = d[1];f[2] = d[2];
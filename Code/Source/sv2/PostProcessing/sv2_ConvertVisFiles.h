@@ -43,6 +43,9 @@
 #include "sv_UnstructuredGrid.h"
 #include "sv_PolyData.h"
 
+#include <thread>
+#include <vector>
+
 #ifdef SV_USE_ZLIB
   #ifdef SV_USE_SYSTEM_ZLIB
     #include <zlib.h>
@@ -93,6 +96,12 @@ class SV_EXPORT_POST cvConvertVisFiles {
     cvPolyData* GetDisplacementObj();
     cvPolyData* GetWSSObj();
 
+    // inflate the file a block at a time, the next block on a helper
+    // thread, and parse data blocks in parallel (default), or read line
+    // by line with gzgets
+    void SetBufferedRead(int flag) {bufferedRead_ = flag;}
+    int GetBufferedRead() {return bufferedRead_;}
+
   protected:
 
     int openInputFile(char* filename, gzFile* fp);
@@ -108,6 +117,16 @@ class SV_EXPORT_POST cvConvertVisFiles {
 
     int findStringInFile(char *findme, gzFile fp);
     int readNextLineFromFile(gzFile fp);
+    int endOfInputFile(gzFile fp);
+
+    int fillInputBuffer(gzFile fp);
+    int inflateBlock(gzFile fp, char* buffer);
+    void startPrefetch(gzFile fp);
+    int finishPrefetch();
+    int parseDataLines(const char* begin, size_t size, int numComps,
+                       std::vector<double> &values);
+    int readDataBlock(gzFile fp, int numComps, std::vector<double> &values,
+                      const char *endmarker, const char *endmarker2 = nullptr);
 
   private:
 
@@ -133,6 +152,16 @@ class SV_EXPORT_POST cvConvertVisFiles {
 
     char currentLine_[MAXVISLINELENGTH];
 
+    int bufferedRead_;
+    std::vector<char> inputBuffer_;
+    size_t inputBufferPos_;
+    int inputEOF_;
+
+    // next block, inflated while the input buffer is parsed
+    std::vector<char> prefetchBuffer_;
+    int prefetchRead_;
+    std::thread prefetchThread_;
+
     vtkPoints* meshpts_;
     vtkUnstructuredGrid* grid_;
     vtkFloatingPointArrayType* pressure_;
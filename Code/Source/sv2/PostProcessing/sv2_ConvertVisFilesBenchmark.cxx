@@ -0,0 +1,130 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// Compares the throughput of the buffered, parallel parsing reader of
+// cvConvertVisFiles with the line by line gzgets reader on the same files.
+//
+//   sv2_ConvertVisFilesBenchmark <mesh file> [results file] [repeats]
+
+#include "SimVascular.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include "sv2_ConvertVisFiles.h"
+
+#include "vtkTimerLog.h"
+
+static double fileSizeMB(const char *filename) {
+    struct stat info;
+    if (stat(filename,&info) != 0) {
+      return 0.0;
+    }
+    return info.st_size/(1024.0*1024.0);
+}
+
+// read the files repeats times with the given reader and report the best
+// times, returns SV_ERROR if a read fails
+static int runReader(int buffered, char *meshfile, char *resfile, int repeats) {
+
+    double bestMesh = -1.0;
+    double bestRes = -1.0;
+
+    for (int i = 0; i < repeats; i++) {
+      cvConvertVisFiles converter;
+      converter.SetBufferedRead(buffered);
+
+      double startTime = vtkTimerLog::GetUniversalTime();
+      if (converter.ReadVisMesh(meshfile) == SV_ERROR) {
+        fprintf(stderr,"ERROR: could not read mesh (%s).\n",meshfile);
+        return SV_ERROR;
+      }
+      double meshTime = vtkTimerLog::GetUniversalTime() - startTime;
+      if (bestMesh < 0.0 || meshTime < bestMesh) {
+        bestMesh = meshTime;
+      }
+
+      if (resfile == nullptr) {
+        continue;
+      }
+
+      startTime = vtkTimerLog::GetUniversalTime();
+      if (converter.ReadVisRes(resfile) == SV_ERROR) {
+        fprintf(stderr,"ERROR: could not read results (%s).\n",resfile);
+        return SV_ERROR;
+      }
+      double resTime = vtkTimerLog::GetUniversalTime() - startTime;
+      if (bestRes < 0.0 || resTime < bestRes) {
+        bestRes = resTime;
+      }
+    }
+
+    const char *name = buffered ? "buffered" : "line by line";
+    double meshMB = fileSizeMB(meshfile);
+    fprintf(stdout,"%-12s mesh:    %10.3f s  %10.2f MB/s\n",name,bestMesh,
+            (bestMesh > 0.0) ? meshMB/bestMesh : 0.0);
+    if (resfile != nullptr) {
+      double resMB = fileSizeMB(resfile);
+      fprintf(stdout,"%-12s results: %10.3f s  %10.2f MB/s\n",name,bestRes,
+              (bestRes > 0.0) ? resMB/bestRes : 0.0);
+    }
+
+    return SV_OK;
+
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 2) {
+      fprintf(stderr,"usage: %s <mesh file> [results file] [repeats]\n",argv[0]);
+      return 1;
+    }
+
+    char *meshfile = argv[1];
+    char *resfile = (argc > 2) ? argv[2] : nullptr;
+    int repeats = (argc > 3) ? atoi(argv[3]) : 3;
+    if (repeats < 1) {
+      repeats = 1;
+    }
+
+    // throughput is relative to the size of the files on disk
+    if (runReader(0,meshfile,resfile,repeats) == SV_ERROR) {
+      return 1;
+    }
+    if (runReader(1,meshfile,resfile,repeats) == SV_ERROR) {
+      return 1;
+    }
+
+    return 0;
+
+}
@@ -42,6 +42,7 @@ set(H_FILES
     sv4gui_MeshAdaptor.h
     sv4gui_MeshTetGenAdaptor.h
     sv4gui_MitkMeshObjectFactory.h
+    sv4gui_MeshBatch.h
 )
 
 set(CPP_FILES
@@ -58,6 +59,7 @@ set(CPP_FILES
     sv4gui_MeshTetGenAdaptor.cxx
     sv4gui_MitkMeshObjectFactory.cxx
     sv4gui_MeshAdaptor.cxx
+    sv4gui_MeshBatch.cxx
 )
 
 set(RESOURCE_FILES
@@ -0,0 +1,619 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sv4gui_MeshBatch.h"
+
+#include "sv4gui_Mesh.h"
+#include "sv4gui_MeshFactory.h"
+#include "sv4gui_MitkMeshIO.h"
+#include "sv4gui_ModelIO.h"
+#include "sv4gui_StringUtils.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#ifndef _WIN32
+// Return the resident memory of 'pid' that is not backed by files, i.e.
+// what the process allocated itself rather than shared libraries mapped
+// from the parent, in MB, or a negative value if it is not known.
+double GetPrivateResidentMB(pid_t pid)
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/" + std::to_string(pid) + "/statm");
+    long size, resident, shared;
+    if (!(statm >> size >> resident >> shared))
+        return -1.0;
+    return static_cast<double>(resident - shared)*sysconf(_SC_PAGESIZE)/(1024.0*1024.0);
+#else
+    return -1.0;
+#endif
+}
+#endif
+
+// Return true if 'cmd' sets the global edge size ("option GlobalEdgeSize 0.5").
+bool IsGlobalEdgeSizeCommand(const std::string& cmd)
+{
+    auto params = sv4guiStringUtils_split(sv4guiStringUtils_lower(cmd), ' ');
+
+    if (params.size() != 3 || params[0] != "option")
+        return false;
+
+    return params[1] == "globaledgesize" || params[1] == "gsize" || params[1] == "a";
+}
+
+// Copy 'job' with its global edge size set to 'size'. The size command is
+// replaced if the commands have one and added before the first mesh
+// generation otherwise.
+sv4guiMeshBatch::Job SetGlobalEdgeSize(const sv4guiMeshBatch::Job& job, const std::string& size)
+{
+    sv4guiMeshBatch::Job sizedJob = job;
+    std::string sizeCmd = "option GlobalEdgeSize " + size;
+
+    bool found = false;
+    for (auto& cmd : sizedJob.commands)
+    {
+        if (IsGlobalEdgeSizeCommand(cmd))
+        {
+            cmd = sizeCmd;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        auto it = sizedJob.commands.begin();
+        for (; it != sizedJob.commands.end(); ++it)
+        {
+            std::string cmd = *it;
+            sv4guiStringUtils_trim(cmd);
+            if (sv4guiStringUtils_lower(cmd) == "generatemesh")
+                break;
+        }
+        sizedJob.commands.insert(it, sizeCmd);
+    }
+
+    return sizedJob;
+}
+
+}
+
+sv4guiMeshBatch::sv4guiMeshBatch()
+    : m_MaxWorkers(0)
+    , m_MemoryLimitMB(-1.0)
+{
+}
+
+//---------------------
+// GetPhysicalMemoryMB
+//---------------------
+// The physical memory of the machine, 0 if it is not known.
+//
+double sv4guiMeshBatch::GetPhysicalMemoryMB()
+{
+#ifdef _WIN32
+    return 0.0;
+#else
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0)
+        return 0.0;
+    return static_cast<double>(pages)*pageSize/(1024.0*1024.0);
+#endif
+}
+
+void sv4guiMeshBatch::AddJob(const Job& job)
+{
+    m_Jobs.push_back(job);
+}
+
+//-------------
+// ReadJobFile
+//-------------
+// Read jobs from a text file with one keyword per line:
+//
+//   job <name>                start a job
+//   model <file.mdl>          model to mesh
+//   type <mesh type>          mesher, TetGen by default
+//   history <file.msh>        append the command history of a saved mesh
+//   command <mesh command>    append a single mesh command
+//   edgesizes <h1> <h2> ...   run the job once per global edge size
+//   output <prefix>           write <prefix>.vtp and <prefix>.vtu
+//   end                       finish the job
+//
+// Relative paths are taken relative to the job file. Lines starting
+// with '#' are ignored.
+//
+bool sv4guiMeshBatch::ReadJobFile(std::string filePath, std::string& msg)
+{
+    std::ifstream in(filePath);
+    if (!in.is_open())
+    {
+        msg = "Unable to open job file " + filePath;
+        return false;
+    }
+
+    std::string dir = vtksys::SystemTools::GetFilenamePath(
+        vtksys::SystemTools::CollapseFullPath(filePath));
+    auto fullPath = [&dir](const std::string& path) {
+        return vtksys::SystemTools::CollapseFullPath(path, dir);
+    };
+
+    Job job;
+    std::vector<std::string> edgeSizes;
+    bool inJob = false;
+    std::string line;
+    int lineNum = 0;
+
+    while (std::getline(in, line))
+    {
+        lineNum++;
+        sv4guiStringUtils_trim(line);
+        if (line == "" || line[0] == '#')
+            continue;
+
+        std::string key = line.substr(0, line.find(' '));
+        std::string value = key.size() < line.size() ? line.substr(key.size()+1) : "";
+        sv4guiStringUtils_trim(value);
+        key = sv4guiStringUtils_lower(key);
+
+        if (key != "job" && !inJob)
+        {
+            msg = "Line " + std::to_string(lineNum) + ": '" + key + "' outside of a job";
+            return false;
+        }
+
+        if (key == "job")
+        {
+            if (inJob)
+            {
+                msg = "Line " + std::to_string(lineNum) + ": missing 'end' for job " + job.name;
+                return false;
+            }
+            job = Job();
+            job.name = value;
+            edgeSizes.clear();
+            inJob = true;
+        }
+        else if (key == "model")
+        {
+            job.modelFile = fullPath(value);
+        }
+        else if (key == "type")
+        {
+            job.meshType = value;
+        }
+        else if (key == "history")
+        {
+            sv4guiMitkMesh::Pointer mitkMesh = sv4guiMitkMeshIO::ReadFromFile(fullPath(value), false, false);
+            if (mitkMesh.IsNull() || mitkMesh->GetMesh() == nullptr)
+            {
+                msg = "Line " + std::to_string(lineNum) + ": unable to read mesh " + value;
+                return false;
+            }
+            auto history = mitkMesh->GetMesh()->GetCommandHistory();
+            job.commands.insert(job.commands.end(), history.begin(), history.end());
+            job.meshType = mitkMesh->GetMesh()->GetType();
+        }
+        else if (key == "command")
+        {
+            job.commands.push_back(value);
+        }
+        else if (key == "edgesizes")
+        {
+            edgeSizes = sv4guiStringUtils_split(value, ' ');
+        }
+        else if (key == "output")
+        {
+            job.outputPrefix = fullPath(value);
+        }
+        else if (key == "end")
+        {
+            if (job.modelFile == "")
+            {
+                msg = "Line " + std::to_string(lineNum) + ": no model for job " + job.name;
+                return false;
+            }
+
+            if (edgeSizes.empty())
+            {
+                AddJob(job);
+            }
+            else
+            {
+                for (int i = 0; i < edgeSizes.size(); i++)
+                {
+                    Job sizedJob = SetGlobalEdgeSize(job, edgeSizes[i]);
+                    sizedJob.name = job.name + "-" + edgeSizes[i];
+                    if (job.outputPrefix != "")
+                        sizedJob.outputPrefix = job.outputPrefix + "-" + edgeSizes[i];
+                    AddJob(sizedJob);
+                }
+            }
+            inJob = false;
+        }
+        else
+        {
+            msg = "Line " + std::to_string(lineNum) + ": unknown keyword '" + key + "'";
+            return false;
+        }
+    }
+
+    if (inJob)
+    {
+        msg = "Missing 'end' for job " + job.name;
+        return false;
+    }
+
+    return true;
+}
+
+//--------
+// RunJob
+//--------
+// Run a single job in the calling process.
+//
+bool sv4guiMeshBatch::RunJob(const Job& job, JobResult& result)
+{
+    auto jobStart = std::chrono::steady_clock::now();
+    auto stageStart = jobStart;
+    auto endStage = [&result, &stageStart](const std::string& stage) {
+        result.timings.push_back({stage, SecondsSince(stageStart)});
+        stageStart = std::chrono::steady_clock::now();
+    };
+
+    result = JobResult();
+
+    sv4guiModel::Pointer model = sv4guiModelIO::CreateGroupFromFile(job.modelFile);
+    if (model.IsNull() || model->GetModelElement() == nullptr)
+    {
+        result.message = "Unable to read model " + job.modelFile;
+        return false;
+    }
+    endStage("read model");
+
+    sv4guiMesh* mesh = sv4guiMeshFactory::CreateMesh(job.meshType);
+    if (mesh == nullptr)
+    {
+        result.message = "Unknown mesh type " + job.meshType;
+        return false;
+    }
+
+    mesh->InitNewMesher();
+    if (!mesh->SetModelElement(model->GetModelElement()))
+    {
+        result.message = "Unable to load model " + job.modelFile + " into mesher";
+        delete mesh;
+        return false;
+    }
+    endStage("load model");
+
+    for (auto cmd : job.commands)
+    {
+        sv4guiStringUtils_trim(cmd);
+        if (cmd == "")
+            continue;
+
+        std::string msg;
+        if (!mesh->ExecuteCommand(cmd, msg))
+        {
+            result.message = "'" + cmd + "' failed: " + msg;
+            delete mesh;
+            return false;
+        }
+        endStage(cmd);
+    }
+
+    if (job.outputPrefix != "")
+    {
+        if (mesh->GetSurfaceMesh() && !mesh->WriteSurfaceFile(job.outputPrefix + ".vtp"))
+        {
+            result.message = "Unable to write " + job.outputPrefix + ".vtp";
+            delete mesh;
+            return false;
+        }
+        if (mesh->GetVolumeMesh() && !mesh->WriteVolumeFile(job.outputPrefix + ".vtu"))
+        {
+            result.message = "Unable to write " + job.outputPrefix + ".vtu";
+            delete mesh;
+            return false;
+        }
+        endStage("write mesh");
+    }
+
+    delete mesh;
+
+    result.success = true;
+    result.message = "Completed";
+    result.totalSeconds = SecondsSince(jobStart);
+    return true;
+}
+
+//-----
+// Run
+//-----
+// Run all jobs, at most m_MaxWorkers at a time (one per hardware thread
+// if not set). Each job runs in a forked worker that reports its result
+// through a temporary file; the peak resident memory of the worker is
+// taken from the operating system when it exits. Where the resident
+// memory of a running worker can be read, a worker whose private
+// resident memory grows past m_MemoryLimitMB (the physical memory shared
+// among the workers if not set) is stopped.
+//
+bool sv4guiMeshBatch::Run()
+{
+    m_Results.assign(m_Jobs.size(), JobResult());
+
+#ifdef _WIN32
+    for (int i = 0; i < m_Jobs.size(); i++)
+        RunJob(m_Jobs[i], m_Results[i]);
+#else
+    size_t maxWorkers = m_MaxWorkers;
+    if (maxWorkers == 0)
+        maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+    double memoryLimitMB = m_MemoryLimitMB;
+    if (memoryLimitMB < 0)
+    {
+        size_t numWorkers = std::max<size_t>(1, std::min(maxWorkers, m_Jobs.size()));
+        memoryLimitMB = GetPhysicalMemoryMB()/numWorkers;
+    }
+    if (GetPrivateResidentMB(getpid()) < 0)
+        memoryLimitMB = 0.0;
+    if (memoryLimitMB > 0)
+        std::cout << "Limiting the resident memory of each mesh job to " << static_cast<long>(memoryLimitMB) << " MB" << std::endl;
+
+    std::vector<std::string> resultFiles(m_Jobs.size());
+    std::vector<std::chrono::steady_clock::time_point> startTimes(m_Jobs.size());
+    std::map<pid_t, size_t> running;
+    std::vector<bool> overLimit(m_Jobs.size(), false);
+    size_t next = 0;
+
+    while (next < m_Jobs.size() || !running.empty())
+    {
+        while (next < m_Jobs.size() && running.size() < maxWorkers)
+        {
+            size_t i = next++;
+
+            char tmpName[] = "/tmp/sv4gui_mesh_batch_XXXXXX";
+            int fd = mkstemp(tmpName);
+            if (fd < 0)
+            {
+                RunJob(m_Jobs[i], m_Results[i]);
+                continue;
+            }
+            close(fd);
+            resultFiles[i] = tmpName;
+
+            std::cout << "Starting mesh job " << m_Jobs[i].name << std::endl;
+            fflush(stdout);
+            fflush(stderr);
+            startTimes[i] = std::chrono::steady_clock::now();
+
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                JobResult result;
+                bool success = false;
+                try
+                {
+                    success = RunJob(m_Jobs[i], result);
+                }
+                catch (const std::bad_alloc&)
+                {
+                    result.success = false;
+                    result.message = "Out of memory";
+                }
+                WriteResultFile(resultFiles[i], result);
+                fflush(stdout);
+                fflush(stderr);
+                _exit(success ? 0 : 1);
+            }
+            else if (pid < 0)
+            {
+                std::remove(resultFiles[i].c_str());
+                RunJob(m_Jobs[i], m_Results[i]);
+                continue;
+            }
+
+            running[pid] = i;
+        }
+
+        if (running.empty())
+            continue;
+
+        int status = 0;
+        struct rusage usage;
+        pid_t pid = wait4(-1, &status, (memoryLimitMB > 0) ? WNOHANG : 0, &usage);
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        // No worker has finished, stop those over the memory limit
+        if (pid == 0)
+        {
+            for (auto& worker : running)
+            {
+                if (!overLimit[worker.second] && GetPrivateResidentMB(worker.first) > memoryLimitMB)
+                {
+                    overLimit[worker.second] = true;
+                    kill(worker.first, SIGKILL);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        auto worker = running.find(pid);
+        if (worker == running.end())
+            continue;
+
+        size_t i = worker->second;
+        running.erase(worker);
+
+        JobResult& result = m_Results[i];
+        if (!ReadResultFile(resultFiles[i], result))
+        {
+            result.success = false;
+            if (WIFSIGNALED(status))
+                result.message = "Worker terminated by signal " + std::to_string(WTERMSIG(status));
+            else
+                result.message = "Worker exited without a result";
+            result.totalSeconds = SecondsSince(startTimes[i]);
+        }
+        std::remove(resultFiles[i].c_str());
+
+        if (overLimit[i])
+        {
+            result.success = false;
+            result.message = "Exceeded memory limit of " + std::to_string(static_cast<long>(memoryLimitMB)) + " MB";
+        }
+
+#ifdef __APPLE__
+        result.peakMemoryMB = usage.ru_maxrss/(1024.0*1024.0);
+#else
+        result.peakMemoryMB = usage.ru_maxrss/1024.0;
+#endif
+
+        std::cout << "Finished mesh job " << m_Jobs[i].name << ": " << result.message << std::endl;
+    }
+#endif
+
+    for (auto& result : m_Results)
+    {
+        if (!result.success)
+            return false;
+    }
+    return true;
+}
+
+void sv4guiMeshBatch::PrintResults(std::ostream& os) const
+{
+    for (int i = 0; i < m_Results.size(); i++)
+    {
+        const JobResult& result = m_Results[i];
+        os << m_Jobs[i].name << ": " << (result.success ? "ok" : "FAILED")
+           << "  " << std::fixed << std::setprecision(2) << result.totalSeconds << " s";
+        if (result.peakMemoryMB > 0)
+            os << "  " << std::setprecision(1) << result.peakMemoryMB << " MB peak";
+        os << std::endl;
+
+        if (!result.success)
+            os << "    " << result.message << std::endl;
+
+        for (auto& timing : result.timings)
+            os << "    " << std::setw(10) << std::setprecision(3) << timing.seconds << " s  " << timing.stage << std::endl;
+    }
+}
+
+bool sv4guiMeshBatch::WriteResultFile(std::string filePath, const JobResult& result)
+{
+    std::ofstream out(filePath);
+    if (!out.is_open())
+        return false;
+
+    out << std::setprecision(17);
+    out << "success " << (result.success ? 1 : 0) << "\n";
+    out << "total " << result.totalSeconds << "\n";
+    out << "message " << result.message << "\n";
+    for (auto& timing : result.timings)
+        out << "stage " << timing.seconds << " " << timing.stage << "\n";
+
+    return out.good();
+}
+
+bool sv4guiMeshBatch::ReadResultFile(std::string filePath, JobResult& result)
+{
+    std::ifstream in(filePath);
+    if (!in.is_open())
+        return false;
+
+    bool found = false;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream ss(line);
+        std::string key;
+        ss >> key;
+        if (key == "success")
+        {
+            int success = 0;
+            ss >> success;
+            result.success = (success == 1);
+            found = true;
+        }
+        else if (key == "total")
+        {
+            ss >> result.totalSeconds;
+        }
+        else if (key == "message")
+        {
+            std::getline(ss >> std::ws, result.message);
+        }
+        else if (key == "stage")
+        {
+            StageTiming timing;
+            ss >> timing.seconds;
+            std::getline(ss >> std::ws, timing.stage);
+            result.timings.push_back(timing);
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,128 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SV4GUI_MESHBATCH_H
+#define SV4GUI_MESHBATCH_H
+
+#include <sv4guiModuleMeshExports.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// -----------------
+// sv4guiMeshBatch
+// -----------------
+// Runs a list of independent meshing jobs, each a model file and a mesh
+// command history, e.g. a mesh convergence study over several global
+// edge sizes. Jobs run concurrently in worker processes, at most
+// MaxWorkers at a time. A worker whose private resident memory (not
+// counting shared libraries) grows past MemoryLimitMB is stopped. By
+// default the limit is the physical memory divided by the number of
+// workers, so together the workers stay within the physical memory; a
+// limit of 0 turns it off. The limit is only enforced where the resident
+// memory of a running process can be read (Linux). Per-stage timings are
+// collected for every job.
+//
+// Worker processes are only available on POSIX systems; elsewhere the
+// jobs run one after another in the calling process.
+//
+class SV4GUIMODULEMESH_EXPORT sv4guiMeshBatch
+{
+public:
+
+    struct Job
+    {
+        std::string name;
+        std::string modelFile;
+        std::string meshType = "TetGen";
+        std::vector<std::string> commands;
+        std::string outputPrefix;
+    };
+
+    struct StageTiming
+    {
+        std::string stage;
+        double seconds;
+    };
+
+    struct JobResult
+    {
+        bool success = false;
+        std::string message;
+        std::vector<StageTiming> timings;
+        double totalSeconds = 0.0;
+        double peakMemoryMB = 0.0;
+    };
+
+    sv4guiMeshBatch();
+
+    void AddJob(const Job& job);
+
+    const std::vector<Job>& GetJobs() const {return m_Jobs;}
+
+    void SetMaxWorkers(int maxWorkers) {m_MaxWorkers=maxWorkers;}
+
+    // A negative limit (the default) uses the physical memory divided by
+    // the number of workers, 0 means no limit
+    void SetMemoryLimitMB(double memoryLimitMB) {m_MemoryLimitMB=memoryLimitMB;}
+
+    double GetMemoryLimitMB() const {return m_MemoryLimitMB;}
+
+    static double GetPhysicalMemoryMB();
+
+    bool ReadJobFile(std::string filePath, std::string& msg);
+
+    bool Run();
+
+    const std::vector<JobResult>& GetResults() const {return m_Results;}
+
+    void PrintResults(std::ostream& os) const;
+
+    static bool RunJob(const Job& job, JobResult& result);
+
+  protected:
+
+    std::vector<Job> m_Jobs;
+
+    std::vector<JobResult> m_Results;
+
+    int m_MaxWorkers;
+
+    double m_MemoryLimitMB;
+
+    static bool WriteResultFile(std::string filePath, const JobResult& result);
+
+    static bool ReadResultFile(std::string filePath, JobResult& result);
+
+  };
+
+#endif // SV4GUI_MESHBATCH_H
@@ -33,6 +33,7 @@
 #include "sv4gui_MitkMeshIO.h"
 
 #include "sv_polydatasolid_utils.h"
+#include "sv_MeshCompleteFile.h"
 #include "sv_vtk_utils.h"
 
 #include <QDir>
@@ -284,6 +285,8 @@ bool sv4guiMeshLegacyIO::WriteFiles(vtkSmartPointer<vtkPolyData> surfaceMesh, vt
     QDir mDir(meshDir);
     mDir.mkdir("mesh-surfaces");
     auto faces = modelElement->GetFaces();
+    std::vector<std::string> faceNames;
+    std::vector<vtkSmartPointer<vtkPolyData>> facePolyData;
 
     for (int i = 0; i < faces.size(); i++) {
       auto face = faces[i];
@@ -295,6 +298,12 @@ bool sv4guiMeshLegacyIO::WriteFiles(vtkSmartPointer<vtkPolyData> surfaceMesh, vt
       int ident = modelElement->GetFaceIdentifierFromInnerSolid(face->id);
       PlyDtaUtils_GetFacePolyData(surfaceMesh.GetPointer(), &ident, facepd);
 
+      // The mesh-complete file maps the original ids itself.
+      auto faceCopy = vtkSmartPointer<vtkPolyData>::New();
+      faceCopy->ShallowCopy(facepd);
+      faceNames.push_back(face->name);
+      facePolyData.push_back(faceCopy);
+
       ResetFaceSurfaceIds(facepd, node_map, elem_map);
 
       vtpFilePath = meshDir + "/mesh-surfaces/" + QString::fromStdString(face->name) + ".vtp";
@@ -309,6 +318,19 @@ bool sv4guiMeshLegacyIO::WriteFiles(vtkSmartPointer<vtkPolyData> surfaceMesh, vt
       }
     }
 
+    // Write the volume mesh and all surfaces to a single binary file
+    // that can be memory mapped when setting up a simulation.
+    //
+    std::vector<vtkPolyData*> facePointers;
+    for (auto& facepd : facePolyData) {
+      facePointers.push_back(facepd.GetPointer());
+    }
+    QString meshCompletePath = QDir::toNativeSeparators(meshDir + "/mesh-complete.svmesh");
+    if (cvMeshCompleteFile::Write(meshCompletePath.toStdString(), volumeMesh, surfaceMesh,
+        faceNames, facePointers) != SV_OK) {
+      std::cout << "[sv4guiMeshLegacyIO::WriteFiles] Unable to write " << meshCompletePath.toStdString() << std::endl;
+    }
+
     // If there are wall faces then extract separate faces from the
     // mesh surface based on RegionId. 
     //
@@ -341,6 +341,12 @@ bool sv4guiMeshTetGen::ParseCommand(std::string cmd, std::string& flag, double v
             values[0]=std::stod(params[1]);
             option=true;
         }
+        else if(paramSize==2 && params[0]=="incrementalremesh")
+        {
+            flag="IncrementalRemesh";
+            values[0]=std::stod(params[1]);
+            option=true;
+        }
         else if(params[0]=="setwalls")
         {
             flag="setWalls";
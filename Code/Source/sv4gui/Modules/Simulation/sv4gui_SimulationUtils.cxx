@@ -33,7 +33,6 @@
 #include "sv4gui_SimXmlWriter.h"
 
 #include "sv4gui_StringUtils.h"
-#include "sv_integrate_surface.h"
 
 #include <sstream>
 #include <iostream>
@@ -45,6 +44,90 @@
 #include <vtkPointData.h>
 #include <vtkDoubleArray.h>
 #include <vtkAbstractArray.h>
+#include <vtkCellArray.h>
+#include <vtkMath.h>
+#include <vtkSMPTools.h>
+
+namespace {
+
+// Face quadrature weights, computed once per face and reused for every
+// time step.
+struct FaceWeights
+{
+    std::vector<double> weights;
+    std::vector<double> normals;
+    double area;
+};
+
+// One face integral: a pressure array (area weighted sum) or a velocity
+// array (flux through the face).
+struct FaceIntegral
+{
+    int face;
+    bool isVelocity;
+    vtkDataArray* array;
+    double value;
+};
+
+struct ComputeFaceWeightsFunctor
+{
+    std::vector<vtkPolyData*>* Faces;
+    std::vector<FaceWeights>* Weights;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+        for(vtkIdType i=begin;i<end;++i)
+        {
+            FaceWeights& fw=(*this->Weights)[i];
+            sv4guiSimulationUtils::ComputeFaceIntegrationWeights((*this->Faces)[i], fw.weights, fw.normals, fw.area);
+        }
+    }
+};
+
+struct IntegrateFacesFunctor
+{
+    std::vector<FaceWeights>* Weights;
+    std::vector<FaceIntegral>* Integrals;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+        for(vtkIdType i=begin;i<end;++i)
+        {
+            FaceIntegral& fi=(*this->Integrals)[i];
+            const FaceWeights& fw=(*this->Weights)[fi.face];
+            vtkIdType numPts=fw.weights.size();
+            vtkDoubleArray* darray=vtkDoubleArray::SafeDownCast(fi.array);
+            const double* data=(darray!=nullptr) ? darray->GetPointer(0) : nullptr;
+            double sum=0.0;
+
+            if(!fi.isVelocity)
+            {
+                for(vtkIdType j=0;j<numPts;++j)
+                    sum+=fw.weights[j]*((data!=nullptr) ? data[j] : fi.array->GetComponent(j,0));
+            }
+            else
+            {
+                double v[3];
+                for(vtkIdType j=0;j<numPts;++j)
+                {
+                    if(data!=nullptr)
+                    {
+                        v[0]=data[3*j]; v[1]=data[3*j+1]; v[2]=data[3*j+2];
+                    }
+                    else
+                    {
+                        fi.array->GetTuple(j,v);
+                    }
+                    sum+=fw.weights[j]*vtkMath::Dot(v,&fw.normals[3*j]);
+                }
+            }
+
+            fi.value=sum;
+        }
+    }
+};
+
+}
 
 //-----------------------
 // CreateSolverInputFile
@@ -765,40 +848,24 @@ bool sv4guiSimulationUtils::CreateFlowFiles(std::string outFlowFilePath, std::st
     std::map<std::string,std::map<std::string, double>> flowrateMap;
     std::map<std::string,std::map<std::string, double>> areaMap;
 
-    auto it=vtpMap.begin();
-    while(it!=vtpMap.end())
-    {
-        for(auto step_simvtp:simVtps)
-        {
-            std::string step=step_simvtp.first;
-            vtkSmartPointer<vtkPolyData> simvtp=step_simvtp.second;
-
-            if(simvtp!=nullptr)
-                VtpExtractSingleFace(step,simvtp, it->second);
-        }
-
-        for(auto step_simug:simUgs)
-        {
-            std::string step=step_simug.first;
-            vtkSmartPointer<vtkUnstructuredGrid> simug=step_simug.second;
-
-            if(simug!=nullptr)
-                VtuExtractSingleFace(step,simug, it->second);
-        }
+    // Extract all faces for one time step at a time, the face to mesh
+    // point ids are only recomputed if the mesh numbering changes.
+    std::map<std::string,std::vector<vtkIdType>> faceLocalIds;
 
-        std::map<std::string, double> pmap;
-        std::map<std::string, double> qmap;
-        std::map<std::string, double> amap;
-
-        VtpIntegrateFace(it->second,pmap,qmap,amap);
-
-        pressureMap[it->first]=pmap;
-        flowrateMap[it->first]=qmap;
-        areaMap[it->first]=amap;
+    for(auto step_simvtp:simVtps)
+    {
+        if(step_simvtp.second!=nullptr)
+            ExtractFaces(step_simvtp.first, step_simvtp.second, vtpMap, faceLocalIds);
+    }
 
-        it++;
+    for(auto step_simug:simUgs)
+    {
+        if(step_simug.second!=nullptr)
+            ExtractFaces(step_simug.first, step_simug.second, vtpMap, faceLocalIds);
     }
 
+    IntegrateFaces(vtpMap,pressureMap,flowrateMap,areaMap);
+
     std::ofstream pressurefs(outPressureFlePath.c_str());
     std::ofstream flowfs(outFlowFilePath.c_str());
     std::ofstream averagefs(outAverageFilePath.c_str());
@@ -942,220 +1009,356 @@ bool sv4guiSimulationUtils::CreateFlowFiles(std::string outFlowFilePath, std::st
 //
 void sv4guiSimulationUtils::VtpExtractSingleFace(std::string step, vtkSmartPointer<vtkPolyData> simvtp,vtkSmartPointer<vtkPolyData> facevtp)
 {
-    int faceNumPoint=facevtp->GetNumberOfPoints();
-    vtkDataArray* faceNodeIDs=facevtp->GetPointData()->GetArray("GlobalNodeID");
-
-    vtkPointData* pointData=simvtp->GetPointData();
+    std::map<std::string,vtkSmartPointer<vtkPolyData>> faces;
+    faces["face"]=facevtp;
+    std::map<std::string,std::vector<vtkIdType>> faceLocalIds;
 
-    std::vector<std::string> pressureNames, velocityNames;
+    ExtractFaces(step, simvtp, faces, faceLocalIds);
+}
 
-    for(int i=0;i<pointData->GetNumberOfArrays();++i)
-    {
-        std::string name(pointData->GetAbstractArray(i)->GetName());
+//----------------------
+// VtuExtractSingleFace
+//----------------------
+//
+void sv4guiSimulationUtils::VtuExtractSingleFace(std::string step, vtkSmartPointer<vtkUnstructuredGrid> simug,vtkSmartPointer<vtkPolyData> facevtp)
+{
+    std::map<std::string,vtkSmartPointer<vtkPolyData>> faces;
+    faces["face"]=facevtp;
+    std::map<std::string,std::vector<vtkIdType>> faceLocalIds;
 
-        if(step=="combo")
-        {
-            if(name=="pressure_avg" || name=="pressure_avg_mmHg")
-                continue;
+    ExtractFaces(step, simug, faces, faceLocalIds);
+}
 
-            if(name.substr(0,9)=="pressure_")
-                pressureNames.push_back(name);
-            else if(name.substr(0,9)=="velocity_")
-                velocityNames.push_back(name);
-        }
-        else
-        {
-            if(name=="pressure")
-                pressureNames.push_back(name);
-            else if(name=="velocity")
-                velocityNames.push_back(name);
-        }
-    }
+//----------------------
+// BuildGlobalNodeIndex
+//----------------------
+// Build a dense GlobalNodeID to local point id index for a simulation
+// data set. Ids not present in the data set map to -1.
+//
+void sv4guiSimulationUtils::BuildGlobalNodeIndex(vtkDataSet* simds, std::vector<vtkIdType>& globalToLocal)
+{
+    globalToLocal.clear();
 
-    std::map<int,int> mapGlobal2Local;
-    vtkDataArray* simvtpGlobalIDs=pointData->GetArray("GlobalNodeID");
-    for(int i=0;i<simvtp->GetNumberOfPoints();++i)
-    {
-        int nodeID=simvtpGlobalIDs->GetTuple1(i);
-        mapGlobal2Local[nodeID]=i;
-    }
+    vtkDataArray* globalIDs=simds->GetPointData()->GetArray("GlobalNodeID");
+    if(globalIDs==nullptr)
+        return;
 
-    for(int i=0;i<pressureNames.size();++i)
+    vtkIdType numPoints=simds->GetNumberOfPoints();
+    std::vector<vtkIdType> ids(numPoints);
+    vtkIdType maxID=-1;
+    for(vtkIdType i=0;i<numPoints;++i)
     {
-        vtkSmartPointer<vtkDoubleArray> parray=vtkSmartPointer<vtkDoubleArray>::New();
-        parray->SetNumberOfComponents(1);
-        parray->Allocate(100,100);
-
-        std::string pn=pressureNames[i];
-        if(step!="combo")
-            pn=pn+"_"+step;
-
-        parray->SetName(pn.c_str());
-
-        vtkDataArray* array=pointData->GetArray(pressureNames[i].c_str());
-        for(int j=0;j<faceNumPoint;++j)
-        {
-            int gID=faceNodeIDs->GetTuple1(j);
-            int lID=mapGlobal2Local[gID];
-            double p=array->GetTuple1(lID);
-            parray->InsertNextTuple1(p);
-        }
-
-        facevtp->GetPointData()->AddArray(parray);
+        ids[i]=globalIDs->GetTuple1(i);
+        if(ids[i]>maxID)
+            maxID=ids[i];
     }
 
-    for(int i=0;i<velocityNames.size();++i)
+    globalToLocal.assign(maxID+1,-1);
+    for(vtkIdType i=0;i<numPoints;++i)
     {
-        vtkSmartPointer<vtkDoubleArray> varray=vtkSmartPointer<vtkDoubleArray>::New();
-        varray->SetNumberOfComponents(3);
-        varray->Allocate(100,100);
-
-        std::string vn=velocityNames[i];
-        if(step!="combo")
-            vn=vn+"_"+step;
-
-        varray->SetName(vn.c_str());
-
-        vtkDataArray* array=pointData->GetArray(velocityNames[i].c_str());
-        for(int j=0;j<faceNumPoint;++j)
-        {
-            int gID=faceNodeIDs->GetTuple1(j);
-            int lID=mapGlobal2Local[gID];
-            double* v=array->GetTuple3(lID);
-            varray->InsertNextTuple3(v[0],v[1],v[2]);
-        }
-
-        facevtp->GetPointData()->AddArray(varray);
+        if(ids[i]>=0)
+            globalToLocal[ids[i]]=i;
     }
-
 }
 
-void sv4guiSimulationUtils::VtuExtractSingleFace(std::string step, vtkSmartPointer<vtkUnstructuredGrid> simug,vtkSmartPointer<vtkPolyData> facevtp)
+//--------------
+// ExtractFaces
+//--------------
+// Copy the pressure and velocity arrays of one time step (or of all time
+// steps of a combo file) onto all faces in a single pass.
+//
+// faceLocalIds holds the simulation point id of each face point. It is
+// computed on first use and kept as long as the simulation mesh numbering
+// does not change, so calling this for every time step of the same mesh
+// only builds the GlobalNodeID index once.
+//
+void sv4guiSimulationUtils::ExtractFaces(std::string step, vtkDataSet* simds, std::map<std::string,vtkSmartPointer<vtkPolyData>>& faces,
+                                         std::map<std::string,std::vector<vtkIdType>>& faceLocalIds)
 {
-    int faceNumPoint=facevtp->GetNumberOfPoints();
-    vtkDataArray* faceNodeIDs=facevtp->GetPointData()->GetArray("GlobalNodeID");
+    vtkPointData* pointData=simds->GetPointData();
+    vtkDataArray* simGlobalIDs=pointData->GetArray("GlobalNodeID");
 
-    vtkPointData* pointData=simug->GetPointData();
-
-    std::vector<std::string> pressureNames, velocityNames;
+    std::vector<vtkDataArray*> arrays;
+    std::vector<std::string> names;
 
     for(int i=0;i<pointData->GetNumberOfArrays();++i)
     {
         std::string name(pointData->GetAbstractArray(i)->GetName());
+        vtkDataArray* array=pointData->GetArray(i);
+
+        if(array==nullptr)
+            continue;
 
         if(step=="combo")
         {
             if(name=="pressure_avg" || name=="pressure_avg_mmHg")
                 continue;
 
-            if(name.substr(0,9)=="pressure_")
-                pressureNames.push_back(name);
-            else if(name.substr(0,9)=="velocity_")
-                velocityNames.push_back(name);
+            if(name.substr(0,9)!="pressure_" && name.substr(0,9)!="velocity_")
+                continue;
         }
         else
         {
-            if(name=="pressure")
-                pressureNames.push_back(name);
-            else if(name=="velocity")
-                velocityNames.push_back(name);
+            if(name!="pressure" && name!="velocity")
+                continue;
+
+            name=name+"_"+step;
         }
-    }
 
-    std::map<int,int> mapGlobal2Local;
-    vtkDataArray* simugGlobalIDs=pointData->GetArray("GlobalNodeID");
-    for(int i=0;i<simug->GetNumberOfPoints();++i)
-    {
-        int nodeID=simugGlobalIDs->GetTuple1(i);
-        mapGlobal2Local[nodeID]=i;
+        arrays.push_back(array);
+        names.push_back(name);
     }
 
-    for(int i=0;i<pressureNames.size();++i)
-    {
-        vtkSmartPointer<vtkDoubleArray> parray=vtkSmartPointer<vtkDoubleArray>::New();
-        parray->SetNumberOfComponents(1);
-        parray->Allocate(100,100);
+    if(arrays.size()==0)
+        return;
 
-        std::string pn=pressureNames[i];
-        if(step!="combo")
-            pn=pn+"_"+step;
+    // Check the cached face ids against this mesh, rebuild the index only
+    // if one of them no longer matches.
+    std::vector<vtkIdType> globalToLocal;
+    bool haveIndex=false;
 
-        parray->SetName(pn.c_str());
+    for(auto name_face:faces)
+    {
+        vtkPolyData* facevtp=name_face.second;
+        vtkDataArray* faceNodeIDs=facevtp->GetPointData()->GetArray("GlobalNodeID");
+        vtkIdType faceNumPoint=facevtp->GetNumberOfPoints();
+        std::vector<vtkIdType>& localIds=faceLocalIds[name_face.first];
 
-        vtkDataArray* array=pointData->GetArray(pressureNames[i].c_str());
-        for(int j=0;j<faceNumPoint;++j)
+        bool valid=((vtkIdType)localIds.size()==faceNumPoint);
+        for(vtkIdType j=0;valid && j<faceNumPoint;++j)
         {
-            int gID=faceNodeIDs->GetTuple1(j);
-            int lID=mapGlobal2Local[gID];
-            double p=array->GetTuple1(lID);
-            parray->InsertNextTuple1(p);
+            valid=(localIds[j]<simds->GetNumberOfPoints() && simGlobalIDs!=nullptr &&
+                   simGlobalIDs->GetTuple1(localIds[j])==faceNodeIDs->GetTuple1(j));
         }
+        if(valid)
+            continue;
 
-        facevtp->GetPointData()->AddArray(parray);
+        if(!haveIndex)
+        {
+            BuildGlobalNodeIndex(simds, globalToLocal);
+            haveIndex=true;
+        }
+
+        // Node ids not found in the simulation data map to point 0 as they
+        // did with the old std::map lookup.
+        localIds.resize(faceNumPoint);
+        for(vtkIdType j=0;j<faceNumPoint;++j)
+        {
+            vtkIdType gID=faceNodeIDs->GetTuple1(j);
+            vtkIdType lID=-1;
+            if(gID>=0 && gID<(vtkIdType)globalToLocal.size())
+                lID=globalToLocal[gID];
+            localIds[j]=(lID<0) ? 0 : lID;
+        }
     }
 
-    for(int i=0;i<velocityNames.size();++i)
+    for(auto name_face:faces)
     {
-        vtkSmartPointer<vtkDoubleArray> varray=vtkSmartPointer<vtkDoubleArray>::New();
-        varray->SetNumberOfComponents(3);
-        varray->Allocate(100,100);
+        vtkPolyData* facevtp=name_face.second;
+        const std::vector<vtkIdType>& localIds=faceLocalIds[name_face.first];
+        vtkIdType faceNumPoint=localIds.size();
 
-        std::string vn=velocityNames[i];
-        if(step!="combo")
-            vn=vn+"_"+step;
+        for(int i=0;i<arrays.size();++i)
+        {
+            vtkDataArray* array=arrays[i];
+            int numComps=array->GetNumberOfComponents();
 
-        varray->SetName(vn.c_str());
+            vtkSmartPointer<vtkDoubleArray> farray=vtkSmartPointer<vtkDoubleArray>::New();
+            farray->SetNumberOfComponents(numComps);
+            farray->SetNumberOfTuples(faceNumPoint);
+            farray->SetName(names[i].c_str());
 
-        vtkDataArray* array=pointData->GetArray(velocityNames[i].c_str());
-        for(int j=0;j<faceNumPoint;++j)
-        {
-            int gID=faceNodeIDs->GetTuple1(j);
-            int lID=mapGlobal2Local[gID];
-            double* v=array->GetTuple3(lID);
-            varray->InsertNextTuple3(v[0],v[1],v[2]);
-        }
+            double* out=farray->GetPointer(0);
+            vtkDoubleArray* darray=vtkDoubleArray::SafeDownCast(array);
+            if(darray!=nullptr)
+            {
+                const double* in=darray->GetPointer(0);
+                for(vtkIdType j=0;j<faceNumPoint;++j)
+                {
+                    const double* src=in+localIds[j]*numComps;
+                    for(int k=0;k<numComps;++k)
+                        out[j*numComps+k]=src[k];
+                }
+            }
+            else
+            {
+                for(vtkIdType j=0;j<faceNumPoint;++j)
+                    array->GetTuple(localIds[j], out+j*numComps);
+            }
 
-        facevtp->GetPointData()->AddArray(varray);
+            facevtp->GetPointData()->AddArray(farray);
+        }
     }
 }
 
+//------------------
+// VtpIntegrateFace
+//------------------
+//
 void sv4guiSimulationUtils::VtpIntegrateFace(vtkSmartPointer<vtkPolyData> facevtp, std::map<std::string, double>& pmap
                                          , std::map<std::string, double>& qmap, std::map<std::string, double>& amap)
 {
-    vtkPointData* pointData=facevtp->GetPointData();
+    std::map<std::string,vtkSmartPointer<vtkPolyData>> faces;
+    faces["face"]=facevtp;
 
-    std::vector<std::string> pressureNames, velocityNames;
+    std::map<std::string,std::map<std::string, double>> pressureMap;
+    std::map<std::string,std::map<std::string, double>> flowrateMap;
+    std::map<std::string,std::map<std::string, double>> areaMap;
 
-    for(int i=0;i<pointData->GetNumberOfArrays();++i)
+    IntegrateFaces(faces,pressureMap,flowrateMap,areaMap);
+
+    pmap=pressureMap["face"];
+    qmap=flowrateMap["face"];
+    amap=areaMap["face"];
+}
+
+//-------------------------------
+// ComputeFaceIntegrationWeights
+//-------------------------------
+// Compute the point weights and point normals used to integrate point
+// data over a face.
+//
+// Point data is linear over each triangle, so integrating it is a
+// weighted sum of point values with each triangle adding a third of its
+// area to its points. Flow is integrated as the point velocity dotted
+// with the normalized, area weighted point normal, which gives the same
+// result as vtkSVIntegrateFlowThroughSurface. Polygons are fan
+// triangulated.
+//
+void sv4guiSimulationUtils::ComputeFaceIntegrationWeights(vtkPolyData* facevtp, std::vector<double>& weights, std::vector<double>& normals, double& area)
+{
+    vtkIdType numPts=facevtp->GetNumberOfPoints();
+    weights.assign(numPts,0.0);
+    normals.assign(3*numPts,0.0);
+    area=0.0;
+
+    vtkCellArray* polys=facevtp->GetPolys();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double p0[3],p1[3],p2[3],v1[3],v2[3],cross[3];
+
+    for(polys->InitTraversal();polys->GetNextCell(npts,pts);)
     {
-        std::string name(pointData->GetAbstractArray(i)->GetName());
+        if(npts<3)
+            continue;
 
-        if(name.substr(0,9)=="pressure_")
-            pressureNames.push_back(name);
-        else if(name.substr(0,9)=="velocity_")
-            velocityNames.push_back(name);
+        // Point normals use the first three points of the cell like
+        // vtkSVSurfaceVectors.
+        facevtp->GetPoint(pts[0],p0);
+        facevtp->GetPoint(pts[1],p1);
+        facevtp->GetPoint(pts[2],p2);
+        vtkMath::Subtract(p1,p0,v1);
+        vtkMath::Subtract(p2,p0,v2);
+        vtkMath::Cross(v1,v2,cross);
+        for(vtkIdType j=0;j<npts;++j)
+        {
+            normals[3*pts[j]]+=cross[0];
+            normals[3*pts[j]+1]+=cross[1];
+            normals[3*pts[j]+2]+=cross[2];
+        }
+
+        for(vtkIdType j=1;j<npts-1;++j)
+        {
+            facevtp->GetPoint(pts[j],p1);
+            facevtp->GetPoint(pts[j+1],p2);
+            vtkMath::Subtract(p1,p0,v1);
+            vtkMath::Subtract(p2,p0,v2);
+            vtkMath::Cross(v1,v2,cross);
+            double triArea=0.5*vtkMath::Norm(cross);
+            area+=triArea;
+            weights[pts[0]]+=triArea/3.0;
+            weights[pts[j]]+=triArea/3.0;
+            weights[pts[j+1]]+=triArea/3.0;
+        }
     }
 
-    for(int i=0;i<pressureNames.size();i++)
+    for(vtkIdType i=0;i<numPts;++i)
+        vtkMath::Normalize(&normals[3*i]);
+}
+
+//----------------
+// IntegrateFaces
+//----------------
+// Integrate the pressure and flow of all time steps over all faces.
+//
+// The face weights are computed once per face and each (face, time step)
+// integral is then a weighted sum over the face points. Both stages are
+// run in parallel; the results are stored by face name and time step
+// like VtpIntegrateFace.
+//
+void sv4guiSimulationUtils::IntegrateFaces(std::map<std::string,vtkSmartPointer<vtkPolyData>>& faces,
+                                           std::map<std::string,std::map<std::string, double>>& pressureMap,
+                                           std::map<std::string,std::map<std::string, double>>& flowrateMap,
+                                           std::map<std::string,std::map<std::string, double>>& areaMap)
+{
+    std::vector<std::string> faceNames;
+    std::vector<vtkPolyData*> faceVtps;
+    std::vector<FaceIntegral> integrals;
+    std::vector<std::string> integralSteps;
+
+    for(auto name_face:faces)
     {
-        pointData->SetActiveScalars(pressureNames[i].c_str());
-        double force=0,area=0;
+        int faceIndex=faceNames.size();
+        faceNames.push_back(name_face.first);
+        faceVtps.push_back(name_face.second);
+
+        vtkPointData* pointData=name_face.second->GetPointData();
+        for(int i=0;i<pointData->GetNumberOfArrays();i++)
+        {
+            vtkDataArray* array=pointData->GetArray(i);
+            if(array==nullptr || array->GetName()==nullptr)
+                continue;
 
-        sys_geom_IntegrateSurface2(facevtp,0,&force,&area);
+            std::string name(array->GetName());
+            FaceIntegral fi;
+            fi.face=faceIndex;
+            fi.array=array;
+            fi.value=0.0;
 
-        amap[pressureNames[i].substr(9)]=area;
-        pmap[pressureNames[i].substr(9)]=force/area;
+            if(name.substr(0,9)=="pressure_" && array->GetNumberOfComponents()==1)
+                fi.isVelocity=false;
+            else if(name.substr(0,9)=="velocity_" && array->GetNumberOfComponents()==3)
+                fi.isVelocity=true;
+            else
+                continue;
+
+            integrals.push_back(fi);
+            integralSteps.push_back(name.substr(9));
+        }
     }
 
-    for(int i=0;i<velocityNames.size();i++)
-    {
-        pointData->SetActiveVectors(velocityNames[i].c_str());
-        double flowrate=0,area=0;
+    std::vector<FaceWeights> weights(faceVtps.size());
+    ComputeFaceWeightsFunctor weightsFunctor;
+    weightsFunctor.Faces=&faceVtps;
+    weightsFunctor.Weights=&weights;
+    vtkSMPTools::For(0,faceVtps.size(),1,weightsFunctor);
 
-        sys_geom_IntegrateSurface2(facevtp,1,&flowrate,&area);
+    IntegrateFacesFunctor integrateFunctor;
+    integrateFunctor.Weights=&weights;
+    integrateFunctor.Integrals=&integrals;
+    vtkSMPTools::For(0,integrals.size(),integrateFunctor);
 
-        qmap[pressureNames[i].substr(9)]=flowrate;
+    for(int i=0;i<faceNames.size();i++)
+    {
+        pressureMap[faceNames[i]];
+        flowrateMap[faceNames[i]];
+        areaMap[faceNames[i]];
     }
 
-}
+    for(int i=0;i<integrals.size();i++)
+    {
+        const FaceIntegral& fi=integrals[i];
+        const std::string& faceName=faceNames[fi.face];
+        double area=weights[fi.face].area;
 
+        if(fi.isVelocity)
+        {
+            flowrateMap[faceName][integralSteps[i]]=fi.value;
+        }
+        else
+        {
+            areaMap[faceName][integralSteps[i]]=area;
+            pressureMap[faceName][integralSteps[i]]=fi.value/area;
+        }
+    }
+}
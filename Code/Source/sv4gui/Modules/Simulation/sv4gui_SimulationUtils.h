@@ -36,10 +36,12 @@
 
 #include "sv4gui_SimJob.h"
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include <vtkSmartPointer.h>
+#include <vtkDataSet.h>
 #include <vtkPolyData.h>
 #include <vtkUnstructuredGrid.h>
 
@@ -70,7 +72,19 @@ public:
 
     static void VtuExtractSingleFace(std::string step, vtkSmartPointer<vtkUnstructuredGrid> simug,vtkSmartPointer<vtkPolyData> facevtp);
 
+    static void BuildGlobalNodeIndex(vtkDataSet* simds, std::vector<vtkIdType>& globalToLocal);
+
+    static void ExtractFaces(std::string step, vtkDataSet* simds, std::map<std::string,vtkSmartPointer<vtkPolyData>>& faces,
+                             std::map<std::string,std::vector<vtkIdType>>& faceLocalIds);
+
     static void VtpIntegrateFace(vtkSmartPointer<vtkPolyData>facevtp, std::map<std::string, double>& pmap, std::map<std::string, double>& qmap, std::map<std::string, double>& amap);
+
+    static void ComputeFaceIntegrationWeights(vtkPolyData* facevtp, std::vector<double>& weights, std::vector<double>& normals, double& area);
+
+    static void IntegrateFaces(std::map<std::string,vtkSmartPointer<vtkPolyData>>& faces,
+                               std::map<std::string,std::map<std::string, double>>& pressureMap,
+                               std::map<std::string,std::map<std::string, double>>& flowrateMap,
+                               std::map<std::string,std::map<std::string, double>>& areaMap);
 };
 
 #endif /* SV4GUI_SIMULATIONUTILS_H */
@@ -47,6 +47,8 @@
 
 #include "sv4gui_DataNodeOperation.h"
 
+#include "sv_MeshQuality.h"
+
 #include <mitkIPreferencesService.h>
 #include <mitkIPreferences.h>
 #include <berryPlatform.h>
@@ -2296,6 +2298,23 @@ void sv4guiMeshEdit::DisplayMeshInfo()
             + "\n" + "Number of Edges: " + QString::number(nMeshEdges)
             + "\n" + "Number of Faces: " + QString::number(nMeshFaces);
 
+    // Element quality of the whole mesh and of each region.
+    cvMeshQuality quality;
+    if(volumeMesh && quality.Compute(volumeMesh)==SV_OK)
+    {
+      for(auto const& group : quality.GetGroups())
+      {
+        if(group.regionId>=0 && quality.GetGroups().size()==2)
+          continue;
+
+        QString name=(group.regionId<0) ? "" : QString::fromStdString(group.name)+" ";
+        stat+="\n\n" + name + "Min Radius Ratio: " + QString::number(group.metrics[cvMeshQuality::RADIUS_RATIO].min)
+            + "\n" + name + "Min Dihedral Angle: " + QString::number(group.metrics[cvMeshQuality::MIN_DIHEDRAL_ANGLE].min)
+            + "\n" + name + "Max Aspect Ratio: " + QString::number(group.metrics[cvMeshQuality::ASPECT_RATIO].max)
+            + "\n" + name + "Inverted Elements: " + QString::number(group.numberOfInverted);
+      }
+    }
+
     std::cout << stat << std::endl << std::flush;
 
     QMessageBox::information(m_Parent,"Mesh Statistics","Mesh done. Statistics:           \n\n"+stat);
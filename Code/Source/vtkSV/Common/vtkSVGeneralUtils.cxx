@@ -70,6 +70,7 @@
 
 #include "vtkSVGlobals.h"
 #include "vtkSVMathUtils.h"
+#include "vtkSVPolyDataAdjacency.h"
 
 #include "sv_vtk_utils.h"
 
@@ -653,6 +654,24 @@ int vtkSVGeneralUtils::GetPointCellsValues(vtkPointSet *ps, std::string arrayNam
     ps->GetCellData()->GetArray(arrayName.c_str());
   valList->Reset();
 
+  // Polydata uses the cached adjacency, no links or id list needed
+  vtkPolyData *pd = vtkPolyData::SafeDownCast(ps);
+  if (pd != NULL)
+  {
+    vtkIdType ncells;
+    const vtkIdType *cells;
+    vtkSVPolyDataAdjacency::GetAdjacency(pd)->GetPointCells(pointId, ncells, cells);
+    for (vtkIdType i=0; i<ncells; i++)
+    {
+      int value = valArray->GetTuple1(cells[i]);
+
+      if (valList->IsId(value) == -1)
+        valList->InsertNextId(value);
+    }
+
+    return SV_OK;
+  }
+
   // Get point cells
   vtkNew(vtkIdList, cellIds);
   ps->GetPointCells(pointId, cellIds);
@@ -683,23 +702,22 @@ int vtkSVGeneralUtils::GetNeighborsCellsValues(vtkPolyData *pd, std::string arra
   valList->Reset();
 
   // Get cell points
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
   vtkIdType npts;
   const vtkIdType* pts;
-  pd->GetCellPoints(cellId, npts, pts);
+  adjacency->GetCellPoints(cellId, npts, pts);
 
   // Loop through points
   for (int i=0; i<npts; i++)
   {
-    int ptId0 = pts[i];
-    int ptId1 = pts[(i+1)%npts];
-
-    vtkNew(vtkIdList, cellEdgeNeighbors);
-    pd->GetCellEdgeNeighbors(cellId, ptId0, ptId1, cellEdgeNeighbors);
+    vtkIdType nneis;
+    const vtkIdType *neis;
+    adjacency->GetCellEdgeNeighbors(cellId, i, nneis, neis);
 
     // Loop through and check each point
-    for (int j=0; j<cellEdgeNeighbors->GetNumberOfIds(); j++)
+    for (int j=0; j<nneis; j++)
     {
-      int value = valArray->GetTuple1(cellEdgeNeighbors->GetId(j));
+      int value = valArray->GetTuple1(neis[j]);
 
       // Only adding to list if value is not -1
       if (valList->IsId(value) == -1)
@@ -1911,31 +1929,25 @@ int vtkSVGeneralUtils::GetRegions(vtkPolyData *pd, std::string arrayName,
   std::vector<int> numberOfDirectNeighbors(numCells);
   std::vector<int> pointOnOpenEdge(numPoints, 0);
 
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
+  adjacency->GetCellDirectNeighbors(directNeighbors, numberOfDirectNeighbors);
+
   for (int i=0; i<numCells; i++)
   {
-    int directNeiCount = 0;
-    std::vector<int> neighborCells;
     vtkIdType npts;
     const vtkIdType* pts;
-    pd->GetCellPoints(i, npts, pts);
+    adjacency->GetCellPoints(i, npts, pts);
     for (int j=0; j<npts; j++)
     {
-      int ptId0 = pts[j];
-      int ptId1 = pts[(j+1)%npts];
-      vtkNew(vtkIdList, cellEdgeNeighbors);
-      pd->GetCellEdgeNeighbors(i, ptId0, ptId1, cellEdgeNeighbors);
-      directNeiCount += cellEdgeNeighbors->GetNumberOfIds();
-      for (int k=0; k<cellEdgeNeighbors->GetNumberOfIds(); k++)
-        neighborCells.push_back(cellEdgeNeighbors->GetId(k));
-
-      if (cellEdgeNeighbors->GetNumberOfIds() == 0)
+      vtkIdType nneis;
+      const vtkIdType *neis;
+      adjacency->GetCellEdgeNeighbors(i, j, nneis, neis);
+      if (nneis == 0)
       {
-        pointOnOpenEdge[ptId0] = 1;
-        pointOnOpenEdge[ptId1] = 1;
+        pointOnOpenEdge[pts[j]] = 1;
+        pointOnOpenEdge[pts[(j+1)%npts]] = 1;
       }
     }
-    directNeighbors[i] = neighborCells;
-    numberOfDirectNeighbors[i] = directNeiCount;
   }
 
   for (int i=0; i<numCells; i++)
@@ -2087,7 +2099,7 @@ int vtkSVGeneralUtils::GetRegions(vtkPolyData *pd, std::string arrayName,
         }
         else
         {
-          pd->GetPointCells(tempNodes[j], pointCells);
+          adjacency->GetPointCells(tempNodes[j], pointCells);
         }
 
         for (int k=0; k<pointCells->GetNumberOfIds(); k++)
@@ -2164,7 +2176,7 @@ int vtkSVGeneralUtils::GetRegions(vtkPolyData *pd, std::string arrayName,
               }
 
               vtkNew(vtkIdList, tempCells);
-              pd->GetPointCells(pointCCWId, tempCells);
+              adjacency->GetPointCells(pointCCWId, tempCells);
 
               for (int ii=0; ii<tempCells->GetNumberOfIds(); ii++)
               {
@@ -2202,31 +2214,25 @@ int vtkSVGeneralUtils::GetSpecificRegions(vtkPolyData *pd, std::string arrayName
   std::vector<int> numberOfDirectNeighbors(numCells);
   std::vector<int> pointOnOpenEdge(numPoints, 0);
 
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
+  adjacency->GetCellDirectNeighbors(directNeighbors, numberOfDirectNeighbors);
+
   for (int i=0; i<numCells; i++)
   {
-    int directNeiCount = 0;
-    std::vector<int> neighborCells;
     vtkIdType npts;
     const vtkIdType* pts;
-    pd->GetCellPoints(i, npts, pts);
+    adjacency->GetCellPoints(i, npts, pts);
     for (int j=0; j<npts; j++)
     {
-      int ptId0 = pts[j];
-      int ptId1 = pts[(j+1)%npts];
-      vtkNew(vtkIdList, cellEdgeNeighbors);
-      pd->GetCellEdgeNeighbors(i, ptId0, ptId1, cellEdgeNeighbors);
-      directNeiCount += cellEdgeNeighbors->GetNumberOfIds();
-      for (int k=0; k<cellEdgeNeighbors->GetNumberOfIds(); k++)
-        neighborCells.push_back(cellEdgeNeighbors->GetId(k));
-
-      if (cellEdgeNeighbors->GetNumberOfIds() == 0)
+      vtkIdType nneis;
+      const vtkIdType *neis;
+      adjacency->GetCellEdgeNeighbors(i, j, nneis, neis);
+      if (nneis == 0)
       {
-        pointOnOpenEdge[ptId0] = 1;
-        pointOnOpenEdge[ptId1] = 1;
+        pointOnOpenEdge[pts[j]] = 1;
+        pointOnOpenEdge[pts[(j+1)%npts]] = 1;
       }
     }
-    directNeighbors[i] = neighborCells;
-    numberOfDirectNeighbors[i] = directNeiCount;
   }
 
   for (int i=0; i<numCells; i++)
@@ -2400,7 +2406,7 @@ int vtkSVGeneralUtils::GetSpecificRegions(vtkPolyData *pd, std::string arrayName
         }
         else
         {
-          pd->GetPointCells(tempNodes[j], pointCells);
+          adjacency->GetPointCells(tempNodes[j], pointCells);
         }
 
         for (int k=0; k<pointCells->GetNumberOfIds(); k++)
@@ -2486,7 +2492,7 @@ int vtkSVGeneralUtils::GetSpecificRegions(vtkPolyData *pd, std::string arrayName
               }
 
               vtkNew(vtkIdList, tempCells);
-              pd->GetPointCells(pointCCWId, tempCells);
+              adjacency->GetPointCells(pointCCWId, tempCells);
 
               for (int ii=0; ii<tempCells->GetNumberOfIds(); ii++)
               {
@@ -2569,7 +2575,7 @@ int vtkSVGeneralUtils::GetCWPoint(vtkPolyData *pd, const int pointId, const int
 int vtkSVGeneralUtils::CheckCellValuesEdge(vtkPolyData *pd, std::string arrayName, const int cellId, const int pointId0, const int pointId1)
 {
   vtkNew(vtkIdList, cellEdgeNeighbors);
-  pd->GetCellEdgeNeighbors(cellId, pointId0, pointId1, cellEdgeNeighbors);
+  vtkSVPolyDataAdjacency::GetAdjacency(pd)->GetCellEdgeNeighbors(cellId, pointId0, pointId1, cellEdgeNeighbors);
 
   vtkNew(vtkIdList, uniqueVals);
   uniqueVals->InsertNextId(pd->GetCellData()->GetArray(arrayName.c_str())->GetTuple1(cellId));
@@ -2592,7 +2598,7 @@ int vtkSVGeneralUtils::CheckCellValuesEdge(vtkPolyData *pd, std::string arrayNam
 int vtkSVGeneralUtils::CheckBoundaryEdge(vtkPolyData *pd, std::string arrayName, const int cellId, const int pointId0, const int pointId1)
 {
   vtkNew(vtkIdList, cellEdgeNeighbors);
-  pd->GetCellEdgeNeighbors(cellId, pointId0, pointId1, cellEdgeNeighbors);
+  vtkSVPolyDataAdjacency::GetAdjacency(pd)->GetCellEdgeNeighbors(cellId, pointId0, pointId1, cellEdgeNeighbors);
 
   vtkNew(vtkIdList, uniqueVals);
   uniqueVals->InsertNextId(pd->GetCellData()->GetArray(arrayName.c_str())->GetTuple1(cellId));
@@ -2749,6 +2755,7 @@ void vtkSVGeneralUtils::GetMostOccuringVal(vtkIdList *idList, int &output,
 int vtkSVGeneralUtils::SmoothBoundaries(vtkPolyData *pd, std::string arrayName)
 {
   int numPoints = pd->GetNumberOfPoints();
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
   std::vector<int> cornerPoints;
   std::vector<int> isCornerPoint(numPoints);
   std::vector<int> isBoundaryPoint(numPoints);
@@ -2783,7 +2790,7 @@ int vtkSVGeneralUtils::SmoothBoundaries(vtkPolyData *pd, std::string arrayName)
       if (pointCellsValues->GetNumberOfIds() == 2)
       {
         vtkNew(vtkIdList, pointCells);
-        pd->GetPointCells(i, pointCells);
+        adjacency->GetPointCells(i, pointCells);
 
         int count[2]; count[0] = 0; count[1] = 0;
         int cellIds[2][2];
@@ -2851,7 +2858,7 @@ int vtkSVGeneralUtils::SmoothBoundaries(vtkPolyData *pd, std::string arrayName)
                 int ptId0 = pts[j];
                 int ptId1 = pts[(j+1)%npts];
                 vtkNew(vtkIdList, neighborCell);
-                pd->GetCellEdgeNeighbors(cellIds[0][0], ptId0, ptId1, neighborCell);
+                adjacency->GetCellEdgeNeighbors(cellIds[0][0], ptId0, ptId1, neighborCell);
                 if (neighborCell->GetNumberOfIds() > 0)
                 {
                   if (neighborCell->GetId(0) == cellIds[0][1])
@@ -2919,7 +2926,7 @@ int vtkSVGeneralUtils::SmoothBoundaries(vtkPolyData *pd, std::string arrayName)
                 int ptId0 = pts[j];
                 int ptId1 = pts[(j+1)%npts];
                 vtkNew(vtkIdList, neighborCell);
-                pd->GetCellEdgeNeighbors(cellIds[1][0], ptId0, ptId1, neighborCell);
+                adjacency->GetCellEdgeNeighbors(cellIds[1][0], ptId0, ptId1, neighborCell);
                 if (neighborCell->GetNumberOfIds() > 0)
                 {
                   if (neighborCell->GetId(0) == cellIds[1][1])
@@ -2986,6 +2993,7 @@ int vtkSVGeneralUtils::SmoothBoundaries(vtkPolyData *pd, std::string arrayName)
 int vtkSVGeneralUtils::SmoothSpecificBoundaries(vtkPolyData *pd, std::string arrayName, vtkIdList *targetRegions)
 {
   int numPoints = pd->GetNumberOfPoints();
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
   std::vector<int> cornerPoints;
   std::vector<int> isCornerPoint(numPoints);
   std::vector<int> isBoundaryPoint(numPoints);
@@ -3025,7 +3033,7 @@ int vtkSVGeneralUtils::SmoothSpecificBoundaries(vtkPolyData *pd, std::string arr
       if (pointCellsValues->GetNumberOfIds() == 2)
       {
         vtkNew(vtkIdList, pointCells);
-        pd->GetPointCells(i, pointCells);
+        adjacency->GetPointCells(i, pointCells);
 
         int count[2]; count[0] = 0; count[1] = 0;
         int cellIds[2][2];
@@ -3093,7 +3101,7 @@ int vtkSVGeneralUtils::SmoothSpecificBoundaries(vtkPolyData *pd, std::string arr
                 int ptId0 = pts[j];
                 int ptId1 = pts[(j+1)%npts];
                 vtkNew(vtkIdList, neighborCell);
-                pd->GetCellEdgeNeighbors(cellIds[0][0], ptId0, ptId1, neighborCell);
+                adjacency->GetCellEdgeNeighbors(cellIds[0][0], ptId0, ptId1, neighborCell);
                 if (neighborCell->GetNumberOfIds() > 0)
                 {
                   if (neighborCell->GetId(0) == cellIds[0][1])
@@ -3161,7 +3169,7 @@ int vtkSVGeneralUtils::SmoothSpecificBoundaries(vtkPolyData *pd, std::string arr
                 int ptId0 = pts[j];
                 int ptId1 = pts[(j+1)%npts];
                 vtkNew(vtkIdList, neighborCell);
-                pd->GetCellEdgeNeighbors(cellIds[1][0], ptId0, ptId1, neighborCell);
+                adjacency->GetCellEdgeNeighbors(cellIds[1][0], ptId0, ptId1, neighborCell);
                 if (neighborCell->GetNumberOfIds() > 0)
                 {
                   if (neighborCell->GetId(0) == cellIds[1][1])
@@ -3231,9 +3239,10 @@ int vtkSVGeneralUtils::GetPointEdgeCells(vtkPolyData *pd, std::string arrayName,
 {
   int sameValue = pd->GetCellData()->GetArray(arrayName.c_str())->GetTuple1(cellId);
 
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
   vtkIdType npts;
   const vtkIdType* pts;
-  pd->GetCellPoints(cellId, npts, pts);
+  adjacency->GetCellPoints(cellId, npts, pts);
 
   for (int i=0; i<npts; i++)
   {
@@ -3242,12 +3251,13 @@ int vtkSVGeneralUtils::GetPointEdgeCells(vtkPolyData *pd, std::string arrayName,
 
     if (ptId0 == pointId || ptId1 == pointId)
     {
-      vtkNew(vtkIdList, cellNeighbor);
-      pd->GetCellEdgeNeighbors(cellId, ptId0, ptId1, cellNeighbor);
+      vtkIdType nneis;
+      const vtkIdType *neis;
+      adjacency->GetCellEdgeNeighbors(cellId, i, nneis, neis);
 
-      for (int j=0; j<cellNeighbor->GetNumberOfIds(); j++)
+      for (int j=0; j<nneis; j++)
       {
-        int cellNeighborId = cellNeighbor->GetId(j);
+        int cellNeighborId = neis[j];
         int cellNeighborValue = pd->GetCellData()->GetArray(arrayName.c_str())->GetTuple1(cellNeighborId);
         if (sameCells->IsId(cellNeighborId) == -1 && cellNeighborValue == sameValue)
         {
@@ -3400,78 +3410,27 @@ int vtkSVGeneralUtils::GetCellRingNeighbors(vtkPolyData *pd, vtkIdList *cellIds,
                                             int totNumberOfRings,
                                             std::vector<std::vector<int> > &neighbors)
 {
-  // Number of cells
-  int numCells = cellIds->GetNumberOfIds();
+  // Rings ringNumber through totNumberOfRings, always at least one
+  int numberOfRings = totNumberOfRings - ringNumber + 1;
+  if (numberOfRings < 1)
+    numberOfRings = 1;
 
-  for (int i=0; i<numCells; i++)
+  // Only the lists of the given cells are expanded
+  int numCells = cellIds->GetNumberOfIds();
+  if (numCells < (int) neighbors.size())
   {
-    // temporary node vec
-    std::vector<int> tmpNodes;
-    int iSize = neighbors[i].size();
-
-    for (int j=0; j<iSize; j++)
-    {
-      // Get neighbor cell points
-      int neiCellId = neighbors[i][j];
-      vtkIdType npts;
-      const vtkIdType* pts;
-      pd->GetCellPoints(neiCellId, npts, pts);
-
-      // Loop around cell points
-      for (int k=0; k<npts; k++)
-      {
-        int tmpNode = pts[k];
-        int kSize   = tmpNodes.size();
-
-        int kk = 0;
-        for (kk=0; kk<kSize; kk++)
-        {
-          if (tmpNode == tmpNodes[kk])
-          {
-            break;
-          }
-        }
-        if (kk == kSize)
-        {
-          tmpNodes.push_back(tmpNode);
-        }
-      }
-    }
-
-    // Now find neighbor elems
-    iSize = tmpNodes.size();
+    std::vector<std::vector<int> > cellNeighbors(numCells);
+    for (int i=0; i<numCells; i++)
+      cellNeighbors[i].swap(neighbors[i]);
 
-    for (int j=0; j<iSize; j++)
-    {
-      int tmpNode = tmpNodes[j];
+    vtkSVPolyDataAdjacency::GetAdjacency(pd)->GetCellRingNeighbors(numberOfRings, cellNeighbors);
 
-      vtkNew(vtkIdList, pointCellIds);
-      pd->GetPointCells(tmpNode, pointCellIds);
-      for (int k=0; k<pointCellIds->GetNumberOfIds(); k++)
-      {
-        int tmpCell = pointCellIds->GetId(k);
-        int kSize =   neighbors[i].size();
-
-        int kk=0;
-        for (kk=0; kk<kSize; kk++)
-        {
-          if (tmpCell == neighbors[i][kk])
-          {
-            break;
-          }
-        }
-        if (kk == kSize)
-        {
-          neighbors[i].push_back(tmpCell);
-        }
-      }
-    }
+    for (int i=0; i<numCells; i++)
+      neighbors[i].swap(cellNeighbors[i]);
   }
-
-  if (ringNumber < totNumberOfRings)
+  else
   {
-    ringNumber++;
-    vtkSVGeneralUtils::GetCellRingNeighbors(pd, cellIds, ringNumber, totNumberOfRings, neighbors);
+    vtkSVPolyDataAdjacency::GetAdjacency(pd)->GetCellRingNeighbors(numberOfRings, neighbors);
   }
 
   return SV_OK;
@@ -3484,43 +3443,10 @@ int vtkSVGeneralUtils::GetCellDirectNeighbors(vtkPolyData *pd,
                                               std::vector<std::vector<int> > &neighbors,
                                               std::vector<int> &numNeighbors)
 {
-
-  int numCells = pd->GetNumberOfCells();
-  pd->BuildLinks();
-
   neighbors.clear();
   numNeighbors.clear();
 
-  // Loop through cells
-  for (int i=0; i<numCells; i++)
-  {
-    // count number of edge neighbors
-    int directNeiCount = 0;
-    std::vector<int> neighborCells;
-
-    // Get cell points
-    vtkIdType npts;
-    const vtkIdType* pts;
-    pd->GetCellPoints(i, npts, pts);
-
-    // Get cell edge neighbors
-    for (int j=0; j<npts; j++)
-    {
-      int ptId0 = pts[j];
-      int ptId1 = pts[(j+1)%npts];
-
-      // Get cell edge neighbors
-      vtkNew(vtkIdList, cellEdgeNeighbors);
-      pd->GetCellEdgeNeighbors(i, ptId0, ptId1, cellEdgeNeighbors);
-      directNeiCount += cellEdgeNeighbors->GetNumberOfIds();
-      for (int k=0; k<cellEdgeNeighbors->GetNumberOfIds(); k++)
-      {
-        neighborCells.push_back(cellEdgeNeighbors->GetId(k));
-      }
-    }
-    neighbors.push_back(neighborCells);
-    numNeighbors.push_back(directNeiCount);
-  }
+  vtkSVPolyDataAdjacency::GetAdjacency(pd)->GetCellDirectNeighbors(neighbors, numNeighbors);
 
   return SV_OK;
 }
@@ -3537,6 +3463,7 @@ int vtkSVGeneralUtils::CorrectCellBoundaries(vtkPolyData *pd, std::string cellAr
 
   // Num cells
   pd->BuildLinks();
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
   int numCells = pd->GetNumberOfCells();
 
   // Set up array to keep track of temp cell ids, will be different than
@@ -3567,22 +3494,20 @@ int vtkSVGeneralUtils::CorrectCellBoundaries(vtkPolyData *pd, std::string cellAr
         // Get Cell points
         vtkIdType npts;
         const vtkIdType* pts;
-        pd->GetCellPoints(queue->GetId(j), npts, pts);
+        adjacency->GetCellPoints(queue->GetId(j), npts, pts);
 
         // Loop through cell points
         for (int k=0; k<npts; k++)
         {
-          int ptId0 = pts[k];
-          int ptId1 = pts[(k+1)%npts];
-
           // Get cell edge neighbors
-          vtkNew(vtkIdList, cellEdgeNeighbors);
-          pd->GetCellEdgeNeighbors(queue->GetId(j), ptId0, ptId1, cellEdgeNeighbors);
+          vtkIdType nneis;
+          const vtkIdType *neis;
+          adjacency->GetCellEdgeNeighbors(queue->GetId(j), k, nneis, neis);
 
           // Check val of cell edge neighbors
-          for (int l=0; l<cellEdgeNeighbors->GetNumberOfIds(); l++)
+          for (int l=0; l<nneis; l++)
           {
-            int cellEdgeNeighbor = cellEdgeNeighbors->GetId(l);
+            int cellEdgeNeighbor = neis[l];
             if (tmpIds->GetTuple1(cellEdgeNeighbor) == -1 &&
                 cellIds->GetTuple1(i) == cellIds->GetTuple1(cellEdgeNeighbor))
             {
@@ -3616,22 +3541,20 @@ int vtkSVGeneralUtils::CorrectCellBoundaries(vtkPolyData *pd, std::string cellAr
       // Get cell points
       vtkIdType npts;
       const vtkIdType* pts;
-      pd->GetCellPoints(i, npts, pts);
+      adjacency->GetCellPoints(i, npts, pts);
 
       // Loop through cell points
       for (int j=0; j<npts; j++)
       {
-        int ptId0 = pts[j];
-        int ptId1 = pts[(j+1)%npts];
-
         // Get cell edge neighbors
-        vtkNew(vtkIdList, cellEdgeNeighbors);
-        pd->GetCellEdgeNeighbors(i, ptId0, ptId1, cellEdgeNeighbors);
+        vtkIdType nneis;
+        const vtkIdType *neis;
+        adjacency->GetCellEdgeNeighbors(i, j, nneis, neis);
 
         // loop through neighbors
-        for (int k=0; k<cellEdgeNeighbors->GetNumberOfIds(); k++)
+        for (int k=0; k<nneis; k++)
         {
-          int cellEdgeNeighbor = cellEdgeNeighbors->GetId(k);
+          int cellEdgeNeighbor = neis[k];
 
           // Check to see if equal to region val
           // Important for these cases! Adding to make sure the value is not -1
@@ -3689,6 +3612,7 @@ int vtkSVGeneralUtils::CorrectSpecificCellBoundaries(vtkPolyData *pd, std::strin
 
   // Num cells
   pd->BuildLinks();
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
   int numCells = pd->GetNumberOfCells();
 
   // Set up array to keep track of temp cell ids, will be different than
@@ -3719,22 +3643,20 @@ int vtkSVGeneralUtils::CorrectSpecificCellBoundaries(vtkPolyData *pd, std::strin
         // Get Cell points
         vtkIdType npts;
         const vtkIdType* pts;
-        pd->GetCellPoints(queue->GetId(j), npts, pts);
+        adjacency->GetCellPoints(queue->GetId(j), npts, pts);
 
         // Loop through cell points
         for (int k=0; k<npts; k++)
         {
-          int ptId0 = pts[k];
-          int ptId1 = pts[(k+1)%npts];
-
           // Get cell edge neighbors
-          vtkNew(vtkIdList, cellEdgeNeighbors);
-          pd->GetCellEdgeNeighbors(queue->GetId(j), ptId0, ptId1, cellEdgeNeighbors);
+          vtkIdType nneis;
+          const vtkIdType *neis;
+          adjacency->GetCellEdgeNeighbors(queue->GetId(j), k, nneis, neis);
 
           // Check val of cell edge neighbors
-          for (int l=0; l<cellEdgeNeighbors->GetNumberOfIds(); l++)
+          for (int l=0; l<nneis; l++)
           {
-            int cellEdgeNeighbor = cellEdgeNeighbors->GetId(l);
+            int cellEdgeNeighbor = neis[l];
             if (tmpIds->GetTuple1(cellEdgeNeighbor) == -1 &&
                 cellIds->GetTuple1(i) == cellIds->GetTuple1(cellEdgeNeighbor))
             {
@@ -3768,22 +3690,20 @@ int vtkSVGeneralUtils::CorrectSpecificCellBoundaries(vtkPolyData *pd, std::strin
       // Get cell points
       vtkIdType npts;
       const vtkIdType* pts;
-      pd->GetCellPoints(i, npts, pts);
+      adjacency->GetCellPoints(i, npts, pts);
 
       // Loop through cell points
       for (int j=0; j<npts; j++)
       {
-        int ptId0 = pts[j];
-        int ptId1 = pts[(j+1)%npts];
-
         // Get cell edge neighbors
-        vtkNew(vtkIdList, cellEdgeNeighbors);
-        pd->GetCellEdgeNeighbors(i, ptId0, ptId1, cellEdgeNeighbors);
+        vtkIdType nneis;
+        const vtkIdType *neis;
+        adjacency->GetCellEdgeNeighbors(i, j, nneis, neis);
 
         // loop through neighbors
-        for (int k=0; k<cellEdgeNeighbors->GetNumberOfIds(); k++)
+        for (int k=0; k<nneis; k++)
         {
-          int cellEdgeNeighbor = cellEdgeNeighbors->GetId(k);
+          int cellEdgeNeighbor = neis[k];
 
           // Check to see if equal to region val
           // Important for these cases! Adding to make sure the value is not -1
@@ -32,6 +32,7 @@
 #include "vtkSVMathUtils.h"
 
 #include "vtkSVSparseMatrix.h"
+#include "vtkSVSparseSolver.h"
 
 #include "vtkSmartPointer.h"
 #include "vtkSVGlobals.h"
@@ -122,97 +123,24 @@ int vtkSVMathUtils::MultiplyScalar(double a[], double scalar, const int size)
 // ----------------------
 // ConjugateGradient
 // ----------------------
+/**
+ * \details Solves the normal equations A'A x = A'b with Jacobi
+ * preconditioned conjugate gradient. To reuse the work vectors and
+ * preconditioner over many solves, use vtkSVSparseSolver directly.
+ */
 int vtkSVMathUtils::ConjugateGradient(vtkSVSparseMatrix *a,
                                        const double *b,
                                        int num_iterations,
                                        double *x, const double epsilon)
 {
-  vtkNew(vtkSVSparseMatrix, a_trans);
-  a->Transpose(a_trans);
-
-  double *a_trans_b = new double[a_trans->GetNumberOfRows()];
-  a_trans->MultiplyColumn(b, a_trans_b);
-
-  // Solve a_trans * a * x = a_trans_b.
-  double *r = new double[a_trans->GetNumberOfRows()];
-  double *p = new double[a_trans->GetNumberOfRows()];
-
-  double *temp = new double[a_trans->GetNumberOfRows()];
-
-  // temp = A'A * x
-  vtkSVMathUtils::Multiply_ATA_b(a_trans, a, x, temp);
-
-  // r = A'b - temp
-  vtkSVMathUtils::Add(a_trans_b, temp, -1.0, a_trans->GetNumberOfRows(), r);
-
-  // p = r
-  std::copy(r, r + a_trans->GetNumberOfRows(), p);
-
-  // rs_old = r' * r
-  double rs_old = 0.0;
-  vtkSVMathUtils::InnerProduct(r, r, a_trans->GetNumberOfRows(), rs_old);
-
-  if (sqrt(rs_old) < epsilon) {
-    //printf("The initial solution is good.\n");
-    delete [] r;
-    delete [] p;
-    delete [] temp;
-    delete [] a_trans_b;
-    return rs_old;
-  }
-
-  int iteration = 0;
-  for (iteration = 0;
-       iteration < num_iterations && iteration < a_trans->GetNumberOfRows();
-       iteration++)
-  {
-    // temp = A'A * p
-    vtkSVMathUtils::Multiply_ATA_b(a_trans, a, p, temp);
-
-    // alpha = rs_old / (p' * temp)
-    double alpha_den = 0.0;
-    vtkSVMathUtils::InnerProduct(p, temp, a_trans->GetNumberOfRows(), alpha_den);
-    double alpha = rs_old / alpha_den;
-
-    // x = x + alpha * p
-    vtkSVMathUtils::Add(x, p, alpha, a_trans->GetNumberOfRows(), x);
-
-    // r = r - alpha * temp
-    vtkSVMathUtils::Add(r, temp, -alpha, a_trans->GetNumberOfRows(), r);
-
-    // rs_new = r' * r
-    double rs_new = 0.0;
-    vtkSVMathUtils::InnerProduct(r, r, a_trans->GetNumberOfRows(), rs_new);
-
-    // Traditionally, if norm(rs_new) is small enough, the iteration can stop.
-    if (sqrt(rs_new) < epsilon)
-    {
-      /// DEBUG ///
-      //printf("rs_new = %.20lf\n", rs_new);
-
-      break;
-    }
-
-    // p = r + (rs_new / rs_old) * p
-    vtkSVMathUtils::Add(r, p, rs_new / rs_old, a_trans->GetNumberOfRows(), p);
-
-    // rs_old = rs_new
-    rs_old = rs_new;
-
-    /// DEBUG ///
-    //printf("  rs_old = %.20lf\n", rs_old);
-  }
-
-  /// DEBUG ///
-  //printf("rs_old = %.20lf\n", rs_old);
-  //printf("iterations = %d\n", iteration);
-
-  delete [] r;
-  delete [] p;
-  delete [] temp;
-  delete [] a_trans_b;
-
-  return rs_old;
+  vtkNew(vtkSVSparseSolver, solver);
+  solver->SetMatrix(a);
+  solver->SetSolverType(vtkSVSparseSolver::NORMAL_EQUATIONS);
+  solver->SetPreconditioner(vtkSVSparseSolver::PRECONDITIONER_JACOBI);
+  solver->SetMaximumNumberOfIterations(num_iterations);
+  solver->SetTolerance(epsilon);
+
+  return solver->Solve(b, x);
 }
 
 // ----------------------
@@ -62,7 +62,8 @@ public:
    *  \param x Vector to solve for with initial guess. Number of values should
    *  equal the number of columns in the sparse matrix.
    *  \param epsilon Desired residual that the conjugate gradient solve should
-   *  reach before exiting. */
+   *  reach before exiting.
+   *  \return SV_OK if the solve completed, SV_ERROR otherwise. */
   static int ConjugateGradient(vtkSVSparseMatrix *a,
                                 const double *b, int num_iterations,
                                 double *x, const double epsilon);
@@ -0,0 +1,497 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vtkSVPolyDataAdjacency.h"
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkInformation.h"
+#include "vtkInformationObjectBaseKey.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSVGlobals.h"
+
+// ----------------------
+// Adjacency functors
+// ----------------------
+namespace
+{
+/// \brief Count or fill the edge neighbors of each cell edge. Edge j of a
+/// cell uses the cells of its point j that also contain point j+1.
+struct vtkSVEdgeNeighborFunctor
+{
+  const vtkIdType *CellPointOffsets;
+  const vtkIdType *CellPoints;
+  const vtkIdType *PointCellOffsets;
+  const vtkIdType *PointCells;
+  const vtkIdType *EdgeNeighborOffsets;
+  vtkIdType       *Counts;
+  vtkIdType       *EdgeNeighbors;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      const vtkIdType start = this->CellPointOffsets[i];
+      const vtkIdType npts  = this->CellPointOffsets[i+1] - start;
+      for (vtkIdType j = 0; j < npts; j++)
+      {
+        const vtkIdType ptId0 = this->CellPoints[start + j];
+        const vtkIdType ptId1 = this->CellPoints[start + (j+1)%npts];
+
+        vtkIdType count = 0;
+        for (vtkIdType k = this->PointCellOffsets[ptId0];
+             k < this->PointCellOffsets[ptId0+1]; k++)
+        {
+          const vtkIdType neiId = this->PointCells[k];
+          if (neiId == i)
+            continue;
+
+          vtkIdType l = this->CellPointOffsets[neiId];
+          for (; l < this->CellPointOffsets[neiId+1]; l++)
+          {
+            if (this->CellPoints[l] == ptId1)
+              break;
+          }
+          if (l == this->CellPointOffsets[neiId+1])
+            continue;
+
+          if (this->EdgeNeighbors != NULL)
+            this->EdgeNeighbors[this->EdgeNeighborOffsets[start+j] + count] = neiId;
+          count++;
+        }
+
+        if (this->Counts != NULL)
+          this->Counts[start + j + 1] = count;
+      }
+    }
+  }
+};
+
+/// \brief Concatenate the edge neighbors of each cell
+struct vtkSVDirectNeighborFunctor
+{
+  const vtkSVPolyDataAdjacency    *Adjacency;
+  std::vector<std::vector<int> >  *Neighbors;
+  std::vector<int>                *NumberOfNeighbors;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      vtkIdType npts;
+      const vtkIdType *pts;
+      this->Adjacency->GetCellPoints(i, npts, pts);
+
+      std::vector<int> &neighborCells = (*this->Neighbors)[i];
+      neighborCells.clear();
+      for (int j = 0; j < npts; j++)
+      {
+        vtkIdType nneis;
+        const vtkIdType *neis;
+        this->Adjacency->GetCellEdgeNeighbors(i, j, nneis, neis);
+        for (vtkIdType k = 0; k < nneis; k++)
+          neighborCells.push_back(neis[k]);
+      }
+      (*this->NumberOfNeighbors)[i] = neighborCells.size();
+    }
+  }
+};
+
+/// \brief Ring expansion of independent lists of cells. Points and cells are
+/// marked with the index of the list being expanded so the per thread marks
+/// never need to be cleared. Only the points of the cells added by the
+/// previous ring can bring in new cells, and they are visited in the same
+/// order as a full rescan of the list would visit them.
+struct vtkSVRingNeighborFunctor
+{
+  const vtkSVPolyDataAdjacency   *Adjacency;
+  std::vector<std::vector<int> > *Neighbors;
+  int                             NumberOfRings;
+
+  vtkSMPThreadLocal<std::vector<vtkIdType> > CellMarks;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > PointMarks;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > RingPoints;
+
+  void Initialize()
+  {
+    this->CellMarks.Local().assign(this->Adjacency->GetNumberOfCells(), -1);
+    this->PointMarks.Local().assign(this->Adjacency->GetNumberOfPoints(), -1);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<vtkIdType> &cellMarks  = this->CellMarks.Local();
+    std::vector<vtkIdType> &pointMarks = this->PointMarks.Local();
+    std::vector<vtkIdType> &ringPoints = this->RingPoints.Local();
+
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      std::vector<int> &neighbors = (*this->Neighbors)[i];
+      for (size_t j = 0; j < neighbors.size(); j++)
+        cellMarks[neighbors[j]] = i;
+
+      size_t ringStart = 0;
+      for (int r = 0; r < this->NumberOfRings; r++)
+      {
+        const size_t ringEnd = neighbors.size();
+
+        ringPoints.clear();
+        for (size_t j = ringStart; j < ringEnd; j++)
+        {
+          vtkIdType npts;
+          const vtkIdType *pts;
+          this->Adjacency->GetCellPoints(neighbors[j], npts, pts);
+          for (vtkIdType k = 0; k < npts; k++)
+          {
+            if (pointMarks[pts[k]] != i)
+            {
+              pointMarks[pts[k]] = i;
+              ringPoints.push_back(pts[k]);
+            }
+          }
+        }
+
+        for (size_t j = 0; j < ringPoints.size(); j++)
+        {
+          vtkIdType ncells;
+          const vtkIdType *cells;
+          this->Adjacency->GetPointCells(ringPoints[j], ncells, cells);
+          for (vtkIdType k = 0; k < ncells; k++)
+          {
+            if (cellMarks[cells[k]] != i)
+            {
+              cellMarks[cells[k]] = i;
+              neighbors.push_back(cells[k]);
+            }
+          }
+        }
+
+        if (neighbors.size() == ringEnd)
+          break;
+        ringStart = ringEnd;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+}
+
+// ----------------------
+// StandardNewMacro
+// ----------------------
+vtkStandardNewMacro(vtkSVPolyDataAdjacency);
+
+// ----------------------
+// Information key
+// ----------------------
+vtkInformationKeyMacro(vtkSVPolyDataAdjacency, ADJACENCY, ObjectBase);
+
+// ----------------------
+// Constructor
+// ----------------------
+vtkSVPolyDataAdjacency::vtkSVPolyDataAdjacency()
+{
+  this->NumberOfPoints = 0;
+  this->NumberOfCells  = 0;
+  this->DataMTime      = 0;
+  for (int i=0; i<4; i++)
+  {
+    this->Stamps[i].Array = NULL;
+    this->Stamps[i].MTime = 0;
+    this->Stamps[i].NumberOfConnectivityIds = 0;
+  }
+
+  this->CellPointOffsets.assign(1, 0);
+  this->PointCellOffsets.assign(1, 0);
+  this->EdgeNeighborOffsets.assign(1, 0);
+}
+
+// ----------------------
+// Destructor
+// ----------------------
+vtkSVPolyDataAdjacency::~vtkSVPolyDataAdjacency()
+{
+}
+
+// ----------------------
+// PrintSelf
+// ----------------------
+void vtkSVPolyDataAdjacency::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number of points: " << this->NumberOfPoints << "\n";
+  os << indent << "Number of cells: " << this->NumberOfCells << "\n";
+  os << indent << "Number of edge neighbors: " << this->EdgeNeighbors.size() << "\n";
+}
+
+// ----------------------
+// GetAdjacency
+// ----------------------
+vtkSVPolyDataAdjacency *vtkSVPolyDataAdjacency::GetAdjacency(vtkPolyData *pd)
+{
+  vtkInformation *info = pd->GetInformation();
+
+  vtkSVPolyDataAdjacency *adjacency =
+    vtkSVPolyDataAdjacency::SafeDownCast(info->Get(vtkSVPolyDataAdjacency::ADJACENCY()));
+  if (adjacency != NULL && adjacency->IsUpToDate(pd))
+    return adjacency;
+
+  vtkNew(vtkSVPolyDataAdjacency, newAdjacency);
+  newAdjacency->Build(pd);
+  info->Set(vtkSVPolyDataAdjacency::ADJACENCY(), newAdjacency);
+
+  return newAdjacency;
+}
+
+// ----------------------
+// Invalidate
+// ----------------------
+void vtkSVPolyDataAdjacency::Invalidate(vtkPolyData *pd)
+{
+  pd->GetInformation()->Remove(vtkSVPolyDataAdjacency::ADJACENCY());
+}
+
+// ----------------------
+// GetCellArrayStamps
+// ----------------------
+void vtkSVPolyDataAdjacency::GetCellArrayStamps(vtkPolyData *pd, CellArrayStamp stamps[4])
+{
+  vtkCellArray *cellArrays[4] = {pd->GetVerts(), pd->GetLines(),
+                                 pd->GetPolys(), pd->GetStrips()};
+  for (int i=0; i<4; i++)
+  {
+    stamps[i].Array = cellArrays[i];
+    stamps[i].MTime = 0;
+    stamps[i].NumberOfConnectivityIds = 0;
+    if (cellArrays[i] != NULL)
+    {
+      stamps[i].MTime = cellArrays[i]->GetMTime();
+      stamps[i].NumberOfConnectivityIds = cellArrays[i]->GetNumberOfConnectivityIds();
+    }
+  }
+}
+
+// ----------------------
+// IsUpToDate
+// ----------------------
+int vtkSVPolyDataAdjacency::IsUpToDate(vtkPolyData *pd) const
+{
+  // Only the polydata's own time, point and cell data do not matter here
+  if (pd->vtkObject::GetMTime() != this->DataMTime ||
+      pd->GetNumberOfPoints() != this->NumberOfPoints ||
+      pd->GetNumberOfCells() != this->NumberOfCells)
+    return 0;
+
+  CellArrayStamp stamps[4];
+  vtkSVPolyDataAdjacency::GetCellArrayStamps(pd, stamps);
+  for (int i=0; i<4; i++)
+  {
+    if (stamps[i].Array != this->Stamps[i].Array ||
+        stamps[i].MTime != this->Stamps[i].MTime ||
+        stamps[i].NumberOfConnectivityIds != this->Stamps[i].NumberOfConnectivityIds)
+      return 0;
+  }
+
+  return 1;
+}
+
+// ----------------------
+// Build
+// ----------------------
+int vtkSVPolyDataAdjacency::Build(vtkPolyData *pd)
+{
+  const vtkIdType numPoints = pd->GetNumberOfPoints();
+  const vtkIdType numCells  = pd->GetNumberOfCells();
+
+  this->NumberOfPoints = numPoints;
+  this->NumberOfCells  = numCells;
+
+  // Cell points, serial as GetCellPoints may use the cell array's scratch
+  // storage
+  this->CellPointOffsets.assign(numCells+1, 0);
+  this->CellPoints.clear();
+  for (vtkIdType i=0; i<numCells; i++)
+  {
+    vtkIdType npts;
+    const vtkIdType *pts;
+    pd->GetCellPoints(i, npts, pts);
+    this->CellPoints.insert(this->CellPoints.end(), pts, pts+npts);
+    this->CellPointOffsets[i+1] = this->CellPoints.size();
+  }
+  const vtkIdType numCellPoints = this->CellPoints.size();
+
+  // Point cells, filled in cell order so each point's cells are sorted
+  this->PointCellOffsets.assign(numPoints+1, 0);
+  for (vtkIdType i=0; i<numCellPoints; i++)
+    this->PointCellOffsets[this->CellPoints[i]+1]++;
+  for (vtkIdType i=0; i<numPoints; i++)
+    this->PointCellOffsets[i+1] += this->PointCellOffsets[i];
+
+  this->PointCells.resize(numCellPoints);
+  std::vector<vtkIdType> fill(this->PointCellOffsets.begin(),
+                              this->PointCellOffsets.end()-1);
+  for (vtkIdType i=0; i<numCells; i++)
+  {
+    for (vtkIdType j=this->CellPointOffsets[i]; j<this->CellPointOffsets[i+1]; j++)
+      this->PointCells[fill[this->CellPoints[j]]++] = i;
+  }
+
+  // Edge neighbors, counted then filled
+  this->EdgeNeighborOffsets.assign(numCellPoints+1, 0);
+
+  vtkSVEdgeNeighborFunctor edgeFunctor;
+  edgeFunctor.CellPointOffsets    = this->CellPointOffsets.data();
+  edgeFunctor.CellPoints          = this->CellPoints.data();
+  edgeFunctor.PointCellOffsets    = this->PointCellOffsets.data();
+  edgeFunctor.PointCells          = this->PointCells.data();
+  edgeFunctor.EdgeNeighborOffsets = this->EdgeNeighborOffsets.data();
+  edgeFunctor.Counts              = this->EdgeNeighborOffsets.data();
+  edgeFunctor.EdgeNeighbors       = NULL;
+  vtkSMPTools::For(0, numCells, edgeFunctor);
+
+  for (vtkIdType i=0; i<numCellPoints; i++)
+    this->EdgeNeighborOffsets[i+1] += this->EdgeNeighborOffsets[i];
+
+  this->EdgeNeighbors.resize(this->EdgeNeighborOffsets[numCellPoints]);
+  edgeFunctor.Counts        = NULL;
+  edgeFunctor.EdgeNeighbors = this->EdgeNeighbors.data();
+  vtkSMPTools::For(0, numCells, edgeFunctor);
+
+  // Stamp after building, getting the cell points can build the cells
+  this->DataMTime = pd->vtkObject::GetMTime();
+  vtkSVPolyDataAdjacency::GetCellArrayStamps(pd, this->Stamps);
+
+  return SV_OK;
+}
+
+// ----------------------
+// GetPointCells
+// ----------------------
+void vtkSVPolyDataAdjacency::GetPointCells(vtkIdType ptId, vtkIdList *cellIds) const
+{
+  vtkIdType ncells;
+  const vtkIdType *cells;
+  this->GetPointCells(ptId, ncells, cells);
+
+  cellIds->SetNumberOfIds(ncells);
+  for (vtkIdType i=0; i<ncells; i++)
+    cellIds->SetId(i, cells[i]);
+}
+
+// ----------------------
+// GetCellEdgeNeighbors
+// ----------------------
+void vtkSVPolyDataAdjacency::GetCellEdgeNeighbors(vtkIdType cellId, vtkIdType ptId0,
+                                                  vtkIdType ptId1, vtkIdList *neighbors) const
+{
+  neighbors->Reset();
+
+  vtkIdType nneis;
+  const vtkIdType *neis;
+
+  // Use stored neighbors if this is an edge of the cell
+  if (cellId >= 0 && cellId < this->NumberOfCells)
+  {
+    vtkIdType npts;
+    const vtkIdType *pts;
+    this->GetCellPoints(cellId, npts, pts);
+    for (vtkIdType j=0; j<npts; j++)
+    {
+      if (pts[j] == ptId0 && pts[(j+1)%npts] == ptId1)
+      {
+        this->GetCellEdgeNeighbors(cellId, j, nneis, neis);
+        for (vtkIdType k=0; k<nneis; k++)
+          neighbors->InsertNextId(neis[k]);
+        return;
+      }
+    }
+  }
+
+  // Otherwise the cells of the first point that contain the second
+  this->GetPointCells(ptId0, nneis, neis);
+  for (vtkIdType k=0; k<nneis; k++)
+  {
+    if (neis[k] == cellId)
+      continue;
+
+    vtkIdType npts;
+    const vtkIdType *pts;
+    this->GetCellPoints(neis[k], npts, pts);
+    for (vtkIdType j=0; j<npts; j++)
+    {
+      if (pts[j] == ptId1)
+      {
+        neighbors->InsertNextId(neis[k]);
+        break;
+      }
+    }
+  }
+}
+
+// ----------------------
+// GetCellDirectNeighbors
+// ----------------------
+void vtkSVPolyDataAdjacency::GetCellDirectNeighbors(std::vector<std::vector<int> > &neighbors,
+                                                    std::vector<int> &numNeighbors) const
+{
+  neighbors.resize(this->NumberOfCells);
+  numNeighbors.resize(this->NumberOfCells);
+
+  vtkSVDirectNeighborFunctor neighborFunctor;
+  neighborFunctor.Adjacency         = this;
+  neighborFunctor.Neighbors         = &neighbors;
+  neighborFunctor.NumberOfNeighbors = &numNeighbors;
+  vtkSMPTools::For(0, this->NumberOfCells, neighborFunctor);
+}
+
+// ----------------------
+// GetCellRingNeighbors
+// ----------------------
+void vtkSVPolyDataAdjacency::GetCellRingNeighbors(int numberOfRings,
+                                                  std::vector<std::vector<int> > &neighbors) const
+{
+  if (numberOfRings < 1 || neighbors.empty())
+    return;
+
+  vtkSVRingNeighborFunctor ringFunctor;
+  ringFunctor.Adjacency     = this;
+  ringFunctor.Neighbors     = &neighbors;
+  ringFunctor.NumberOfRings = numberOfRings;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(neighbors.size()), ringFunctor);
+}
@@ -0,0 +1,181 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  \class  vtkSVPolyDataAdjacency
+ *  \brief Compact point to cell and cell to cell adjacency of a vtkPolyData.
+ *
+ *  All connectivity is stored in compressed (CSR) arrays: the points of each
+ *  cell, the cells using each point in increasing cell order (the same order
+ *  vtkPolyData::BuildLinks gives), and the edge neighbors of every cell edge.
+ *  Edge j of a cell goes from its point j to point j+1.
+ *
+ *  GetAdjacency caches the structure in the information of the polydata so
+ *  that the ring, region and boundary queries of vtkSVGeneralUtils share one
+ *  copy. The cache is rebuilt when the number of points or cells changes,
+ *  when any of the cell arrays is replaced or modified, or when Modified is
+ *  called on the polydata itself. Changes to point or cell data do not
+ *  invalidate it. Call Invalidate after editing cells in place without
+ *  calling Modified.
+ *
+ *  \author Adam Updegrove
+ *  \author updega2@gmail.com
+ *  \author UC Berkeley
+ *  \author shaddenlab.berkeley.edu
+ */
+
+#ifndef vtkSVPolyDataAdjacency_h
+#define vtkSVPolyDataAdjacency_h
+
+#include "vtkObject.h"
+#include "vtkSVCommonModule.h" // For export
+
+#include <vector>
+
+class vtkCellArray;
+class vtkIdList;
+class vtkInformationObjectBaseKey;
+class vtkPolyData;
+
+class VTKSVCOMMON_EXPORT vtkSVPolyDataAdjacency : public vtkObject
+{
+public:
+  static vtkSVPolyDataAdjacency *New();
+  vtkTypeMacro(vtkSVPolyDataAdjacency,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// \brief Get the adjacency of pd, building it if it is not cached yet or
+  /// the topology changed. The returned object is owned by pd. Not thread
+  /// safe, get it before starting any parallel work.
+  static vtkSVPolyDataAdjacency *GetAdjacency(vtkPolyData *pd);
+
+  /// \brief Remove the cached adjacency from pd.
+  static void Invalidate(vtkPolyData *pd);
+
+  /// \brief Key used to store the adjacency in the information of the
+  /// polydata.
+  static vtkInformationObjectBaseKey *ADJACENCY();
+
+  /// \brief Build the adjacency arrays from pd.
+  int Build(vtkPolyData *pd);
+
+  /// \brief Whether the adjacency was built from the current topology of pd.
+  int IsUpToDate(vtkPolyData *pd) const;
+
+  //@{
+  /// \brief Sizes of the mesh the adjacency was built from.
+  vtkIdType GetNumberOfPoints() const {return this->NumberOfPoints;}
+  vtkIdType GetNumberOfCells() const {return this->NumberOfCells;}
+  //@}
+
+  //@{
+  /// \brief Points of a cell.
+  void GetCellPoints(vtkIdType cellId, vtkIdType &npts,
+                     const vtkIdType *&pts) const
+  {
+    npts = this->CellPointOffsets[cellId+1] - this->CellPointOffsets[cellId];
+    pts  = this->CellPoints.data() + this->CellPointOffsets[cellId];
+  }
+  //@}
+
+  //@{
+  /// \brief Cells using a point, in increasing cell order.
+  void GetPointCells(vtkIdType ptId, vtkIdType &ncells,
+                     const vtkIdType *&cells) const
+  {
+    ncells = this->PointCellOffsets[ptId+1] - this->PointCellOffsets[ptId];
+    cells  = this->PointCells.data() + this->PointCellOffsets[ptId];
+  }
+  void GetPointCells(vtkIdType ptId, vtkIdList *cellIds) const;
+  //@}
+
+  /// \brief Neighbors across edge edgeId of a cell, the cell itself excluded.
+  void GetCellEdgeNeighbors(vtkIdType cellId, int edgeId, vtkIdType &nneis,
+                            const vtkIdType *&neis) const
+  {
+    vtkIdType loc = this->CellPointOffsets[cellId] + edgeId;
+    nneis = this->EdgeNeighborOffsets[loc+1] - this->EdgeNeighborOffsets[loc];
+    neis  = this->EdgeNeighbors.data() + this->EdgeNeighborOffsets[loc];
+  }
+
+  /// \brief Same result as vtkPolyData::GetCellEdgeNeighbors. Uses the stored
+  /// edge neighbors when (ptId0, ptId1) is an edge of cellId, otherwise
+  /// intersects the cells of the two points.
+  void GetCellEdgeNeighbors(vtkIdType cellId, vtkIdType ptId0,
+                            vtkIdType ptId1, vtkIdList *neighbors) const;
+
+  /// \brief Get the edge neighbors of every cell, in edge order, computed in
+  /// parallel.
+  void GetCellDirectNeighbors(std::vector<std::vector<int> > &neighbors,
+                              std::vector<int> &numNeighbors) const;
+
+  /// \brief Grow each list of cells in neighbors by numberOfRings rings of
+  /// point connected cells. New cells are appended in the order a repeated
+  /// scan of the list would find them. Lists are expanded in parallel.
+  void GetCellRingNeighbors(int numberOfRings,
+                            std::vector<std::vector<int> > &neighbors) const;
+
+protected:
+  vtkSVPolyDataAdjacency();
+  ~vtkSVPolyDataAdjacency();
+
+  // Topology stamp of one of the cell arrays of the polydata
+  struct CellArrayStamp
+  {
+    vtkCellArray *Array;
+    vtkMTimeType  MTime;
+    vtkIdType     NumberOfConnectivityIds;
+  };
+
+  static void GetCellArrayStamps(vtkPolyData *pd, CellArrayStamp stamps[4]);
+
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+
+  std::vector<vtkIdType> CellPointOffsets;
+  std::vector<vtkIdType> CellPoints;
+
+  std::vector<vtkIdType> PointCellOffsets;
+  std::vector<vtkIdType> PointCells;
+
+  // Indexed like CellPoints, one entry per cell edge
+  std::vector<vtkIdType> EdgeNeighborOffsets;
+  std::vector<vtkIdType> EdgeNeighbors;
+
+  vtkMTimeType   DataMTime;
+  CellArrayStamp Stamps[4];
+
+private:
+  vtkSVPolyDataAdjacency(const vtkSVPolyDataAdjacency&);  // Not implemented.
+  void operator=(const vtkSVPolyDataAdjacency&);  // Not implemented.
+};
+
+#endif  // vtkSVPolyDataAdjacency_h
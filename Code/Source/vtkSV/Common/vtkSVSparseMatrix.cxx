@@ -33,9 +33,92 @@
 
 #include "vtkObjectFactory.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 #include "vtkSVGlobals.h"
 
 #include <algorithm>
+#include <utility>
+
+// ----------------------
+// SpMV functors
+// ----------------------
+namespace
+{
+// Minimum number of rows handed to a single thread
+const vtkIdType SV_SPMV_GRAIN = 1024;
+
+/// \brief y = A x using the CSR arrays
+struct vtkSVCSRMultiplyFunctor
+{
+  const int    *RowPointers;
+  const int    *ColumnIndices;
+  const double *Values;
+  const double *Column;
+  double       *Output;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      double sum = 0.0;
+      for (int j = this->RowPointers[i]; j < this->RowPointers[i+1]; j++)
+        sum += this->Values[j] * this->Column[this->ColumnIndices[j]];
+      this->Output[i] = sum;
+    }
+  }
+};
+
+/// \brief Y = A X using the CSR arrays for interleaved columns
+struct vtkSVCSRMultiplyColumnsFunctor
+{
+  const int    *RowPointers;
+  const int    *ColumnIndices;
+  const double *Values;
+  const double *Columns;
+  int           NumberOfColumns;
+  double       *Output;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const int k = this->NumberOfColumns;
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      double *out = this->Output + i*k;
+      for (int c = 0; c < k; c++)
+        out[c] = 0.0;
+      for (int j = this->RowPointers[i]; j < this->RowPointers[i+1]; j++)
+      {
+        const double value = this->Values[j];
+        const double *in = this->Columns + this->ColumnIndices[j]*k;
+        for (int c = 0; c < k; c++)
+          out[c] += value * in[c];
+      }
+    }
+  }
+};
+
+/// \brief y = A x using the assembly storage
+struct vtkSVRowMultiplyFunctor
+{
+  const std::vector<std::vector<double> > *Data;
+  const std::vector<std::vector<int> >    *Cols;
+  const double *Column;
+  double       *Output;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      const std::vector<double> &rowData = (*this->Data)[i];
+      const std::vector<int>    &rowCols = (*this->Cols)[i];
+      double sum = 0.0;
+      for (size_t j = 0; j < rowCols.size(); j++)
+        sum += rowData[j] * this->Column[rowCols[j]];
+      this->Output[i] = sum;
+    }
+  }
+};
+}
 
 // ----------------------
 // StandardNewMacro
@@ -47,6 +130,7 @@ vtkStandardNewMacro(vtkSVSparseMatrix);
 // ----------------------
 vtkSVSparseMatrix::vtkSVSparseMatrix()
 {
+  this->Compressed      = 0;
   this->NumberOfRows    = 0;
   this->NumberOfColumns = 0;
 }
@@ -67,6 +151,7 @@ void vtkSVSparseMatrix::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Number of rows: " << this->NumberOfRows << "\n";
   os << indent << "Number of columns: " << this->NumberOfColumns << "\n";
+  os << indent << "Compressed: " << this->Compressed << "\n";
 }
 
 // ----------------------
@@ -74,6 +159,7 @@ void vtkSVSparseMatrix::PrintSelf(ostream& os, vtkIndent indent)
 // ----------------------
 void vtkSVSparseMatrix::SetNumberOfRows(int numRows)
 {
+  this->Expand();
   this->NumberOfRows = numRows;
   this->Data.resize(numRows);
   this->Cols.resize(numRows);
@@ -84,6 +170,7 @@ void vtkSVSparseMatrix::SetNumberOfRows(int numRows)
 // ----------------------
 void vtkSVSparseMatrix::SetMatrixSize(int numRows, int numCols)
 {
+  this->Expand();
   this->NumberOfRows    = numRows;
   this->NumberOfColumns = numCols;
   this->Data.resize(numRows);
@@ -95,6 +182,9 @@ void vtkSVSparseMatrix::SetMatrixSize(int numRows, int numCols)
 // ----------------------
 int vtkSVSparseMatrix::GetNumberOfElements() const
 {
+  if (this->Compressed)
+    return this->RowPointers[this->NumberOfRows];
+
   int numEls = 0;
   for (int i = 0; i < this->NumberOfRows; i++)
     numEls += this->Cols[i].size();
@@ -102,17 +192,154 @@ int vtkSVSparseMatrix::GetNumberOfElements() const
   return numEls;
 }
 
+// ----------------------
+// Compress
+// ----------------------
+void vtkSVSparseMatrix::Compress()
+{
+  if (this->Compressed)
+    return;
+
+  this->RowPointers.assign(this->NumberOfRows+1, 0);
+  for (int i = 0; i < this->NumberOfRows; i++)
+    this->RowPointers[i+1] = this->RowPointers[i] + this->Cols[i].size();
+
+  int numEls = this->RowPointers[this->NumberOfRows];
+  this->ColumnIndices.resize(numEls);
+  this->Values.resize(numEls);
+
+  // Sort each row by column so lookups and triangular solves can rely on it
+  std::vector<std::pair<int, double> > row;
+  for (int i = 0; i < this->NumberOfRows; i++)
+  {
+    row.resize(this->Cols[i].size());
+    for (size_t j = 0; j < this->Cols[i].size(); j++)
+      row[j] = std::make_pair(this->Cols[i][j], this->Data[i][j]);
+    std::sort(row.begin(), row.end());
+
+    int start = this->RowPointers[i];
+    for (size_t j = 0; j < row.size(); j++)
+    {
+      this->ColumnIndices[start+j] = row[j].first;
+      this->Values[start+j]        = row[j].second;
+    }
+  }
+
+  // Release the assembly storage
+  std::vector<std::vector<double> >().swap(this->Data);
+  std::vector<std::vector<int> >().swap(this->Cols);
+
+  this->Compressed = 1;
+  this->Modified();
+}
+
+// ----------------------
+// Expand
+// ----------------------
+void vtkSVSparseMatrix::Expand()
+{
+  if (!this->Compressed)
+    return;
+
+  this->Data.resize(this->NumberOfRows);
+  this->Cols.resize(this->NumberOfRows);
+  for (int i = 0; i < this->NumberOfRows; i++)
+  {
+    int start = this->RowPointers[i];
+    int end   = this->RowPointers[i+1];
+    this->Cols[i].assign(this->ColumnIndices.begin() + start,
+                         this->ColumnIndices.begin() + end);
+    this->Data[i].assign(this->Values.begin() + start,
+                         this->Values.begin() + end);
+  }
+
+  std::vector<int>().swap(this->RowPointers);
+  std::vector<int>().swap(this->ColumnIndices);
+  std::vector<double>().swap(this->Values);
+
+  this->Compressed = 0;
+  this->Modified();
+}
+
 // ----------------------
 // MultiplyColumn
 // ----------------------
 void vtkSVSparseMatrix::MultiplyColumn(
     const double *column, double *output) const
 {
+  if (this->Compressed)
+  {
+    vtkSVCSRMultiplyFunctor multiplier;
+    multiplier.RowPointers   = this->RowPointers.data();
+    multiplier.ColumnIndices = this->ColumnIndices.data();
+    multiplier.Values        = this->Values.data();
+    multiplier.Column        = column;
+    multiplier.Output        = output;
+    vtkSMPTools::For(0, this->NumberOfRows, SV_SPMV_GRAIN, multiplier);
+  }
+  else
+  {
+    vtkSVRowMultiplyFunctor multiplier;
+    multiplier.Data   = &this->Data;
+    multiplier.Cols   = &this->Cols;
+    multiplier.Column = column;
+    multiplier.Output = output;
+    vtkSMPTools::For(0, this->NumberOfRows, SV_SPMV_GRAIN, multiplier);
+  }
+}
+
+// ----------------------
+// MultiplyColumns
+// ----------------------
+void vtkSVSparseMatrix::MultiplyColumns(
+    const double *columns, int numColumns, double *output) const
+{
+  if (!this->Compressed)
+  {
+    // Not compressed, multiply one column at a time
+    std::vector<double> column(this->NumberOfColumns);
+    std::vector<double> result(this->NumberOfRows);
+    for (int c = 0; c < numColumns; c++)
+    {
+      for (int i = 0; i < this->NumberOfColumns; i++)
+        column[i] = columns[i*numColumns + c];
+      this->MultiplyColumn(column.data(), result.data());
+      for (int i = 0; i < this->NumberOfRows; i++)
+        output[i*numColumns + c] = result[i];
+    }
+    return;
+  }
+
+  vtkSVCSRMultiplyColumnsFunctor multiplier;
+  multiplier.RowPointers     = this->RowPointers.data();
+  multiplier.ColumnIndices   = this->ColumnIndices.data();
+  multiplier.Values          = this->Values.data();
+  multiplier.Columns         = columns;
+  multiplier.NumberOfColumns = numColumns;
+  multiplier.Output          = output;
+  vtkSMPTools::For(0, this->NumberOfRows, SV_SPMV_GRAIN, multiplier);
+}
+
+// ----------------------
+// MultiplyTransposeColumn
+// ----------------------
+void vtkSVSparseMatrix::MultiplyTransposeColumn(
+    const double *column, double *output) const
+{
+  std::fill(output, output + this->NumberOfColumns, 0.0);
+
   for (int i = 0; i < this->NumberOfRows; i++)
   {
-    output[i] = 0.0;
-    for (int j = 0; j < this->Cols[i].size(); j++)
-      output[i] += this->Data[i][j] * column[this->Cols[i][j]];
+    if (this->Compressed)
+    {
+      for (int j = this->RowPointers[i]; j < this->RowPointers[i+1]; j++)
+        output[this->ColumnIndices[j]] += this->Values[j] * column[i];
+    }
+    else
+    {
+      for (size_t j = 0; j < this->Cols[i].size(); j++)
+        output[this->Cols[i][j]] += this->Data[i][j] * column[i];
+    }
   }
 }
 
@@ -121,6 +348,8 @@ void vtkSVSparseMatrix::MultiplyColumn(
 // ----------------------
 void vtkSVSparseMatrix::SetElement(int row, int col, double value)
 {
+  this->Expand();
+
   if (value == 0.0) {
     for (int j = 0; j < this->Cols[row].size(); j++)
     {
@@ -153,6 +382,16 @@ void vtkSVSparseMatrix::SetElement(int row, int col, double value)
 // ----------------------
 double vtkSVSparseMatrix::GetElement(int row, int col) const
 {
+  if (this->Compressed)
+  {
+    const int *rowStart = this->ColumnIndices.data() + this->RowPointers[row];
+    const int *rowEnd   = this->ColumnIndices.data() + this->RowPointers[row+1];
+    const int *loc = std::lower_bound(rowStart, rowEnd, col);
+    if (loc != rowEnd && *loc == col)
+      return this->Values[loc - this->ColumnIndices.data()];
+    return 0.0;
+  }
+
   for (int j = 0; j < this->Cols[row].size(); j++)
   {
     if (this->Cols[row][j] == col)
@@ -161,17 +400,57 @@ double vtkSVSparseMatrix::GetElement(int row, int col) const
   return 0.0;
 }
 
+// ----------------------
+// GetDiagonal
+// ----------------------
+void vtkSVSparseMatrix::GetDiagonal(double *diagonal) const
+{
+  int numDiag = svminimum(this->NumberOfRows, this->NumberOfColumns);
+  for (int i = 0; i < numDiag; i++)
+    diagonal[i] = this->GetElement(i, i);
+}
+
 // ----------------------
 // Transpose
 // ----------------------
+/**
+ * \details Counting transpose directly into CSR storage, linear in the
+ * number of non-zeros.
+ */
 int vtkSVSparseMatrix::Transpose(vtkSVSparseMatrix *transpose)
 {
+  this->Compress();
+
   transpose->SetMatrixSize(this->NumberOfColumns, this->NumberOfRows);
 
+  std::vector<int> rowPointers(this->NumberOfColumns+1, 0);
+  for (size_t j = 0; j < this->ColumnIndices.size(); j++)
+    rowPointers[this->ColumnIndices[j]+1]++;
+  for (int i = 0; i < this->NumberOfColumns; i++)
+    rowPointers[i+1] += rowPointers[i];
+
+  // Rows of this matrix are visited in order, so the columns of the
+  // transpose come out sorted
+  std::vector<int>    columnIndices(this->ColumnIndices.size());
+  std::vector<double> values(this->Values.size());
+  std::vector<int>    next(rowPointers.begin(), rowPointers.end() - 1);
   for (int i = 0; i < this->NumberOfRows; i++)
   {
-    for (int j = 0; j < this->Cols[i].size(); j++)
-      transpose->SetElement(this->Cols[i][j], i, this->Data[i][j]);
+    for (int j = this->RowPointers[i]; j < this->RowPointers[i+1]; j++)
+    {
+      int loc = next[this->ColumnIndices[j]]++;
+      columnIndices[loc] = i;
+      values[loc]        = this->Values[j];
+    }
   }
+
+  std::vector<std::vector<double> >().swap(transpose->Data);
+  std::vector<std::vector<int> >().swap(transpose->Cols);
+  transpose->RowPointers.swap(rowPointers);
+  transpose->ColumnIndices.swap(columnIndices);
+  transpose->Values.swap(values);
+  transpose->Compressed = 1;
+  transpose->Modified();
+
   return SV_OK;
 }
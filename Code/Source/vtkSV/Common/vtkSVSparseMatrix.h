@@ -31,7 +31,14 @@
 
 /**
  *  \class  vtkSVSparseMatrix
- *  \brief This is class of useful functions for reading and writing vtk files.
+ *  \brief This is a sparse matrix class used for the linear systems assembled
+ *  by the parameterization and smoothing filters.
+ *
+ *  The matrix is assembled row by row with SetElement. Once assembly is
+ *  finished, Compress converts the matrix to compressed sparse row (CSR)
+ *  storage, which is what the multiplication routines and
+ *  vtkSVSparseSolver work on. Calling SetElement on a compressed matrix
+ *  moves it back to the assembly storage.
  *
  *  \author Adam Updegrove
  *  \author updega2@gmail.com
@@ -69,30 +76,74 @@ public:
   /// \brief Set the matrix rows and columns
   void SetMatrixSize(int numRows, int numCols);
 
-  /// \brief Multiply a column by the matrix
+  /// \brief Multiply a column by the matrix. Rows are processed in parallel.
   ///  \param the column vector to multiply
   ///  \param output the result, must be properly allocated
   void MultiplyColumn(const double *column, double *output) const;
 
+  /// \brief Multiply several columns by the matrix in one pass over the
+  /// non-zeros. Columns are interleaved, entry i of column k is at
+  /// i*numColumns + k for both input and output.
+  ///  \param columns the interleaved column vectors to multiply
+  ///  \param numColumns the number of columns
+  ///  \param output the interleaved result, must be properly allocated
+  void MultiplyColumns(const double *columns, int numColumns,
+                       double *output) const;
+
+  /// \brief Multiply a column by the transpose of the matrix without forming
+  /// the transpose.
+  ///  \param the column vector to multiply, size of number of rows
+  ///  \param output the result, size of number of columns
+  void MultiplyTransposeColumn(const double *column, double *output) const;
+
   /// \brief Set an element of the matrix
   void SetElement(int row, int col, double value);
 
   /// \brief Get an element of the matrix
   double GetElement(int row, int col) const;
 
-  /// \brief Transpose the matrix
+  /// \brief Get the diagonal of the matrix
+  /// \param diagonal, must be allocated to the smaller of rows and columns
+  void GetDiagonal(double *diagonal) const;
+
+  /// \brief Transpose the matrix, the transpose is returned compressed
   /// \param transpose, the transposed matrix
   int Transpose(vtkSVSparseMatrix *transpose);
 
   /// \brief Get the total number of non-zero elements in the matrix
   int GetNumberOfElements() const;
 
+  /// \brief Convert the assembled rows into CSR storage with sorted column
+  /// indices. Must be called once assembly is complete.
+  void Compress();
+
+  /// \brief Whether the matrix is currently stored in CSR format
+  int IsCompressed() const {return this->Compressed;}
+
+  //@{
+  /// \brief Direct access to the CSR arrays, only valid when compressed.
+  const int    *GetRowPointers() const {return this->RowPointers.data();}
+  const int    *GetColumnIndices() const {return this->ColumnIndices.data();}
+  const double *GetValues() const {return this->Values.data();}
+  //@}
+
 protected:
   vtkSVSparseMatrix();
   ~vtkSVSparseMatrix();
 
+  // Move CSR storage back into the per row assembly storage
+  void Expand();
+
+  // Assembly storage
   std::vector<std::vector<double> > Data;
   std::vector<std::vector<int> >    Cols;
+
+  // CSR storage
+  std::vector<int>    RowPointers;
+  std::vector<int>    ColumnIndices;
+  std::vector<double> Values;
+
+  int Compressed;
   int NumberOfRows;
   int NumberOfColumns;
 
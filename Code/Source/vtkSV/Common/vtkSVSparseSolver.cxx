@@ -0,0 +1,649 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vtkSVSparseSolver.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
+#include "vtkSVGlobals.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ----------------------
+// Vector kernels
+// ----------------------
+// All vectors hold NumberOfColumns interleaved columns, entry i of column c
+// is at i*NumberOfColumns + c.
+namespace
+{
+// Fixed block size for reductions; the partial sums are always combined in
+// the same order so the result does not depend on the number of threads.
+const vtkIdType SV_REDUCTION_BLOCK = 4096;
+
+/// \brief Partial column inner products over fixed blocks of rows
+struct vtkSVBlockDotFunctor
+{
+  const double *A;
+  const double *B;
+  vtkIdType     Size;
+  int           NumberOfColumns;
+  double       *Partials;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const int k = this->NumberOfColumns;
+    for (vtkIdType block = begin; block < end; block++)
+    {
+      vtkIdType first = block * SV_REDUCTION_BLOCK;
+      vtkIdType last  = svminimum(first + SV_REDUCTION_BLOCK, this->Size);
+      double *sum = this->Partials + block*k;
+      for (int c = 0; c < k; c++)
+        sum[c] = 0.0;
+      for (vtkIdType i = first*k; i < last*k; i += k)
+      {
+        for (int c = 0; c < k; c++)
+          sum[c] += this->A[i+c] * this->B[i+c];
+      }
+    }
+  }
+};
+
+/// \brief c = a + beta * b with one beta per column
+struct vtkSVAxpyFunctor
+{
+  const double *A;
+  const double *B;
+  const double *Beta;
+  int           NumberOfColumns;
+  double       *C;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const int k = this->NumberOfColumns;
+    for (vtkIdType i = begin*k; i < end*k; i += k)
+    {
+      for (int c = 0; c < k; c++)
+        this->C[i+c] = this->A[i+c] + this->Beta[c] * this->B[i+c];
+    }
+  }
+};
+
+/// \brief c = a * d, with one d value per row
+struct vtkSVScaleFunctor
+{
+  const double *A;
+  const double *D;
+  int           NumberOfColumns;
+  double       *C;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const int k = this->NumberOfColumns;
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      for (int c = 0; c < k; c++)
+        this->C[i*k+c] = this->A[i*k+c] * this->D[i];
+    }
+  }
+};
+
+void vtkSVParallelDot(const double *a, const double *b, vtkIdType size,
+                      int numCols, std::vector<double> &partials,
+                      double *product)
+{
+  vtkIdType numBlocks = (size + SV_REDUCTION_BLOCK - 1) / SV_REDUCTION_BLOCK;
+  partials.resize(numBlocks*numCols);
+
+  vtkSVBlockDotFunctor dotter;
+  dotter.A               = a;
+  dotter.B               = b;
+  dotter.Size            = size;
+  dotter.NumberOfColumns = numCols;
+  dotter.Partials        = partials.data();
+  vtkSMPTools::For(0, numBlocks, 1, dotter);
+
+  for (int c = 0; c < numCols; c++)
+    product[c] = 0.0;
+  for (vtkIdType i = 0; i < numBlocks; i++)
+  {
+    for (int c = 0; c < numCols; c++)
+      product[c] += partials[i*numCols+c];
+  }
+}
+
+void vtkSVParallelAxpy(const double *a, const double *b, const double *beta,
+                       vtkIdType size, int numCols, double *c)
+{
+  vtkSVAxpyFunctor adder;
+  adder.A               = a;
+  adder.B               = b;
+  adder.Beta            = beta;
+  adder.NumberOfColumns = numCols;
+  adder.C               = c;
+  vtkSMPTools::For(0, size, SV_REDUCTION_BLOCK, adder);
+}
+
+void vtkSVParallelScale(const double *a, const double *d,
+                        vtkIdType size, int numCols, double *c)
+{
+  vtkSVScaleFunctor scaler;
+  scaler.A               = a;
+  scaler.D               = d;
+  scaler.NumberOfColumns = numCols;
+  scaler.C               = c;
+  vtkSMPTools::For(0, size, SV_REDUCTION_BLOCK, scaler);
+}
+}
+
+// ----------------------
+// StandardNewMacro
+// ----------------------
+vtkStandardNewMacro(vtkSVSparseSolver);
+
+// ----------------------
+// Constructor
+// ----------------------
+vtkSVSparseSolver::vtkSVSparseSolver()
+{
+  this->Matrix    = nullptr;
+  this->Transpose = nullptr;
+
+  this->SolverType                = NORMAL_EQUATIONS;
+  this->Preconditioner            = PRECONDITIONER_JACOBI;
+  this->ActivePreconditioner      = PRECONDITIONER_NONE;
+  this->MaximumNumberOfIterations = 1000;
+  this->Tolerance                 = 1.0e-8;
+
+  this->NumberOfIterations = 0;
+  this->ResidualNorm       = 0.0;
+  this->Breakdown          = 0;
+
+  this->SystemSize     = 0;
+  this->InitializeTime = 0;
+}
+
+// ----------------------
+// Destructor
+// ----------------------
+vtkSVSparseSolver::~vtkSVSparseSolver()
+{
+  if (this->Matrix != nullptr)
+  {
+    this->Matrix->UnRegister(this);
+    this->Matrix = nullptr;
+  }
+  if (this->Transpose != nullptr)
+  {
+    this->Transpose->Delete();
+    this->Transpose = nullptr;
+  }
+}
+
+// ----------------------
+// PrintSelf
+// ----------------------
+void vtkSVSparseSolver::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Solver type: " << this->SolverType << "\n";
+  os << indent << "Preconditioner: " << this->Preconditioner << "\n";
+  os << indent << "Active preconditioner: " << this->ActivePreconditioner << "\n";
+  os << indent << "Maximum number of iterations: " << this->MaximumNumberOfIterations << "\n";
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "Number of iterations: " << this->NumberOfIterations << "\n";
+  os << indent << "Residual norm: " << this->ResidualNorm << "\n";
+}
+
+// ----------------------
+// SetMatrix
+// ----------------------
+void vtkSVSparseSolver::SetMatrix(vtkSVSparseMatrix *matrix)
+{
+  if (this->Matrix == matrix)
+    return;
+
+  if (this->Matrix != nullptr)
+    this->Matrix->UnRegister(this);
+  this->Matrix = matrix;
+  if (this->Matrix != nullptr)
+    this->Matrix->Register(this);
+
+  this->InitializeTime = 0;
+  this->Modified();
+}
+
+// ----------------------
+// Initialize
+// ----------------------
+int vtkSVSparseSolver::Initialize()
+{
+  if (this->Matrix == nullptr)
+  {
+    vtkErrorMacro("No matrix given to solver");
+    return SV_ERROR;
+  }
+
+  this->Matrix->Compress();
+
+  int numRows = this->Matrix->GetNumberOfRows();
+  int numCols = this->Matrix->GetNumberOfColumns();
+
+  if (this->SolverType == SYMMETRIC)
+  {
+    if (numRows != numCols)
+    {
+      vtkErrorMacro("Symmetric solve requires a square matrix, matrix is " << numRows << " x " << numCols);
+      return SV_ERROR;
+    }
+    if (this->Transpose != nullptr)
+    {
+      this->Transpose->Delete();
+      this->Transpose = nullptr;
+    }
+  }
+  else
+  {
+    // Cached transpose so that A' products are parallel row products too
+    if (this->Transpose == nullptr)
+      this->Transpose = vtkSVSparseMatrix::New();
+    this->Matrix->Transpose(this->Transpose);
+  }
+
+  this->SystemSize = numCols;
+
+  std::vector<double>().swap(this->InverseDiagonal);
+  std::vector<int>().swap(this->LowerRowPointers);
+  std::vector<int>().swap(this->LowerColumnIndices);
+  std::vector<double>().swap(this->LowerValues);
+
+  this->ActivePreconditioner = PRECONDITIONER_NONE;
+  if (this->Preconditioner == PRECONDITIONER_IC0 &&
+      this->SolverType == SYMMETRIC)
+  {
+    if (this->BuildIC0() == SV_OK)
+      this->ActivePreconditioner = PRECONDITIONER_IC0;
+    else
+    {
+      vtkDebugMacro("IC(0) factorization broke down, using Jacobi");
+      std::vector<int>().swap(this->LowerRowPointers);
+      std::vector<int>().swap(this->LowerColumnIndices);
+      std::vector<double>().swap(this->LowerValues);
+    }
+  }
+
+  if (this->Preconditioner != PRECONDITIONER_NONE &&
+      this->ActivePreconditioner == PRECONDITIONER_NONE)
+  {
+    if (this->BuildJacobi() == SV_OK)
+      this->ActivePreconditioner = PRECONDITIONER_JACOBI;
+  }
+
+  this->InitializeTime = this->Matrix->GetMTime();
+
+  return SV_OK;
+}
+
+// ----------------------
+// BuildJacobi
+// ----------------------
+int vtkSVSparseSolver::BuildJacobi()
+{
+  const int    *rowPtrs = this->Matrix->GetRowPointers();
+  const int    *cols    = this->Matrix->GetColumnIndices();
+  const double *vals    = this->Matrix->GetValues();
+  int numRows = this->Matrix->GetNumberOfRows();
+
+  this->InverseDiagonal.assign(this->SystemSize, 0.0);
+
+  if (this->SolverType == SYMMETRIC)
+    this->Matrix->GetDiagonal(this->InverseDiagonal.data());
+  else
+  {
+    // Diagonal of A'A is the squared norm of each column of A
+    for (int i = 0; i < numRows; i++)
+    {
+      for (int j = rowPtrs[i]; j < rowPtrs[i+1]; j++)
+        this->InverseDiagonal[cols[j]] += vals[j] * vals[j];
+    }
+  }
+
+  for (int i = 0; i < this->SystemSize; i++)
+  {
+    if (fabs(this->InverseDiagonal[i]) > VTK_SV_DOUBLE_TOL)
+      this->InverseDiagonal[i] = 1.0 / this->InverseDiagonal[i];
+    else
+      this->InverseDiagonal[i] = 1.0;
+  }
+
+  return SV_OK;
+}
+
+// ----------------------
+// BuildIC0
+// ----------------------
+/**
+ * \details Incomplete Cholesky factorization with the sparsity of the lower
+ * triangle of A. The rows of L are stored in CSR format with the diagonal
+ * as the last entry of each row.
+ */
+int vtkSVSparseSolver::BuildIC0()
+{
+  const int    *rowPtrs = this->Matrix->GetRowPointers();
+  const int    *cols    = this->Matrix->GetColumnIndices();
+  const double *vals    = this->Matrix->GetValues();
+  int n = this->SystemSize;
+
+  // Copy the lower triangle
+  this->LowerRowPointers.assign(n+1, 0);
+  this->LowerColumnIndices.clear();
+  this->LowerValues.clear();
+  for (int i = 0; i < n; i++)
+  {
+    int hasDiagonal = 0;
+    for (int j = rowPtrs[i]; j < rowPtrs[i+1] && cols[j] <= i; j++)
+    {
+      this->LowerColumnIndices.push_back(cols[j]);
+      this->LowerValues.push_back(vals[j]);
+      if (cols[j] == i)
+        hasDiagonal = 1;
+    }
+    if (!hasDiagonal)
+      return SV_ERROR;
+    this->LowerRowPointers[i+1] = this->LowerColumnIndices.size();
+  }
+
+  const int *lRowPtrs = this->LowerRowPointers.data();
+  const int *lCols    = this->LowerColumnIndices.data();
+  double    *lVals    = this->LowerValues.data();
+
+  for (int i = 0; i < n; i++)
+  {
+    int rowStart = lRowPtrs[i];
+    int diagLoc  = lRowPtrs[i+1] - 1;
+
+    for (int j = rowStart; j < diagLoc; j++)
+    {
+      int k = lCols[j];
+
+      // Sparse dot of the already computed part of row i with row k
+      double sum = 0.0;
+      int a = rowStart;
+      int b = lRowPtrs[k];
+      int bEnd = lRowPtrs[k+1] - 1;
+      while (a < j && b < bEnd)
+      {
+        if (lCols[a] == lCols[b])
+          sum += lVals[a++] * lVals[b++];
+        else if (lCols[a] < lCols[b])
+          a++;
+        else
+          b++;
+      }
+
+      lVals[j] = (lVals[j] - sum) / lVals[lRowPtrs[k+1] - 1];
+    }
+
+    double diag = lVals[diagLoc];
+    for (int j = rowStart; j < diagLoc; j++)
+      diag -= lVals[j] * lVals[j];
+
+    if (diag <= VTK_SV_DOUBLE_TOL)
+      return SV_ERROR;
+    lVals[diagLoc] = sqrt(diag);
+  }
+
+  return SV_OK;
+}
+
+// ----------------------
+// ApplyOperator
+// ----------------------
+void vtkSVSparseSolver::ApplyOperator(const double *x, double *y, int numRhs)
+{
+  if (this->SolverType == SYMMETRIC)
+    this->Matrix->MultiplyColumns(x, numRhs, y);
+  else
+  {
+    this->Matrix->MultiplyColumns(x, numRhs, this->Temp.data());
+    this->Transpose->MultiplyColumns(this->Temp.data(), numRhs, y);
+  }
+}
+
+// ----------------------
+// ApplyPreconditioner
+// ----------------------
+void vtkSVSparseSolver::ApplyPreconditioner(const double *r, double *z,
+                                            int numRhs)
+{
+  int n = this->SystemSize;
+  if (this->ActivePreconditioner == PRECONDITIONER_JACOBI)
+    vtkSVParallelScale(r, this->InverseDiagonal.data(), n, numRhs, z);
+  else if (this->ActivePreconditioner == PRECONDITIONER_IC0)
+  {
+    const int    *lRowPtrs = this->LowerRowPointers.data();
+    const int    *lCols    = this->LowerColumnIndices.data();
+    const double *lVals    = this->LowerValues.data();
+
+    // Forward solve L y = r
+    for (int i = 0; i < n; i++)
+    {
+      double *zi = z + i*numRhs;
+      int diagLoc = lRowPtrs[i+1] - 1;
+      for (int c = 0; c < numRhs; c++)
+        zi[c] = r[i*numRhs+c];
+      for (int j = lRowPtrs[i]; j < diagLoc; j++)
+      {
+        const double *zj = z + lCols[j]*numRhs;
+        for (int c = 0; c < numRhs; c++)
+          zi[c] -= lVals[j] * zj[c];
+      }
+      for (int c = 0; c < numRhs; c++)
+        zi[c] /= lVals[diagLoc];
+    }
+
+    // Backward solve L' z = y, column oriented on the rows of L
+    for (int i = n-1; i >= 0; i--)
+    {
+      double *zi = z + i*numRhs;
+      int diagLoc = lRowPtrs[i+1] - 1;
+      for (int c = 0; c < numRhs; c++)
+        zi[c] /= lVals[diagLoc];
+      for (int j = lRowPtrs[i]; j < diagLoc; j++)
+      {
+        double *zj = z + lCols[j]*numRhs;
+        for (int c = 0; c < numRhs; c++)
+          zj[c] -= lVals[j] * zi[c];
+      }
+    }
+  }
+  else
+    std::copy(r, r + n*numRhs, z);
+}
+
+// ----------------------
+// Solve
+// ----------------------
+int vtkSVSparseSolver::Solve(const double *b, double *x)
+{
+  return this->Solve(b, x, 1);
+}
+
+// ----------------------
+// Solve
+// ----------------------
+/**
+ * \details Each right hand side runs its own conjugate gradient recurrence,
+ * but all of them share every pass over the matrix. Right hand sides that
+ * have converged are frozen by zeroing their step lengths.
+ */
+int vtkSVSparseSolver::Solve(const double *b, double *x, int numRhs)
+{
+  if (this->Matrix == nullptr)
+  {
+    vtkErrorMacro("No matrix given to solver");
+    return SV_ERROR;
+  }
+  if (numRhs < 1)
+  {
+    vtkErrorMacro("Number of right hand sides must be at least one");
+    return SV_ERROR;
+  }
+
+  if (!this->Matrix->IsCompressed() ||
+      this->Matrix->GetMTime() != this->InitializeTime)
+  {
+    if (this->Initialize() != SV_OK)
+      return SV_ERROR;
+  }
+
+  int n = this->SystemSize;
+  int numVals = n*numRhs;
+  this->Rhs.resize(numVals);
+  this->Residual.resize(numVals);
+  this->Direction.resize(numVals);
+  this->Preconditioned.resize(numVals);
+  this->Product.resize(numVals);
+  this->Temp.resize(this->Matrix->GetNumberOfRows()*numRhs);
+
+  double *rhs = this->Rhs.data();
+  double *r   = this->Residual.data();
+  double *p   = this->Direction.data();
+  double *z   = this->Preconditioned.data();
+  double *q   = this->Product.data();
+  std::vector<double> partials;
+
+  // Per right hand side scalars
+  std::vector<double> rr(numRhs), rz(numRhs), rzNew(numRhs), pq(numRhs);
+  std::vector<double> alpha(numRhs), beta(numRhs);
+  std::vector<int> active(numRhs, 1);
+  int numActive = numRhs;
+
+  this->NumberOfIterations = 0;
+  this->Breakdown          = 0;
+
+  // rhs = b or A'b
+  if (this->SolverType == SYMMETRIC)
+    std::copy(b, b + numVals, rhs);
+  else
+    this->Transpose->MultiplyColumns(b, numRhs, rhs);
+
+  // r = rhs - Op x
+  this->ApplyOperator(x, q, numRhs);
+  std::fill(beta.begin(), beta.end(), -1.0);
+  vtkSVParallelAxpy(rhs, q, beta.data(), n, numRhs, r);
+
+  vtkSVParallelDot(r, r, n, numRhs, partials, rr.data());
+  this->ResidualNorm = 0.0;
+  for (int c = 0; c < numRhs; c++)
+  {
+    this->ResidualNorm = svmaximum(this->ResidualNorm, sqrt(rr[c]));
+    if (sqrt(rr[c]) < this->Tolerance)
+    {
+      active[c] = 0;
+      numActive--;
+    }
+  }
+  if (numActive == 0)
+    return SV_OK;
+
+  // p = z = M^-1 r
+  this->ApplyPreconditioner(r, z, numRhs);
+  std::copy(z, z + numVals, p);
+  vtkSVParallelDot(r, z, n, numRhs, partials, rz.data());
+
+  for (int iter = 0; iter < this->MaximumNumberOfIterations && iter < n; iter++)
+  {
+    // q = Op p
+    this->ApplyOperator(p, q, numRhs);
+
+    vtkSVParallelDot(p, q, n, numRhs, partials, pq.data());
+    for (int c = 0; c < numRhs; c++)
+    {
+      alpha[c] = 0.0;
+      if (!active[c])
+        continue;
+      if (pq[c] <= 0.0 || rz[c] <= 0.0)
+      {
+        this->Breakdown = 1;
+        active[c] = 0;
+        numActive--;
+        continue;
+      }
+      alpha[c] = rz[c] / pq[c];
+    }
+    if (numActive == 0)
+      break;
+
+    // x = x + alpha * p
+    vtkSVParallelAxpy(x, p, alpha.data(), n, numRhs, x);
+
+    // r = r - alpha * q
+    for (int c = 0; c < numRhs; c++)
+      beta[c] = -alpha[c];
+    vtkSVParallelAxpy(r, q, beta.data(), n, numRhs, r);
+    this->NumberOfIterations = iter + 1;
+
+    vtkSVParallelDot(r, r, n, numRhs, partials, rr.data());
+    this->ResidualNorm = 0.0;
+    for (int c = 0; c < numRhs; c++)
+    {
+      this->ResidualNorm = svmaximum(this->ResidualNorm, sqrt(rr[c]));
+      if (active[c] && sqrt(rr[c]) < this->Tolerance)
+      {
+        active[c] = 0;
+        numActive--;
+      }
+    }
+    if (numActive == 0)
+      break;
+
+    // p = z + (rz_new / rz) * p
+    this->ApplyPreconditioner(r, z, numRhs);
+    vtkSVParallelDot(r, z, n, numRhs, partials, rzNew.data());
+    for (int c = 0; c < numRhs; c++)
+    {
+      beta[c] = active[c] ? rzNew[c] / rz[c] : 0.0;
+      rz[c]   = rzNew[c];
+    }
+    vtkSVParallelAxpy(z, p, beta.data(), n, numRhs, p);
+  }
+
+  if (this->Breakdown)
+  {
+    vtkDebugMacro("Conjugate gradient broke down after " << this->NumberOfIterations << " iterations, system is not positive definite");
+    return SV_ERROR;
+  }
+
+  return SV_OK;
+}
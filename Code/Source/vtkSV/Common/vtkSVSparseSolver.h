@@ -0,0 +1,200 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  \class  vtkSVSparseSolver
+ *  \brief Preconditioned conjugate gradient solver for vtkSVSparseMatrix.
+ *
+ *  The solver keeps its work vectors, the cached transpose and the
+ *  preconditioner between calls to Solve, so repeated solves with the same
+ *  matrix only pay for the iterations. Two systems are supported. With
+ *  SYMMETRIC the matrix must be symmetric positive definite and A x = b is
+ *  solved directly; Jacobi and incomplete Cholesky (IC(0))
+ *  preconditioning are available. With NORMAL_EQUATIONS, A'A x = A'b is
+ *  solved for any (possibly rectangular) matrix without forming A'A and
+ *  Jacobi preconditioning uses the diagonal of A'A. Several right hand
+ *  sides can be solved together from interleaved storage. Matrix vector
+ *  products and vector updates run in parallel through vtkSMPTools, and
+ *  inner products are reduced in a fixed order so results do not depend on
+ *  the number of threads.
+ *
+ *  \author Adam Updegrove
+ *  \author updega2@gmail.com
+ *  \author UC Berkeley
+ *  \author shaddenlab.berkeley.edu
+ */
+
+#ifndef vtkSVSparseSolver_h
+#define vtkSVSparseSolver_h
+
+#include "vtkObject.h"
+#include "vtkSVCommonModule.h" // For export
+
+#include "vtkSVSparseMatrix.h"
+
+#include <vector>
+
+class VTKSVCOMMON_EXPORT vtkSVSparseSolver : public vtkObject
+{
+public:
+  static vtkSVSparseSolver *New();
+  vtkTypeMacro(vtkSVSparseSolver,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// \brief System that is solved
+  enum SV_SPARSE_SOLVER_TYPE
+  {
+    NORMAL_EQUATIONS = 0,
+    SYMMETRIC
+  };
+
+  /// \brief Preconditioner applied to the conjugate gradient iterations
+  enum SV_SPARSE_PRECONDITIONER_TYPE
+  {
+    PRECONDITIONER_NONE = 0,
+    PRECONDITIONER_JACOBI,
+    PRECONDITIONER_IC0
+  };
+
+  //@{
+  /// \brief Get/Set the matrix, it is compressed during Initialize
+  vtkGetObjectMacro(Matrix, vtkSVSparseMatrix);
+  void SetMatrix(vtkSVSparseMatrix *matrix);
+  //@}
+
+  //@{
+  /// \brief Get/Set the system type, NORMAL_EQUATIONS or SYMMETRIC
+  vtkGetMacro(SolverType, int);
+  vtkSetMacro(SolverType, int);
+  //@}
+
+  //@{
+  /// \brief Get/Set the requested preconditioner. IC0 is only used with
+  /// SYMMETRIC; if the factorization breaks down Jacobi is used instead.
+  vtkGetMacro(Preconditioner, int);
+  vtkSetMacro(Preconditioner, int);
+  //@}
+
+  //@{
+  /// \brief Get/Set the maximum number of iterations. The iterations are
+  /// also never more than the size of the system.
+  vtkGetMacro(MaximumNumberOfIterations, int);
+  vtkSetMacro(MaximumNumberOfIterations, int);
+  //@}
+
+  //@{
+  /// \brief Get/Set the tolerance on the norm of the residual
+  vtkGetMacro(Tolerance, double);
+  vtkSetMacro(Tolerance, double);
+  //@}
+
+  //@{
+  /// \brief Information about the last solve
+  vtkGetMacro(NumberOfIterations, int);
+  vtkGetMacro(ResidualNorm, double);
+  vtkGetMacro(ActivePreconditioner, int);
+  //@}
+
+  /// \brief Whether the last solve stopped because the system was found to
+  /// not be positive definite.
+  vtkGetMacro(Breakdown, int);
+
+  /// \brief Compress the matrix and build the transpose and preconditioner.
+  /// Called automatically by Solve when the matrix has changed.
+  int Initialize();
+
+  /** \brief Solve the system.
+   *  \param b Right hand side, size of the number of rows of the matrix.
+   *  \param x Initial guess on input and solution on output, size of the
+   *  number of columns of the matrix.
+   *  \return SV_OK if solved, SV_ERROR if the solver could not be set up or
+   *  broke down. */
+  int Solve(const double *b, double *x);
+
+  /** \brief Solve the system for several right hand sides at once. The
+   *  preconditioner and every matrix product are shared between them.
+   *  \param b Interleaved right hand sides, value i of right hand side k is
+   *  at b[i*numRhs + k].
+   *  \param x Interleaved initial guesses and solutions, same layout as b.
+   *  \param numRhs Number of right hand sides.
+   *  \return SV_OK if all were solved, SV_ERROR if the solver could not be
+   *  set up or broke down on any of them. */
+  int Solve(const double *b, double *x, int numRhs);
+
+protected:
+  vtkSVSparseSolver();
+  ~vtkSVSparseSolver();
+
+  // Operator of the system, y = A x or y = A'A x
+  void ApplyOperator(const double *x, double *y, int numRhs);
+
+  // z = M^-1 r
+  void ApplyPreconditioner(const double *r, double *z, int numRhs);
+
+  int BuildJacobi();
+  int BuildIC0();
+
+  vtkSVSparseMatrix *Matrix;
+  vtkSVSparseMatrix *Transpose;
+
+  int SolverType;
+  int Preconditioner;
+  int ActivePreconditioner;
+  int MaximumNumberOfIterations;
+  double Tolerance;
+
+  int NumberOfIterations;
+  double ResidualNorm;
+  int Breakdown;
+
+  int SystemSize;
+  vtkMTimeType InitializeTime;
+
+  // Preconditioner storage
+  std::vector<double> InverseDiagonal;
+  std::vector<int>    LowerRowPointers;
+  std::vector<int>    LowerColumnIndices;
+  std::vector<double> LowerValues;
+
+  // Work vectors
+  std::vector<double> Rhs;
+  std::vector<double> Residual;
+  std::vector<double> Direction;
+  std::vector<double> Preconditioned;
+  std::vector<double> Product;
+  std::vector<double> Temp;
+
+private:
+  vtkSVSparseSolver(const vtkSVSparseSolver&);  // Not implemented.
+  void operator=(const vtkSVSparseSolver&);  // Not implemented.
+};
+
+#endif  // vtkSVSparseSolver_h
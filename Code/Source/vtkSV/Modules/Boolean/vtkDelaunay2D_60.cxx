@@ -160,9 +160,11 @@ vtkIdType vtkDelaunay2D_60::FindTriangle(double x[3], vtkIdType ptIds[3],
     }
 
   // Randomization (of find edge neighbora) avoids walking in
-  // circles in certain weird cases
-  srand(tri);
-  ir = rand() % 3;
+  // circles in certain weird cases. The start edge is hashed from the
+  // triangle id rather than drawn from the global rand() so the walk is
+  // the same when several triangulations run at once
+  ir = static_cast<int>(((static_cast<unsigned long long>(tri) + 1) *
+                         0x9E3779B97F4A7C15ULL) >> 33) % 3;
   // evaluate in/out of each edge
   for (inside=1, minProj=0.0, ic=0; ic<3; ic++)
     {
@@ -878,6 +878,7 @@ vtkSVLoopBooleanPolyDataFilter::vtkSVLoopBooleanPolyDataFilter() :
 
   this->NumberOfIntersectionPoints = 0;
   this->NumberOfIntersectionLines = 0;
+  this->LocalizeToOverlap = 0;
 
   this->Status = 1;
   this->Tolerance = 1e-6;
@@ -934,6 +935,7 @@ int vtkSVLoopBooleanPolyDataFilter::RequestData(
   polydataIntersection->SplitFirstOutputOn();
   polydataIntersection->SplitSecondOutputOn();
   polydataIntersection->SetTolerance(this->Tolerance);
+  polydataIntersection->SetLocalizeToOverlap(this->LocalizeToOverlap);
   polydataIntersection->Update();
   if (polydataIntersection->GetStatus() != SV_OK)
     {
@@ -1112,6 +1114,8 @@ void vtkSVLoopBooleanPolyDataFilter::PrintSelf(
           this->NoIntersectionOutput << "\n";
   os << indent << "Tolerance: " <<
           this->Tolerance << "\n";
+  os << indent << "LocalizeToOverlap: " <<
+          this->LocalizeToOverlap << "\n";
   os << indent << "NumberOfIntersectionPoints: " <<
           this->NumberOfIntersectionPoints << "\n";
   os << indent << "NumberOfIntersectionLines: " <<
@@ -126,6 +126,12 @@ public:
   vtkGetMacro(Tolerance, double);
   vtkSetMacro(Tolerance, double);
 
+  /// \brief Restrict the intersection and splitting work to the region where
+  /// the two surfaces overlap. See vtkSVLoopIntersectionPolyDataFilter.
+  vtkGetMacro(LocalizeToOverlap, int);
+  vtkSetMacro(LocalizeToOverlap, int);
+  vtkBooleanMacro(LocalizeToOverlap, int);
+
 protected:
   vtkSVLoopBooleanPolyDataFilter();
   ~vtkSVLoopBooleanPolyDataFilter();
@@ -140,6 +146,7 @@ protected:
   int NoIntersectionOutput;
   int NumberOfIntersectionPoints;
   int NumberOfIntersectionLines;
+  int LocalizeToOverlap;
 
   int Status;
   double Tolerance;
@@ -35,6 +35,7 @@
 #include "vtkSVLoopIntersectionPolyDataFilter.h"
 #include "delaunay_options.h"
 
+#include "vtkBoundingBox.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCleanPolyData.h"
@@ -59,6 +60,8 @@
 #include "vtkPoints.h"
 #include "vtkPolyDataNormals.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSortDataArray.h"
 #include "vtkSmartPointer.h"
 #include "vtkSVGlobals.h"
@@ -70,6 +73,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 //----------------------------------------------------------------------------
 // Helper typedefs and data structures.
@@ -93,6 +97,30 @@ struct simPolygon
   int orientation; // their orientation
 };
 
+// ----------------------
+// simNodePair
+// ----------------------
+struct simNodePair
+{
+  vtkOBBNode *node0; // leaf node of the first tree
+  vtkOBBNode *node1; // leaf node of the second tree
+  vtkMatrix4x4 *transform; // transform between the trees
+};
+
+// ----------------------
+// simTriangleIntersection
+// ----------------------
+struct simTriangleIntersection
+{
+  vtkIdType cellId0; // intersecting cell of the first surface
+  vtkIdType cellId1; // intersecting cell of the second surface
+  vtkIdType triPtIds0[3]; // points of cellId0
+  vtkIdType triPtIds1[3]; // points of cellId1
+  double pt0[3]; // first end of the intersection line
+  double pt1[3]; // second end of the intersection line
+  double surfaceId[2]; // surface each end lies on
+};
+
 }
 
 // ----------------------
@@ -126,10 +154,39 @@ public:
   Impl();
   virtual ~Impl();
 
-  /// \brief Finds all triangle triangle intersections between two input OOBTrees
+  /// \brief Records the leaf node pairs of the two input OBBTrees that may
+  /// hold intersecting triangles
   static int FindTriangleIntersections(vtkOBBNode *node0, vtkOBBNode *node1,
                                        vtkMatrix4x4 *transform, void *arg);
 
+  /// \brief Finds the triangle triangle intersections of one leaf node pair
+  void FindNodeIntersections(const simNodePair &nodePair,
+                             vtkIdList *cellPtIds,
+                             std::vector<simTriangleIntersection> *hits);
+
+  /// \brief Adds a triangle triangle intersection to the lines and maps
+  void AddTriangleIntersection(const simTriangleIntersection &hit);
+
+  /// \brief Runs FindNodeIntersections over a range of node pairs, keeping
+  /// the intersections of each pair in its own buffer
+  class FindNodeIntersectionsFunctor
+  {
+  public:
+    Impl *Info;
+    std::vector<std::vector<simTriangleIntersection> > *Hits;
+    vtkSMPThreadLocalObject<vtkIdList> CellPtIds;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkIdList *cellPtIds = this->CellPtIds.Local();
+      for (vtkIdType i = begin; i < end; i++)
+        {
+        this->Info->FindNodeIntersections(this->Info->NodePairs[i], cellPtIds,
+                                          &(*this->Hits)[i]);
+        }
+    }
+  };
+
   /// \brief Temporarily moving here to try some stuff out
   static int IntersectPlaneWithLine(double p1[3], double p2[3], double n[3],
                                     double p0[3], double& t, double x[3]);
@@ -138,8 +195,18 @@ public:
   int SplitMesh(int inputIndex, vtkPolyData *output,
                 vtkPolyData *intersectionLines);
 
+  /// \brief Gets the cells of the designated input whose bounds overlap the
+  /// other input. The OBB tree is built on these cells only.
+  static void GetOverlapCells(vtkPolyData *mesh, vtkPolyData *other,
+                              double tolerance, vtkPolyData *overlap,
+                              vtkIdTypeArray *overlapCellIds);
+
 protected:
 
+  /// \brief Marks the intersected cells and their edge neighbors, which
+  /// are the only cells that SplitMesh needs to split
+  void GetCellsToSplit(int inputIndex, std::vector<char> &cellsToSplit);
+
   /// \brief Split cells into polygons created by intersection lines
   vtkCellArray* SplitCell(vtkPolyData *input, vtkIdType cellId,
                           const vtkIdType *cellPts,
@@ -195,6 +262,14 @@ public:
   vtkPolyData         *Mesh[2];
   vtkOBBTree          *OBBTree1;
 
+  /// \brief Ids of the cells in Mesh given to the OBB trees when the search
+  /// is localized to the overlap. nullptr if the trees hold all cells.
+  vtkIdTypeArray      *OverlapCellIds[2];
+  int                 LocalizeToOverlap;
+
+  /// \brief Leaf node pairs found by the OBB tree search, in search order
+  std::vector<simNodePair> NodePairs;
+
   // Stores the intersection lines.
   vtkCellArray        *IntersectionLines;
 
@@ -252,6 +327,7 @@ vtkSVLoopIntersectionPolyDataFilter::Impl::Impl() :
     {
     this->Mesh[i]                 = nullptr;
     this->CellIds[i]              = nullptr;
+    this->OverlapCellIds[i]       = nullptr;
     this->IntersectionMap[i]      = new IntersectionMapType();
     this->IntersectionPtsMap[i]   = new IntersectionMapType();
     this->PointEdgeMap[i]         = new PointEdgeMapType();
@@ -259,6 +335,7 @@ vtkSVLoopIntersectionPolyDataFilter::Impl::Impl() :
   this->PointMapper               = new IntersectionMapType();
   this->SplittingPD               = vtkPolyData::New();
   this->TransformSign = 0;
+  this->LocalizeToOverlap = 0;
   this->Tolerance = 1e-6;
 }
 
@@ -280,6 +357,10 @@ vtkSVLoopIntersectionPolyDataFilter::Impl::~Impl()
 // ----------------------
 // Impl::FindTriangleIntersections
 // ----------------------
+/// \details Broad phase of the intersection search. The OBB tree callback
+/// only records the pairs of leaf nodes whose boxes intersect, in traversal
+/// order. The triangles of each pair are tested afterwards by
+/// FindNodeIntersections.
 int vtkSVLoopIntersectionPolyDataFilter::Impl
 ::FindTriangleIntersections(vtkOBBNode *node0, vtkOBBNode *node1,
                             vtkMatrix4x4 *transform, void *arg)
@@ -287,16 +368,30 @@ int vtkSVLoopIntersectionPolyDataFilter::Impl
   vtkSVLoopIntersectionPolyDataFilter::Impl *info =
     reinterpret_cast<vtkSVLoopIntersectionPolyDataFilter::Impl*>(arg);
 
-  //Set up local structures to hold Impl array information
-  vtkPolyData     *mesh0                 = info->Mesh[0];
-  vtkPolyData     *mesh1                 = info->Mesh[1];
-  vtkOBBTree      *obbTree1              = info->OBBTree1;
-  vtkCellArray    *intersectionLines     = info->IntersectionLines;
-  vtkIdTypeArray  *intersectionSurfaceId = info->SurfaceId;
-  vtkIdTypeArray  *intersectionCellIds0  = info->CellIds[0];
-  vtkIdTypeArray  *intersectionCellIds1  = info->CellIds[1];
-  vtkPointLocator *pointMerger           = info->PointMerger;
-  double tolerance                       = info->Tolerance;
+  simNodePair nodePair;
+  nodePair.node0     = node0;
+  nodePair.node1     = node1;
+  nodePair.transform = transform;
+  info->NodePairs.push_back(nodePair);
+
+  return SV_OK;
+}
+
+// ----------------------
+// Impl::FindNodeIntersections
+// ----------------------
+/// \details Narrow phase for one pair of leaf nodes. Only reads the meshes
+/// and trees, so pairs can be tested concurrently. The intersecting
+/// triangle pairs are returned in the order the serial search visits them.
+void vtkSVLoopIntersectionPolyDataFilter::Impl
+::FindNodeIntersections(const simNodePair &nodePair, vtkIdList *cellPtIds,
+                        std::vector<simTriangleIntersection> *hits)
+{
+  vtkPolyData *mesh0     = this->Mesh[0];
+  vtkPolyData *mesh1     = this->Mesh[1];
+  vtkOBBNode  *node0     = nodePair.node0;
+  vtkOBBNode  *node1     = nodePair.node1;
+  double      tolerance  = this->Tolerance;
 
   //The number of cells in OBBTree
   int numCells0 = node0->Cells->GetNumberOfIds();
@@ -304,240 +399,285 @@ int vtkSVLoopIntersectionPolyDataFilter::Impl
   for (vtkIdType id0 = 0; id0 < numCells0; id0++)
     {
     vtkIdType cellId0 = node0->Cells->GetId(id0);
+    if (this->OverlapCellIds[0] != nullptr)
+      {
+      cellId0 = this->OverlapCellIds[0]->GetValue(cellId0);
+      }
     int type0 = mesh0->GetCellType(cellId0);
 
     //Make sure the cell is a triangle
     if (type0 == VTK_TRIANGLE)
       {
-      vtkIdType npts0;
-      const vtkIdType *triPtIds0;
-      mesh0->GetCellPoints(cellId0, npts0, triPtIds0);
+      vtkIdType triPtIds0[3];
+      mesh0->GetCellPoints(cellId0, cellPtIds);
       double triPts0[3][3];
-      for (vtkIdType id = 0; id < npts0; id++)
+      for (vtkIdType id = 0; id < 3; id++)
         {
+        triPtIds0[id] = cellPtIds->GetId(id);
         mesh0->GetPoint(triPtIds0[id], triPts0[id]);
         }
 
-      if (obbTree1->TriangleIntersectsNode
-          (node1, triPts0[0], triPts0[1], triPts0[2], transform))
+      if (this->OBBTree1->TriangleIntersectsNode
+          (node1, triPts0[0], triPts0[1], triPts0[2], nodePair.transform))
         {
         int numCells1 = node1->Cells->GetNumberOfIds();
         for (vtkIdType id1 = 0; id1 < numCells1; id1++)
           {
           vtkIdType cellId1 = node1->Cells->GetId(id1);
+          if (this->OverlapCellIds[1] != nullptr)
+            {
+            cellId1 = this->OverlapCellIds[1]->GetValue(cellId1);
+            }
           int type1 = mesh1->GetCellType(cellId1);
           if (type1 == VTK_TRIANGLE)
             {
             // See if the two cells actually intersect. If they do,
-            // add an entry into the intersection maps and add an
-            // intersection line.
-            vtkIdType npts1;
-            const vtkIdType *triPtIds1;
-            mesh1->GetCellPoints(cellId1, npts1, triPtIds1);
+            // keep the intersection for the merge.
+            vtkIdType triPtIds1[3];
+            mesh1->GetCellPoints(cellId1, cellPtIds);
 
             double triPts1[3][3];
-            for (vtkIdType id = 0; id < npts1; id++)
+            for (vtkIdType id = 0; id < 3; id++)
               {
+              triPtIds1[id] = cellPtIds->GetId(id);
               mesh1->GetPoint(triPtIds1[id], triPts1[id]);
               }
 
             int coplanar = 0;
-            double outpt0[3], outpt1[3];
-            double surfaceid[2];
+            simTriangleIntersection hit;
             int intersects =
               vtkSVLoopIntersectionPolyDataFilter::TriangleTriangleIntersection
               (triPts0[0], triPts0[1], triPts0[2],
                triPts1[0], triPts1[1], triPts1[2],
-               coplanar, outpt0, outpt1, surfaceid, tolerance);
+               coplanar, hit.pt0, hit.pt1, hit.surfaceId, tolerance);
 
             if (coplanar)
               {
               // Coplanar triangle intersection is not handled.
               // This intersection will not be included in the output. TODO
               //vtkDebugMacro(<<"Coplanar");
-              intersects = 0;
               continue;
               }
 
-            //If actual intersection, add point and cell to edge, line,
-            //and surface maps!
             if (intersects)
               {
-              vtkIdType lineId = intersectionLines->GetNumberOfCells();
-
-              vtkIdType ptId0, ptId1;
-              int unique[2];
-              unique[0] = pointMerger->InsertUniquePoint(outpt0, ptId0);
-              unique[1] = pointMerger->InsertUniquePoint(outpt1, ptId1);
-
-              int addline = 1;
-              if (ptId0 == ptId1)
-                {
-                addline = 0;
-                }
-
-              if (ptId0 == ptId1 && surfaceid[0] != surfaceid[1])
+              hit.cellId0 = cellId0;
+              hit.cellId1 = cellId1;
+              for (int id = 0; id < 3; id++)
                 {
-                intersectionSurfaceId->InsertValue(ptId0, 3);
-                }
-              else
-                {
-                if (unique[0])
-                  {
-                  intersectionSurfaceId->InsertValue(ptId0, surfaceid[0]);
-                  }
-                else
-                  {
-                  if (intersectionSurfaceId->GetValue(ptId0) != 3)
-                    {
-                    intersectionSurfaceId->InsertValue(ptId0, surfaceid[0]);
-                    }
-                  }
-                if (unique[1])
-                  {
-                  intersectionSurfaceId->InsertValue(ptId1, surfaceid[1]);
-                  }
-                else
-                  {
-                  if (intersectionSurfaceId->GetValue(ptId1) != 3)
-                    {
-                    intersectionSurfaceId->InsertValue(ptId1, surfaceid[1]);
-                    }
-                  }
-                }
-
-              info->IntersectionPtsMap[0]->
-                insert(std::make_pair(ptId0, cellId0));
-              info->IntersectionPtsMap[1]->
-                insert(std::make_pair(ptId0, cellId1));
-              info->IntersectionPtsMap[0]->
-                insert(std::make_pair(ptId1, cellId0));
-              info->IntersectionPtsMap[1]->
-                insert(std::make_pair(ptId1, cellId1));
-
-              //Check to see if duplicate line. Line can only be a duplicate
-              //line if both points are not unique and they don't
-              //equal eachother
-              if (!unique[0] && !unique[1] && ptId0 != ptId1)
-                {
-                vtkNew(vtkPolyData, lineTest);
-                lineTest->SetPoints(pointMerger->GetPoints());
-                lineTest->SetLines(intersectionLines);
-                lineTest->BuildLinks();
-                int newLine = info->CheckLine(lineTest, ptId0, ptId1);
-                if (newLine == 0)
-                  {
-                  addline = 0;
-                  }
-                }
-              if (addline)
-                {
-                //If the line is new and does not consist of two identical
-                //points, add the line to the intersection and update
-                //mapping information
-                intersectionLines->InsertNextCell(2);
-                intersectionLines->InsertCellPoint(ptId0);
-                intersectionLines->InsertCellPoint(ptId1);
-
-                intersectionCellIds0->InsertNextValue(cellId0);
-                intersectionCellIds1->InsertNextValue(cellId1);
-
-                info->PointCellIds[0]->InsertValue(ptId0, cellId0);
-                info->PointCellIds[0]->InsertValue(ptId1, cellId0);
-                info->PointCellIds[1]->InsertValue(ptId0, cellId1);
-                info->PointCellIds[1]->InsertValue(ptId1, cellId1);
-
-                info->IntersectionMap[0]->
-                  insert(std::make_pair(cellId0, lineId));
-                info->IntersectionMap[1]->
-                  insert(std::make_pair(cellId1, lineId));
-
-                // Check which edges of cellId0 and cellId1 outpt0 and
-                // outpt1 are on, if any.
-                int isOnEdge=0;
-                int m0p0=0, m0p1=0, m1p0=0, m1p1=0;
-                for (vtkIdType edgeId = 0; edgeId < 3; edgeId++)
-                  {
-                  isOnEdge = info->AddToPointEdgeMap(0, ptId0, outpt0,
-                      mesh0, cellId0, edgeId, lineId, triPtIds0);
-                  if (isOnEdge != -1)
-                    {
-                    m0p0++;
-                    }
-                  isOnEdge = info->AddToPointEdgeMap(0, ptId1, outpt1,
-                      mesh0, cellId0, edgeId, lineId, triPtIds0);
-                  if (isOnEdge != -1)
-                    {
-                    m0p1++;
-                    }
-                  isOnEdge = info->AddToPointEdgeMap(1, ptId0, outpt0,
-                      mesh1, cellId1, edgeId, lineId, triPtIds1);
-                  if (isOnEdge != -1)
-                    {
-                    m1p0++;
-                    }
-                  isOnEdge = info->AddToPointEdgeMap(1, ptId1, outpt1,
-                      mesh1, cellId1, edgeId, lineId, triPtIds1);
-                  if (isOnEdge != -1)
-                    {
-                    m1p1++;
-                    }
-                  }
-                //Special cases caught by tolerance and not from the Point
-                //Merger
-                if (m0p0 > 0 && m1p0 > 0)
-                  {
-                  intersectionSurfaceId->InsertValue(ptId0, 3);
-                  }
-                if (m0p1 > 0 && m1p1 > 0)
-                  {
-                  intersectionSurfaceId->InsertValue(ptId1, 3);
-                  }
-                }
-              //Add information about origin surface to std::maps for
-              //checks later
-              if (intersectionSurfaceId->GetValue(ptId0) == 1)
-                {
-                info->IntersectionPtsMap[0]->
-                  insert(std::make_pair(ptId0, cellId0));
-                }
-              else if (intersectionSurfaceId->GetValue(ptId0) == 2)
-                {
-                info->IntersectionPtsMap[1]->
-                  insert(std::make_pair(ptId0, cellId1));
-                }
-              else
-                {
-                info->IntersectionPtsMap[0]->
-                  insert(std::make_pair(ptId0, cellId0));
-                info->IntersectionPtsMap[1]->
-                  insert(std::make_pair(ptId0, cellId1));
-                }
-              if (intersectionSurfaceId->GetValue(ptId1) == 1)
-                {
-                info->IntersectionPtsMap[0]->
-                  insert(std::make_pair(ptId1, cellId0));
-                }
-              else if (intersectionSurfaceId->GetValue(ptId1) == 2)
-                {
-                info->IntersectionPtsMap[1]->
-                  insert(std::make_pair(ptId1, cellId1));
-                }
-              else
-                {
-                info->IntersectionPtsMap[0]->
-                  insert(std::make_pair(ptId1, cellId0));
-                info->IntersectionPtsMap[1]->
-                  insert(std::make_pair(ptId1, cellId1));
+                hit.triPtIds0[id] = triPtIds0[id];
+                hit.triPtIds1[id] = triPtIds1[id];
                 }
+              hits->push_back(hit);
               }
             }
           }
         }
       }
     }
+}
 
-  return SV_OK;
+// ----------------------
+// Impl::AddTriangleIntersection
+// ----------------------
+/// \details Adds one triangle-triangle intersection to the intersection
+/// points, lines, and maps. Called serially in the order of the search so
+/// the merged result does not depend on the number of threads.
+void vtkSVLoopIntersectionPolyDataFilter::Impl
+::AddTriangleIntersection(const simTriangleIntersection &hit)
+{
+  //Set up local structures to hold Impl array information
+  vtkSVLoopIntersectionPolyDataFilter::Impl *info = this;
+  vtkPolyData     *mesh0                 = this->Mesh[0];
+  vtkPolyData     *mesh1                 = this->Mesh[1];
+  vtkCellArray    *intersectionLines     = this->IntersectionLines;
+  vtkIdTypeArray  *intersectionSurfaceId = this->SurfaceId;
+  vtkIdTypeArray  *intersectionCellIds0  = this->CellIds[0];
+  vtkIdTypeArray  *intersectionCellIds1  = this->CellIds[1];
+  vtkPointLocator *pointMerger           = this->PointMerger;
+
+  vtkIdType cellId0 = hit.cellId0;
+  vtkIdType cellId1 = hit.cellId1;
+  const vtkIdType *triPtIds0 = hit.triPtIds0;
+  const vtkIdType *triPtIds1 = hit.triPtIds1;
+  double outpt0[3], outpt1[3], surfaceid[2];
+  for (int i = 0; i < 3; i++)
+    {
+    outpt0[i] = hit.pt0[i];
+    outpt1[i] = hit.pt1[i];
+    }
+  surfaceid[0] = hit.surfaceId[0];
+  surfaceid[1] = hit.surfaceId[1];
+
+  //If actual intersection, add point and cell to edge, line,
+  //and surface maps!
+  vtkIdType lineId = intersectionLines->GetNumberOfCells();
+
+  vtkIdType ptId0, ptId1;
+  int unique[2];
+  unique[0] = pointMerger->InsertUniquePoint(outpt0, ptId0);
+  unique[1] = pointMerger->InsertUniquePoint(outpt1, ptId1);
+
+  int addline = 1;
+  if (ptId0 == ptId1)
+    {
+    addline = 0;
+    }
+
+  if (ptId0 == ptId1 && surfaceid[0] != surfaceid[1])
+    {
+    intersectionSurfaceId->InsertValue(ptId0, 3);
+    }
+  else
+    {
+    if (unique[0])
+      {
+      intersectionSurfaceId->InsertValue(ptId0, surfaceid[0]);
+      }
+    else
+      {
+      if (intersectionSurfaceId->GetValue(ptId0) != 3)
+        {
+        intersectionSurfaceId->InsertValue(ptId0, surfaceid[0]);
+        }
+      }
+    if (unique[1])
+      {
+      intersectionSurfaceId->InsertValue(ptId1, surfaceid[1]);
+      }
+    else
+      {
+      if (intersectionSurfaceId->GetValue(ptId1) != 3)
+        {
+        intersectionSurfaceId->InsertValue(ptId1, surfaceid[1]);
+        }
+      }
+    }
+
+  info->IntersectionPtsMap[0]->
+    insert(std::make_pair(ptId0, cellId0));
+  info->IntersectionPtsMap[1]->
+    insert(std::make_pair(ptId0, cellId1));
+  info->IntersectionPtsMap[0]->
+    insert(std::make_pair(ptId1, cellId0));
+  info->IntersectionPtsMap[1]->
+    insert(std::make_pair(ptId1, cellId1));
+
+  //Check to see if duplicate line. Line can only be a duplicate
+  //line if both points are not unique and they don't
+  //equal eachother
+  if (!unique[0] && !unique[1] && ptId0 != ptId1)
+    {
+    vtkNew(vtkPolyData, lineTest);
+    lineTest->SetPoints(pointMerger->GetPoints());
+    lineTest->SetLines(intersectionLines);
+    lineTest->BuildLinks();
+    int newLine = info->CheckLine(lineTest, ptId0, ptId1);
+    if (newLine == 0)
+      {
+      addline = 0;
+      }
+    }
+  if (addline)
+    {
+    //If the line is new and does not consist of two identical
+    //points, add the line to the intersection and update
+    //mapping information
+    intersectionLines->InsertNextCell(2);
+    intersectionLines->InsertCellPoint(ptId0);
+    intersectionLines->InsertCellPoint(ptId1);
+
+    intersectionCellIds0->InsertNextValue(cellId0);
+    intersectionCellIds1->InsertNextValue(cellId1);
+
+    info->PointCellIds[0]->InsertValue(ptId0, cellId0);
+    info->PointCellIds[0]->InsertValue(ptId1, cellId0);
+    info->PointCellIds[1]->InsertValue(ptId0, cellId1);
+    info->PointCellIds[1]->InsertValue(ptId1, cellId1);
+
+    info->IntersectionMap[0]->
+      insert(std::make_pair(cellId0, lineId));
+    info->IntersectionMap[1]->
+      insert(std::make_pair(cellId1, lineId));
+
+    // Check which edges of cellId0 and cellId1 outpt0 and
+    // outpt1 are on, if any.
+    int isOnEdge=0;
+    int m0p0=0, m0p1=0, m1p0=0, m1p1=0;
+    for (vtkIdType edgeId = 0; edgeId < 3; edgeId++)
+      {
+      isOnEdge = info->AddToPointEdgeMap(0, ptId0, outpt0,
+          mesh0, cellId0, edgeId, lineId, triPtIds0);
+      if (isOnEdge != -1)
+        {
+        m0p0++;
+        }
+      isOnEdge = info->AddToPointEdgeMap(0, ptId1, outpt1,
+          mesh0, cellId0, edgeId, lineId, triPtIds0);
+      if (isOnEdge != -1)
+        {
+        m0p1++;
+        }
+      isOnEdge = info->AddToPointEdgeMap(1, ptId0, outpt0,
+          mesh1, cellId1, edgeId, lineId, triPtIds1);
+      if (isOnEdge != -1)
+        {
+        m1p0++;
+        }
+      isOnEdge = info->AddToPointEdgeMap(1, ptId1, outpt1,
+          mesh1, cellId1, edgeId, lineId, triPtIds1);
+      if (isOnEdge != -1)
+        {
+        m1p1++;
+        }
+      }
+    //Special cases caught by tolerance and not from the Point
+    //Merger
+    if (m0p0 > 0 && m1p0 > 0)
+      {
+      intersectionSurfaceId->InsertValue(ptId0, 3);
+      }
+    if (m0p1 > 0 && m1p1 > 0)
+      {
+      intersectionSurfaceId->InsertValue(ptId1, 3);
+      }
+    }
+  //Add information about origin surface to std::maps for
+  //checks later
+  if (intersectionSurfaceId->GetValue(ptId0) == 1)
+    {
+    info->IntersectionPtsMap[0]->
+      insert(std::make_pair(ptId0, cellId0));
+    }
+  else if (intersectionSurfaceId->GetValue(ptId0) == 2)
+    {
+    info->IntersectionPtsMap[1]->
+      insert(std::make_pair(ptId0, cellId1));
+    }
+  else
+    {
+    info->IntersectionPtsMap[0]->
+      insert(std::make_pair(ptId0, cellId0));
+    info->IntersectionPtsMap[1]->
+      insert(std::make_pair(ptId0, cellId1));
+    }
+  if (intersectionSurfaceId->GetValue(ptId1) == 1)
+    {
+    info->IntersectionPtsMap[0]->
+      insert(std::make_pair(ptId1, cellId0));
+    }
+  else if (intersectionSurfaceId->GetValue(ptId1) == 2)
+    {
+    info->IntersectionPtsMap[1]->
+      insert(std::make_pair(ptId1, cellId1));
+    }
+  else
+    {
+    info->IntersectionPtsMap[0]->
+      insert(std::make_pair(ptId1, cellId0));
+    info->IntersectionPtsMap[1]->
+      insert(std::make_pair(ptId1, cellId1));
+    }
 }
 
 // ----------------------
@@ -575,13 +715,23 @@ int vtkSVLoopIntersectionPolyDataFilter::Impl
   outPD->CopyAllocate(inPD, input->GetNumberOfPoints());
 
   // Copy over the point data from the input
-  for (vtkIdType ptId = 0; ptId < inputNumPoints; ptId++)
+  if (this->LocalizeToOverlap)
     {
-    double pt[3];
-    input->GetPoints()->GetPoint(ptId, pt);
-    output->GetPoints()->InsertNextPoint(pt);
-    outPD->CopyData(inPD, ptId, ptId);
-    this->BoundaryPoints[inputIndex]->InsertValue(ptId, 0);
+    points->InsertPoints(0, inputNumPoints, 0, input->GetPoints());
+    outPD->CopyData(inPD, 0, inputNumPoints, 0);
+    this->BoundaryPoints[inputIndex]->SetNumberOfValues(inputNumPoints);
+    this->BoundaryPoints[inputIndex]->FillComponent(0, 0);
+    }
+  else
+    {
+    for (vtkIdType ptId = 0; ptId < inputNumPoints; ptId++)
+      {
+      double pt[3];
+      input->GetPoints()->GetPoint(ptId, pt);
+      output->GetPoints()->InsertNextPoint(pt);
+      outPD->CopyData(inPD, ptId, ptId);
+      this->BoundaryPoints[inputIndex]->InsertValue(ptId, 0);
+      }
     }
 
   // Copy the points from splitLines to the output, interpolating the
@@ -619,6 +769,15 @@ int vtkSVLoopIntersectionPolyDataFilter::Impl
     newPolys->EstimateSize(cells->GetNumberOfCells(), 3);
     output->SetPolys(newPolys);
 
+    // When localized, the cells to split are known up front and the
+    // untouched cells have their data copied in contiguous runs
+    std::vector<char> cellsToSplit;
+    vtkIdType runSrcId = 0, runDstId = 0, runLength = 0;
+    if (this->LocalizeToOverlap)
+      {
+      this->GetCellsToSplit(inputIndex, cellsToSplit);
+      }
+
     vtkNew( vtkIdList , edgeNeighbors);
     vtkIdType nptsX = 0;
     const vtkIdType *pts;
@@ -632,6 +791,35 @@ int vtkSVLoopIntersectionPolyDataFilter::Impl
         continue;
         }
 
+      if (this->LocalizeToOverlap)
+        {
+        if (!cellsToSplit[cellIdX])
+          {
+          newId = newPolys->InsertNextCell(3, pts);
+          if (runLength > 0 && runSrcId + runLength == cellIdX &&
+              runDstId + runLength == newId)
+            {
+            runLength++;
+            }
+          else
+            {
+            if (runLength > 0)
+              {
+              outCD->CopyData(inCD, runDstId, runLength, runSrcId);
+              }
+            runSrcId = cellIdX;
+            runDstId = newId;
+            runLength = 1;
+            }
+          continue;
+          }
+        if (runLength > 0)
+          {
+          outCD->CopyData(inCD, runDstId, runLength, runSrcId);
+          runLength = 0;
+          }
+        }
+
       cellsToCheck->Reset();
       cellsToCheck->Allocate(nptsX+1);
       cellsToCheck->InsertNextId(cellIdX);
@@ -722,11 +910,104 @@ int vtkSVLoopIntersectionPolyDataFilter::Impl
           }
         }
       } // for (cells->InitTraversal(); ...
+    if (runLength > 0)
+      {
+      outCD->CopyData(inCD, runDstId, runLength, runSrcId);
+      }
     } //if inputGetPolys()->GetNumberOfCells() > 1 ...
 
   return SV_OK;
 }
 
+// ----------------------
+// Impl::GetCellsToSplit
+// ----------------------
+/// \details A cell is split if it is intersected or if it shares an edge
+/// with an intersected cell, as the intersection line may end on that edge.
+/// This is the same test SplitMesh applies cell by cell, but it only visits
+/// the cells in the intersection map.
+void vtkSVLoopIntersectionPolyDataFilter::Impl
+::GetCellsToSplit(int inputIndex, std::vector<char> &cellsToSplit)
+{
+  vtkPolyData *input = this->Mesh[inputIndex];
+  IntersectionMapType *intersectionMap = this->IntersectionMap[inputIndex];
+  cellsToSplit.assign(input->GetNumberOfCells(), 0);
+
+  vtkNew( vtkIdList , edgeNeighbors);
+  IntersectionMapIteratorType iter = intersectionMap->begin();
+  for (; iter != intersectionMap->end();
+       iter = intersectionMap->upper_bound(iter->first))
+    {
+    vtkIdType cellId = iter->first;
+    cellsToSplit[cellId] = 1;
+
+    vtkIdType npts;
+    const vtkIdType *pts;
+    input->GetCellPoints(cellId, npts, pts);
+    if (npts != 3)
+      {
+      continue;
+      }
+    vtkIdType cellPts[3] = {pts[0], pts[1], pts[2]};
+    for (vtkIdType ptId = 0; ptId < 3; ptId++)
+      {
+      edgeNeighbors->Reset();
+      input->GetCellEdgeNeighbors(cellId, cellPts[ptId], cellPts[(ptId+1) % 3],
+                                  edgeNeighbors);
+      for (vtkIdType nbr = 0; nbr < edgeNeighbors->GetNumberOfIds(); nbr++)
+        {
+        cellsToSplit[edgeNeighbors->GetId(nbr)] = 1;
+        }
+      }
+    }
+}
+
+// ----------------------
+// Impl::GetOverlapCells
+// ----------------------
+/// \details Triangles of mesh whose bounds do not reach the bounding box of
+/// other (grown by the tolerance) cannot intersect it and are left out.
+void vtkSVLoopIntersectionPolyDataFilter::Impl
+::GetOverlapCells(vtkPolyData *mesh, vtkPolyData *other, double tolerance,
+                  vtkPolyData *overlap, vtkIdTypeArray *overlapCellIds)
+{
+  double bounds[6];
+  other->GetBounds(bounds);
+  vtkBoundingBox otherBox(bounds);
+  otherBox.Inflate(tolerance);
+
+  vtkNew( vtkCellArray , polys);
+  overlapCellIds->Reset();
+
+  vtkIdType numCells = mesh->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    if (mesh->GetCellType(cellId) != VTK_TRIANGLE)
+      {
+      continue;
+      }
+    vtkIdType npts;
+    const vtkIdType *pts;
+    mesh->GetCellPoints(cellId, npts, pts);
+
+    vtkBoundingBox cellBox;
+    double pt[3];
+    for (vtkIdType i = 0; i < npts; i++)
+      {
+      mesh->GetPoint(pts[i], pt);
+      cellBox.AddPoint(pt);
+      }
+    if (otherBox.Intersects(cellBox))
+      {
+      polys->InsertNextCell(npts, pts);
+      overlapCellIds->InsertNextValue(cellId);
+      }
+    }
+
+  overlap->SetPoints(mesh->GetPoints());
+  overlap->SetPolys(polys);
+}
+
 // ----------------------
 // Impl::SplitCell
 // ----------------------
@@ -2040,6 +2321,7 @@ vtkSVLoopIntersectionPolyDataFilter::vtkSVLoopIntersectionPolyDataFilter()
 
   this->CheckMesh = 1;
   this->CheckInput = 0;
+  this->LocalizeToOverlap = 0;
   this->Status = 1;
   this->ComputeIntersectionPointArray = 0;
   this->Tolerance = 1e-6;
@@ -2063,6 +2345,7 @@ void vtkSVLoopIntersectionPolyDataFilter::PrintSelf(ostream &os, vtkIndent inden
   os << indent << "SplitFirstOutput: " << this->SplitFirstOutput << "\n";
   os << indent << "SplitSecondOutput: " << this->SplitSecondOutput << "\n";
   os << indent << "CheckMesh: " << this->CheckMesh << "\n";
+  os << indent << "LocalizeToOverlap: " << this->LocalizeToOverlap << "\n";
   os << indent << "Status: " << this->CheckMesh << "\n";
   os << indent << "ComputeIntersectionPointArray: " <<
           this->ComputeIntersectionPointArray << "\n";
@@ -2420,28 +2703,61 @@ int vtkSVLoopIntersectionPolyDataFilter::RequestData(
     outPolyDataInfo1->Get(vtkDataObject::DATA_OBJECT()));
 
   // Set up new poly data for the inputs to build cells and links.
+  // The meshes are only read, so the localized mode shares the input arrays
   vtkNew(vtkPolyData , mesh0);
-  mesh0->DeepCopy(input0);
-
   vtkNew(vtkPolyData , mesh1);
-  mesh1->DeepCopy(input1);
+  if (this->LocalizeToOverlap)
+    {
+    mesh0->ShallowCopy(input0);
+    mesh1->ShallowCopy(input1);
+    }
+  else
+    {
+    mesh0->DeepCopy(input0);
+    mesh1->DeepCopy(input1);
+    }
+
+  // Only the cells near the other surface go into the trees when localized
+  vtkPolyData *treeData0 = mesh0;
+  vtkPolyData *treeData1 = mesh1;
+  vtkNew(vtkPolyData , overlap0);
+  vtkNew(vtkPolyData , overlap1);
+  vtkNew(vtkIdTypeArray , overlapCellIds0);
+  vtkNew(vtkIdTypeArray , overlapCellIds1);
+  if (this->LocalizeToOverlap)
+    {
+    Impl::GetOverlapCells(mesh0, mesh1, this->Tolerance, overlap0,
+                          overlapCellIds0);
+    Impl::GetOverlapCells(mesh1, mesh0, this->Tolerance, overlap1,
+                          overlapCellIds1);
+    treeData0 = overlap0;
+    treeData1 = overlap1;
+    vtkDebugMacro(<<"Overlap cells "<<overlap0->GetNumberOfCells()<<" of "<<
+      mesh0->GetNumberOfCells()<<" and "<<overlap1->GetNumberOfCells()<<
+      " of "<<mesh1->GetNumberOfCells());
+    }
+  int searchTrees = treeData0->GetNumberOfCells() > 0 &&
+                    treeData1->GetNumberOfCells() > 0;
 
   // Find the triangle-triangle intersections between mesh0 and mesh1
   vtkNew(vtkOBBTree , obbTree0);
-  obbTree0->SetDataSet(mesh0);
+  obbTree0->SetDataSet(treeData0);
   obbTree0->SetNumberOfCellsPerNode(10);
   obbTree0->SetMaxLevel(1000000);
   obbTree0->SetTolerance(this->Tolerance);
   obbTree0->AutomaticOn();
-  obbTree0->BuildLocator();
 
   vtkNew(vtkOBBTree , obbTree1);
-  obbTree1->SetDataSet(mesh1);
+  obbTree1->SetDataSet(treeData1);
   obbTree1->SetNumberOfCellsPerNode(10);
   obbTree1->SetMaxLevel(1000000);
   obbTree1->SetTolerance(this->Tolerance);
   obbTree1->AutomaticOn();
-  obbTree1->BuildLocator();
+  if (searchTrees || !this->LocalizeToOverlap)
+    {
+    obbTree0->BuildLocator();
+    obbTree1->BuildLocator();
+    }
 
   // Set up the structure for determining exact triangle-triangle
   // intersections.
@@ -2452,6 +2768,12 @@ int vtkSVLoopIntersectionPolyDataFilter::RequestData(
   impl->Mesh[1]  = mesh1;
   impl->OBBTree1 = obbTree1;
   impl->Tolerance = this->Tolerance;
+  impl->LocalizeToOverlap = this->LocalizeToOverlap;
+  if (this->LocalizeToOverlap)
+    {
+    impl->OverlapCellIds[0] = overlapCellIds0;
+    impl->OverlapCellIds[1] = overlapCellIds1;
+    }
 
   vtkNew(vtkCellArray , lines);
   outputIntersection->SetLines(lines);
@@ -2506,10 +2828,41 @@ int vtkSVLoopIntersectionPolyDataFilter::RequestData(
   pointMerger->InitPointInsertion(outputIntersection->GetPoints(), bounds0);
   impl->PointMerger = pointMerger;
 
-  // This performs the triangle intersection search
-  obbTree0->IntersectWithOBBTree
-    (obbTree1, 0, vtkSVLoopIntersectionPolyDataFilter::
-     Impl::FindTriangleIntersections, impl);
+  // This performs the triangle intersection search. The tree search gives
+  // the leaf node pairs to test, the pairs are tested in parallel, and the
+  // intersections are added serially in search order so the output is the
+  // same for any number of threads.
+  if (searchTrees || !this->LocalizeToOverlap)
+    {
+    obbTree0->IntersectWithOBBTree
+      (obbTree1, 0, vtkSVLoopIntersectionPolyDataFilter::
+       Impl::FindTriangleIntersections, impl);
+
+    // Cells must exist before the meshes are read from several threads
+    if (mesh0->NeedToBuildCells())
+      {
+      mesh0->BuildCells();
+      }
+    if (mesh1->NeedToBuildCells())
+      {
+      mesh1->BuildCells();
+      }
+
+    std::vector<std::vector<simTriangleIntersection> >
+      hits(impl->NodePairs.size());
+    Impl::FindNodeIntersectionsFunctor nodeIntersector;
+    nodeIntersector.Info = impl;
+    nodeIntersector.Hits = &hits;
+    vtkSMPTools::For(0, impl->NodePairs.size(), nodeIntersector);
+
+    for (size_t i = 0; i < hits.size(); i++)
+      {
+      for (size_t j = 0; j < hits[i].size(); j++)
+        {
+        impl->AddTriangleIntersection(hits[i][j]);
+        }
+      }
+    }
 
   int rawLines = outputIntersection->GetNumberOfLines();
 
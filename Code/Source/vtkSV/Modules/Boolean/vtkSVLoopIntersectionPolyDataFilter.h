@@ -137,6 +137,16 @@ public:
   vtkBooleanMacro(CheckMesh, int);
   //@}
 
+  //@{
+  /// \brief If on, only the cells near the other surface are searched for
+  /// triangle intersections, and only the intersected cells plus their ring
+  /// of edge neighbors are visited when splitting. All other cells are
+  /// copied over in bulk. Default: OFF
+  vtkGetMacro(LocalizeToOverlap, int);
+  vtkSetMacro(LocalizeToOverlap, int);
+  vtkBooleanMacro(LocalizeToOverlap, int);
+  //@}
+
   //@{
   /// \brief Check the status of the filter after update.
   /// \details If the status is zero,
@@ -189,6 +199,7 @@ protected:
   int ComputeIntersectionPointArray;
   int CheckMesh;
   int CheckInput;
+  int LocalizeToOverlap;
   int Status;
   double Tolerance;
 
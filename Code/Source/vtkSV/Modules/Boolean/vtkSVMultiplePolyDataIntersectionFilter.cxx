@@ -49,6 +49,68 @@
 #include "vtkIdList.h"
 #include "vtkIntArray.h"
 #include "vtkAppendPolyData.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+// ----------------------
+// Union functors
+// ----------------------
+namespace
+{
+/// \brief A group of inputs that have been unioned into one surface
+struct vtkSVUnionCluster
+{
+  vtkSmartPointer<vtkPolyData> Surface;
+  std::vector<int> Members;
+};
+
+/// \brief One union of two clusters in a reduction round
+struct vtkSVUnionPair
+{
+  int Clusters[2];
+  int Status;
+  int Intersects;
+  vtkSmartPointer<vtkPolyData> Output;
+};
+
+/// \brief Runs the booleans of a round. Each pair touches only its own two
+/// clusters, so the pairs are independent of one another.
+struct vtkSVUnionFunctor
+{
+  std::vector<vtkSVUnionCluster> *Clusters;
+  std::vector<vtkSVUnionPair>    *Pairs;
+  double Tolerance;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType p = begin; p < end; p++)
+    {
+      vtkSVUnionPair &pair = (*this->Pairs)[p];
+
+      vtkNew(vtkSVLoopBooleanPolyDataFilter, boolean);
+      boolean->SetInputData(0,(*this->Clusters)[pair.Clusters[0]].Surface);
+      boolean->SetInputData(1,(*this->Clusters)[pair.Clusters[1]].Surface);
+      boolean->SetTolerance(this->Tolerance);
+      boolean->LocalizeToOverlapOn();
+      boolean->SetOperationToUnion();
+      boolean->Update();
+
+      pair.Status = boolean->GetStatus();
+      pair.Intersects = boolean->GetNumberOfIntersectionPoints() != 0 &&
+                        boolean->GetNumberOfIntersectionLines() != 0;
+      if (pair.Status == 1 && pair.Intersects)
+      {
+        // Take over the output arrays, the filter is released right after
+        pair.Output = vtkSmartPointer<vtkPolyData>::New();
+        pair.Output->ShallowCopy(boolean->GetOutput());
+      }
+    }
+  }
+};
+}
 
 // ----------------------
 // StandardNewMacro
@@ -65,6 +127,7 @@ vtkSVMultiplePolyDataIntersectionFilter::vtkSVMultiplePolyDataIntersectionFilter
   this->NoIntersectionOutput = 1;
   this->PassInfoAsGlobal = 0;
   this->AssignSurfaceIds = 0;
+  this->ParallelUnion = 1;
 
   this->BooleanObject = vtkPolyData::New();
   this->IntersectionTable = nullptr;
@@ -219,83 +282,129 @@ int vtkSVMultiplePolyDataIntersectionFilter::BuildIntersectionTable(
 }
 
 // ----------------------
-// ExecuteInformation
+// ExecuteIntersection
 // ----------------------
+/// \details Every input starts as its own cluster. In each round, clusters
+/// with an input pair flagged in the IntersectionTable are matched up and
+/// the matched pairs are unioned concurrently. A merged cluster replaces its
+/// two parents, so later booleans only see the surfaces of the branches
+/// being joined instead of the whole accumulated model. Pairs whose booleans
+/// find no intersection are not tried again.
 int vtkSVMultiplePolyDataIntersectionFilter::ExecuteIntersection(
-    vtkPolyData* inputs[], int numInputs,int start)
+    vtkPolyData* inputs[], int numInputs,
+    std::vector<vtkSmartPointer<vtkPolyData> > &results)
 {
-  int numChecks = 0;
-  int totalIntersections = 0;
-  vtkNew(vtkIdList, checkInputArray);
-  vtkNew(vtkIdList, checkInputArray2);
-  vtkNew(vtkIdList, tmp);
-
-  this->inResult[start] = 1;
-  checkInputArray->InsertNextId(start);
-  while ((numChecks = checkInputArray->GetNumberOfIds()) > 0)
+  std::vector<vtkSVUnionCluster> clusters(numInputs);
+  std::vector<int> clusterOf(numInputs);
+  std::vector<int> alive(numInputs, 1);
+  for (int i = 0; i < numInputs; i++)
+    {
+    clusters[i].Surface = vtkSmartPointer<vtkPolyData>::New();
+    clusters[i].Surface->ShallowCopy(inputs[i]);
+    clusters[i].Members.push_back(i);
+    if (this->PassInfoAsGlobal)
+      this->PreSetGlobalArrays(clusters[i].Surface);
+    clusterOf[i] = i;
+    }
+
+  std::set<std::pair<int, int> > noIntersection;
+  while (true)
     {
-    for(int c = 0;c < numChecks; c++)
+    // Candidate cluster pairs from the bounding box table, in index order
+    std::set<std::pair<int, int> > candidates;
+    for (int i = 0; i < numInputs; i++)
       {
-      int i = checkInputArray->GetId(c);
-      for (int j = 0;j < numInputs; j++)
+      for (int j = i+1; j < numInputs; j++)
         {
-	//Bounding boxes intersect!
-        if (this->IntersectionTable[i][j] == 1)
-          {
-	    //std::cout<<"UNIONING "<<i<<" and "<<j<<endl;
-	    this->IntersectionTable[i][j] = -1;
-	    this->IntersectionTable[j][i] = -1;
-
-	  vtkNew(vtkSVLoopBooleanPolyDataFilter, boolean);
-	  if (this->PassInfoAsGlobal && totalIntersections != 0)
-	    this->PreSetGlobalArrays(inputs[j]);
-
-	  boolean->SetInputData(0,this->BooleanObject);
-	  boolean->SetInputData(1,inputs[j]);
-	  boolean->SetTolerance(this->Tolerance);
-	  //if (this->NoIntersectionOutput)
-	  //  boolean->SetNoIntersectionOutput(1);
-	  //else
-	  //  boolean->SetNoIntersectionOutput(0);
-	  boolean->SetOperationToUnion();
-	  boolean->Update();
-	  if (boolean->GetStatus() != 1)
-	  {
-	    return SV_ERROR;
-	  }
+        if (this->IntersectionTable[i][j] != 1)
+          continue;
+        int c0 = std::min(clusterOf[i], clusterOf[j]);
+        int c1 = std::max(clusterOf[i], clusterOf[j]);
+        if (c0 != c1 && !noIntersection.count(std::make_pair(c0, c1)))
+          candidates.insert(std::make_pair(c0, c1));
+        }
+      }
+    if (candidates.empty())
+      break;
+
+    // Each cluster takes part in at most one union per round
+    std::vector<vtkSVUnionPair> pairs;
+    std::vector<int> used(clusters.size(), 0);
+    std::set<std::pair<int, int> >::iterator it;
+    for (it = candidates.begin(); it != candidates.end(); ++it)
+      {
+      if (used[it->first] || used[it->second])
+        continue;
+      used[it->first] = used[it->second] = 1;
+      vtkSVUnionPair pair;
+      pair.Clusters[0] = it->first;
+      pair.Clusters[1] = it->second;
+      pair.Status = 0;
+      pair.Intersects = 0;
+      pairs.push_back(pair);
+      }
 
-	  int numPts = boolean->GetNumberOfIntersectionPoints();
-	  int numLines = boolean->GetNumberOfIntersectionLines();
-
-	  //Objects actually don't intersect
-	  if ((numPts == 0 || numLines == 0))
-	    {
-	      std::cout<<"NO INTERSECTION FOR OBJECTS "<<i<<" AND "<<j<<endl;
-	    }
-	  else
-	    {
-	      this->inResult[i] = 1;
-	      this->inResult[j] = 1;
-	      totalIntersections++;
-	      this->BooleanObject->DeepCopy(boolean->GetOutput());
-	      if (this->PassInfoAsGlobal)
-		this->PostSetGlobalArrays(totalIntersections);
-
-	      checkInputArray2->InsertNextId(j);
-	      for (int k = 0;k < numInputs; k++)
-		{
-		this->IntersectionTable[k][j] = -1;
-		}
-	    }
-          }
+    vtkSVUnionFunctor unioner;
+    unioner.Clusters  = &clusters;
+    unioner.Pairs     = &pairs;
+    unioner.Tolerance = this->Tolerance;
+    if (this->ParallelUnion)
+      vtkSMPTools::For(0, pairs.size(), 1, unioner);
+    else
+      unioner(0, pairs.size());
+
+    for (size_t p = 0; p < pairs.size(); p++)
+      {
+      int c0 = pairs[p].Clusters[0];
+      int c1 = pairs[p].Clusters[1];
+      if (pairs[p].Status != 1)
+        {
+        return SV_ERROR;
         }
-        //this->PrintTable(numInputs);
+
+      //Objects actually don't intersect
+      if (!pairs[p].Intersects)
+        {
+        std::cout<<"NO INTERSECTION FOR OBJECTS "<<clusters[c0].Members[0]<<
+          " AND "<<clusters[c1].Members[0]<<endl;
+        noIntersection.insert(std::make_pair(c0, c1));
+        continue;
+        }
+
+      if (this->PassInfoAsGlobal)
+        this->PostSetGlobalArrays(pairs[p].Output);
+
+      vtkSVUnionCluster merged;
+      merged.Surface = pairs[p].Output;
+      merged.Members = clusters[c0].Members;
+      merged.Members.insert(merged.Members.end(),
+        clusters[c1].Members.begin(), clusters[c1].Members.end());
+      std::sort(merged.Members.begin(), merged.Members.end());
+
+      int newCluster = clusters.size();
+      for (size_t m = 0; m < merged.Members.size(); m++)
+        clusterOf[merged.Members[m]] = newCluster;
+      clusters[c0].Surface = vtkSmartPointer<vtkPolyData>();
+      clusters[c1].Surface = vtkSmartPointer<vtkPolyData>();
+      alive[c0] = alive[c1] = 0;
+      clusters.push_back(merged);
+      alive.push_back(1);
       }
-      tmp = checkInputArray;
-      checkInputArray = checkInputArray2;
-      checkInputArray2 = tmp;
-      tmp->Reset();
     }
+
+  // Order the remaining clusters by their first input
+  std::vector<std::pair<int, int> > order;
+  for (size_t c = 0; c < clusters.size(); c++)
+    {
+    if (alive[c])
+      order.push_back(std::make_pair(clusters[c].Members[0], (int) c));
+    }
+  std::sort(order.begin(), order.end());
+
+  results.clear();
+  for (size_t c = 0; c < order.size(); c++)
+    results.push_back(clusters[order[c].second].Surface);
+
   return SV_OK;
 }
 
@@ -326,67 +435,52 @@ void vtkSVMultiplePolyDataIntersectionFilter::PreSetGlobalArrays(
 // ----------------------
 // PostSetGlobalArrays
 // ----------------------
+/// \details Both sides of a union carry the global arrays, so the new
+/// boundary is or-ed into the global boundary of the output.
 void vtkSVMultiplePolyDataIntersectionFilter::PostSetGlobalArrays(
-    int numIntersections)
+    vtkPolyData *output)
 {
   //std::cout<<"Passing Data"<<endl;
-  if (numIntersections == 1)
+  vtkIntArray *currentPointArray = vtkIntArray::SafeDownCast(
+      output->GetPointData()->GetArray("BoundaryPoints"));
+  vtkIntArray *globalPointArray = vtkIntArray::SafeDownCast(
+      output->GetPointData()->GetArray("GlobalBoundaryPoints"));
+  vtkIntArray *currentCellArray = vtkIntArray::SafeDownCast(
+      output->GetCellData()->GetArray("BoundaryCells"));
+  vtkIntArray *globalCellArray = vtkIntArray::SafeDownCast(
+      output->GetCellData()->GetArray("GlobalBoundaryCells"));
+  if (currentPointArray == nullptr || currentCellArray == nullptr)
   {
-    vtkNew(vtkIntArray, currentPointArray);
-    vtkNew(vtkIntArray, currentCellArray);
-    currentPointArray = vtkIntArray::SafeDownCast(
-	this->BooleanObject->GetPointData()->GetArray("BoundaryPoints"));
-    currentCellArray = vtkIntArray::SafeDownCast(
-	this->BooleanObject->GetCellData()->GetArray("BoundaryCells"));
-
-    currentPointArray->SetName("GlobalBoundaryPoints");
-    this->BooleanObject->GetPointData()->AddArray(currentPointArray);
-    currentCellArray->SetName("GlobalBoundaryCells");
-    this->BooleanObject->GetCellData()->AddArray(currentCellArray);
+    return;
   }
-  else
+
+  vtkNew(vtkIntArray, newPointArray);
+  vtkNew(vtkIntArray, newCellArray);
+
+  int numPts = output->GetNumberOfPoints();
+  int numCells = output->GetNumberOfCells();
+  newPointArray->SetNumberOfTuples(numPts);
+  for (int i = 0; i< numPts; i++)
   {
-    vtkNew(vtkIntArray, currentPointArray);
-    vtkNew(vtkIntArray, globalPointArray);
-    vtkNew(vtkIntArray, newPointArray);
-    vtkNew(vtkIntArray, currentCellArray);
-    vtkNew(vtkIntArray, globalCellArray);
-    vtkNew(vtkIntArray, newCellArray);
-
-    currentPointArray = vtkIntArray::SafeDownCast(
-	this->BooleanObject->GetPointData()->GetArray("BoundaryPoints"));
-    globalPointArray = vtkIntArray::SafeDownCast(
-	this->BooleanObject->GetPointData()->
-	GetArray("GlobalBoundaryPoints"));
-    currentCellArray = vtkIntArray::SafeDownCast(
-	this->BooleanObject->GetCellData()->GetArray("BoundaryCells"));
-    globalCellArray = vtkIntArray::SafeDownCast(
-	this->BooleanObject->GetCellData()->
-	GetArray("GlobalBoundaryCells"));
-
-    int numPts = this->BooleanObject->GetNumberOfPoints();
-    int numCells = this->BooleanObject->GetNumberOfCells();
-    for (int i = 0; i< numPts; i++)
-    {
-      newPointArray->InsertValue(i,0);
-      if (globalPointArray->GetValue(i) == 1 ||
-	  currentPointArray->GetValue(i) == 1)
-	newPointArray->InsertValue(i,1);
-    }
-    this->BooleanObject->GetPointData()->RemoveArray("GlobalBoundaryPoints");
-    newPointArray->SetName("GlobalBoundaryPoints");
-    this->BooleanObject->GetPointData()->AddArray(newPointArray);
-    for (int i = 0; i< numCells; i++)
-    {
-      newCellArray->InsertValue(i,0);
-      if (globalCellArray->GetValue(i) == 1 ||
-	  currentCellArray->GetValue(i) == 1)
-	newCellArray->InsertValue(i,1);
-    }
-    this->BooleanObject->GetCellData()->RemoveArray("GlobalBoundaryCells");
-    newCellArray->SetName("GlobalBoundaryCells");
-    this->BooleanObject->GetCellData()->AddArray(newCellArray);
+    newPointArray->SetValue(i,0);
+    if ((globalPointArray != nullptr && globalPointArray->GetValue(i) == 1) ||
+        currentPointArray->GetValue(i) == 1)
+      newPointArray->SetValue(i,1);
   }
+  output->GetPointData()->RemoveArray("GlobalBoundaryPoints");
+  newPointArray->SetName("GlobalBoundaryPoints");
+  output->GetPointData()->AddArray(newPointArray);
+  newCellArray->SetNumberOfTuples(numCells);
+  for (int i = 0; i< numCells; i++)
+  {
+    newCellArray->SetValue(i,0);
+    if ((globalCellArray != nullptr && globalCellArray->GetValue(i) == 1) ||
+        currentCellArray->GetValue(i) == 1)
+      newCellArray->SetValue(i,1);
+  }
+  output->GetCellData()->RemoveArray("GlobalBoundaryCells");
+  newCellArray->SetName("GlobalBoundaryCells");
+  output->GetCellData()->AddArray(newCellArray);
 }
 
 // ----------------------
@@ -445,12 +539,10 @@ int vtkSVMultiplePolyDataIntersectionFilter::RequestData(
     return SV_OK;
     }
 
-  this->inResult = new int[numInputs];
   this->IntersectionTable = new int*[numInputs];
   vtkPolyData** inputs = new vtkPolyData*[numInputs];
   for (int idx = 0; idx < numInputs; ++idx)
     {
-    this->inResult[idx] = 0;
     inputs[idx] = vtkPolyData::GetData(inputVector[0], idx);
     this->IntersectionTable[idx] = new int[numInputs];
     for (int idy = 0; idy < numInputs; ++idy)
@@ -464,63 +556,41 @@ int vtkSVMultiplePolyDataIntersectionFilter::RequestData(
     vtkGenericWarningMacro( << "No intersections!");
   //this->PrintTable(numInputs);
 
-  this->BooleanObject->DeepCopy(inputs[0]);
-  int retVal = this->ExecuteIntersection(inputs,numInputs,0);
+  std::vector<vtkSmartPointer<vtkPolyData> > results;
+  int retVal = this->ExecuteIntersection(inputs,numInputs,results);
+
+  for (int idx = 0; idx < numInputs; ++idx)
+    {
+      delete [] this->IntersectionTable[idx];
+    }
+  delete [] this->IntersectionTable;
+  this->IntersectionTable = nullptr;
+  delete [] inputs;
+
   if (retVal == 0)
   {
     this->Status = 0;
-    for (int idx = 0; idx < numInputs; ++idx)
-      {
-	delete [] this->IntersectionTable[idx];
-      }
-    delete [] this->inResult;
-    delete [] this->IntersectionTable;
-    delete [] inputs;
     return SV_ERROR;
   }
-  vtkNew(vtkAppendPolyData, appender);
-  vtkNew(vtkPolyData, tmp);
-  if (this->NoIntersectionOutput)
+
+  // The first group always holds input 0
+  if (this->NoIntersectionOutput && results.size() > 1)
   {
-    tmp->DeepCopy(this->BooleanObject);
-    appender->AddInputData(tmp);
-    for (int i = 0; i< numInputs; i++)
+    vtkNew(vtkAppendPolyData, appender);
+    for (size_t i = 0; i < results.size(); i++)
     {
-      if (this->inResult[i] == 0)
-      {
-	//std::cout<<"Adding in!!"<<endl;
-	this->BooleanObject->DeepCopy(inputs[i]);
-	int check = this->ExecuteIntersection(inputs,numInputs,i);
-	if (check == 0)
-	{
-	  this->Status = 0;
-	  for (int idx = 0; idx < numInputs; ++idx)
-	    {
-	      delete [] this->IntersectionTable[idx];
-	    }
-	  delete [] this->inResult;
-	  delete [] this->IntersectionTable;
-	  delete [] inputs;
-	  return SV_ERROR;
-	}
-	vtkNew(vtkPolyData, tmp2);
-	tmp2->DeepCopy(this->BooleanObject);
-        appender->AddInputData(tmp2);
-      }
+      appender->AddInputData(results[i]);
     }
     appender->Update();
-    this->BooleanObject->DeepCopy(appender->GetOutput());
+    this->BooleanObject->ShallowCopy(appender->GetOutput());
+  }
+  else if (!results.empty())
+  {
+    this->BooleanObject->ShallowCopy(results[0]);
   }
 
-  output->DeepCopy(this->BooleanObject);
+  output->ShallowCopy(this->BooleanObject);
 
-  for (int idx = 0; idx < numInputs; ++idx)
-    {
-      delete [] this->IntersectionTable[idx];
-    }
-  delete [] this->inResult;
-  delete [] this->IntersectionTable;
-  delete [] inputs;
   return retVal;
 }
 
@@ -616,6 +686,7 @@ void vtkSVMultiplePolyDataIntersectionFilter::PrintSelf(ostream& os,
   os << "UserManagedInputs:" << (this->UserManagedInputs?"On":"Off") << endl;
   os << "AssignSurfaceIds:" << (this->AssignSurfaceIds?"On":"Off") << endl;
   os << "PassInfoAsGlobal:" << (this->PassInfoAsGlobal?"On":"Off") << endl;
+  os << "ParallelUnion:" << (this->ParallelUnion?"On":"Off") << endl;
 }
 
 // ----------------------
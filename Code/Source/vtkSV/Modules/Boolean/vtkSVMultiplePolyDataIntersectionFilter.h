@@ -46,6 +46,9 @@
 
 #include "vtkPolyData.h"
 #include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+
+#include <vector>
 
 class VTKSVBOOLEAN_EXPORT vtkSVMultiplePolyDataIntersectionFilter : public vtkPolyDataAlgorithm
 {
@@ -139,6 +142,15 @@ public:
   vtkGetMacro(Status, int);
   //@}
 
+  //@{
+  /// \brief Set/get whether independent pairs of objects are unioned
+  /// concurrently. The objects are combined by a pairwise reduction either
+  /// way; with this off the pairs of each round are run one after another.
+  vtkSetMacro(ParallelUnion,int);
+  vtkGetMacro(ParallelUnion,int);
+  vtkBooleanMacro(ParallelUnion,int);
+  //@}
+
   //@{
   /// \brief tolerance for geometric tests
   vtkGetMacro(Tolerance, double);
@@ -164,20 +176,24 @@ protected:
   int NoIntersectionOutput;
   int PassInfoAsGlobal;
   int AssignSurfaceIds;
+  int ParallelUnion;
 
   int **IntersectionTable;
-  int *inResult;
   vtkPolyData *BooleanObject;
   int Status;
   double Tolerance;
 
   //Function to build the table defining where intersections occur.
   int BuildIntersectionTable(vtkPolyData* inputs[], int numInputs);
-  //Function to run the intersection on intersecting polydatas
-  int ExecuteIntersection(vtkPolyData *inputs[],int numInputs,int start);
+  //Function to run the intersection on intersecting polydatas. Groups of
+  //objects whose bounding boxes intersect are unioned pairwise, round by
+  //round, until no more pairs intersect. The resulting groups are
+  //returned ordered by their lowest input index.
+  int ExecuteIntersection(vtkPolyData *inputs[],int numInputs,
+                          std::vector<vtkSmartPointer<vtkPolyData> > &results);
   //Function to set the boundary point information as global information
   void PreSetGlobalArrays(vtkPolyData *input);
-  void PostSetGlobalArrays(int numIntersections);
+  void PostSetGlobalArrays(vtkPolyData *output);
   //Function to set surface id
   void SetSurfaceId(vtkPolyData *input,int surfaceid);
 
@@ -36,12 +36,171 @@
 #include "vtkDoubleArray.h"
 #include "vtkErrorCode.h"
 #include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include "vtkSVGlobals.h"
 #include "vtkSVGeneralUtils.h"
 
+#include <unordered_map>
+
+// ----------------------
+// Anonymous namespace
+// ----------------------
+namespace
+{
+/// \brief Key of the edge between two points, independent of their order
+inline long long vtkSVThinnerEdgeKey(vtkIdType ptId0, vtkIdType ptId1, vtkIdType numPts)
+{
+  if (ptId0 > ptId1)
+    std::swap(ptId0, ptId1);
+  return static_cast<long long>(ptId0)*numPts + ptId1;
+}
+
+/// \brief Marks the edges of the edge pd that end at a point with no other
+/// remaining edge. Reads only the state of the previous layer.
+struct vtkSVThinnerEdgeFunctor
+{
+  int NumberOfEdgeCells;
+  const int *EdgeCellNumPts;
+  const int *EdgeCellPoints;
+  const int *EdgePointOffsets;
+  const int *EdgePointCells;
+  const unsigned char *DeletedEdge;
+  const unsigned char *PreserveEdge;
+  unsigned char *RemoveEdge;
+
+  int NumberOfRemainingEdges(int ptId) const
+  {
+    int numNotDeleted = 0;
+    for (int j=this->EdgePointOffsets[ptId]; j<this->EdgePointOffsets[ptId+1]; j++)
+    {
+      if (!this->DeletedEdge[this->EdgePointCells[j]])
+        numNotDeleted++;
+    }
+    return numNotDeleted;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      this->RemoveEdge[i] = 0;
+      if (this->DeletedEdge[i] || this->EdgeCellNumPts[i] != 2 || this->PreserveEdge[i])
+        continue;
+
+      if (this->NumberOfRemainingEdges(this->EdgeCellPoints[2*i]) == 1 ||
+          this->NumberOfRemainingEdges(this->EdgeCellPoints[2*i+1]) == 1)
+        this->RemoveEdge[i] = 1;
+    }
+  }
+};
+
+/// \brief Finds the triangles with at least one open edge, an edge whose
+/// other triangles are all deleted, and the edge to remove with them.
+struct vtkSVThinnerTriangleFunctor
+{
+  const int *TriEdges;
+  const int *EdgeTriOffsets;
+  const int *EdgeTriIds;
+  const unsigned char *DeletedCell;
+  int *RemoveTriEdge;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      this->RemoveTriEdge[i] = -1;
+      if (this->DeletedCell[i])
+        continue;
+
+      int isOpen[3];
+      int numOpen = 0;
+      for (int j=0; j<3; j++)
+      {
+        int triEdge = this->TriEdges[3*i+j];
+        int numNeighbors = 0;
+        int numDeletedNeighbors = 0;
+        for (int k=this->EdgeTriOffsets[triEdge]; k<this->EdgeTriOffsets[triEdge+1]; k++)
+        {
+          int neighborId = this->EdgeTriIds[k];
+          if (neighborId == i)
+            continue;
+          numNeighbors++;
+          if (this->DeletedCell[neighborId])
+            numDeletedNeighbors++;
+        }
+        isOpen[j] = numDeletedNeighbors == numNeighbors;
+        numOpen += isOpen[j];
+      }
+
+      // Local edge j goes from point j to point j+1
+      int loc = -1;
+      if (numOpen == 3)
+        loc = 0;
+      else if (numOpen == 2)
+      {
+        for (int j=0; j<3; j++)
+        {
+          if (!isOpen[j])
+            loc = (j+2)%3;
+        }
+      }
+      else if (numOpen == 1)
+      {
+        for (int j=0; j<3; j++)
+        {
+          if (isOpen[j])
+            loc = j;
+        }
+      }
+
+      if (loc != -1)
+        this->RemoveTriEdge[i] = this->TriEdges[3*i+loc];
+    }
+  }
+};
+
+/// \brief Finds the edges whose triangles have all been deleted
+struct vtkSVThinnerIsolatedFunctor
+{
+  const int *TriEdgeOfEdgeCell;
+  const int *EdgeCellNumPts;
+  const int *EdgeTriOffsets;
+  const int *EdgeTriIds;
+  const unsigned char *DeletedCell;
+  const int *EdgeIsolatedIter;
+  unsigned char *Isolated;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      this->Isolated[i] = 0;
+      if (this->EdgeIsolatedIter[i] != -1 || this->EdgeCellNumPts[i] != 2)
+        continue;
+
+      int triEdge = this->TriEdgeOfEdgeCell[i];
+      int isolated = 1;
+      if (triEdge != -1)
+      {
+        for (int k=this->EdgeTriOffsets[triEdge]; k<this->EdgeTriOffsets[triEdge+1]; k++)
+        {
+          if (!this->DeletedCell[this->EdgeTriIds[k]])
+          {
+            isolated = 0;
+            break;
+          }
+        }
+      }
+      this->Isolated[i] = isolated;
+    }
+  }
+};
+}
+
 // ----------------------
 // StandardNewMacro
 // ----------------------
@@ -92,7 +251,8 @@ int vtkSVCellComplexThinner::RequestData(
   vtkPolyData *input = vtkPolyData::GetData(inputVector[0]);
   vtkPolyData *output = vtkPolyData::GetData(outputVector);
 
-  this->WorkTriPd->DeepCopy(input);
+  // Arrays are only added to the work copies, the input is not modified
+  this->WorkTriPd->ShallowCopy(input);
 
   // Prep work for filter
   if (this->PrepFilter() != SV_OK)
@@ -110,8 +270,8 @@ int vtkSVCellComplexThinner::RequestData(
     return SV_ERROR;
   }
 
-  output->DeepCopy(this->WorkTriPd);
-  this->OutputEdgePd->DeepCopy(this->WorkEdgePd);
+  output->ShallowCopy(this->WorkTriPd);
+  this->OutputEdgePd->ShallowCopy(this->WorkEdgePd);
 
   return SV_OK;
 }
@@ -123,7 +283,7 @@ int vtkSVCellComplexThinner::PrepFilter()
 {
   if (this->InputEdgePd != nullptr)
   {
-    this->WorkEdgePd->DeepCopy(this->InputEdgePd);
+    this->WorkEdgePd->ShallowCopy(this->InputEdgePd);
   }
   else
   {
@@ -156,372 +316,203 @@ int vtkSVCellComplexThinner::PrepFilter()
 // ----------------------
 int vtkSVCellComplexThinner::RunFilter()
 {
-  int dontTouch = 0;
-  if (this->PreserveEdgeCellsArrayName)
-    dontTouch = 1;
-
   int numTriCells  = this->WorkTriPd->GetNumberOfCells();
   int numTriPts    = this->WorkTriPd->GetNumberOfPoints();
   int numEdgeCells = this->WorkEdgePd->GetNumberOfCells();
   int numEdgePts   = this->WorkEdgePd->GetNumberOfPoints();
 
-  std::vector<int> deletedCell(numTriCells, 0);
-  std::vector<int> deletedEdge(numEdgeCells, 0);
-
-  vtkNew(vtkIntArray, edgeRemoveIterArray);
-  edgeRemoveIterArray->SetNumberOfTuples(numEdgeCells);
-  edgeRemoveIterArray->FillComponent(0, -1);
-  edgeRemoveIterArray->SetName("RemovalIteration");
-
-  vtkNew(vtkIntArray, edgeIsolatedIterArray);
-  edgeIsolatedIterArray->SetNumberOfTuples(numEdgeCells);
-  edgeIsolatedIterArray->FillComponent(0, -1);
-  edgeIsolatedIterArray->SetName("IsolatedIteration");
-
-  vtkNew(vtkIntArray, endIsolatedIterArray);
-  endIsolatedIterArray->SetNumberOfTuples(numEdgeCells);
-  endIsolatedIterArray->FillComponent(0, -1);
-  endIsolatedIterArray->SetName("IsolatedIteration");
-
-  vtkNew(vtkIntArray, removeIterArray);
-  removeIterArray->SetNumberOfTuples(numTriCells);
-  removeIterArray->FillComponent(0, -1);
-  removeIterArray->SetName("RemovalIteration");
-
-  int iter = 0;
-  int nDelTris = 0;
-  int nDelEdges = 0;
-  int nIsolated = 0;
-
-  vtkNew(vtkIdList, ptCellIds);
-  vtkNew(vtkIdList, openEdges);
-  vtkNew(vtkIdList, cellNeighborIds);
-  vtkNew(vtkIdList, pointIds);
-  vtkNew(vtkIdList, edgeCell);
-  vtkNew(vtkIdList, edgeCellIds);
-
-  std::vector<int> tmpDeletedCells;
-  std::vector<int> tmpDeletedEdges;
-
   vtkIdType npts;
   const vtkIdType *pts;
 
-  int loc;
-  int ptId0;
-  int ptId1;
-  int ptId2;
-  int cellId;
-  int delEdge;
-  int isMedEdge;
-  int numDeletedNeighbors     = 0;
-  int numNotDeletedNeighbors  = 0;
-  int numNotDeletedNeighbors0 = 0;
-  int numNotDeletedNeighbors1 = 0;
-
-  // Set up connectivity matrices for tri pd
-  std::vector<std::vector<int> > triCellPoints(numTriCells);
+  // --------------------------------------------------------------
+  // Number the edges of the triangles, an edge is keyed by its two points
+  std::unordered_map<long long, int> edgeKeyIds;
+  std::vector<int> triEdges(3*numTriCells, -1);
+  int numTriEdges = 0;
   for (int i=0; i<numTriCells; i++)
   {
     this->WorkTriPd->GetCellPoints(i, npts, pts);
-    for (int j=0; j<npts; j++)
-      triCellPoints[i].push_back(pts[j]);
+    for (int j=0; j<3; j++)
+    {
+      long long key = vtkSVThinnerEdgeKey(pts[j], pts[(j+1)%3], numTriPts);
+      std::pair<std::unordered_map<long long, int>::iterator, bool> inserted =
+        edgeKeyIds.insert(std::make_pair(key, numTriEdges));
+      if (inserted.second)
+        numTriEdges++;
+      triEdges[3*i+j] = inserted.first->second;
+    }
   }
 
-  // Set up connectivity matrices for edge pd
-  std::vector<std::vector<int> > edgeCellPoints(numEdgeCells);
-  std::vector<std::vector<int> > edgePointCells(numEdgePts);
+  // Triangles of each edge in compressed rows
+  std::vector<int> edgeTriOffsets(numTriEdges+1, 0);
+  for (int i=0; i<3*numTriCells; i++)
+    edgeTriOffsets[triEdges[i]+1]++;
+  for (int i=0; i<numTriEdges; i++)
+    edgeTriOffsets[i+1] += edgeTriOffsets[i];
+  std::vector<int> edgeTriIds(edgeTriOffsets[numTriEdges]);
+  std::vector<int> edgeTriFill(edgeTriOffsets.begin(), edgeTriOffsets.end()-1);
+  for (int i=0; i<3*numTriCells; i++)
+    edgeTriIds[edgeTriFill[triEdges[i]]++] = i/3;
+
+  // Match the triangle edges with the cells of the edge pd
+  std::vector<int> edgeCellOfTriEdge(numTriEdges, -1);
+  std::vector<int> numEdgeCellsOfTriEdge(numTriEdges, 0);
+  std::vector<int> triEdgeOfEdgeCell(numEdgeCells, -1);
+  std::vector<int> edgeCellNumPts(numEdgeCells);
+  std::vector<int> edgePointOffsets(numEdgePts+1, 0);
   for (int i=0; i<numEdgeCells; i++)
   {
     this->WorkEdgePd->GetCellPoints(i, npts, pts);
+    edgeCellNumPts[i] = npts;
     for (int j=0; j<npts; j++)
-      edgeCellPoints[i].push_back(pts[j]);
+      edgePointOffsets[pts[j]+1]++;
+    if (npts != 2)
+      continue;
+
+    std::unordered_map<long long, int>::iterator it =
+      edgeKeyIds.find(vtkSVThinnerEdgeKey(pts[0], pts[1], numTriPts));
+    if (it != edgeKeyIds.end())
+    {
+      triEdgeOfEdgeCell[i] = it->second;
+      edgeCellOfTriEdge[it->second] = i;
+      numEdgeCellsOfTriEdge[it->second]++;
+    }
   }
 
+  // Cells of the edge pd attached to each point, in compressed rows
   for (int i=0; i<numEdgePts; i++)
+    edgePointOffsets[i+1] += edgePointOffsets[i];
+  std::vector<int> edgeCellPoints(2*numEdgeCells, -1);
+  std::vector<int> edgePointCells(edgePointOffsets[numEdgePts]);
+  std::vector<int> edgePointFill(edgePointOffsets.begin(), edgePointOffsets.end()-1);
+  for (int i=0; i<numEdgeCells; i++)
   {
-    this->WorkEdgePd->GetPointCells(i, ptCellIds);
-    for (int j=0; j<ptCellIds->GetNumberOfIds(); j++)
-      edgePointCells[i].push_back(ptCellIds->GetId(j));
+    this->WorkEdgePd->GetCellPoints(i, npts, pts);
+    for (int j=0; j<npts; j++)
+    {
+      edgePointCells[edgePointFill[pts[j]]++] = i;
+      if (j < 2)
+        edgeCellPoints[2*i+j] = pts[j];
+    }
   }
 
+  std::vector<unsigned char> preserveEdge(numEdgeCells, 0);
+  if (this->PreserveEdgeCellsArrayName)
+  {
+    vtkDataArray *preserveArray = this->WorkEdgePd->GetCellData()->GetArray(this->PreserveEdgeCellsArrayName);
+    for (int i=0; i<numEdgeCells; i++)
+      preserveEdge[i] = static_cast<int>(preserveArray->GetTuple1(i)) == 1;
+  }
+  // --------------------------------------------------------------
+
+  std::vector<unsigned char> deletedCell(numTriCells, 0);
+  std::vector<unsigned char> deletedEdge(numEdgeCells, 0);
+
+  std::vector<int> removeIter(numTriCells, -1);
+  std::vector<int> edgeRemoveIter(numEdgeCells, -1);
+  std::vector<int> edgeIsolatedIter(numEdgeCells, -1);
+
+  // Per layer decisions, each filled in parallel from the previous layer
+  std::vector<unsigned char> removeEdgeNow(numEdgeCells, 0);
+  std::vector<unsigned char> isolatedNow(numEdgeCells, 0);
+  std::vector<int> removeTriEdgeNow(numTriCells, -1);
+
+  vtkSVThinnerEdgeFunctor edgeRemover;
+  edgeRemover.NumberOfEdgeCells = numEdgeCells;
+  edgeRemover.EdgeCellNumPts    = edgeCellNumPts.data();
+  edgeRemover.EdgeCellPoints    = edgeCellPoints.data();
+  edgeRemover.EdgePointOffsets  = edgePointOffsets.data();
+  edgeRemover.EdgePointCells    = edgePointCells.data();
+  edgeRemover.DeletedEdge       = deletedEdge.data();
+  edgeRemover.PreserveEdge      = preserveEdge.data();
+  edgeRemover.RemoveEdge        = removeEdgeNow.data();
+
+  vtkSVThinnerTriangleFunctor triRemover;
+  triRemover.TriEdges       = triEdges.data();
+  triRemover.EdgeTriOffsets = edgeTriOffsets.data();
+  triRemover.EdgeTriIds     = edgeTriIds.data();
+  triRemover.DeletedCell    = deletedCell.data();
+  triRemover.RemoveTriEdge  = removeTriEdgeNow.data();
+
+  vtkSVThinnerIsolatedFunctor isolator;
+  isolator.TriEdgeOfEdgeCell = triEdgeOfEdgeCell.data();
+  isolator.EdgeCellNumPts    = edgeCellNumPts.data();
+  isolator.EdgeTriOffsets    = edgeTriOffsets.data();
+  isolator.EdgeTriIds        = edgeTriIds.data();
+  isolator.DeletedCell       = deletedCell.data();
+  isolator.EdgeIsolatedIter  = edgeIsolatedIter.data();
+  isolator.Isolated          = isolatedNow.data();
+
+  int iter = 0;
+  int nDelTris = 0;
+  int nDelEdges = 0;
+  int nIsolated = 0;
+
   while ( nDelTris > 0 || nDelEdges > 0 || iter == 0 )
   {
-    tmpDeletedCells.clear();
-    tmpDeletedEdges.clear();
     // --------------------------------------------------------------
-    // Do edges before
+    // Find the removable edges and triangles of this layer
+    vtkSMPTools::For(0, numEdgeCells, edgeRemover);
+    vtkSMPTools::For(0, numTriCells, triRemover);
+
+    // Remove them in one batch
     nDelEdges = 0;
     for (int i=0; i<numEdgeCells; i++)
     {
-      if (!deletedEdge[i])
+      if (removeEdgeNow[i])
       {
-        npts = edgeCellPoints[i].size();
-
-        if (npts == 2)
-        {
-          ptId0 = edgeCellPoints[i][0];
-          ptId1 = edgeCellPoints[i][1];
-
-          numNotDeletedNeighbors0 = 0;
-          numNotDeletedNeighbors1 = 0;
-          for (int j=0; j<edgePointCells[ptId0].size(); j++)
-          {
-            cellId = edgePointCells[ptId0][j];
-            if (!deletedEdge[cellId])
-              numNotDeletedNeighbors0++;
-          }
-          for (int j=0; j<edgePointCells[ptId1].size(); j++)
-          {
-            cellId = edgePointCells[ptId1][j];
-            if (!deletedEdge[cellId])
-              numNotDeletedNeighbors1++;
-          }
-
-          if (numNotDeletedNeighbors0 == 1 ||
-              numNotDeletedNeighbors1 == 1)
-          {
-            delEdge = 1;
-            if (dontTouch)
-            {
-              isMedEdge = this->WorkEdgePd->GetCellData()->GetArray(this->PreserveEdgeCellsArrayName)->GetTuple1(i);
-              if (isMedEdge == 1)
-              {
-                delEdge = 0;
-              }
-            }
-
-            if (delEdge)
-            {
-              nDelEdges++;
-              tmpDeletedEdges.push_back(i);
-              edgeRemoveIterArray->SetTuple1(i, iter);
-            }
-          }
-
-        }
+        nDelEdges++;
+        edgeRemoveIter[i] = iter;
       }
     }
-    // --------------------------------------------------------------
-    nDelTris = 0;
 
+    nDelTris = 0;
     for (int i=0; i<numTriCells; i++)
     {
-      if (!deletedCell[i])
-      {
-        npts = triCellPoints[i].size();
+      int triEdge = removeTriEdgeNow[i];
+      if (triEdge == -1)
+        continue;
 
-        if (npts == 3)
-        {
-          openEdges->Reset();
-          for (int j=0; j<npts; j++)
-          {
-            ptId0 = triCellPoints[i][j];
-            ptId1 = triCellPoints[i][(j+1)%npts];
-
-            this->WorkTriPd->GetCellEdgeNeighbors(i, ptId0, ptId1, cellNeighborIds);
-
-            if (cellNeighborIds->GetNumberOfIds() == 0)
-              openEdges->InsertNextId(j);
-            else
-            {
-              numDeletedNeighbors = 0;
-              for (int k=0; k<cellNeighborIds->GetNumberOfIds(); k++)
-              {
-                if (deletedCell[cellNeighborIds->GetId(k)])
-                  numDeletedNeighbors++;
-              }
-              if (numDeletedNeighbors == cellNeighborIds->GetNumberOfIds())
-                openEdges->InsertNextId(j);
-            }
-          }
-          if (openEdges->GetNumberOfIds() == 3)
-          {
-            nDelTris++;
-            tmpDeletedCells.push_back(i);
-            removeIterArray->SetTuple1(i, iter);
-
-            // --------------------------------------------------------------
-            // Remove on edge pd
-            ptId0 = triCellPoints[i][0];
-            ptId1 = triCellPoints[i][1];
-
-            pointIds->Reset();
-            pointIds->SetNumberOfIds(2);
-            pointIds->SetId(0, ptId0);
-            pointIds->SetId(1, ptId1);
-
-            this->WorkEdgePd->GetCellNeighbors(-1, pointIds, edgeCell);
-
-            if (edgeCell->GetNumberOfIds() != 1)
-            {
-              vtkWarningMacro("Number of cells is not 1, it is " << edgeCell->GetNumberOfIds());
-            }
-            else
-            {
-              delEdge = 1;
-              if (dontTouch)
-              {
-                isMedEdge = this->WorkEdgePd->GetCellData()->GetArray(this->PreserveEdgeCellsArrayName)->GetTuple1(edgeCell->GetId(0));
-                if (isMedEdge == 1)
-                {
-                  delEdge = 0;
-                }
-              }
-
-              if (delEdge)
-              {
-                nDelEdges++;
-                tmpDeletedEdges.push_back(edgeCell->GetId(0));
-                edgeRemoveIterArray->SetTuple1(edgeCell->GetId(0), iter);
-              }
-            }
-
-            // --------------------------------------------------------------
-          }
-          else if (openEdges->GetNumberOfIds() == 2)
-          {
-            nDelTris++;
-            for (int j=0; j<npts; j++)
-            {
-              if (j != openEdges->GetId(0) && j != openEdges->GetId(1))
-                loc = j;
-            }
-
-            ptId0 = triCellPoints[i][loc];
-            ptId1 = triCellPoints[i][(loc+1)%npts];
-            ptId2 = triCellPoints[i][(loc+2)%npts];
-
-            tmpDeletedCells.push_back(i);
-            removeIterArray->SetTuple1(i, iter);
-
-            // --------------------------------------------------------------
-            // Remove on edge pd
-            pointIds->Reset();
-            pointIds->SetNumberOfIds(2);
-            pointIds->SetId(0, ptId0);
-            pointIds->SetId(1, ptId2);
-
-            this->WorkEdgePd->GetCellNeighbors(-1, pointIds, edgeCell);
-
-            if (edgeCell->GetNumberOfIds() != 1)
-            {
-              vtkWarningMacro("Number of cells is not 1, it is " << edgeCell->GetNumberOfIds());
-            }
-            else
-            {
-              delEdge = 1;
-              if (dontTouch)
-              {
-                isMedEdge = this->WorkEdgePd->GetCellData()->GetArray(this->PreserveEdgeCellsArrayName)->GetTuple1(edgeCell->GetId(0));
-                if (isMedEdge == 1)
-                {
-                  delEdge = 0;
-                }
-              }
-
-              if (delEdge)
-              {
-                nDelEdges++;
-                tmpDeletedEdges.push_back(edgeCell->GetId(0));
-                edgeRemoveIterArray->SetTuple1(edgeCell->GetId(0), iter);
-              }
-            }
-
-
-            // --------------------------------------------------------------
-          }
-          else if (openEdges->GetNumberOfIds() == 1)
-          {
-            nDelTris++;
-            loc = openEdges->GetId(0);
-
-            ptId0 = triCellPoints[i][loc];
-            ptId1 = triCellPoints[i][(loc+1)%npts];
-            ptId2 = triCellPoints[i][(loc+2)%npts];
-
-            tmpDeletedCells.push_back(i);
-            removeIterArray->SetTuple1(i, iter);
-
-            // --------------------------------------------------------------
-            // Remove on edge pd
-            pointIds->Reset();
-            pointIds->SetNumberOfIds(2);
-            pointIds->SetId(0, ptId0);
-            pointIds->SetId(1, ptId1);
-
-            this->WorkEdgePd->GetCellNeighbors(-1, pointIds, edgeCell);
-
-            if (edgeCell->GetNumberOfIds() != 1)
-            {
-              vtkWarningMacro("Number of cells is not 1, it is " << edgeCell->GetNumberOfIds());
-            }
-            else
-            {
-              delEdge = 1;
-              if (dontTouch)
-              {
-                isMedEdge = this->WorkEdgePd->GetCellData()->GetArray(this->PreserveEdgeCellsArrayName)->GetTuple1(edgeCell->GetId(0));
-                if (isMedEdge == 1)
-                {
-                  delEdge = 0;
-                }
-              }
-
-              if (delEdge)
-              {
-                nDelEdges++;
-                tmpDeletedEdges.push_back(edgeCell->GetId(0));
-                edgeRemoveIterArray->SetTuple1(edgeCell->GetId(0), iter);
-              }
-            }
-
-            // --------------------------------------------------------------
-          }
-        }
+      nDelTris++;
+      removeIter[i] = iter;
+
+      // Remove on edge pd
+      if (numEdgeCellsOfTriEdge[triEdge] != 1)
+      {
+        vtkWarningMacro("Number of cells is not 1, it is " << numEdgeCellsOfTriEdge[triEdge]);
+      }
+      else if (!preserveEdge[edgeCellOfTriEdge[triEdge]])
+      {
+        nDelEdges++;
+        removeEdgeNow[edgeCellOfTriEdge[triEdge]] = 1;
+        edgeRemoveIter[edgeCellOfTriEdge[triEdge]] = iter;
       }
     }
     vtkDebugMacro("Iteration " << iter << ", Number of triangles removed: " << nDelTris << ", Number of edges removed: " << nDelEdges);
 
-    for (int i=0; i<tmpDeletedCells.size(); i++)
-      deletedCell[tmpDeletedCells[i]] = 1;
-    for (int i=0; i<tmpDeletedEdges.size(); i++)
-      deletedEdge[tmpDeletedEdges[i]] = 1;
+    for (int i=0; i<numTriCells; i++)
+    {
+      if (removeTriEdgeNow[i] != -1)
+        deletedCell[i] = 1;
+    }
+    for (int i=0; i<numEdgeCells; i++)
+    {
+      if (removeEdgeNow[i])
+        deletedEdge[i] = 1;
+    }
+    // --------------------------------------------------------------
 
     // --------------------------------------------------------------
     // Now add to edge isolated list
     if (nIsolated != numEdgeCells)
     {
+      vtkSMPTools::For(0, numEdgeCells, isolator);
       for (int i=0; i<numEdgeCells; i++)
       {
-        int currVal = edgeIsolatedIterArray->GetTuple1(i);
-
-        if (currVal == -1)
+        if (isolatedNow[i])
         {
-          npts = edgeCellPoints[i].size();
-
-          if (npts == 2)
-          {
-            pointIds->Reset();
-            pointIds->SetNumberOfIds(2);
-            pointIds->SetId(0, edgeCellPoints[i][0]);
-            pointIds->SetId(1, edgeCellPoints[i][1]);
-
-            this->WorkTriPd->GetCellNeighbors(-1, pointIds, edgeCellIds);
-
-            numDeletedNeighbors = 0;
-            for (int j=0; j<edgeCellIds->GetNumberOfIds(); j++)
-            {
-              if (deletedCell[edgeCellIds->GetId(j)])
-                numDeletedNeighbors++;
-            }
-
-            if (numDeletedNeighbors == edgeCellIds->GetNumberOfIds())
-            {
-              endIsolatedIterArray->SetTuple1(i, iter);
-              edgeIsolatedIterArray->SetTuple1(i, iter);
-              nIsolated++;
-            }
-          }
+          edgeIsolatedIter[i] = iter;
+          nIsolated++;
         }
       }
     }
@@ -530,44 +521,46 @@ int vtkSVCellComplexThinner::RunFilter()
     iter++;
   }
 
+  vtkNew(vtkIntArray, removeIterArray);
+  removeIterArray->SetNumberOfTuples(numTriCells);
+  removeIterArray->SetName("RemovalIteration");
+  for (int i=0; i<numTriCells; i++)
+    removeIterArray->SetValue(i, removeIter[i]);
+
   this->WorkTriPd->GetCellData()->AddArray(removeIterArray);
 
-  this->WorkEdgePd->GetCellData()->AddArray(edgeRemoveIterArray);
-  this->WorkEdgePd->GetCellData()->AddArray(endIsolatedIterArray);
+  vtkNew(vtkIntArray, edgeRemoveIterArray);
+  edgeRemoveIterArray->SetNumberOfTuples(numEdgeCells);
+  edgeRemoveIterArray->SetName("RemovalIteration");
+
+  vtkNew(vtkIntArray, endIsolatedIterArray);
+  endIsolatedIterArray->SetNumberOfTuples(numEdgeCells);
+  endIsolatedIterArray->SetName("IsolatedIteration");
 
   vtkNew(vtkIntArray, mAbsArray);
   mAbsArray->SetNumberOfTuples(numEdgeCells);
-  mAbsArray->FillComponent(0, -1);
   mAbsArray->SetName("MAbs");
 
   vtkNew(vtkDoubleArray, mRelArray);
   mRelArray->SetNumberOfTuples(numEdgeCells);
-  mRelArray->FillComponent(0, -1.0);
   mRelArray->SetName("MRel");
 
   for (int i=0; i<numEdgeCells; i++)
   {
-    double currIVal = endIsolatedIterArray->GetTuple1(i);
-    double edgeRVal = edgeRemoveIterArray->GetTuple1(i);
-
-    if (currIVal == -1)
-      endIsolatedIterArray->SetTuple1(i, 0);
-    if (edgeRVal == -1)
-      edgeRemoveIterArray->SetTuple1(i, iter);
-  }
-
-  for (int i=0; i<numEdgeCells; i++)
-  {
-    double iVal = endIsolatedIterArray->GetTuple1(i);
-    double rVal = edgeRemoveIterArray->GetTuple1(i);
+    double iVal = edgeIsolatedIter[i] == -1 ? 0 : edgeIsolatedIter[i];
+    double rVal = edgeRemoveIter[i] == -1 ? iter : edgeRemoveIter[i];
 
     int mAbsVal = rVal - iVal;
     double mRelVal = 1.0 - ((iVal+1)/(rVal+1));
 
-    mAbsArray->SetTuple1(i, mAbsVal);
-    mRelArray->SetTuple1(i, mRelVal);
+    endIsolatedIterArray->SetValue(i, iVal);
+    edgeRemoveIterArray->SetValue(i, rVal);
+    mAbsArray->SetValue(i, mAbsVal);
+    mRelArray->SetValue(i, mRelVal);
   }
 
+  this->WorkEdgePd->GetCellData()->AddArray(edgeRemoveIterArray);
+  this->WorkEdgePd->GetCellData()->AddArray(endIsolatedIterArray);
   this->WorkEdgePd->GetCellData()->AddArray(mAbsArray);
   this->WorkEdgePd->GetCellData()->AddArray(mRelArray);
 
@@ -31,7 +31,6 @@
 
 #include "vtkSVHausdorffDistance.h"
 
-#include "vtkCellLocator.h"
 #include "vtkDoubleArray.h"
 #include "vtkErrorCode.h"
 #include "vtkGenericCell.h"
@@ -41,12 +40,73 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkVersion.h"
 
 #include "vtkSVGeneralUtils.h"
 #include "vtkSVMathUtils.h"
 #include "vtkSVGlobals.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <vector>
+
+// ----------------------
+// Distance functor
+// ----------------------
+namespace
+{
+/// \brief Closest distance from each point to the locator surface. Each
+/// thread uses its own generic cell for the locator queries.
+class vtkSVClosestDistanceFunctor
+{
+public:
+  vtkPoints *Points;
+  vtkAbstractCellLocator *Locator;
+  double *Distances;
+
+  double Threshold;
+  int StopAtThreshold;
+  std::atomic<int> *Stopped;
+
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *genericCell = this->Cell.Local();
+
+    double pt[3], closestPt[3];
+    vtkIdType closestCell;
+    int subId;
+    double dist2;
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      if (this->StopAtThreshold && this->Stopped->load())
+        return;
+
+      this->Points->GetPoint(i, pt);
+      this->Locator->FindClosestPoint(pt, closestPt, genericCell, closestCell,
+                                      subId, dist2);
+      this->Distances[i] = sqrt(dist2);
+
+      if (this->StopAtThreshold && this->Distances[i] > this->Threshold)
+        this->Stopped->store(1);
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+}
 
 // ----------------------
 // StandardNewMacro
@@ -65,8 +125,16 @@ vtkSVHausdorffDistance::vtkSVHausdorffDistance()
 
   this->DistanceArrayName = nullptr;
 
-  this->AverageDistance   = 0.0;
-  this->HausdorffDistance = 0.0;
+  this->AverageDistance    = 0.0;
+  this->HausdorffDistance  = 0.0;
+  this->MinimumDistance    = 0.0;
+  this->PercentileDistance = 0.0;
+
+  this->Symmetric         = 0;
+  this->Percentile        = 95.0;
+  this->DistanceThreshold = -1.0;
+  this->StopAtThreshold   = 0;
+  this->ThresholdExceeded = 0;
 }
 
 // ----------------------
@@ -105,6 +173,13 @@ void vtkSVHausdorffDistance::PrintSelf(ostream& os, vtkIndent indent)
   }
   os << indent << "Average Distance: " << this->AverageDistance << "\n";
   os << indent << "Hausdorff Distance: " << this->HausdorffDistance << "\n";
+  os << indent << "Minimum Distance: " << this->MinimumDistance << "\n";
+  os << indent << "Percentile: " << this->Percentile << "\n";
+  os << indent << "Percentile Distance: " << this->PercentileDistance << "\n";
+  os << indent << "Symmetric: " << this->Symmetric << "\n";
+  os << indent << "Distance Threshold: " << this->DistanceThreshold << "\n";
+  os << indent << "Stop At Threshold: " << this->StopAtThreshold << "\n";
+  os << indent << "Threshold Exceeded: " << this->ThresholdExceeded << "\n";
 }
 
 // ----------------------
@@ -180,30 +255,42 @@ int vtkSVHausdorffDistance::RunFilter()
   distances->SetNumberOfTuples(numPoints);
   distances->SetName(this->DistanceArrayName);
 
-  // Cell locator using the source pd
-  vtkNew(vtkCellLocator, locator);
-  locator->SetDataSet(this->SourcePd);
-  locator->BuildLocator();
+  this->ThresholdExceeded = 0;
 
-  // Loop through each point in target and get distance
+  // Distances from each point in target to source
+  int stopped = this->ComputeDistances(this->TargetPd, this->SourcePd,
+                                       distances->GetPointer(0));
+
+  // And from source to target if symmetric
+  std::vector<double> reverseDistances;
+  if (this->Symmetric && !stopped)
+  {
+    reverseDistances.resize(this->SourcePd->GetNumberOfPoints());
+    stopped = this->ComputeDistances(this->SourcePd, this->TargetPd,
+                                     reverseDistances.data());
+  }
+
+  if (stopped)
+  {
+    vtkDebugMacro("Distance above threshold found, stopping");
+    this->ThresholdExceeded = 1;
+    return SV_OK;
+  }
+
+  // Gather all distances, target distances first
+  std::vector<double> allDistances(distances->GetPointer(0),
+                                   distances->GetPointer(0) + numPoints);
+  allDistances.insert(allDistances.end(), reverseDistances.begin(),
+                      reverseDistances.end());
+
+  // Update distance information
+  int numDistances = allDistances.size();
   double maxDistance   = 0.0;
   double minDistance   = VTK_SV_LARGE_DOUBLE;
   double totalDistance = 0.0;
-  for (int i=0; i<numPoints; i++)
+  for (int i=0; i<numDistances; i++)
   {
-    double pt[3];
-    this->TargetPd->GetPoint(i, pt);
-
-    double closestPt[3];
-    vtkIdType closestCell;
-    int subId;
-    double dist2;
-    vtkNew(vtkGenericCell, genericCell);
-    locator->FindClosestPoint(pt, closestPt, genericCell, closestCell, subId,
-                              dist2);
-    double distance = vtkSVMathUtils::Distance(closestPt, pt);
-
-    distances->SetTuple1(i, distance);
+    double distance = allDistances[i];
     if (distance > maxDistance)
       maxDistance = distance;
 
@@ -213,11 +300,55 @@ int vtkSVHausdorffDistance::RunFilter()
     totalDistance += distance;
   }
 
+  // Nearest rank percentile
+  int rank = static_cast<int>(ceil(this->Percentile/100.0 * numDistances)) - 1;
+  rank = svmaximum(0, svminimum(rank, numDistances - 1));
+  std::nth_element(allDistances.begin(), allDistances.begin() + rank,
+                   allDistances.end());
+
   // Add array and update distance information
   this->TargetPd->GetPointData()->AddArray(distances);
-  this->AverageDistance   = totalDistance/numPoints;
-  this->HausdorffDistance = maxDistance;
-  this->MinimumDistance   = minDistance;
+  this->AverageDistance    = totalDistance/numDistances;
+  this->HausdorffDistance  = maxDistance;
+  this->MinimumDistance    = minDistance;
+  this->PercentileDistance = allDistances[rank];
+
+  if (this->DistanceThreshold >= 0.0 &&
+      this->HausdorffDistance > this->DistanceThreshold)
+    this->ThresholdExceeded = 1;
 
   return SV_OK;
 }
+
+// ----------------------
+// ComputeDistances
+// ----------------------
+int vtkSVHausdorffDistance::ComputeDistances(vtkPolyData *pointsPd,
+                                             vtkPolyData *surfacePd,
+                                             double *distances)
+{
+  // Cell locator using the surface pd
+  vtkNew(vtkStaticCellLocator, locator);
+  locator->SetDataSet(surfacePd);
+  locator->BuildLocator();
+
+  std::atomic<int> stopped(0);
+
+  vtkSVClosestDistanceFunctor distancer;
+  distancer.Points          = pointsPd->GetPoints();
+  distancer.Locator         = locator;
+  distancer.Distances       = distances;
+  distancer.Threshold       = this->DistanceThreshold;
+  distancer.StopAtThreshold = this->StopAtThreshold &&
+                              this->DistanceThreshold >= 0.0;
+  distancer.Stopped         = &stopped;
+
+  // Locator queries are only thread safe from VTK 9.2
+#if VTK_MAJOR_VERSION > 9 || (VTK_MAJOR_VERSION == 9 && VTK_MINOR_VERSION >= 2)
+  vtkSMPTools::For(0, pointsPd->GetNumberOfPoints(), distancer);
+#else
+  distancer(0, pointsPd->GetNumberOfPoints());
+#endif
+
+  return stopped.load();
+}
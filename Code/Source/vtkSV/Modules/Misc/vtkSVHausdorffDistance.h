@@ -36,7 +36,11 @@
  * between two surfaces. The first input is the source polydata and used as
  * the reference polydata. The algorithm processes each point in the second
  * input and calculates the distance of each point to the reference surface.
- * A vtkCellLocator is used for the distance calculation.
+ * A vtkStaticCellLocator is used for the distance calculation and the
+ * points are processed in parallel. Optionally the distance is also
+ * computed from the reference to the second input to get the symmetric
+ * Hausdorff distance, and the filter can stop as soon as a distance above
+ * a threshold is found when only a pass/fail check is needed.
  *
  * \author Adam Updegrove
  * \author updega2@gmail.com
@@ -68,8 +72,44 @@ public:
   vtkGetMacro(HausdorffDistance, double);
   vtkGetMacro(AverageDistance, double);
   vtkGetMacro(MinimumDistance, double);
+  vtkGetMacro(PercentileDistance, double);
   //@}
 
+  //@{
+  /// \brief Also compute distances from the source to the target so that
+  /// the distances are two-way. Only the target distances are added to the
+  /// output, but all distance values include both directions.
+  vtkSetMacro(Symmetric, int);
+  vtkGetMacro(Symmetric, int);
+  vtkBooleanMacro(Symmetric, int);
+  //@}
+
+  //@{
+  /// \brief Percentile of the point distances to report in
+  /// PercentileDistance, between 0 and 100. Default is 95.
+  vtkSetClampMacro(Percentile, double, 0.0, 100.0);
+  vtkGetMacro(Percentile, double);
+  //@}
+
+  //@{
+  /// \brief Distance to compare against, turned off if negative. Default is
+  /// -1.0.
+  vtkSetMacro(DistanceThreshold, double);
+  vtkGetMacro(DistanceThreshold, double);
+  //@}
+
+  //@{
+  /// \brief Stop as soon as a distance above DistanceThreshold is found.
+  /// If the filter stops early, only ThresholdExceeded is valid and no
+  /// distance array is added to the output.
+  vtkSetMacro(StopAtThreshold, int);
+  vtkGetMacro(StopAtThreshold, int);
+  vtkBooleanMacro(StopAtThreshold, int);
+  //@}
+
+  /// \brief Whether any distance was above DistanceThreshold
+  vtkGetMacro(ThresholdExceeded, int);
+
 protected:
   vtkSVHausdorffDistance();
   ~vtkSVHausdorffDistance();
@@ -82,6 +122,11 @@ protected:
   int PrepFilter(); // Prep work
   int RunFilter(); // Run filter operations
 
+  // Compute the distance from each point of pointsPd to the surface of
+  // surfacePd, returns 1 if stopped early because of the threshold
+  int ComputeDistances(vtkPolyData *pointsPd, vtkPolyData *surfacePd,
+                       double *distances);
+
   char* DistanceArrayName; // Name of distance data array
 
   vtkPolyData *SourcePd; // First input to the filter
@@ -90,6 +135,13 @@ protected:
   double AverageDistance; // The average calculated distance from target to source
   double HausdorffDistance; // The largest distance from all point distances
   double MinimumDistance; // The smallest distance from all point distances
+  double PercentileDistance; // The distance at the requested percentile
+
+  int Symmetric;
+  double Percentile;
+  double DistanceThreshold;
+  int StopAtThreshold;
+  int ThresholdExceeded;
 
 private:
   vtkSVHausdorffDistance(const vtkSVHausdorffDistance&);  // Not implemented.
@@ -0,0 +1,245 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vtkSVVoronoiCache.h"
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <mutex>
+
+// ----------------------
+// Anonymous namespace
+// ----------------------
+namespace
+{
+struct vtkSVVoronoiCacheEntry
+{
+  std::string Key;
+  vtkSmartPointer<vtkUnstructuredGrid> DelaunayTessellation;
+  vtkSmartPointer<vtkPolyData> VoronoiDiagram;
+  vtkSmartPointer<vtkIdList> PoleIds;
+};
+
+// Most recently used entry first
+std::list<vtkSVVoronoiCacheEntry> CacheEntries;
+int CacheMaximumNumberOfEntries = 4;
+std::mutex CacheMutex;
+
+/// \brief 64 bit FNV-1a hash, accumulated over several buffers
+void HashBytes(const void *data, size_t size, unsigned long long &hash)
+{
+  const unsigned char *bytes = static_cast<const unsigned char*>(data);
+  for (size_t i=0; i<size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+}
+
+void TrimCache()
+{
+  while (CacheEntries.size() > static_cast<size_t>(CacheMaximumNumberOfEntries))
+    CacheEntries.pop_back();
+}
+}
+
+// ----------------------
+// ComputeKey
+// ----------------------
+std::string vtkSVVoronoiCache::ComputeKey(vtkPolyData *surface,
+                                          double delaunayTolerance,
+                                          int flipNormals,
+                                          vtkIdList *capCenterIds,
+                                          int simplifyVoronoi,
+                                          const char *radiusArrayName)
+{
+  unsigned long long hash = 14695981039346656037ULL;
+
+  vtkIdType numPts = surface->GetNumberOfPoints();
+  for (vtkIdType i=0; i<numPts; i++)
+  {
+    double pt[3];
+    surface->GetPoint(i, pt);
+    HashBytes(pt, sizeof(pt), hash);
+  }
+
+  vtkIdType numPolys = surface->GetNumberOfPolys();
+  vtkIdType npts;
+  const vtkIdType *pts;
+  vtkCellArray *polys = surface->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    HashBytes(&npts, sizeof(npts), hash);
+    HashBytes(pts, npts*sizeof(vtkIdType), hash);
+  }
+
+  HashBytes(&delaunayTolerance, sizeof(delaunayTolerance), hash);
+  HashBytes(&flipNormals, sizeof(flipNormals), hash);
+  HashBytes(&simplifyVoronoi, sizeof(simplifyVoronoi), hash);
+  if (capCenterIds != nullptr)
+  {
+    vtkIdType numCaps = capCenterIds->GetNumberOfIds();
+    HashBytes(&numCaps, sizeof(numCaps), hash);
+    HashBytes(capCenterIds->GetPointer(0), numCaps*sizeof(vtkIdType), hash);
+  }
+  if (radiusArrayName != nullptr)
+    HashBytes(radiusArrayName, strlen(radiusArrayName), hash);
+
+  // Sizes are kept in the clear to make collisions of different models
+  // even less likely
+  char key[128];
+  snprintf(key, sizeof(key), "%lld_%lld_%016llx",
+           static_cast<long long>(numPts), static_cast<long long>(numPolys), hash);
+  return std::string(key);
+}
+
+// ----------------------
+// Find
+// ----------------------
+int vtkSVVoronoiCache::Find(const std::string &key,
+                            vtkUnstructuredGrid *delaunayTessellation,
+                            vtkPolyData *voronoiDiagram,
+                            vtkIdList *poleIds)
+{
+  std::lock_guard<std::mutex> lock(CacheMutex);
+
+  std::list<vtkSVVoronoiCacheEntry>::iterator it;
+  for (it = CacheEntries.begin(); it != CacheEntries.end(); ++it)
+  {
+    if (it->Key == key)
+      break;
+  }
+  if (it == CacheEntries.end())
+    return 0;
+
+  if ((delaunayTessellation && !it->DelaunayTessellation) ||
+      (voronoiDiagram && !it->VoronoiDiagram) ||
+      (poleIds && !it->PoleIds))
+    return 0;
+
+  if (delaunayTessellation)
+    delaunayTessellation->DeepCopy(it->DelaunayTessellation);
+  if (voronoiDiagram)
+    voronoiDiagram->DeepCopy(it->VoronoiDiagram);
+  if (poleIds)
+    poleIds->DeepCopy(it->PoleIds);
+
+  CacheEntries.splice(CacheEntries.begin(), CacheEntries, it);
+
+  return 1;
+}
+
+// ----------------------
+// Insert
+// ----------------------
+void vtkSVVoronoiCache::Insert(const std::string &key,
+                               vtkUnstructuredGrid *delaunayTessellation,
+                               vtkPolyData *voronoiDiagram,
+                               vtkIdList *poleIds)
+{
+  // Copy outside of the lock, the tessellation can be large
+  vtkSVVoronoiCacheEntry newEntry;
+  newEntry.Key = key;
+  if (delaunayTessellation)
+  {
+    newEntry.DelaunayTessellation = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    newEntry.DelaunayTessellation->DeepCopy(delaunayTessellation);
+  }
+  if (voronoiDiagram)
+  {
+    newEntry.VoronoiDiagram = vtkSmartPointer<vtkPolyData>::New();
+    newEntry.VoronoiDiagram->DeepCopy(voronoiDiagram);
+  }
+  if (poleIds)
+  {
+    newEntry.PoleIds = vtkSmartPointer<vtkIdList>::New();
+    newEntry.PoleIds->DeepCopy(poleIds);
+  }
+
+  std::lock_guard<std::mutex> lock(CacheMutex);
+
+  std::list<vtkSVVoronoiCacheEntry>::iterator it;
+  for (it = CacheEntries.begin(); it != CacheEntries.end(); ++it)
+  {
+    if (it->Key == key)
+      break;
+  }
+  if (it != CacheEntries.end())
+  {
+    // Keep what the existing entry has and the new one does not
+    if (!newEntry.DelaunayTessellation)
+      newEntry.DelaunayTessellation = it->DelaunayTessellation;
+    if (!newEntry.VoronoiDiagram)
+      newEntry.VoronoiDiagram = it->VoronoiDiagram;
+    if (!newEntry.PoleIds)
+      newEntry.PoleIds = it->PoleIds;
+    CacheEntries.erase(it);
+  }
+
+  CacheEntries.push_front(newEntry);
+  TrimCache();
+}
+
+// ----------------------
+// Clear
+// ----------------------
+void vtkSVVoronoiCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(CacheMutex);
+  CacheEntries.clear();
+}
+
+// ----------------------
+// SetMaximumNumberOfEntries
+// ----------------------
+void vtkSVVoronoiCache::SetMaximumNumberOfEntries(int number)
+{
+  std::lock_guard<std::mutex> lock(CacheMutex);
+  CacheMaximumNumberOfEntries = number < 0 ? 0 : number;
+  TrimCache();
+}
+
+// ----------------------
+// GetMaximumNumberOfEntries
+// ----------------------
+int vtkSVVoronoiCache::GetMaximumNumberOfEntries()
+{
+  std::lock_guard<std::mutex> lock(CacheMutex);
+  return CacheMaximumNumberOfEntries;
+}
@@ -0,0 +1,109 @@
+/* Copyright (c) Stanford University, The Regents of the University of
+ *               California, and others.
+ *
+ * All Rights Reserved.
+ *
+ * See Copyright-SimVascular.txt for additional details.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  \class vtkSVVoronoiCache
+ *  \brief Process wide cache of the internal Delaunay tessellation and the
+ *  voronoi diagram of closed surfaces. Entries are keyed on the content of
+ *  the surface and on the options that change the tessellation, so that
+ *  repeated centerline extractions on the same model, e.g. with different
+ *  source and target caps, do not recompute the tessellation.
+ *
+ *  Entries are deep copies and the least recently used entry is dropped
+ *  once MaximumNumberOfEntries is exceeded. All functions are thread safe.
+ */
+
+#ifndef vtkSVVoronoiCache_h
+#define vtkSVVoronoiCache_h
+
+#include "vtkObject.h"
+#include "vtkSVMiscModule.h" // For export
+
+#include <string>
+
+class vtkIdList;
+class vtkPolyData;
+class vtkUnstructuredGrid;
+
+class VTKSVMISC_EXPORT vtkSVVoronoiCache : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkSVVoronoiCache,vtkObject);
+
+  /** \brief Build the key of a surface. The hash covers the points and the
+   *  polygons of the surface.
+   *  \param surface closed surface the tessellation is computed on.
+   *  \param delaunayTolerance tolerance given to vtkDelaunay3D.
+   *  \param flipNormals whether the surface normals are flipped.
+   *  \param capCenterIds cap center ids used to extract the internal
+   *  tetrahedra, can be nullptr.
+   *  \param simplifyVoronoi whether the voronoi diagram is simplified.
+   *  \param radiusArrayName name of the radius array on the voronoi diagram. */
+  static std::string ComputeKey(vtkPolyData *surface,
+                                double delaunayTolerance,
+                                int flipNormals,
+                                vtkIdList *capCenterIds,
+                                int simplifyVoronoi,
+                                const char *radiusArrayName);
+
+  /** \brief Copy a cached entry into the given objects. Any of the outputs
+   *  can be nullptr.
+   *  \return 1 if the entry exists and holds every requested output, 0
+   *  otherwise. */
+  static int Find(const std::string &key,
+                  vtkUnstructuredGrid *delaunayTessellation,
+                  vtkPolyData *voronoiDiagram,
+                  vtkIdList *poleIds);
+
+  /** \brief Store an entry. Objects that are nullptr are not stored; an
+   *  existing entry with the same key is updated. */
+  static void Insert(const std::string &key,
+                     vtkUnstructuredGrid *delaunayTessellation,
+                     vtkPolyData *voronoiDiagram,
+                     vtkIdList *poleIds);
+
+  /** \brief Remove all entries. */
+  static void Clear();
+
+  /** \brief Get and set the number of entries kept. Default is 4. */
+  static void SetMaximumNumberOfEntries(int number);
+  static int GetMaximumNumberOfEntries();
+
+protected:
+  vtkSVVoronoiCache() {}
+  ~vtkSVVoronoiCache() {}
+
+private:
+  vtkSVVoronoiCache(const vtkSVVoronoiCache&);  // Not implemented.
+  void operator=(const vtkSVVoronoiCache&);  // Not implemented.
+};
+
+#endif
@@ -47,6 +47,7 @@
 #include "vtkSVGeneralUtils.h"
 #include "vtkSVGlobals.h"
 #include "vtkSVMathUtils.h"
+#include "vtkSVSparseSolver.h"
 
 #include <iostream>
 #include <sstream>
@@ -271,10 +272,8 @@ int vtkSVPlanarMapper::PrepFilter()
   // Set the size of the matrices
   this->ATutte->SetMatrixSize(numPoints, numPoints);
   this->AHarm->SetMatrixSize(numPoints, numPoints);
-  this->Xu.resize(numPoints, 0.0);
-  this->Xv.resize(numPoints, 0.0);
-  this->Bu.resize(numPoints, 0.0);
-  this->Bv.resize(numPoints, 0.0);
+  this->X.resize(2*numPoints, 0.0);
+  this->B.resize(2*numPoints, 0.0);
 
   return SV_OK;
 }
@@ -347,8 +346,8 @@ int vtkSVPlanarMapper::SetBoundaries()
     this->ATutte->SetElement(id, id, 1.0);
 
     // Set right hand side to be point on boundary
-    this->Bu[id] = pt[this->Dir0];
-    this->Bv[id] = pt[this->Dir1];
+    this->B[2*id]   = pt[this->Dir0];
+    this->B[2*id+1] = pt[this->Dir1];
   }
 
   return SV_OK;
@@ -413,8 +412,8 @@ int vtkSVPlanarMapper::SetInternalNodes()
       this->ATutte->SetElement(i, i, tot_tutte_weight);
 
       // Set initial values for solution vector
-      this->Xu[i] = centroid[this->Dir0]; //pt[this->Dir0];
-      this->Xv[i] = centroid[this->Dir1]; //pt[this->Dir1];
+      this->X[2*i]   = centroid[this->Dir0]; //pt[this->Dir0];
+      this->X[2*i+1] = centroid[this->Dir1]; //pt[this->Dir1];
     }
   }
 
@@ -430,14 +429,19 @@ int vtkSVPlanarMapper::SolveSystem()
 
   double epsilon = 1.0e-8;
 
-  vtkSVMathUtils::ConjugateGradient(this->ATutte, &this->Bu[0], numPoints,
-                                    &this->Xu[0], epsilon);
-  vtkSVMathUtils::ConjugateGradient(this->AHarm,  &this->Bu[0], numPoints,
-                                    &this->Xu[0], epsilon);
-  vtkSVMathUtils::ConjugateGradient(this->ATutte, &this->Bv[0], numPoints,
-                                    &this->Xv[0], epsilon);
-  vtkSVMathUtils::ConjugateGradient(this->AHarm,  &this->Bv[0], numPoints,
-                                    &this->Xv[0], epsilon);
+  // Solve u and v together for each system, the tutte solution is the
+  // initial guess for the harmonic solve
+  vtkNew(vtkSVSparseSolver, solver);
+  solver->SetSolverType(vtkSVSparseSolver::NORMAL_EQUATIONS);
+  solver->SetPreconditioner(vtkSVSparseSolver::PRECONDITIONER_JACOBI);
+  solver->SetMaximumNumberOfIterations(numPoints);
+  solver->SetTolerance(epsilon);
+
+  solver->SetMatrix(this->ATutte);
+  solver->Solve(&this->B[0], &this->X[0], 2);
+
+  solver->SetMatrix(this->AHarm);
+  solver->Solve(&this->B[0], &this->X[0], 2);
 
   // Get pt from boundary for stationary dir axis
   double origPt[3];
@@ -448,8 +452,8 @@ int vtkSVPlanarMapper::SolveSystem()
 
     // New pt
     double pt[3];
-    pt[this->Dir0] = this->Xu[i];
-    pt[this->Dir1] = this->Xv[i];
+    pt[this->Dir0] = this->X[2*i];
+    pt[this->Dir1] = this->X[2*i+1];
     pt[this->Dir2] = origPt[this->Dir2];
     this->PlanarPd->GetPoints()->SetPoint(i, pt);
   }
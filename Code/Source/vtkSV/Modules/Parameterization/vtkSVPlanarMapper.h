@@ -137,10 +137,9 @@ private:
 
   vtkSVSparseMatrix *ATutte;
   vtkSVSparseMatrix *AHarm;
-  std::vector<double> Xu;
-  std::vector<double> Xv;
-  std::vector<double> Bu;
-  std::vector<double> Bv;
+  // Solution and right hand side with u and v interleaved per point
+  std::vector<double> X;
+  std::vector<double> B;
 
   int RemoveInternalIds;
   double Lambda;
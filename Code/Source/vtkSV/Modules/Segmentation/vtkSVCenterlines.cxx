@@ -53,6 +53,8 @@
 #include "vtkPolyDataNormals.h"
 #include "vtkPolyLine.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkTetra.h"
 #include "vtkThreshold.h"
@@ -65,6 +67,7 @@
 #include "vtkSVGlobals.h"
 #include "vtkSVPolyDataSurfaceInspector.h"
 #include "vtkSVIOUtils.h"
+#include "vtkSVVoronoiCache.h"
 
 #include "vtkvmtkInternalTetrahedraExtractor.h"
 #include "vtkvmtkNonManifoldFastMarching.h"
@@ -72,6 +75,86 @@
 #include "vtkvmtkSteepestDescentLineTracer.h"
 #include "vtkvmtkVoronoiDiagram3D.h"
 
+// ----------------------
+// Anonymous namespace
+// ----------------------
+namespace
+{
+/// \brief Solves the eikonal equation and backtraces the centerline of each
+/// edge. Every thread marches on its own shallow copy of the voronoi diagram
+/// because the fast marching builds cells and links on its input.
+struct vtkSVCenterlineEdgeTracer
+{
+  vtkPolyData *VoronoiDiagram;
+  const std::vector<std::vector<int> > *VoronoiSeeds;
+  std::vector<vtkSmartPointer<vtkPolyData> > *Lines;
+
+  const char *RadiusArrayName;
+  const char *CostFunctionArrayName;
+  const char *EikonalSolutionArrayName;
+  const char *EdgeArrayName;
+  const char *EdgePCoordArrayName;
+
+  vtkSMPThreadLocalObject<vtkPolyData> LocalVoronoi;
+  vtkSMPThreadLocalObject<vtkvmtkNonManifoldFastMarching> LocalFastMarching;
+
+  void Initialize()
+  {
+    vtkPolyData *voronoi = this->LocalVoronoi.Local();
+    voronoi->ShallowCopy(this->VoronoiDiagram);
+
+    vtkvmtkNonManifoldFastMarching *fastMarching = this->LocalFastMarching.Local();
+    fastMarching->SetInputData(voronoi);
+    fastMarching->SetCostFunctionArrayName(this->CostFunctionArrayName);
+    fastMarching->SetSolutionArrayName(this->EikonalSolutionArrayName);
+    fastMarching->SeedsBoundaryConditionsOn();
+    fastMarching->StopOnTargetsOn();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkvmtkNonManifoldFastMarching *fastMarching = this->LocalFastMarching.Local();
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      int voronoiId0 = (*this->VoronoiSeeds)[i][0];
+      int voronoiIdN = (*this->VoronoiSeeds)[i][1];
+
+      vtkNew(vtkIdList, voronoiSourceSeedIds);
+      voronoiSourceSeedIds->SetNumberOfIds(1);
+      voronoiSourceSeedIds->SetId(0, voronoiIdN);
+
+      vtkNew(vtkIdList, voronoiTargetSeedIds);
+      voronoiTargetSeedIds->SetNumberOfIds(1);
+      voronoiTargetSeedIds->SetId(0, voronoiId0);
+
+      // March only until the end of the edge has been reached
+      fastMarching->SetSeeds(voronoiSourceSeedIds);
+      fastMarching->SetTargets(voronoiTargetSeedIds);
+      fastMarching->Update();
+
+      vtkNew(vtkvmtkSteepestDescentLineTracer, centerlineBacktracing);
+      centerlineBacktracing->SetInputConnection(fastMarching->GetOutputPort());
+      centerlineBacktracing->SetDataArrayName(this->RadiusArrayName);
+      centerlineBacktracing->SetDescentArrayName(this->EikonalSolutionArrayName);
+      centerlineBacktracing->SetEdgeArrayName(this->EdgeArrayName);
+      centerlineBacktracing->SetEdgePCoordArrayName(this->EdgePCoordArrayName);
+      centerlineBacktracing->SetSeeds(voronoiTargetSeedIds);
+      centerlineBacktracing->MergePathsOff();
+      centerlineBacktracing->StopOnTargetsOn();
+      centerlineBacktracing->SetTargets(voronoiSourceSeedIds);
+      centerlineBacktracing->Update();
+
+      (*this->Lines)[i] = vtkSmartPointer<vtkPolyData>::New();
+      (*this->Lines)[i]->ShallowCopy(centerlineBacktracing->GetOutput());
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+}
+
 // ----------------------
 // StandardNewMacro
 // ----------------------
@@ -114,6 +197,8 @@ vtkSVCenterlines::vtkSVCenterlines()
   this->CenterlineResampling = 0;
   this->AppendEndPointsToCenterlines = 0;
   this->ProcessCenterlinesIntoTree = 1;
+  this->ParallelEdgeTracing = 1;
+  this->UseVoronoiCache = 1;
 
   this->ResamplingStepLength = 1.0;
 
@@ -348,11 +433,32 @@ int vtkSVCenterlines::RequestData(
     }
   }
 
+  // ------------------------------------------------------------------------
+  // Look for a tessellation and voronoi diagram of this same surface
+  vtkNew(vtkPolyData, voronoiDiagram);
+  std::string voronoiCacheKey;
+  int voronoiCached = 0;
+  if (this->GenerateDelaunayTessellation && this->UseVoronoiCache)
+  {
+    voronoiCacheKey = vtkSVVoronoiCache::ComputeKey(input, this->DelaunayTolerance,
+                                                    this->FlipNormals, this->CapCenterIds,
+                                                    this->SimplifyVoronoi, this->RadiusArrayName);
+
+    vtkNew(vtkUnstructuredGrid, cachedDelaunay);
+    if (vtkSVVoronoiCache::Find(voronoiCacheKey, cachedDelaunay, voronoiDiagram, this->PoleIds))
+    {
+      vtkDebugMacro("Using cached Delaunay Tesselation and Voronoi Diagram");
+      this->SetDelaunayTessellation(cachedDelaunay);
+      voronoiCached = 1;
+    }
+  }
+  // ------------------------------------------------------------------------
+
   // ------------------------------------------------------------------------
   // Delaunay tesselation
-  vtkDebugMacro("Generating Delaunay Tesselation...");
-  if (this->GenerateDelaunayTessellation)
+  if (this->GenerateDelaunayTessellation && !voronoiCached)
   {
+    vtkDebugMacro("Generating Delaunay Tesselation...");
     vtkNew(vtkDelaunay3D, delaunayTessellator);
     delaunayTessellator->CreateDefaultLocator();
     delaunayTessellator->SetInputConnection(surfaceNormals->GetOutputPort());
@@ -372,30 +478,37 @@ int vtkSVCenterlines::RequestData(
     }
     internalTetrahedraExtractor->Update();
 
-    this->DelaunayTessellation = internalTetrahedraExtractor->GetOutput();
-    this->DelaunayTessellation->Register(this);
+    this->SetDelaunayTessellation(internalTetrahedraExtractor->GetOutput());
   }
   // ------------------------------------------------------------------------
 
   // ------------------------------------------------------------------------
   // Voronoi
-  vtkDebugMacro("Generating Voronoi Diagram...");
-  vtkNew(vtkvmtkVoronoiDiagram3D, voronoiDiagramFilter);
-  voronoiDiagramFilter->SetInputData(this->DelaunayTessellation);
-  voronoiDiagramFilter->SetRadiusArrayName(this->RadiusArrayName);
-  voronoiDiagramFilter->Update();
+  if (!voronoiCached)
+  {
+    vtkDebugMacro("Generating Voronoi Diagram...");
+    vtkNew(vtkvmtkVoronoiDiagram3D, voronoiDiagramFilter);
+    voronoiDiagramFilter->SetInputData(this->DelaunayTessellation);
+    voronoiDiagramFilter->SetRadiusArrayName(this->RadiusArrayName);
+    voronoiDiagramFilter->Update();
 
-  this->PoleIds->DeepCopy(voronoiDiagramFilter->GetPoleIds());
+    this->PoleIds->DeepCopy(voronoiDiagramFilter->GetPoleIds());
 
-  vtkPolyData* voronoiDiagram = voronoiDiagramFilter->GetOutput();
-  if (this->SimplifyVoronoi)
-  {
-    vtkNew(vtkvmtkSimplifyVoronoiDiagram, voronoiDiagramSimplifier);
-    voronoiDiagramSimplifier->SetInputConnection(voronoiDiagramFilter->GetOutputPort());
-    voronoiDiagramSimplifier->SetUnremovablePointIds(voronoiDiagramFilter->GetPoleIds());
-    voronoiDiagramSimplifier->Update();
-    voronoiDiagram = voronoiDiagramSimplifier->GetOutput();
-    voronoiDiagram->Register(this);
+    voronoiDiagram->ShallowCopy(voronoiDiagramFilter->GetOutput());
+    if (this->SimplifyVoronoi)
+    {
+      vtkNew(vtkvmtkSimplifyVoronoiDiagram, voronoiDiagramSimplifier);
+      voronoiDiagramSimplifier->SetInputConnection(voronoiDiagramFilter->GetOutputPort());
+      voronoiDiagramSimplifier->SetUnremovablePointIds(voronoiDiagramFilter->GetPoleIds());
+      voronoiDiagramSimplifier->Update();
+      voronoiDiagram->ShallowCopy(voronoiDiagramSimplifier->GetOutput());
+    }
+
+    if (!voronoiCacheKey.empty())
+    {
+      vtkSVVoronoiCache::Insert(voronoiCacheKey, this->DelaunayTessellation,
+                                voronoiDiagram, this->PoleIds);
+    }
   }
   // ------------------------------------------------------------------------
 
@@ -433,10 +546,10 @@ int vtkSVCenterlines::RequestData(
   voronoiThinner->Update();
 
   vtkNew(vtkPolyData, newTriPd);
-  newTriPd->DeepCopy(voronoiThinner->GetOutput());
+  newTriPd->ShallowCopy(voronoiThinner->GetOutput());
 
   vtkNew(vtkPolyData, newEdgePd);
-  newEdgePd->DeepCopy(voronoiThinner->GetOutputEdgePd());
+  newEdgePd->ShallowCopy(voronoiThinner->GetOutputEdgePd());
 
   vtkDebugMacro("Done computing voronoi thinning iterations...");
   // ------------------------------------------------------------------------
@@ -547,9 +660,9 @@ int vtkSVCenterlines::RequestData(
   medialAxisThinner->Update();
 
   vtkNew(vtkPolyData, nextTriPd);
-  nextTriPd->DeepCopy(medialAxisThinner->GetOutput());
+  nextTriPd->ShallowCopy(medialAxisThinner->GetOutput());
   vtkNew(vtkPolyData, nextEdgePd);
-  nextEdgePd->DeepCopy(medialAxisThinner->GetOutputEdgePd());
+  nextEdgePd->ShallowCopy(medialAxisThinner->GetOutputEdgePd());
   vtkDebugMacro("Done computing voronoi thinning iterations...");
   // ------------------------------------------------------------------------
 
@@ -1330,50 +1443,35 @@ int vtkSVCenterlines::RequestData(
   }
   // ------------------------------------------------------------------------
 
-  vtkNew(vtkAppendPolyData, appender);
+  // ------------------------------------------------------------------------
+  // Trace the centerline of each edge, the edges are independent
+  std::vector<vtkSmartPointer<vtkPolyData> > edgeLines(voronoiSeeds.size());
 
-  vtkNew(vtkvmtkNonManifoldFastMarching, voronoiFastMarching);
-  voronoiFastMarching->SetInputData(voronoiCostFunctionCalculator->GetOutput());
-  voronoiFastMarching->SetCostFunctionArrayName(this->CostFunctionArrayName);
-  voronoiFastMarching->SetSolutionArrayName(this->EikonalSolutionArrayName);
-  voronoiFastMarching->SeedsBoundaryConditionsOn();
-  for (int i=0; i<voronoiSeeds.size(); i++)
+  vtkSVCenterlineEdgeTracer edgeTracer;
+  edgeTracer.VoronoiDiagram           = voronoiCostFunctionCalculator->GetOutput();
+  edgeTracer.VoronoiSeeds             = &voronoiSeeds;
+  edgeTracer.Lines                    = &edgeLines;
+  edgeTracer.RadiusArrayName          = this->RadiusArrayName;
+  edgeTracer.CostFunctionArrayName    = this->CostFunctionArrayName;
+  edgeTracer.EikonalSolutionArrayName = this->EikonalSolutionArrayName;
+  edgeTracer.EdgeArrayName            = this->EdgeArrayName;
+  edgeTracer.EdgePCoordArrayName      = this->EdgePCoordArrayName;
+
+  vtkDebugMacro("Tracing " << voronoiSeeds.size() << " edges...");
+  if (this->ParallelEdgeTracing)
+    vtkSMPTools::For(0, voronoiSeeds.size(), 1, edgeTracer);
+  else
   {
-    int voronoiId0 = voronoiSeeds[i][0];
-    int voronoiIdN = voronoiSeeds[i][1];
-
-    vtkNew(vtkIdList, voronoiSourceSeedIds);
-    voronoiSourceSeedIds->SetNumberOfIds(1);
-    voronoiSourceSeedIds->SetId(0, voronoiIdN);
-
-    vtkNew(vtkIdList, voronoiTargetSeedIds);
-    voronoiTargetSeedIds->SetNumberOfIds(1);
-    voronoiTargetSeedIds->SetId(0, voronoiId0);
-
-    vtkDebugMacro("Doing edge: " << voronoiId0 << " " << voronoiIdN);
-    vtkDebugMacro("Marching...");
-    voronoiFastMarching->SetSeeds(voronoiSourceSeedIds);
-    voronoiFastMarching->Update();
-    vtkDebugMacro("Done");
-
-    //this->VoronoiDiagram->ShallowCopy(voronoiFastMarching->GetOutput());
-
-    vtkNew(vtkvmtkSteepestDescentLineTracer, centerlineBacktracing);
-    centerlineBacktracing->SetInputConnection(voronoiFastMarching->GetOutputPort());
-    centerlineBacktracing->SetDataArrayName(this->RadiusArrayName);
-    centerlineBacktracing->SetDescentArrayName(this->EikonalSolutionArrayName);
-    centerlineBacktracing->SetEdgeArrayName(this->EdgeArrayName);
-    centerlineBacktracing->SetEdgePCoordArrayName(this->EdgePCoordArrayName);
-    centerlineBacktracing->SetSeeds(voronoiTargetSeedIds);
-    centerlineBacktracing->MergePathsOff();
-    centerlineBacktracing->StopOnTargetsOn();
-    centerlineBacktracing->SetTargets(voronoiSourceSeedIds);
-    vtkDebugMacro("Backtracing...");
-    centerlineBacktracing->Update();
-    vtkDebugMacro("Done");
-
-    appender->AddInputData(centerlineBacktracing->GetOutput());
+    edgeTracer.Initialize();
+    edgeTracer(0, voronoiSeeds.size());
   }
+  vtkDebugMacro("Done");
+
+  vtkNew(vtkAppendPolyData, appender);
+  for (int i=0; i<edgeLines.size(); i++)
+    appender->AddInputData(edgeLines[i]);
+  // ------------------------------------------------------------------------
+
   appender->Update();
 
   vtkNew(vtkPolyData, currentLine);
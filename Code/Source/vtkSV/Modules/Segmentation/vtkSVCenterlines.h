@@ -117,6 +117,14 @@ class VTKSVSEGMENTATION_EXPORT vtkSVCenterlines : public vtkPolyDataAlgorithm
   vtkSetMacro(ProcessCenterlinesIntoTree, int);
   vtkGetMacro(ProcessCenterlinesIntoTree, int);
 
+  vtkSetMacro(ParallelEdgeTracing, int);
+  vtkGetMacro(ParallelEdgeTracing, int);
+  vtkBooleanMacro(ParallelEdgeTracing, int);
+
+  vtkSetMacro(UseVoronoiCache, int);
+  vtkGetMacro(UseVoronoiCache, int);
+  vtkBooleanMacro(UseVoronoiCache, int);
+
   vtkSetMacro(RelativeThreshold, double);
   vtkGetMacro(RelativeThreshold, double);
 
@@ -190,6 +198,8 @@ class VTKSVSEGMENTATION_EXPORT vtkSVCenterlines : public vtkPolyDataAlgorithm
   int MedialEdgeThreshold;
   int AbsoluteThreshold;
   int ProcessCenterlinesIntoTree;
+  int ParallelEdgeTracing;
+  int UseVoronoiCache;
 
   double ResamplingStepLength;
   double RelativeThreshold;
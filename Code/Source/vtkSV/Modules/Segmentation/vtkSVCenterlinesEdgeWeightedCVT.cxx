@@ -201,7 +201,7 @@ int vtkSVCenterlinesEdgeWeightedCVT::InitializeGenerators()
 
       cellGenerator = this->WorkGenerators->GetCellData()->GetArray(this->GroupIdsArrayName)->GetTuple1(lastCellId);
 
-      this->PatchIdsArray->SetTuple1(i, cellGenerator);
+      this->PatchIdsArray->SetValue(i, cellGenerator);
     }
   }
   else if (this->UsePointArray)
@@ -227,7 +227,7 @@ int vtkSVCenterlinesEdgeWeightedCVT::GetClosestGenerator(const int evalId, int &
 {
   // Get current generator
   int numGenerators = this->WorkGenerators->GetNumberOfPoints();
-  int currGenerator = this->PatchIdsArray->GetTuple1(evalId);
+  int currGenerator = this->PatchIdsArray->GetValue(evalId);
   newGenerator =  currGenerator;
 
   // GroupIds
@@ -269,7 +269,7 @@ int vtkSVCenterlinesEdgeWeightedCVT::GetClosestGenerator(const int evalId, int &
 double vtkSVCenterlinesEdgeWeightedCVT::GetEdgeWeightedDistance(const int generatorId, const int evalId)
 {
   // Current generator
-  int currGenerator = this->PatchIdsArray->GetTuple1(evalId);
+  int currGenerator = this->PatchIdsArray->GetValue(evalId);
 
   // TODO CHECK FOR NORMALS EARLIER!!!!
   // Current cell normal
@@ -297,7 +297,7 @@ double vtkSVCenterlinesEdgeWeightedCVT::GetEdgeWeightedDistance(const int genera
   for (int i=0; i<this->NumberOfNeighbors[evalId]; i++)
   {
     int neighborId = this->Neighbors[evalId][i];
-    int neighborGenerator = this->PatchIdsArray->GetTuple1(neighborId);
+    int neighborGenerator = this->PatchIdsArray->GetValue(neighborId);
     if (neighborGenerator == generatorId)
     {
       double normal[3];
@@ -95,6 +95,9 @@ protected:
   int GetClosestGenerator(const int evalId, int &newGenerator) override;
   double GetEdgeWeightedDistance(const int generatorId, const int evalId) override;
 
+  // The distance looks up the cell points of the work polydata
+  int IsEvaluationThreadSafe() override {return 0;}
+
 private:
   vtkSVCenterlinesEdgeWeightedCVT(const vtkSVCenterlinesEdgeWeightedCVT&);  // Not implemented.
   void operator=(const vtkSVCenterlinesEdgeWeightedCVT&);  // Not implemented.
@@ -41,6 +41,7 @@
 #include "vtkSVGeneralUtils.h"
 #include "vtkSVGlobals.h"
 #include "vtkSVMathUtils.h"
+#include "vtkSVPolyDataAdjacency.h"
 
 // ----------------------
 // StandardNewMacro
@@ -129,7 +130,7 @@ int vtkSVEdgeWeightedCVT::InitializeConnectivity()
         this->NeighborPatchesIds[i][j] = -1;
       }
 
-      this->NeighborPatchesIds[i][0] = this->PatchIdsArray->GetTuple1(i);
+      this->NeighborPatchesIds[i][0] = this->PatchIdsArray->GetValue(i);
       this->NeighborPatchesNumberOfElements[i][0] = 1;
 
     }
@@ -199,7 +200,7 @@ int vtkSVEdgeWeightedCVT::InitializeGenerators()
           minDist = testDist;
         }
       }
-      this->PatchIdsArray->SetTuple1(i, cellGenerator);
+      this->PatchIdsArray->SetValue(i, cellGenerator);
     }
     delete [] data;
   }
@@ -216,7 +217,7 @@ int vtkSVEdgeWeightedCVT::GetClosestGenerator(const int evalId, int &newGenerato
 {
   // Get current generator
   int numGenerators = this->WorkGenerators->GetNumberOfPoints();
-  int currGenerator = this->PatchIdsArray->GetTuple1(evalId);
+  int currGenerator = this->PatchIdsArray->GetValue(evalId);
   newGenerator =  currGenerator;
 
   // Current minimum to beat is current generator
@@ -253,7 +254,7 @@ int vtkSVEdgeWeightedCVT::GetClosestGenerator(const int evalId, int &newGenerato
 double vtkSVEdgeWeightedCVT::GetEdgeWeightedDistance(const int generatorId, const int evalId)
 {
   // Current generator
-  int currGenerator = this->PatchIdsArray->GetTuple1(evalId);
+  int currGenerator = this->PatchIdsArray->GetValue(evalId);
 
   // TODO CHECK FOR NORMALS EARLIER!!!!
   // Current cell normal
@@ -297,7 +298,7 @@ double vtkSVEdgeWeightedCVT::GetEdgeWeightedDistance(const int generatorId, cons
   for (int i=0; i<this->NumberOfNeighbors[evalId]; i++)
   {
     int neighborId = this->Neighbors[evalId][i];
-    int neighborGenerator = this->PatchIdsArray->GetTuple1(neighborId);
+    int neighborGenerator = this->PatchIdsArray->GetValue(neighborId);
     if (neighborGenerator == generatorId)
     {
       double normal[3];
@@ -348,7 +349,7 @@ double vtkSVEdgeWeightedCVT::GetEdgeWeightedDistance(const int generatorId, cons
   for (int i=0; i<this->NumberOfNeighbors[evalId]; i++)
   {
     if (this->FixedIds[this->Neighbors[evalId][i]] == 1 &&
-        this->PatchIdsArray->GetTuple1(this->Neighbors[evalId][i]) == generatorId)
+        this->PatchIdsArray->GetValue(this->Neighbors[evalId][i]) == generatorId)
       numFixedNeighbors++;
   }
 
@@ -439,7 +440,7 @@ int vtkSVEdgeWeightedCVT::UpdateConnectivity(const int evalId, const int oldGene
     }
   }
 
-  this->PatchIdsArray->SetTuple1(evalId, newGenerator);
+  this->PatchIdsArray->SetValue(evalId, newGenerator);
 
   return SV_OK;
 }
@@ -469,7 +470,7 @@ int vtkSVEdgeWeightedCVT::UpdateGenerators()
     // Get data and patch id
     double data[3];
     this->CVTDataArray->GetTuple(i, data);
-    int patchId = this->PatchIdsArray->GetTuple1(i);
+    int patchId = this->PatchIdsArray->GetValue(i);
 
     // Loop through num of components
     for (int j=0; j<3; j++)
@@ -503,25 +504,22 @@ int vtkSVEdgeWeightedCVT::UpdateGenerators()
 // ----------------------
 int vtkSVEdgeWeightedCVT::GetPointCellValence()
 {
-  this->WorkPd->GetNumberOfPoints();
   // Number of points and cells
   int numPoints = this->WorkPd->GetNumberOfPoints();
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(this->WorkPd);
 
   for (int i=0; i<numPoints; i++)
   {
     // get point cells
-    vtkNew(vtkIdList, pointCells);
-
-    this->WorkPd->GetPointCells(i, pointCells);
+    vtkIdType ncells;
+    const vtkIdType *cells;
+    adjacency->GetPointCells(i, ncells, cells);
 
     // Set number of point cells
-    this->PointCellValenceNumber[i] = pointCells->GetNumberOfIds();
+    this->PointCellValenceNumber[i] = ncells;
 
     // Update point cell info
-    for (int j=0; j<pointCells->GetNumberOfIds(); j++)
-    {
-      this->PointCellValence[i].push_back(pointCells->GetId(j));
-    }
+    this->PointCellValence[i].assign(cells, cells+ncells);
   }
 
   return SV_OK;
@@ -532,79 +530,17 @@ int vtkSVEdgeWeightedCVT::GetPointCellValence()
 // ----------------------
 int vtkSVEdgeWeightedCVT::GetCellRingNeighbors(int ringNumber)
 {
+  // Rings ringNumber through NumberOfRings, always at least one
+  int numberOfRings = this->NumberOfRings - ringNumber + 1;
+  if (numberOfRings < 1)
+    numberOfRings = 1;
+
+  vtkSVPolyDataAdjacency::GetAdjacency(this->WorkPd)->GetCellRingNeighbors(numberOfRings, this->Neighbors);
+
   // Number of cells
   int numCells = this->WorkPd->GetNumberOfCells();
-
   for (int i=0; i<numCells; i++)
-  {
-    // temporary node vec
-    std::vector<int> tmpNodes;
-    int iSize = this->Neighbors[i].size();
-
-    for (int j=0; j<iSize; j++)
-    {
-      // Get neighbor cell points
-      int neiCellId = this->Neighbors[i][j];
-      const vtkIdType *pts; 
-      vtkIdType npts;
-      this->WorkPd->GetCellPoints(neiCellId, npts, pts);
-
-      // Loop around cell points
-      for (int k=0; k<npts; k++)
-      {
-        int tmpNode = pts[k];
-        int kSize   = tmpNodes.size();
-
-        int kk = 0;
-        for (kk=0; kk<kSize; kk++)
-        {
-          if (tmpNode == tmpNodes[kk])
-          {
-            break;
-          }
-        }
-        if (kk == kSize)
-        {
-          tmpNodes.push_back(tmpNode);
-        }
-      }
-    }
-
-    // Now find neighbor elems
-    iSize = tmpNodes.size();
-
-    for (int j=0; j<iSize; j++)
-    {
-      int tmpNode = tmpNodes[j];
-
-      for (int k=0; k<this->PointCellValenceNumber[tmpNode]; k++)
-      {
-        int tmpCell = this->PointCellValence[tmpNode][k];
-        int kSize =   this->Neighbors[i].size();
-
-        int kk=0;
-        for (kk=0; kk<kSize; kk++)
-        {
-          if (tmpCell == this->Neighbors[i][kk])
-          {
-            break;
-          }
-        }
-        if (kk == kSize)
-        {
-          this->Neighbors[i].push_back(tmpCell);
-        }
-      }
-    }
-
     this->NumberOfNeighbors[i] = this->Neighbors[i].size();
-  }
-
-  if (ringNumber < this->NumberOfRings)
-  {
-    ringNumber++;
-    this->GetCellRingNeighbors(ringNumber);
-  }
 
   return SV_OK;
 }
@@ -614,40 +550,8 @@ int vtkSVEdgeWeightedCVT::GetCellRingNeighbors(int ringNumber)
 // ----------------------
 int vtkSVEdgeWeightedCVT::GetCellDirectNeighbors()
 {
-
-  int numCells = this->WorkPd->GetNumberOfCells();
-  this->WorkPd->BuildLinks();
-
-  // Loop through cells
-  for (int i=0; i<numCells; i++)
-  {
-    // count number of edge neighbors
-    int directNeiCount = 0;
-    std::vector<int> neighborCells;
-
-    // Get cell points
-    const vtkIdType *pts;
-    vtkIdType npts;
-    this->WorkPd->GetCellPoints(i, npts, pts);
-
-    // Get cell edge neighbors
-    for (int j=0; j<npts; j++)
-    {
-      int ptId0 = pts[j];
-      int ptId1 = pts[(j+1)%npts];
-
-      // Get cell edge neighbors
-      vtkNew(vtkIdList, cellEdgeNeighbors);
-      this->WorkPd->GetCellEdgeNeighbors(i, ptId0, ptId1, cellEdgeNeighbors);
-      directNeiCount += cellEdgeNeighbors->GetNumberOfIds();
-      for (int k=0; k<cellEdgeNeighbors->GetNumberOfIds(); k++)
-      {
-        neighborCells.push_back(cellEdgeNeighbors->GetId(k));
-      }
-    }
-    this->DirectNeighbors[i] = neighborCells;
-    this->NumberOfDirectNeighbors[i] = directNeiCount;
-  }
+  vtkSVPolyDataAdjacency::GetAdjacency(this->WorkPd)->GetCellDirectNeighbors(
+    this->DirectNeighbors, this->NumberOfDirectNeighbors);
 
   return SV_OK;
 }
@@ -669,7 +573,7 @@ int vtkSVEdgeWeightedCVT::GetCellPatchNeighbors()
       int cellNeighbor = this->Neighbors[i][j];
       if (cellNeighbor != i)
       {
-        int cellNeighborPatch = this->PatchIdsArray->GetTuple1(cellNeighbor);
+        int cellNeighborPatch = this->PatchIdsArray->GetValue(cellNeighbor);
         int neighborLoc;
         this->AddCellPatchNeighbor(i, cellNeighborPatch, neighborLoc);
       }
@@ -758,7 +662,7 @@ int vtkSVEdgeWeightedCVT::IsBoundaryCell(const int cellId)
   {
     int neighborCell = this->DirectNeighbors[cellId][i];
 
-    if (this->PatchIdsArray->GetTuple1(cellId) != this->PatchIdsArray->GetTuple1(neighborCell))
+    if (this->PatchIdsArray->GetValue(cellId) != this->PatchIdsArray->GetValue(neighborCell))
     {
       isOnBoundary = 1;
       break;
@@ -767,3 +671,16 @@ int vtkSVEdgeWeightedCVT::IsBoundaryCell(const int cellId)
 
   return true;
 }
+
+// ----------------------
+// GetDependentIds
+// ----------------------
+const std::vector<int> *vtkSVEdgeWeightedCVT::GetDependentIds(const int evalId)
+{
+  // A change updates the patch counts of the ring, which are read by the
+  // distance of each ring cell. The rings are symmetric and include evalId
+  if (evalId < 0 || evalId >= (int) this->Neighbors.size())
+    return nullptr;
+
+  return &this->Neighbors[evalId];
+}
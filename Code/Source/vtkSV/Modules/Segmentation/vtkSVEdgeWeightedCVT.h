@@ -87,6 +87,8 @@ protected:
   int UpdateConnectivity(const int evalId, const int oldGenerator, const int newGenerator) override;
   int UpdateGenerators() override;
   int IsBoundaryCell(const int cellId) override;
+  const std::vector<int> *GetDependentIds(const int evalId) override;
+  int IsEvaluationThreadSafe() override {return 1;}
 
   // Edge weights setup
   int GetPointCellValence();
@@ -92,7 +92,7 @@ int vtkSVEdgeWeightedSmoother::UpdateGenerators()
 int vtkSVEdgeWeightedSmoother::GetClosestGenerator(const int evalId, int &newGenerator)
 {
   // Get current generator
-  int currGenerator = this->PatchIdsArray->GetTuple1(evalId);
+  int currGenerator = this->PatchIdsArray->GetValue(evalId);
   newGenerator =  currGenerator;
 
   // Current minimum to beat is current generator
@@ -129,7 +129,7 @@ int vtkSVEdgeWeightedSmoother::GetClosestGenerator(const int evalId, int &newGen
 double vtkSVEdgeWeightedSmoother::GetEdgeWeightedDistance(const int generatorId, const int evalId)
 {
   // Current generator
-  int currGenerator = this->PatchIdsArray->GetTuple1(evalId);
+  int currGenerator = this->PatchIdsArray->GetValue(evalId);
 
   // Current cell normal
   vtkDataArray *cellNormals = this->WorkPd->GetCellData()->GetArray("Normals");
@@ -156,7 +156,7 @@ double vtkSVEdgeWeightedSmoother::GetEdgeWeightedDistance(const int generatorId,
   for (int i=0; i<this->NumberOfNeighbors[evalId]; i++)
   {
     int neighborId = this->Neighbors[evalId][i];
-    int neighborGenerator = this->PatchIdsArray->GetTuple1(neighborId);
+    int neighborGenerator = this->PatchIdsArray->GetValue(neighborId);
     if (neighborGenerator == generatorId)
     {
       double normal[3];
@@ -72,6 +72,9 @@ protected:
   int GetClosestGenerator(const int evalId, int &newGenerator) override;
   double GetEdgeWeightedDistance(const int generatorId, const int evalId) override;
 
+  // The distance looks up the cell points of the work polydata
+  int IsEvaluationThreadSafe() override {return 0;}
+
 private:
   vtkSVEdgeWeightedSmoother(const vtkSVEdgeWeightedSmoother&);  // Not implemented.
   void operator=(const vtkSVEdgeWeightedSmoother&);  // Not implemented.
@@ -36,10 +36,41 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 
 #include "vtkSVGeneralUtils.h"
 #include "vtkSVGlobals.h"
 
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+// ----------------------
+// SweepEvaluator
+// ----------------------
+/// \brief Evaluates the active ids of a sweep against the state at the start
+/// of the sweep
+struct vtkSVGeneralCVT::SweepEvaluator
+{
+  vtkSVGeneralCVT *CVT;
+  const int *ActiveIds;
+  int *IsBoundary;
+  int *NewGenerators;
+  int *Status;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      const int evalId = this->ActiveIds[i];
+      this->Status[i] = SV_OK;
+      this->IsBoundary[i] = this->CVT->IsBoundaryCell(evalId);
+      if (this->IsBoundary[i])
+        this->Status[i] = this->CVT->GetClosestGenerator(evalId, this->NewGenerators[i]);
+    }
+  }
+};
+
 // ----------------------
 // Constructor
 // ----------------------
@@ -65,6 +96,7 @@ vtkSVGeneralCVT::vtkSVGeneralCVT()
   this->MaximumNumberOfIterations = 1.0e2;
   this->UseTransferredPatchesAsThreshold = 1;
   this->NoInitialization = 0;
+  this->ParallelSweep = 1;
 }
 
 // ----------------------
@@ -132,6 +164,7 @@ void vtkSVGeneralCVT::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Use transferred patches as threshold: " << this->UseTransferredPatchesAsThreshold << "\n";
   os << indent << "Threshold: " << this->Threshold << "\n";
   os << indent << "Maximum number of iterations: " << this->MaximumNumberOfIterations << "\n";
+  os << indent << "Parallel sweep: " << this->ParallelSweep << "\n";
 }
 
 // ----------------------
@@ -325,16 +358,32 @@ int vtkSVGeneralCVT::RunFilter()
     numDatas = this->WorkPd->GetNumberOfPoints();
 
   // Set fixed values
-  this->FixedIds.resize(numDatas);
-  for (int i=0; i<numDatas; i++)
-    this->FixedIds[i] = 0;
-
+  this->FixedIds.assign(numDatas, 0);
   if (this->FixedIdsList != nullptr)
   {
+    for (int i=0; i<this->FixedIdsList->GetNumberOfIds(); i++)
+    {
+      vtkIdType fixedId = this->FixedIdsList->GetId(i);
+      if (fixedId >= 0 && fixedId < numDatas)
+        this->FixedIds[fixedId] = 1;
+    }
+  }
+
+  // If the derived class knows which ids depend on each other, only the ids
+  // near a change are revisited
+  int useActiveIds = this->UseCellArray && numDatas > 0 &&
+                     this->GetDependentIds(0) != nullptr;
+
+  std::vector<int> activeIds;
+  if (useActiveIds)
+  {
+    this->ScheduledSweep.assign(numDatas, -1);
+    this->RescheduledSweep.assign(numDatas, -1);
+    this->DirtySweep.assign(numDatas, -1);
     for (int i=0; i<numDatas; i++)
     {
-      if (this->FixedIdsList->IsId(i) != -1)
-        this->FixedIds[i] = 1;
+      if (!this->FixedIds[i])
+        activeIds.push_back(i);
     }
   }
 
@@ -351,27 +400,35 @@ int vtkSVGeneralCVT::RunFilter()
     //if (this->UseTransferredPatchesAsThreshold)
     eval = 0;
 
-    // Loop through cells
-    for (int i=0; i<numDatas; i++)
+    if (useActiveIds)
+    {
+      if (this->SweepActiveIds(iter, activeIds, eval) != SV_OK)
+        return SV_ERROR;
+    }
+    else
     {
-      if (this->UseCellArray && this->IsBoundaryCell(i) && !this->FixedIds[i])
+      // Loop through cells
+      for (int i=0; i<numDatas; i++)
       {
-        // Set for check of new generator
-        int oldGenerator = this->PatchIdsArray->GetTuple1(i);
-        int newGenerator;
-        // Get the closest generator
-        if (this->GetClosestGenerator(i, newGenerator) != SV_OK)
-        {
-          vtkErrorMacro("Could not get closest generator");
-          return SV_ERROR;
-        }
-        if (newGenerator != oldGenerator)
+        if (this->UseCellArray && this->IsBoundaryCell(i) && !this->FixedIds[i])
         {
-          this->UpdateConnectivity(i, oldGenerator, newGenerator);
-          //this->UpdateGenerators();
-          this->PatchIdsArray->SetTuple1(i, newGenerator);
-          //if (this->UseTransferredPatchesAsThreshold)
-          eval++;
+          // Set for check of new generator
+          int oldGenerator = this->PatchIdsArray->GetValue(i);
+          int newGenerator;
+          // Get the closest generator
+          if (this->GetClosestGenerator(i, newGenerator) != SV_OK)
+          {
+            vtkErrorMacro("Could not get closest generator");
+            return SV_ERROR;
+          }
+          if (newGenerator != oldGenerator)
+          {
+            this->UpdateConnectivity(i, oldGenerator, newGenerator);
+            //this->UpdateGenerators();
+            this->PatchIdsArray->SetValue(i, newGenerator);
+            //if (this->UseTransferredPatchesAsThreshold)
+            eval++;
+          }
         }
       }
     }
@@ -383,3 +440,123 @@ int vtkSVGeneralCVT::RunFilter()
 
   return SV_OK;
 }
+
+// ----------------------
+// SweepActiveIds
+// ----------------------
+/** \details Visits the active ids in increasing order like the full serial
+ *  sweep. An id whose dependency changed earlier in the sweep is scheduled
+ *  again in this sweep if it comes later, or in the next sweep otherwise.
+ *  Ids that nothing near them changed since their last visit would keep
+ *  their generator and are skipped, so the result is the same as visiting
+ *  every id. When supported, all active ids are first evaluated in parallel
+ *  and the serial pass only recomputes the ones that became dirty. */
+int vtkSVGeneralCVT::SweepActiveIds(const int sweep, std::vector<int> &activeIds,
+                                    int &numChanged)
+{
+  int numActive = activeIds.size();
+  for (int i=0; i<numActive; i++)
+    this->ScheduledSweep[activeIds[i]] = sweep;
+
+  // Evaluate against the state at the start of the sweep
+  int useParallel = this->ParallelSweep && this->IsEvaluationThreadSafe();
+  std::vector<int> isBoundary, newGenerators, status;
+  if (useParallel)
+  {
+    isBoundary.resize(numActive);
+    newGenerators.resize(numActive);
+    status.resize(numActive);
+
+    SweepEvaluator evaluator;
+    evaluator.CVT           = this;
+    evaluator.ActiveIds     = activeIds.data();
+    evaluator.IsBoundary    = isBoundary.data();
+    evaluator.NewGenerators = newGenerators.data();
+    evaluator.Status        = status.data();
+    vtkSMPTools::For(0, numActive, evaluator);
+  }
+
+  // Apply in increasing id order, merging in ids scheduled during the sweep
+  std::priority_queue<int, std::vector<int>, std::greater<int> > addedIds;
+  std::vector<int> nextIds;
+  int activeIndex = 0;
+  while (activeIndex < numActive || !addedIds.empty())
+  {
+    int evalId;
+    int evalIndex = -1;
+    if (!addedIds.empty() &&
+        (activeIndex == numActive || addedIds.top() < activeIds[activeIndex]))
+    {
+      evalId = addedIds.top();
+      addedIds.pop();
+    }
+    else
+    {
+      evalIndex = activeIndex++;
+      evalId = activeIds[evalIndex];
+    }
+
+    // Set for check of new generator
+    int oldGenerator = this->PatchIdsArray->GetValue(evalId);
+    int newGenerator = oldGenerator;
+    int evalBoundary, evalStatus = SV_OK;
+    if (useParallel && evalIndex != -1 && this->DirtySweep[evalId] != sweep)
+    {
+      evalBoundary = isBoundary[evalIndex];
+      newGenerator = newGenerators[evalIndex];
+      evalStatus   = status[evalIndex];
+    }
+    else
+    {
+      evalBoundary = this->IsBoundaryCell(evalId);
+      if (evalBoundary)
+        evalStatus = this->GetClosestGenerator(evalId, newGenerator);
+    }
+
+    if (!evalBoundary)
+      continue;
+
+    if (evalStatus != SV_OK)
+    {
+      vtkErrorMacro("Could not get closest generator");
+      return SV_ERROR;
+    }
+
+    if (newGenerator == oldGenerator)
+      continue;
+
+    this->UpdateConnectivity(evalId, oldGenerator, newGenerator);
+    this->PatchIdsArray->SetValue(evalId, newGenerator);
+    numChanged++;
+
+    // Schedule everything that depends on the changed id
+    const std::vector<int> *dependentIds = this->GetDependentIds(evalId);
+    int numDependents = dependentIds->size();
+    for (int i=-1; i<numDependents; i++)
+    {
+      int dependentId = i == -1 ? evalId : (*dependentIds)[i];
+      if (this->FixedIds[dependentId])
+        continue;
+
+      this->DirtySweep[dependentId] = sweep;
+      if (dependentId > evalId)
+      {
+        if (this->ScheduledSweep[dependentId] != sweep)
+        {
+          this->ScheduledSweep[dependentId] = sweep;
+          addedIds.push(dependentId);
+        }
+      }
+      else if (this->RescheduledSweep[dependentId] != sweep)
+      {
+        this->RescheduledSweep[dependentId] = sweep;
+        nextIds.push_back(dependentId);
+      }
+    }
+  }
+
+  std::sort(nextIds.begin(), nextIds.end());
+  activeIds.swap(nextIds);
+
+  return SV_OK;
+}
@@ -125,6 +125,15 @@ public:
   vtkSetObjectMacro(FixedIdsList, vtkIdList);
   //@}
 
+  //@{
+  /// \brief Evaluate the cells of a sweep in parallel when the derived class
+  /// supports it. Changes are still applied in cell order, so the result is
+  /// the same as a serial sweep. Default is on.
+  vtkGetMacro(ParallelSweep, int);
+  vtkSetMacro(ParallelSweep, int);
+  vtkBooleanMacro(ParallelSweep, int);
+  //@}
+
 protected:
   vtkSVGeneralCVT();
   ~vtkSVGeneralCVT();
@@ -146,6 +155,22 @@ protected:
   virtual int UpdateGenerators() = 0;
   virtual int IsBoundaryCell(const int cellId) = 0;
 
+  // Ids whose boundary status or closest generator can change when evalId
+  // changes generator, evalId included. Only these are revisited after a
+  // change. The default of nullptr means unknown and every id is visited
+  // every sweep.
+  virtual const std::vector<int> *GetDependentIds(const int vtkNotUsed(evalId)) {return nullptr;}
+
+  // Whether IsBoundaryCell and GetClosestGenerator only read the filter
+  // state and can be called from several threads at once.
+  virtual int IsEvaluationThreadSafe() {return 0;}
+
+  // One sweep over the active ids, which are replaced by the ids to visit
+  // on the next sweep.
+  int SweepActiveIds(const int sweep, std::vector<int> &activeIds, int &numChanged);
+
+  struct SweepEvaluator; // Parallel evaluation of the active ids
+
   vtkPolyData *WorkPd; // Polydata used during filter processing
   vtkPolyData *Generators; // Polydata used during filter processing
   vtkPolyData *WorkGenerators; // Polydata used during filter processing
@@ -157,6 +182,12 @@ protected:
 
   std::vector<int> FixedIds;
 
+  // Sweep in which each id was last scheduled, rescheduled for the next
+  // sweep, or had one of its dependencies change
+  std::vector<int> ScheduledSweep;
+  std::vector<int> RescheduledSweep;
+  std::vector<int> DirtySweep;
+
   char *CVTDataArrayName; // Array name on input with data to patch
   char *PatchIdsArrayName; // Array containing patch id info
 
@@ -168,6 +199,7 @@ protected:
   double Threshold; // Threshold to stop at
   int MaximumNumberOfIterations; // Max iterations
   int NoInitialization; // No generator initialization, useful if array already set on input
+  int ParallelSweep; // Evaluate sweeps in parallel
 
 
 private:
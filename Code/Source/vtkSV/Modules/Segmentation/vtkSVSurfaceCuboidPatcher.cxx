@@ -67,6 +67,7 @@
 #include "vtkSVMathUtils.h"
 #include "vtkSVIOUtils.h"
 #include "vtkSVPolycubeGenerator.h"
+#include "vtkSVPolyDataAdjacency.h"
 #include "vtkSVPolyDataEdgeSplitter.h"
 #include "vtkSVSurfaceCenterlineGrouper.h"
 
@@ -5339,6 +5340,7 @@ int vtkSVSurfaceCuboidPatcher::FixNoBoundaryRegions(vtkPolyData *pd, std::string
 
   // Num cells
   pd->BuildLinks();
+  vtkSVPolyDataAdjacency *adjacency = vtkSVPolyDataAdjacency::GetAdjacency(pd);
   int numCells = pd->GetNumberOfCells();
 
   // Set up array to keep track of temp cell ids, will be different than
@@ -5362,8 +5364,9 @@ int vtkSVSurfaceCuboidPatcher::FixNoBoundaryRegions(vtkPolyData *pd, std::string
   int count = 1;
   vtkIdType npts;
   const vtkIdType *pts;
+  vtkIdType nneis;
+  const vtkIdType *neis;
   vtkNew(vtkIdList, queue);
-  vtkNew(vtkIdList, cellEdgeNeighbors);
   std::vector<int> numCellsInRegion;
   for (int i=0; i<numCells; i++)
   {
@@ -5381,21 +5384,18 @@ int vtkSVSurfaceCuboidPatcher::FixNoBoundaryRegions(vtkPolyData *pd, std::string
       for (int j=0; j<count; j++)
       {
         // Get Cell points
-        pd->GetCellPoints(queue->GetId(j), npts, pts);
+        adjacency->GetCellPoints(queue->GetId(j), npts, pts);
 
         // Loop through cell points
         for (int k=0; k<npts; k++)
         {
-          int ptId0 = pts[k];
-          int ptId1 = pts[(k+1)%npts];
-
           // Get cell edge neighbors
-          pd->GetCellEdgeNeighbors(queue->GetId(j), ptId0, ptId1, cellEdgeNeighbors);
+          adjacency->GetCellEdgeNeighbors(queue->GetId(j), k, nneis, neis);
 
           // Check val of cell edge neighbors
-          for (int l=0; l<cellEdgeNeighbors->GetNumberOfIds(); l++)
+          for (int l=0; l<nneis; l++)
           {
-            int cellEdgeNeighbor = cellEdgeNeighbors->GetId(l);
+            int cellEdgeNeighbor = neis[l];
             if (tmpIds->GetTuple1(cellEdgeNeighbor) == -1 &&
                 cellValues->GetTuple1(i) == cellValues->GetTuple1(cellEdgeNeighbor))
             {
@@ -5412,7 +5412,6 @@ int vtkSVSurfaceCuboidPatcher::FixNoBoundaryRegions(vtkPolyData *pd, std::string
     }
   }
 
-  int ptId0, ptId1;
   int cellVal, currentVal;
   int cellId, edgeCellId;
   int maxNum, maxVal;
@@ -5433,25 +5432,22 @@ int vtkSVSurfaceCuboidPatcher::FixNoBoundaryRegions(vtkPolyData *pd, std::string
       }
 
       cellId = j;
-      pd->GetCellPoints(cellId, npts, pts);
+      adjacency->GetCellPoints(cellId, npts, pts);
       currentVal = cellValues->GetTuple1(cellId);
 
       for (int k=0; k<npts; k++)
       {
-        ptId0 = pts[k];
-        ptId1 = pts[(k+1)%npts];
-
-        pd->GetCellEdgeNeighbors(cellId, ptId0, ptId1, cellEdgeNeighbors);
+        adjacency->GetCellEdgeNeighbors(cellId, k, nneis, neis);
 
-        if (cellEdgeNeighbors->GetNumberOfIds() == 0)
+        if (nneis == 0)
         {
           onBoundary = 1;
           break;
         }
 
-        for (int l=0; l<cellEdgeNeighbors->GetNumberOfIds(); l++)
+        for (int l=0; l<nneis; l++)
         {
-          edgeCellId  = cellEdgeNeighbors->GetId(l);
+          edgeCellId  = neis[l];
           cellVal = cellValues->GetTuple1(edgeCellId);
 
           if (cellVal != currentVal && cellVal != -1)
@@ -40,6 +40,7 @@ vtkStandardNewMacro(vtkvmtkNonManifoldFastMarching);
 vtkvmtkNonManifoldFastMarching::vtkvmtkNonManifoldFastMarching()
 {
   this->Seeds = nullptr;
+  this->Targets = nullptr;
   this->TScalars = vtkDoubleArray::New();
   this->StatusScalars = vtkCharArray::New();
   this->ConsideredMinHeap = vtkvmtkMinHeap::New();
@@ -47,6 +48,7 @@ vtkvmtkNonManifoldFastMarching::vtkvmtkNonManifoldFastMarching()
   this->Regularization = 0.0;
   this->StopTravelTime = VTK_VMTK_LARGE_DOUBLE;
   this->StopNumberOfPoints = VTK_VMTK_LARGE_INTEGER;
+  this->StopOnTargets = 0;
   this->UnitSpeed = 0;
   this->InitializeFromScalars = 0;
   this->InitializationArrayName = nullptr;
@@ -60,6 +62,7 @@ vtkvmtkNonManifoldFastMarching::vtkvmtkNonManifoldFastMarching()
   this->IntersectedEdgesArrayName = nullptr;
 
   this->NumberOfAcceptedPoints = 0;
+  this->NumberOfAcceptedTargets = 0;
 
   this->AllowLineUpdate = 1;
   this->UpdateFromConsidered = 1;
@@ -73,6 +76,12 @@ vtkvmtkNonManifoldFastMarching::~vtkvmtkNonManifoldFastMarching()
     this->Seeds = nullptr;
     }
 
+  if (this->Targets)
+    {
+    this->Targets->Delete();
+    this->Targets = nullptr;
+    }
+
   if (this->BoundaryPolyData)
     {
     this->BoundaryPolyData->Delete();
@@ -143,6 +152,7 @@ void vtkvmtkNonManifoldFastMarching::InitPropagation(vtkPolyData* input)
   this->TScalars->FillComponent(0,VTK_VMTK_LARGE_DOUBLE);
 
   this->NumberOfAcceptedPoints = 0;
+  this->NumberOfAcceptedTargets = 0;
 
   this->ConsideredMinHeap->SetMinHeapScalars(this->TScalars);
   this->ConsideredMinHeap->Initialize();
@@ -229,6 +239,10 @@ void vtkvmtkNonManifoldFastMarching::InitPropagation(vtkPolyData* input)
     {
     this->StatusScalars->SetValue(boundaryPointIds->GetId(i),VTK_VMTK_ACCEPTED_STATUS);
     this->NumberOfAcceptedPoints++;
+    if (this->StopOnTargets && this->Targets->IsId(boundaryPointIds->GetId(i)) != -1)
+      {
+      this->NumberOfAcceptedTargets++;
+      }
     }
 
   for (k=0; k<3; k++)   // get a good initial solution
@@ -608,12 +622,26 @@ void vtkvmtkNonManifoldFastMarching::Propagate(vtkPolyData* input)
   double currentTravelTime;
   vtkIdType trialId;
 
+  if (this->StopOnTargets && this->NumberOfAcceptedTargets >= this->Targets->GetNumberOfIds())
+    {
+    return;
+    }
+
   while (this->ConsideredMinHeap->GetSize()>0)
     {
     trialId = this->ConsideredMinHeap->RemoveMin();
     this->StatusScalars->SetValue(trialId,VTK_VMTK_ACCEPTED_STATUS);
     this->NumberOfAcceptedPoints++;
 
+    if (this->StopOnTargets && this->Targets->IsId(trialId) != -1)
+      {
+      this->NumberOfAcceptedTargets++;
+      if (this->NumberOfAcceptedTargets >= this->Targets->GetNumberOfIds())
+        {
+        break;
+        }
+      }
+
     this->UpdateNeighborhood(input,trialId);
 
     currentTravelTime = this->TScalars->GetValue(trialId);
@@ -695,6 +723,15 @@ int vtkvmtkNonManifoldFastMarching::RequestData(
       }
     }
 
+  if (this->StopOnTargets)
+    {
+    if (!this->Targets)
+      {
+      vtkErrorMacro(<<"Targets not specified!");
+      return 1;
+      }
+    }
+
   if (this->PolyDataBoundaryConditions)
     {
     if (!this->BoundaryPolyData)
@@ -722,8 +759,10 @@ int vtkvmtkNonManifoldFastMarching::RequestData(
 
   this->Propagate(input);
 
+  // When stopping on targets the unreached points are left at a large travel
+  // time instead of being reset, otherwise a descent would be drawn into them
   int naccepted = 0, nconsidered = 0, nfar = 0;
-  for (i=0; i<input->GetNumberOfPoints(); i++)
+  for (i=0; i<input->GetNumberOfPoints() && !this->StopOnTargets; i++)
     {
     if (this->TScalars->GetValue(i)>=VTK_VMTK_LARGE_DOUBLE)
       {
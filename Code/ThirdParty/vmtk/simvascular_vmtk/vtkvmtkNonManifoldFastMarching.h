@@ -93,6 +93,17 @@ class VTK_VMTK_COMPUTATIONAL_GEOMETRY_EXPORT vtkvmtkNonManifoldFastMarching : pu
   vtkSetObjectMacro(Seeds,vtkIdList);
   vtkGetObjectMacro(Seeds,vtkIdList);
 
+  // Description:
+  // Toggle on/off stopping the propagation once all the Targets have been accepted. Points that have not been reached keep a large travel time, so that a steepest descent from the targets is unaffected.
+  vtkSetMacro(StopOnTargets,int);
+  vtkGetMacro(StopOnTargets,int);
+  vtkBooleanMacro(StopOnTargets,int);
+
+  // Description:
+  // Set/Get the target points used when StopOnTargets is on.
+  vtkSetObjectMacro(Targets,vtkIdList);
+  vtkGetObjectMacro(Targets,vtkIdList);
+
   // Description:
   // Set/Get poly data were boundary conditions are specified.
   vtkSetObjectMacro(BoundaryPolyData,vtkPolyData);
@@ -157,11 +168,13 @@ class VTK_VMTK_COMPUTATIONAL_GEOMETRY_EXPORT vtkvmtkNonManifoldFastMarching : pu
   vtkvmtkMinHeap* ConsideredMinHeap;
 
   vtkIdList* Seeds;
+  vtkIdList* Targets;
   vtkPolyData* BoundaryPolyData;
 
   double Regularization;
   double StopTravelTime;
   vtkIdType StopNumberOfPoints;
+  int StopOnTargets;
   int UnitSpeed;
   int InitializeFromScalars;
   char* IntersectedEdgesArrayName;
@@ -173,6 +186,7 @@ class VTK_VMTK_COMPUTATIONAL_GEOMETRY_EXPORT vtkvmtkNonManifoldFastMarching : pu
   int PolyDataBoundaryConditions;
 
   vtkIdType NumberOfAcceptedPoints;
+  vtkIdType NumberOfAcceptedTargets;
 
   int AllowLineUpdate;
   int UpdateFromConsidered;